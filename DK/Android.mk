@@ -47,12 +47,14 @@ DKFOUNDATION_SRC := \
 	DKFoundation/DKMutex.cpp \
 	DKFoundation/DKObjectRefCounter.cpp \
 	DKFoundation/DKOperationQueue.cpp \
+	DKFoundation/DKParallel.cpp \
 	DKFoundation/DKRational.cpp \
 	DKFoundation/DKRunLoop.cpp \
 	DKFoundation/DKRunLoopTimer.cpp \
 	DKFoundation/DKSharedLock.cpp \
 	DKFoundation/DKSpinLock.cpp \
 	DKFoundation/DKStringU8.cpp \
+	DKFoundation/DKStringAtom.cpp \
 	DKFoundation/DKStringUE.cpp \
 	DKFoundation/DKStringW.cpp \
 	DKFoundation/DKThread.cpp \
@@ -67,6 +69,7 @@ DKFOUNDATION_SRC := \
 
 DKFRAMEWORK_SRC := \
 	DKFramework/DKAabb.cpp \
+	DKFramework/DKAabbTree.cpp \
 	DKFramework/DKAffineTransform2.cpp \
 	DKFramework/DKAffineTransform3.cpp \
 	DKFramework/DKAnimation.cpp \
@@ -114,6 +117,7 @@ DKFRAMEWORK_SRC := \
 	DKFramework/DKMultiSphereShape.cpp \
 	DKFramework/DKOpenALContext.cpp \
 	DKFramework/DKOpenGLContext.cpp \
+	DKFramework/DKOpenGLRecorder.cpp \
 	DKFramework/DKPlane.cpp \
 	DKFramework/DKPoint2PointConstraint.cpp \
 	DKFramework/DKPolyhedralConvexShape.cpp \
@@ -160,6 +164,7 @@ DKFRAMEWORK_SRC := \
 	DKFramework/DKVoxel32SparseVolume.cpp \
 	DKFramework/DKVoxelIsosurfacePolygonizer.cpp \
 	DKFramework/DKVoxelPolygonizer.cpp \
+	DKFramework/DKVoxelMesher.cpp \
 	DKFramework/DKWindow.cpp \
 	DKFramework/Private/DKAudioStreamFLAC.cpp \
 	DKFramework/Private/DKAudioStreamVorbis.cpp \
@@ -17,17 +17,22 @@
 // unicode string
 #include "DKFoundation/DKString.h"
 #include "DKFoundation/DKStringU8.h"
+#include "DKFoundation/DKStringAtom.h"
 
 // data collections
 #include "DKFoundation/DKArray.h"
 #include "DKFoundation/DKBitArray.h"
 #include "DKFoundation/DKCircularQueue.h"
+#include "DKFoundation/DKHashMap.h"
+#include "DKFoundation/DKHashSet.h"
+#include "DKFoundation/DKHashTable.h"
 #include "DKFoundation/DKList.h"
 #include "DKFoundation/DKMap.h"
 #include "DKFoundation/DKOrderedArray.h"
 #include "DKFoundation/DKSet.h"
 #include "DKFoundation/DKStack.h"
 #include "DKFoundation/DKStaticArray.h"
+#include "DKFoundation/DKSmallArray.h"
 #include "DKFoundation/DKTuple.h"
 #include "DKFoundation/DKQueue.h"
 
@@ -78,6 +83,7 @@
 
 // run-loop, operation queue, message-handler
 #include "DKFoundation/DKOperationQueue.h"
+#include "DKFoundation/DKParallel.h"
 #include "DKFoundation/DKRunLoop.h"
 #include "DKFoundation/DKRunLoopTimer.h"
 
@@ -35,6 +35,11 @@
 //
 //  If you have to obtain element's pointer or reference, beware of thread-safety.
 //  CopyValue() function is always thread-safe.
+//
+//  Items are relocated with realloc, memmove when growing, inserting or
+//  removing. If VALUE cannot be relocated bitwise, specialize
+//  DKRelocationTraits<VALUE> then items will be relocated with move
+//  constructor. (see DKTypes.h)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -151,6 +156,21 @@ namespace DKFoundation
 			new(&data[count]) VALUE(value);
 			return count++;
 		}
+		Index Add(VALUE&& value)
+		{
+			CriticalSection guard(lock);
+			ReserveItemCapsNL(1);
+			new(&data[count]) VALUE(static_cast<VALUE&&>(value));
+			return count++;
+		}
+		// construct one item at tail with arguments.
+		template <typename... Args> Index Emplace(Args&&... args)
+		{
+			CriticalSection guard(lock);
+			ReserveItemCapsNL(1);
+			new(&data[count]) VALUE(std::forward<Args>(args)...);
+			return count++;
+		}
 		// append 's' length of value to tail.
 		Index Add(const VALUE* value, size_t s)
 		{
@@ -199,11 +219,23 @@ namespace DKFoundation
 			if (pos > count)
 				pos = count;
 			if (pos < count)
-				memmove((void*)&data[pos+1], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+				RelocateNL(&data[pos+1], &data[pos], count - pos);
 			new(&data[pos]) VALUE(value);
 			count++;
 			return pos;
 		}
+		Index Insert(VALUE&& value, Index pos)
+		{
+			CriticalSection guard(lock);
+			ReserveItemCapsNL(1);
+			if (pos > count)
+				pos = count;
+			if (pos < count)
+				RelocateNL(&data[pos+1], &data[pos], count - pos);
+			new(&data[pos]) VALUE(static_cast<VALUE&&>(value));
+			count++;
+			return pos;
+		}
 		// insert 's' length of value into position 'pos'.
 		Index Insert(const VALUE* value, size_t s, Index pos)
 		{
@@ -212,7 +244,7 @@ namespace DKFoundation
 			if (pos > count)
 				pos = count;
 			if (pos < count)
-				memmove((void*)&data[pos+s], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+				RelocateNL(&data[pos+s], &data[pos], count - pos);
 			for (Index i = 0; i < s; i++)
 				new(&data[pos+i]) VALUE(value[i]);
 			count += s;
@@ -226,7 +258,7 @@ namespace DKFoundation
 			if (pos > count)
 				pos = count;
 			if (pos < count)
-				memmove((void*)&data[pos+s], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+				RelocateNL(&data[pos+s], &data[pos], count - pos);
 			for (Index i = 0; i < s; i++)
 				new(&data[pos+i]) VALUE(value);
 			count += s;
@@ -241,7 +273,7 @@ namespace DKFoundation
 			if (pos > count)
 				pos = count;
 			if (pos < count)
-				memmove((void*)&data[pos+s], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+				RelocateNL(&data[pos+s], &data[pos], count - pos);
 			for (const VALUE& v : il)
 			{
 				new(&data[pos]) VALUE(v);
@@ -258,7 +290,7 @@ namespace DKFoundation
 			{
 				data[pos].~VALUE();
 				if (count - pos > 1)
-					memmove((void*)&data[pos], (void*)&data[pos+1], sizeof(VALUE) * (count-pos-1));
+					RelocateNL(&data[pos], &data[pos+1], count-pos-1);
 				count--;
 			}
 			return count;
@@ -273,7 +305,7 @@ namespace DKFoundation
 				for (; i < count - pos && i < c; i++)
 					data[pos+i].~VALUE();
 				if (i > 0)
-					memmove((void*)&data[pos], &data[pos+i], sizeof(VALUE) * (count-pos-i));
+					RelocateNL(&data[pos], &data[pos+i], count-pos-i);
 				count -= i;
 			}
 			return count;
@@ -626,12 +658,54 @@ namespace DKFoundation
 			if (c <= capacity)
 				return;
 
+			ReallocNL(c, DKNumber<DKRelocationTraits<VALUE>::IsBitwiseRelocatable>());
+			capacity = c;
+		}
+		void ReallocNL(size_t c, DKTrue)
+		{
 			if (data)
 				data = (VALUE*)Allocator::Realloc(data, sizeof(VALUE) * c);
 			else
 				data = (VALUE*)Allocator::Alloc(sizeof(VALUE) * c);
-
-			capacity = c;
+		}
+		void ReallocNL(size_t c, DKFalse)
+		{
+			VALUE* p = (VALUE*)Allocator::Alloc(sizeof(VALUE) * c);
+			if (data)
+			{
+				Relocate(p, data, count, DKFalse());
+				Allocator::Free(data);
+			}
+			data = p;
+		}
+		// move 'n' items from src to dst, dst and src can be overlapped.
+		// items in src are destroyed, dst should be uninitialized.
+		static void RelocateNL(VALUE* dst, VALUE* src, size_t n)
+		{
+			Relocate(dst, src, n, DKNumber<DKRelocationTraits<VALUE>::IsBitwiseRelocatable>());
+		}
+		static void Relocate(VALUE* dst, VALUE* src, size_t n, DKTrue)
+		{
+			memmove((void*)dst, (void*)src, sizeof(VALUE) * n);
+		}
+		static void Relocate(VALUE* dst, VALUE* src, size_t n, DKFalse)
+		{
+			if (dst < src)
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					new(&dst[i]) VALUE(static_cast<VALUE&&>(src[i]));
+					src[i].~VALUE();
+				}
+			}
+			else if (dst > src)
+			{
+				for (size_t i = n; i > 0; --i)
+				{
+					new(&dst[i-1]) VALUE(static_cast<VALUE&&>(src[i-1]));
+					src[i-1].~VALUE();
+				}
+			}
 		}
 		void ReserveItemCapsNL(size_t c)
 		{
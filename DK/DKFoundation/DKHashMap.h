@@ -0,0 +1,354 @@
+//
+//  File: DKHashMap.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include <initializer_list>
+#include "../DKInclude.h"
+#include "DKHashTable.h"
+#include "DKMap.h"
+#include "DKDummyLock.h"
+#include "DKCriticalSection.h"
+#include "DKTypeTraits.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKHashMap
+// hash table map class (using DKHashTable internally, see DKHashTable.h).
+// interface is same as DKMap, but items are not sorted.
+// lookup is O(1), and items are stored in single array without node
+// allocation. good for lookup table which is not enumerated in order.
+//
+// Insert: insert value if key is not exists.
+// Update: set value for key whether key is exists or not.
+//
+// insertion, deletion, lookup is thread-safe.
+// If you need to modify value directly, you should have lock object.
+//
+// Note:
+//  pointer of Pair (returned by Find) will be changed by insertion, deletion.
+//  enumeration order is not sorted, and changed by insertion, deletion.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	template <
+		typename Key,											// key type
+		typename ValueT,										// value type
+		typename Lock = DKDummyLock,							// lock
+		typename KeyHasher = DKHashTableHasher<Key>,			// key hash
+		typename KeyEqual = DKHashTableKeyEqual<Key>,			// key comparison
+		typename Allocator = DKMemoryDefaultAllocator			// memory allocator
+	>
+	class DKHashMap
+	{
+		// items are stored with non-const key, to be moved in table.
+		typedef DKMapPair<Key, ValueT>			Item;
+		struct ItemKey
+		{
+			FORCEINLINE const Key& operator () (const Item& item) const
+			{
+				return item.key;
+			}
+		};
+	public:
+		typedef DKMapPair<const Key, ValueT>	Pair;
+		typedef DKCriticalSection<Lock>			CriticalSection;
+		typedef DKTypeTraits<Key>				KeyTraits;
+		typedef DKTypeTraits<ValueT>			ValueTraits;
+		typedef DKHashTable<Item, Key, ItemKey, KeyHasher, KeyEqual, Allocator> Container;
+
+		static_assert(sizeof(Item) == sizeof(Pair), "Pair and Item must have same layout.");
+
+		// lock is public. to provde lock object from outside!
+		// FindNoLock, CountNoLock is usable regardless of locking.
+		Lock	lock;
+
+		DKHashMap(void)
+		{
+		}
+		DKHashMap(DKHashMap&& m)
+			: container(static_cast<Container&&>(m.container))
+		{
+		}
+		DKHashMap(const DKHashMap& m)
+		{
+			CriticalSection guard(m.lock);
+			container = m.container;
+		}
+		DKHashMap(std::initializer_list<Pair> il)
+		{
+			container.Reserve(il.size());
+			for (const Pair& p : il)
+				container.Insert(Item(p.key, p.value));
+		}
+		~DKHashMap(void)
+		{
+			Clear();
+		}
+		// Update: overwrite value if key is exists, or insert item.
+		void Update(const Pair& p)
+		{
+			CriticalSection guard(lock);
+			UpdateNL(p.key, p.value);
+		}
+		void Update(const Key& k, const ValueT& v)
+		{
+			CriticalSection guard(lock);
+			UpdateNL(k, v);
+		}
+		void Update(const Pair* p, size_t size)
+		{
+			CriticalSection guard(lock);
+			for (size_t i = 0; i < size; i++)
+				UpdateNL(p[i].key, p[i].value);
+		}
+		template <typename ...Args> void Update(const DKHashMap<Key, ValueT, Args...>& m)
+		{
+			CriticalSection guard(lock);
+			m.EnumerateForward([this](const typename DKHashMap<Key, ValueT, Args...>::Pair& pair)
+			{
+				UpdateNL(pair.key, pair.value);
+			});
+		}
+		void Update(std::initializer_list<Pair> il)
+		{
+			CriticalSection guard(lock);
+			for (const Pair& p : il)
+				UpdateNL(p.key, p.value);
+		}
+		// Insert: insert item if key is not exist, fails otherwise.
+		bool Insert(const Pair& p)
+		{
+			CriticalSection guard(lock);
+			return container.Insert(Item(p.key, p.value)) != NULL;
+		}
+		bool Insert(const Key& k, const ValueT& v)
+		{
+			CriticalSection guard(lock);
+			return container.Insert(Item(k, v)) != NULL;
+		}
+		size_t Insert(const Pair* p, size_t size)
+		{
+			size_t ret = 0;
+			CriticalSection guard(lock);
+			for (size_t i = 0; i < size; i++)
+				if (container.Insert(Item(p[i].key, p[i].value)))
+					ret++;
+			return ret;
+		}
+		template <typename ...Args> size_t Insert(const DKHashMap<Key, ValueT, Args...>& m)
+		{
+			size_t n = 0;
+			CriticalSection guard(lock);
+			m.EnumerateForward([this, &n](const typename DKHashMap<Key, ValueT, Args...>::Pair& pair)
+			{
+				if (container.Insert(Item(pair.key, pair.value)) != NULL)
+					n++;
+			});
+			return n;
+		}
+		size_t Insert(std::initializer_list<Pair> il)
+		{
+			size_t n = 0;
+			CriticalSection guard(lock);
+			for (const Pair& p : il)
+			{
+				if (container.Insert(Item(p.key, p.value)) != NULL)
+					n++;
+			}
+			return n;
+		}
+		void Remove(const Key& k)
+		{
+			CriticalSection guard(lock);
+			container.Remove(k);
+		}
+		void Remove(std::initializer_list<Key> il)
+		{
+			CriticalSection guard(lock);
+			for (const Key& k : il)
+				container.Remove(k);
+		}
+		void Clear(void)
+		{
+			CriticalSection guard(lock);
+			container.Clear();
+		}
+		// reserve space for n items.
+		void Reserve(size_t n)
+		{
+			CriticalSection guard(lock);
+			container.Reserve(n);
+		}
+		Pair* Find(const Key& k)
+		{
+			return const_cast<Pair*>(static_cast<const DKHashMap&>(*this).Find(k));
+		}
+		const Pair* Find(const Key& k) const
+		{
+			CriticalSection guard(lock);
+			return FindNoLock(k);
+		}
+		// Perform search operation without locking.
+		// useful if you have locked already in your context.
+		Pair* FindNoLock(const Key& k)
+		{
+			return const_cast<Pair*>(static_cast<const DKHashMap&>(*this).FindNoLock(k));
+		}
+		const Pair* FindNoLock(const Key& k) const
+		{
+			return reinterpret_cast<const Pair*>(container.Find(k));
+		}
+		// if key 'k' is not exist, an new value inserted and returns.
+		ValueT& Value(const Key& k)
+		{
+			CriticalSection guard(lock);
+			Item* p = container.Find(k);
+			if (p == NULL)
+				p = container.Insert(Item(k, ValueT()));
+			return p->value;
+		}
+		bool IsEmpty(void) const
+		{
+			CriticalSection guard(lock);
+			return container.Count() == 0;
+		}
+		size_t Count(void) const
+		{
+			CriticalSection guard(lock);
+			return container.Count();
+		}
+		size_t CountNoLock(void) const
+		{
+			return container.Count();
+		}
+		DKHashMap& operator = (DKHashMap&& m)
+		{
+			if (this != &m)
+			{
+				CriticalSection guard(lock);
+				container = static_cast<Container&&>(m.container);
+			}
+			return *this;
+		}
+		DKHashMap& operator = (const DKHashMap& m)
+		{
+			if (this != &m)
+			{
+				CriticalSection guardOther(m.lock);
+				CriticalSection guardSelf(lock);
+
+				container = m.container;
+			}
+			return *this;
+		}
+		DKHashMap& operator = (std::initializer_list<Pair> il)
+		{
+			CriticalSection guard(lock);
+			container.Clear();
+			for (const Pair& p : il)
+				container.Insert(Item(p.key, p.value));
+			return *this;
+		}
+		// EnumerateForward / EnumerateBackward: enumerate all items.
+		// You cannot insert, remove items while enumerating. (container is read-only)
+		// enumerator can be lambda or any function type that can receive arguments (VALUE&) or (VALUE&, bool*)
+		// (VALUE&, bool*) type can cancel iteration by set boolean value to true.
+		template <typename T> void EnumerateForward(T&& enumerator)
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<Pair&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<Pair&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (VALUE&) or (VALUE&,bool*)");
+
+			EnumerateForward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator)
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<Pair&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<Pair&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (VALUE&) or (VALUE&,bool*)");
+
+			EnumerateBackward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+		// lambda enumerator (const VALUE&) or (const VALUE&, bool*) function type.
+		template <typename T> void EnumerateForward(T&& enumerator) const
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<const Pair&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<const Pair&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (const VALUE&) or (const VALUE&,bool*)");
+
+			EnumerateForward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator) const
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<const Pair&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<const Pair&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (const VALUE&) or (const VALUE&,bool*)");
+
+			EnumerateBackward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+
+	private:
+		void UpdateNL(const Key& k, const ValueT& v)
+		{
+			Item* p = container.Find(k);
+			if (p)
+				p->value = v;
+			else
+				container.Insert(Item(k, v));
+		}
+		// lambda enumerator (VALUE&)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<1>)
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward([&enumerator](Item& val, bool*) {enumerator(reinterpret_cast<Pair&>(val));});
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<1>)
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward([&enumerator](Item& val, bool*) {enumerator(reinterpret_cast<Pair&>(val));});
+		}
+		// lambda enumerator (const VALUE&)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<1>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward([&enumerator](const Item& val, bool*) {enumerator(reinterpret_cast<const Pair&>(val));});
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<1>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward([&enumerator](const Item& val, bool*) {enumerator(reinterpret_cast<const Pair&>(val));});
+		}
+		// lambda enumerator (VALUE&, bool*)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<2>)
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward([&enumerator](Item& val, bool* stop) {enumerator(reinterpret_cast<Pair&>(val), stop);});
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<2>)
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward([&enumerator](Item& val, bool* stop) {enumerator(reinterpret_cast<Pair&>(val), stop);});
+		}
+		// lambda enumerator (const VALUE&, bool*)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<2>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward([&enumerator](const Item& val, bool* stop) {enumerator(reinterpret_cast<const Pair&>(val), stop);});
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<2>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward([&enumerator](const Item& val, bool* stop) {enumerator(reinterpret_cast<const Pair&>(val), stop);});
+		}
+
+		Container	container;
+	};
+}
@@ -0,0 +1,233 @@
+//
+//  File: DKHashSet.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include <initializer_list>
+#include "../DKInclude.h"
+#include "DKHashTable.h"
+#include "DKDummyLock.h"
+#include "DKCriticalSection.h"
+#include "DKTypeTraits.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKHashSet
+// a set container class. using DKHashTable (see DKHashTable.h) internally.
+// interface is same as DKSet, but values are not sorted.
+//
+// VALUE: value type
+// LOCK: thread-lock type
+// HASHER: value hash function
+// EQUAL: value comparison function
+//
+// Note:
+//   if two set objects has same VALUE but different LOCK, HASHER, EQUAL,
+//   Union(), Intersect() are available only.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	template <
+		typename Value,
+		typename Lock = DKDummyLock,
+		typename Hasher = DKHashTableHasher<Value>,
+		typename Equal = DKHashTableKeyEqual<Value>,
+		typename Allocator = DKMemoryDefaultAllocator
+	>
+	class DKHashSet
+	{
+	public:
+		typedef DKCriticalSection<Lock>		CriticalSection;
+		typedef DKTypeTraits<Value>			ValueTraits;
+		typedef DKHashTable<Value, Value, DKHashTableItemKey<Value>, Hasher, Equal, Allocator>	Container;
+
+		// lock is public. allow object being locked manually.
+		// ContainsNoLock(), CountNoLock() is available when object has been locked.
+		Lock	lock;
+
+		DKHashSet(void)
+		{
+		}
+		DKHashSet(DKHashSet&& s)
+			: container(static_cast<Container&&>(s.container))
+		{
+		}
+		DKHashSet(const DKHashSet& s)
+		{
+			CriticalSection guard(s.lock);
+			container = s.container;
+		}
+		DKHashSet(const Value* v, size_t n)
+		{
+			container.Reserve(n);
+			for (size_t i = 0; i < n; ++i)
+				container.Insert(v[i]);
+		}
+		DKHashSet(std::initializer_list<Value> il)
+		{
+			container.Reserve(il.size());
+			for (const Value& v : il)
+				container.Insert(v);
+		}
+		~DKHashSet(void)
+		{
+		}
+		void Insert(const Value& v)
+		{
+			CriticalSection guard(lock);
+			container.Insert(v);
+		}
+		void Insert(const Value* v, size_t n)
+		{
+			CriticalSection guard(lock);
+			for (size_t i = 0; i < n; ++i)
+				container.Insert(v[i]);
+		}
+		void Insert(std::initializer_list<Value> il)
+		{
+			CriticalSection guard(lock);
+			for (const Value& v : il)
+				container.Insert(v);
+		}
+		template <typename ...Args> DKHashSet& Union(const DKHashSet<Value, Args...>& s)
+		{
+			CriticalSection guard(lock);
+			s.EnumerateForward([this](const Value& val) { container.Insert(val); });
+			return *this;
+		}
+		// remove values which are not contained in s.
+		template <typename ...Args> DKHashSet& Intersect(const DKHashSet<Value, Args...>& s)
+		{
+			CriticalSection guard(lock);
+			Container result;
+			container.EnumerateForward([&](const Value& val, bool*)
+			{
+				if (s.Contains(val))
+					result.Insert(val);
+			});
+			container = static_cast<Container&&>(result);
+			return *this;
+		}
+		void Remove(const Value& v)
+		{
+			CriticalSection guard(lock);
+			container.Remove(v);
+		}
+		void Remove(std::initializer_list<Value> il)
+		{
+			CriticalSection guard(lock);
+			for (const Value& v : il)
+				container.Remove(v);
+		}
+		void Clear(void)
+		{
+			CriticalSection guard(lock);
+			container.Clear();
+		}
+		// reserve space for n values.
+		void Reserve(size_t n)
+		{
+			CriticalSection guard(lock);
+			container.Reserve(n);
+		}
+		bool Contains(const Value& v) const
+		{
+			CriticalSection guard(lock);
+			return container.Find(v) != NULL;
+		}
+		bool ContainsNoLock(const Value& v) const
+		{
+			return container.Find(v) != NULL;
+		}
+		bool IsEmpty(void) const
+		{
+			CriticalSection guard(lock);
+			return container.Count() == 0;
+		}
+		size_t Count(void) const
+		{
+			CriticalSection guard(lock);
+			return container.Count();
+		}
+		size_t CountNoLock(void) const
+		{
+			return container.Count();
+		}
+		DKHashSet& operator = (DKHashSet&& s)
+		{
+			if (this != &s)
+			{
+				CriticalSection guard(lock);
+				container = static_cast<Container&&>(s.container);
+			}
+			return *this;
+		}
+		DKHashSet& operator = (const DKHashSet& s)
+		{
+			if (this != &s)
+			{
+				CriticalSection guardOther(s.lock);
+				CriticalSection guardSelf(lock);
+
+				container = s.container;
+			}
+			return *this;
+		}
+		DKHashSet& operator = (std::initializer_list<Value> il)
+		{
+			CriticalSection guard(lock);
+			container.Clear();
+			for (const Value& v : il)
+				container.Insert(v);
+			return *this;
+		}
+		// lambda enumerator (const VALUE&) or (const VALUE&, bool*) are allowed.
+		// enumerating objects are READ-ONLY. values cannot be modified.
+		template <typename T> void EnumerateForward(T&& enumerator) const
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<const Value&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<const Value&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (const VALUE&) or (const VALUE&,bool*)");
+
+			EnumerateForward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator) const
+		{
+			using Func = typename DKFunctionType<T&&>::Signature;
+			enum {ValidatePType1 = Func::template CanInvokeWithParameterTypes<const Value&>()};
+			enum {ValidatePType2 = Func::template CanInvokeWithParameterTypes<const Value&, bool*>()};
+			static_assert(ValidatePType1 || ValidatePType2, "enumerator's parameter is not compatible with (const VALUE&) or (const VALUE&,bool*)");
+
+			EnumerateBackward(std::forward<T>(enumerator), typename Func::ParameterNumber());
+		}
+	private:
+		// lambda enumerator (const VALUE&)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<1>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward([&enumerator](const Value& val, bool*) {enumerator(val);});
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<1>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward([&enumerator](const Value& val, bool*) {enumerator(val);});
+		}
+		// lambda enumerator (const VALUE&, bool*)
+		template <typename T> void EnumerateForward(T&& enumerator, DKNumber<2>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateForward(enumerator);
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator, DKNumber<2>) const
+		{
+			CriticalSection guard(lock);
+			container.EnumerateBackward(enumerator);
+		}
+
+		Container container;
+	};
+}
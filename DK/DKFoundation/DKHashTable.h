@@ -0,0 +1,473 @@
+//
+//  File: DKHashTable.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include <new>
+#include <type_traits>
+#include "../DKInclude.h"
+#include "DKTypeTraits.h"
+#include "DKFunction.h"
+#include "DKString.h"
+#include "DKStringU8.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKHashTable
+// open-addressing hash table template implementation. (Robin Hood hashing)
+//
+// items are stored in single array, with one byte of probe distance for
+// each slot. (0: empty) items are placed by Robin Hood rule, (item which is
+// far from home slot takes slot of item which is close to home slot) and
+// lookup stops at slot closer to home than searching key.
+// key comparison is performed only with slots of same probe distance.
+// removal shifts following items backward, no tombstone.
+//
+// Hasher: hash function object, returns size_t. default hasher
+//   (DKHashTableHasher) supports integral types, enums, pointers, DKString,
+//   DKStringU8, and hashes bytes of value for other types.
+//   hash value is mixed with fibonacci hashing, low quality hash is allowed.
+//
+// Note:
+//  item pointer will be changed by insertion and deletion.
+//  (unlike DKAVLTree) do not keep item pointer after modifying table.
+//
+//  This class is not thread-safe. You need to use synchronization object
+//  to serialize of access in multi-threaded environment.
+//  You can use DKHashMap, DKHashSet instead, they are thread safe.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	template <typename T, bool = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>
+	struct DKHashTableHasher
+	{
+		// FNV-1a, bytes of value.
+		FORCEINLINE size_t operator () (const T& v) const
+		{
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(&v);
+			size_t h = (size_t)2166136261U;
+			for (size_t i = 0; i < sizeof(T); ++i)
+				h = (h ^ p[i]) * (size_t)16777619U;
+			return h;
+		}
+	};
+	template <typename T> struct DKHashTableHasher<T, true>
+	{
+		FORCEINLINE size_t operator () (T v) const
+		{
+			return (size_t)v;
+		}
+	};
+	template <> struct DKHashTableHasher<DKStringW, false>
+	{
+		FORCEINLINE size_t operator () (const DKStringW& str) const
+		{
+			const DKUniCharW* p = str;
+			size_t h = (size_t)2166136261U;
+			for (size_t i = 0, n = str.Length(); i < n; ++i)
+				h = (h ^ (size_t)p[i]) * (size_t)16777619U;
+			return h;
+		}
+	};
+	template <> struct DKHashTableHasher<DKStringU8, false>
+	{
+		FORCEINLINE size_t operator () (const DKStringU8& str) const
+		{
+			const DKUniChar8* p = str;
+			size_t h = (size_t)2166136261U;
+			for (size_t i = 0, n = str.Bytes(); i < n; ++i)
+				h = (h ^ (unsigned char)p[i]) * (size_t)16777619U;
+			return h;
+		}
+	};
+	template <typename Key> struct DKHashTableKeyEqual
+	{
+		FORCEINLINE bool operator () (const Key& lhs, const Key& rhs) const
+		{
+			return lhs == rhs;
+		}
+	};
+	// key of item is item itself. (for set)
+	template <typename Value> struct DKHashTableItemKey
+	{
+		FORCEINLINE const Value& operator () (const Value& v) const
+		{
+			return v;
+		}
+	};
+
+	template <
+		typename Value,									// item-type
+		typename Key,									// key-type
+		typename ItemKey = DKHashTableItemKey<Value>,	// get key from item
+		typename Hasher = DKHashTableHasher<Key>,		// key hash
+		typename KeyEqual = DKHashTableKeyEqual<Key>,	// key comparison
+		typename Allocator = DKMemoryDefaultAllocator	// memory allocator
+	>
+	class DKHashTable
+	{
+		enum : unsigned int
+		{
+			MinimumCapacity = 16,
+			MaxDistance = 0xff,		// distance + 1 is stored, 0 is empty.
+		};
+
+	public:
+		Hasher hasher;
+		KeyEqual equal;
+		ItemKey itemKey;
+
+		DKHashTable(void)
+			: items(NULL), distances(NULL), capacity(0), count(0), shift(0)
+		{
+		}
+		DKHashTable(DKHashTable&& table)
+			: hasher(static_cast<Hasher&&>(table.hasher))
+			, equal(static_cast<KeyEqual&&>(table.equal))
+			, itemKey(static_cast<ItemKey&&>(table.itemKey))
+			, items(table.items), distances(table.distances)
+			, capacity(table.capacity), count(table.count), shift(table.shift)
+		{
+			table.items = NULL;
+			table.distances = NULL;
+			table.capacity = 0;
+			table.count = 0;
+			table.shift = 0;
+		}
+		DKHashTable(const DKHashTable& table)
+			: hasher(table.hasher), equal(table.equal), itemKey(table.itemKey)
+			, items(NULL), distances(NULL), capacity(0), count(0), shift(0)
+		{
+			CopyFrom(table);
+		}
+		~DKHashTable(void)
+		{
+			Clear();
+			if (items)
+				Allocator::Free(items);
+		}
+		// Update: insertion if not exist or overwrite if exists.
+		FORCEINLINE Value* Update(const Value& v)
+		{
+			Value* p = Find(itemKey(v));
+			if (p)
+			{
+				p->~Value();
+				return new(p) Value(v);
+			}
+			return InsertNew(Value(v));
+		}
+		// Insert: insert if not exist or fail if exists.
+		//  returns NULL if function failed. (already exists)
+		FORCEINLINE Value* Insert(const Value& v)
+		{
+			if (Find(itemKey(v)))
+				return NULL;
+			return InsertNew(Value(v));
+		}
+		FORCEINLINE Value* Insert(Value&& v)
+		{
+			if (Find(itemKey(v)))
+				return NULL;
+			return InsertNew(static_cast<Value&&>(v));
+		}
+		FORCEINLINE Value* Find(const Key& k)
+		{
+			return const_cast<Value*>(static_cast<const DKHashTable&>(*this).Find(k));
+		}
+		FORCEINLINE const Value* Find(const Key& k) const
+		{
+			if (count == 0)
+				return NULL;
+			const size_t mask = capacity - 1;
+			size_t pos = HomeIndex(hasher(k));
+			for (unsigned int d = 1; d <= distances[pos]; ++d)
+			{
+				if (distances[pos] == d && equal(itemKey(items[pos]), k))
+					return &items[pos];
+				pos = (pos + 1) & mask;
+			}
+			return NULL;
+		}
+		bool Remove(const Key& k)
+		{
+			Value* p = Find(k);
+			if (p == NULL)
+				return false;
+
+			// shift following items backward.
+			const size_t mask = capacity - 1;
+			size_t pos = p - items;
+			p->~Value();
+			size_t next = (pos + 1) & mask;
+			while (distances[next] > 1)
+			{
+				new(&items[pos]) Value(static_cast<Value&&>(items[next]));
+				items[next].~Value();
+				distances[pos] = distances[next] - 1;
+				pos = next;
+				next = (next + 1) & mask;
+			}
+			distances[pos] = 0;
+			count--;
+			return true;
+		}
+		void Clear(void)
+		{
+			if (count > 0)
+			{
+				for (size_t i = 0; i < capacity; ++i)
+				{
+					if (distances[i])
+					{
+						items[i].~Value();
+						distances[i] = 0;
+					}
+				}
+				count = 0;
+			}
+		}
+		// reserve slots for n items, avoid rehashing while inserting.
+		void Reserve(size_t n)
+		{
+			size_t c = MinimumCapacity;
+			while (c - (c >> 3) < n)
+				c = c << 1;
+			if (c > capacity)
+				Rehash(c);
+		}
+		size_t Count(void) const
+		{
+			return count;
+		}
+		size_t Capacity(void) const
+		{
+			return capacity;
+		}
+		DKHashTable& operator = (DKHashTable&& table)
+		{
+			if (this != &table)
+			{
+				Clear();
+				if (items)
+					Allocator::Free(items);
+
+				hasher = static_cast<Hasher&&>(table.hasher);
+				equal = static_cast<KeyEqual&&>(table.equal);
+				itemKey = static_cast<ItemKey&&>(table.itemKey);
+				items = table.items;
+				distances = table.distances;
+				capacity = table.capacity;
+				count = table.count;
+				shift = table.shift;
+
+				table.items = NULL;
+				table.distances = NULL;
+				table.capacity = 0;
+				table.count = 0;
+				table.shift = 0;
+			}
+			return *this;
+		}
+		DKHashTable& operator = (const DKHashTable& table)
+		{
+			if (this != &table)
+			{
+				Clear();
+				hasher = table.hasher;
+				equal = table.equal;
+				itemKey = table.itemKey;
+				CopyFrom(table);
+			}
+			return *this;
+		}
+		// lambda enumerator (VALUE&, bool*)
+		// items are enumerated in order of slots. (not sorted)
+		template <typename T> void EnumerateForward(T&& enumerator)
+		{
+			static_assert(DKFunctionType<T&&>::Signature::template CanInvokeWithParameterTypes<Value&, bool*>(),
+						  "enumerator's parameter is not compatible with (VALUE&, bool*)");
+
+			bool stop = false;
+			for (size_t i = 0; i < capacity && !stop; ++i)
+			{
+				if (distances[i])
+					enumerator(items[i], &stop);
+			}
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator)
+		{
+			static_assert(DKFunctionType<T&&>::Signature::template CanInvokeWithParameterTypes<Value&, bool*>(),
+						  "enumerator's parameter is not compatible with (VALUE&, bool*)");
+
+			bool stop = false;
+			for (size_t i = capacity; i > 0 && !stop; --i)
+			{
+				if (distances[i-1])
+					enumerator(items[i-1], &stop);
+			}
+		}
+		// lambda enumerator (const VALUE&, bool*)
+		template <typename T> void EnumerateForward(T&& enumerator) const
+		{
+			static_assert(DKFunctionType<T&&>::Signature::template CanInvokeWithParameterTypes<const Value&, bool*>(),
+						  "enumerator's parameter is not compatible with (const VALUE&, bool*)");
+
+			bool stop = false;
+			for (size_t i = 0; i < capacity && !stop; ++i)
+			{
+				if (distances[i])
+					enumerator(static_cast<const Value&>(items[i]), &stop);
+			}
+		}
+		template <typename T> void EnumerateBackward(T&& enumerator) const
+		{
+			static_assert(DKFunctionType<T&&>::Signature::template CanInvokeWithParameterTypes<const Value&, bool*>(),
+						  "enumerator's parameter is not compatible with (const VALUE&, bool*)");
+
+			bool stop = false;
+			for (size_t i = capacity; i > 0 && !stop; --i)
+			{
+				if (distances[i-1])
+					enumerator(static_cast<const Value&>(items[i-1]), &stop);
+			}
+		}
+
+	private:
+		// fibonacci hashing, use high bits of product.
+		FORCEINLINE size_t HomeIndex(size_t hash) const
+		{
+			if (sizeof(size_t) > 4)
+				return (size_t)((unsigned long long)hash * 11400714819323198485ULL >> shift);
+			return (size_t)((unsigned int)hash * 2654435769U >> shift);
+		}
+		// insert item which is not exists in table.
+		Value* InsertNew(Value&& v)
+		{
+			if ((count + 1) > capacity - (capacity >> 3))	// load factor 7/8
+				Rehash(Max(capacity << 1, (size_t)MinimumCapacity));
+
+			while (true)
+			{
+				Value* p = Place(static_cast<Value&&>(v));
+				if (p)
+					return p;
+				// probe distance too long, grow table.
+				DKASSERT_DEBUG(count > (capacity >> 4));	// hash function is too bad.
+				Rehash(capacity << 1);
+			}
+		}
+		// place item with Robin Hood rule, returns NULL if distance of
+		// item exceeds MaxDistance. (v is not moved in that case)
+		Value* Place(Value&& v)
+		{
+			const size_t mask = capacity - 1;
+			size_t pos = HomeIndex(hasher(itemKey(v)));
+			unsigned int d = 1;
+			while (distances[pos] >= d)
+			{
+				if (++d >= MaxDistance)
+					return NULL;
+				pos = (pos + 1) & mask;
+			}
+			Value* result = &items[pos];
+			if (distances[pos] == 0)
+			{
+				new(result) Value(static_cast<Value&&>(v));
+				distances[pos] = (unsigned char)d;
+				count++;
+				return result;
+			}
+
+			// take slot, and shift displaced items to next empty slot.
+			size_t last = pos;
+			while (distances[last] != 0)
+			{
+				if (static_cast<unsigned int>(distances[last]) + 1 >= MaxDistance)
+					return NULL;
+				last = (last + 1) & mask;
+			}
+			for (size_t i = last; i != pos; )
+			{
+				size_t prev = (i - 1) & mask;
+				new(&items[i]) Value(static_cast<Value&&>(items[prev]));
+				items[prev].~Value();
+				distances[i] = distances[prev] + 1;
+				i = prev;
+			}
+			distances[pos] = (unsigned char)d;
+			new(result) Value(static_cast<Value&&>(v));
+			count++;
+			return result;
+		}
+		void Rehash(size_t newCapacity)
+		{
+			DKASSERT_DEBUG((newCapacity & (newCapacity - 1)) == 0);
+
+			Value* oldItems = items;
+			unsigned char* oldDistances = distances;
+			size_t oldCapacity = capacity;
+
+			// items, distances are allocated with single block.
+			items = (Value*)Allocator::Alloc(newCapacity * (sizeof(Value) + 1));
+			distances = reinterpret_cast<unsigned char*>(&items[newCapacity]);
+			memset(distances, 0, newCapacity);
+			capacity = newCapacity;
+			count = 0;
+			shift = sizeof(size_t) * 8;
+			for (size_t c = newCapacity; c > 1; c = c >> 1)
+				shift--;
+
+			for (size_t i = 0; i < oldCapacity; ++i)
+			{
+				if (oldDistances[i])
+				{
+					if (Place(static_cast<Value&&>(oldItems[i])) == NULL)
+					{
+						// should not happen with doubled capacity, but
+						// keep item with growing table again.
+						Value tmp(static_cast<Value&&>(oldItems[i]));
+						oldItems[i].~Value();
+						for (size_t k = i + 1; k < oldCapacity; ++k)
+						{
+							if (oldDistances[k])
+							{
+								Value t(static_cast<Value&&>(oldItems[k]));
+								oldItems[k].~Value();
+								InsertNew(static_cast<Value&&>(t));
+							}
+						}
+						Allocator::Free(oldItems);
+						InsertNew(static_cast<Value&&>(tmp));
+						return;
+					}
+					oldItems[i].~Value();
+				}
+			}
+			if (oldItems)
+				Allocator::Free(oldItems);
+		}
+		void CopyFrom(const DKHashTable& table)
+		{
+			if (table.count > 0)
+			{
+				Reserve(table.count);
+				for (size_t i = 0; i < table.capacity; ++i)
+				{
+					if (table.distances[i])
+						InsertNew(Value(table.items[i]));
+				}
+			}
+		}
+
+		Value* items;
+		unsigned char* distances;
+		size_t capacity;
+		size_t count;
+		unsigned int shift;
+	};
+}
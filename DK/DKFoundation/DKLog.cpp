@@ -16,10 +16,18 @@
 #include <stdlib.h>
 #include <wchar.h>
 #include <errno.h>
+#include <string.h>
+#include <stdarg.h>
 
 #include "DKLog.h"
 #include "DKString.h"
 #include "DKSpinLock.h"
+#include "DKMutex.h"
+#include "DKCondition.h"
+#include "DKThread.h"
+#include "DKFunction.h"
+#include "DKAtomicNumber32.h"
+#include "DKAtomicNumber64.h"
 
 namespace DKFoundation
 {
@@ -27,6 +35,305 @@ namespace DKFoundation
 	{
 		static DKSpinLock spinLock;
 		static DKObject<DKLogger> defaultLogger = NULL;
+		static DKMutex dispatchLock;		// serialize logger calls
+		static DKAtomicNumber32 logLevel = DKLogLevelVerbose;
+
+		static void DispatchLog(DKLogLevel level, const DKString& str)
+		{
+			// logger is called without spinLock, DKLoggerSet is not blocked by logger.
+			spinLock.Lock();
+			DKObject<DKLogger> logger = defaultLogger;
+			spinLock.Unlock();
+
+			if (logger)
+			{
+				DKCriticalSection<DKMutex> guard(dispatchLock);
+				logger->Log(level, str);
+			}
+			else
+			{
+				fprintf(stderr, "%ls", (const wchar_t*)str);
+			}
+		}
+
+		// Asynchronous logger, bounded MPSC queue of fixed-size records.
+		// producer claims record with CAS on enqueue position, and publishes
+		// record by setting sequence of record. (position + 1)
+		// consumer thread dispatches published records in order.
+		class AsyncLogger
+		{
+		public:
+			enum {TextLength = 240};
+			struct Record
+			{
+				DKAtomicNumber64 sequence;
+				DKLogLevel level;
+				size_t length;
+				DKString* longText;		// message does not fit in text.
+				char text[TextLength];
+			};
+
+			AsyncLogger(size_t size)
+				: records(NULL)
+				, mask(0)
+				, dequeuePos(0)
+				, consumerId(DKThread::invalidId)
+				, terminate(false)
+			{
+				size_t count = 16;
+				while (count < size)
+					count = count << 1;
+				records = new Record[count];
+				mask = count - 1;
+				for (size_t i = 0; i < count; ++i)
+					records[i].sequence = (DKAtomicNumber64::Value)i;
+				enqueuePos = 0;
+				consumerWaiting = 0;
+				dropped = 0;
+			}
+			~AsyncLogger(void)
+			{
+				DKASSERT_DEBUG(thread == NULL);
+				delete[] records;
+			}
+			size_t Capacity(void) const
+			{
+				return mask + 1;
+			}
+			void Start(void)
+			{
+				terminate = false;
+				thread = DKThread::Create(DKFunction(this, &AsyncLogger::ConsumerProc)->Invocation());
+			}
+			void Stop(void)
+			{
+				if (thread)
+				{
+					cond.Lock();
+					terminate = true;
+					cond.Signal();
+					cond.Unlock();
+					thread->WaitTerminate();
+					thread = NULL;
+				}
+				// records published after consumer terminated.
+				Drain();
+			}
+			// returns claimed record, or NULL if buffer is full.
+			Record* Claim(void)
+			{
+				DKAtomicNumber64::Value pos = enqueuePos;
+				while (true)
+				{
+					Record* rec = &records[pos & mask];
+					DKAtomicNumber64::Value diff = (DKAtomicNumber64::Value)rec->sequence - pos;
+					if (diff == 0)
+					{
+						if (enqueuePos.CompareAndSet(pos, pos + 1))
+							return rec;
+						pos = enqueuePos;
+					}
+					else if (diff < 0)
+					{
+						dropped.Increment();
+						return NULL;
+					}
+					else
+					{
+						pos = enqueuePos;
+					}
+				}
+			}
+			void Publish(Record* rec)
+			{
+				rec->sequence.Increment();
+				if (consumerWaiting)
+				{
+					DKCriticalSection<DKCondition> guard(cond);
+					cond.Signal();
+				}
+			}
+			// wait until records claimed before are dispatched.
+			void Flush(void)
+			{
+				if (DKThread::CurrentThreadId() == consumerId)
+					return;
+
+				DKAtomicNumber64::Value pos = enqueuePos;
+				DKCriticalSection<DKCondition> guard(flushCond);
+				while ((DKAtomicNumber64::Value)dequeuePos < pos && thread)
+				{
+					cond.Lock();
+					cond.Signal();
+					cond.Unlock();
+					flushCond.Wait();
+				}
+			}
+
+		private:
+			size_t Drain(void)
+			{
+				size_t count = 0;
+				while (true)
+				{
+					DKAtomicNumber64::Value pos = dequeuePos;
+					Record* rec = &records[pos & mask];
+					if ((DKAtomicNumber64::Value)rec->sequence != pos + 1)
+						break;
+
+					DKLogLevel level = rec->level;
+					DKString* longText = rec->longText;
+					if (longText)
+					{
+						rec->sequence = pos + (DKAtomicNumber64::Value)mask + 1;
+						dequeuePos = pos + 1;
+						DispatchLog(level, *longText);
+						delete longText;
+					}
+					else
+					{
+						DKString str((const DKUniChar8*)rec->text, rec->length);
+						rec->sequence = pos + (DKAtomicNumber64::Value)mask + 1;
+						dequeuePos = pos + 1;
+						DispatchLog(level, str);
+					}
+					count++;
+				}
+				DKAtomicNumber64::Value numDropped = dropped.Exchange(0);
+				if (numDropped > 0)
+					DispatchLog(DKLogLevelWarning, DKString::Format("DKLog: %lld messages dropped.\n", (long long)numDropped));
+
+				if (count > 0)
+				{
+					DKCriticalSection<DKCondition> guard(flushCond);
+					flushCond.Broadcast();
+				}
+				return count;
+			}
+			bool HasPublishedRecord(void) const
+			{
+				DKAtomicNumber64::Value pos = dequeuePos;
+				return (DKAtomicNumber64::Value)records[pos & mask].sequence == pos + 1;
+			}
+			void ConsumerProc(void)
+			{
+				consumerId = DKThread::CurrentThreadId();
+				while (true)
+				{
+					if (Drain() > 0)
+						continue;
+
+					DKCriticalSection<DKCondition> guard(cond);
+					if (terminate)
+						break;
+					consumerWaiting = 1;
+					if (!HasPublishedRecord())
+						cond.Wait();
+					consumerWaiting = 0;
+				}
+				consumerId = DKThread::invalidId;
+
+				DKCriticalSection<DKCondition> guard(flushCond);
+				flushCond.Broadcast();
+			}
+
+			Record* records;
+			size_t mask;
+			DKAtomicNumber64 enqueuePos;
+			DKAtomicNumber64 dequeuePos;
+			DKAtomicNumber64 dropped;
+			DKAtomicNumber32 consumerWaiting;
+			DKCondition cond;
+			DKCondition flushCond;
+			DKObject<DKThread> thread;
+			DKThread::ThreadId consumerId;
+			bool terminate;
+		};
+
+		// async logger is not deleted until disabled, and it is deleted after
+		// all producers leave. (asyncProducers is zero)
+		static AsyncLogger* asyncLogger = NULL;
+		static DKAtomicNumber32 asyncEnabled = 0;
+		static DKAtomicNumber32 asyncProducers = 0;
+		static DKMutex asyncLock;
+
+		static bool IsWideCharFormat(const char* fmt)
+		{
+			// %ls, %lc, %S, %C are converted to utf-8 by DKString.
+			for (const char* p = fmt; *p; ++p)
+			{
+				if (*p != '%')
+					continue;
+				++p;
+				while (*p && strchr("-+ #0123456789.*hljztL", *p))
+				{
+					if (*p == 'l' && (p[1] == 's' || p[1] == 'c'))
+						return true;
+					++p;
+				}
+				if (*p == 'S' || *p == 'C')
+					return true;
+				if (*p == '\0')
+					break;
+			}
+			return false;
+		}
+
+		// returns true if message is posted to async logger (or dropped)
+		static bool AsyncLogV(DKLogLevel level, const char* fmt, va_list ap)
+		{
+			bool posted = false;
+			asyncProducers.Increment();
+			if (asyncEnabled)
+			{
+				AsyncLogger::Record* rec = asyncLogger->Claim();
+				if (rec)
+				{
+					rec->level = level;
+					rec->longText = NULL;
+					rec->length = 0;
+
+					bool formatted = false;
+					if (!IsWideCharFormat(fmt))
+					{
+						va_list ap2;
+						va_copy(ap2, ap);
+						int n = vsnprintf(rec->text, AsyncLogger::TextLength, fmt, ap2);
+						va_end(ap2);
+						if (n >= 0 && n < AsyncLogger::TextLength)
+						{
+							rec->length = n;
+							formatted = true;
+						}
+					}
+					if (!formatted)
+						rec->longText = new DKString(DKString::FormatV(fmt, ap));
+					asyncLogger->Publish(rec);
+				}
+				posted = true;
+			}
+			asyncProducers.Decrement();
+			return posted;
+		}
+		static bool AsyncLog(DKLogLevel level, const DKString& str)
+		{
+			bool posted = false;
+			asyncProducers.Increment();
+			if (asyncEnabled)
+			{
+				AsyncLogger::Record* rec = asyncLogger->Claim();
+				if (rec)
+				{
+					rec->level = level;
+					rec->length = 0;
+					rec->longText = new DKString(str);
+					asyncLogger->Publish(rec);
+				}
+				posted = true;
+			}
+			asyncProducers.Decrement();
+			return posted;
+		}
 	}
 
 	DKGL_API void DKLoggerSet(DKLogger* logger)
@@ -66,25 +373,81 @@ namespace DKFoundation
 		else
 			DKLoggerSet(NULL);
 	}
-	DKGL_API void DKLog(const DKFoundation::DKString& str)
+	DKGL_API void DKLogSetLevel(DKLogLevel level)
 	{
-		Private::spinLock.Lock();
-		if (Private::defaultLogger)
+		Private::logLevel = level;
+	}
+	DKGL_API DKLogLevel DKLogCurrentLevel(void)
+	{
+		return (DKLogLevel)(DKAtomicNumber32::Value)Private::logLevel;
+	}
+	DKGL_API void DKLogSetAsync(bool async, size_t bufferSize)
+	{
+		DKCriticalSection<DKMutex> guard(Private::asyncLock);
+		if (Private::asyncEnabled)
 		{
-			Private::defaultLogger->Log(str);
-			Private::spinLock.Unlock();
-			return;
+			if (async && Private::asyncLogger->Capacity() >= bufferSize)
+				return;
+
+			// wait for producers, and dispatch all records.
+			Private::asyncEnabled = 0;
+			while (Private::asyncProducers != 0)
+				DKThread::Yield();
+			Private::asyncLogger->Stop();
+			delete Private::asyncLogger;
+			Private::asyncLogger = NULL;
 		}
-		Private::spinLock.Unlock();
-		fprintf(stderr, "%ls", (const wchar_t*)str);
+		if (async)
+		{
+			Private::asyncLogger = new Private::AsyncLogger(Max(bufferSize, (size_t)1));
+			Private::asyncLogger->Start();
+			Private::asyncEnabled = 1;
+		}
+	}
+	DKGL_API bool DKLogIsAsync(void)
+	{
+		return Private::asyncEnabled != 0;
+	}
+	DKGL_API void DKLogFlush(void)
+	{
+		Private::asyncProducers.Increment();
+		if (Private::asyncEnabled)
+			Private::asyncLogger->Flush();
+		Private::asyncProducers.Decrement();
+	}
+	DKGL_API void DKLog(const DKFoundation::DKString& str)
+	{
+		DKLog(DKLogLevelInfo, str);
 	}
 	DKGL_API void DKLog(const char* fmt, ...)
 	{
 		if (fmt == NULL || fmt[0] == '\0')
 			return;
+		if (DKLogLevelInfo < Private::logLevel)
+			return;
+		va_list ap;
+		va_start(ap, fmt);
+		if (!Private::AsyncLogV(DKLogLevelInfo, fmt, ap))
+			Private::DispatchLog(DKLogLevelInfo, DKString::FormatV(fmt, ap));
+		va_end(ap);
+	}
+	DKGL_API void DKLog(DKLogLevel level, const DKFoundation::DKString& str)
+	{
+		if (level < Private::logLevel)
+			return;
+		if (!Private::AsyncLog(level, str))
+			Private::DispatchLog(level, str);
+	}
+	DKGL_API void DKLog(DKLogLevel level, const char* fmt, ...)
+	{
+		if (fmt == NULL || fmt[0] == '\0')
+			return;
+		if (level < Private::logLevel)
+			return;
 		va_list ap;
 		va_start(ap, fmt);
-		DKLog(DKString::FormatV(fmt, ap));
+		if (!Private::AsyncLogV(level, fmt, ap))
+			Private::DispatchLog(level, DKString::FormatV(fmt, ap));
 		va_end(ap);
 	}
 }
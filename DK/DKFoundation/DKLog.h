@@ -15,14 +15,38 @@ typedef void(*DKLogCallbackProc)(const DKFoundation::DKString &);
 // DKLogger
 // a logger class.
 // you can sublcass DKLogger to handle log text.
+//
+// Log level:
+//   messages below current level (DKLogSetLevel) are discarded before
+//   formatting. DKLog without level is DKLogLevelInfo.
+//
+// Asynchronous mode: (DKLogSetAsync)
+//   logging thread formats message into fixed-size record of ring buffer,
+//   (lock-free, multiple producers) and background thread dispatches
+//   records to logger in order. logging thread is not blocked by logger.
+//   message is dropped if ring buffer is full, number of dropped messages
+//   are reported by background thread. (memory usage is bounded)
+//   call DKLogFlush() to wait until messages logged before are dispatched.
+//   message which does not fit in record, or has wide-char string argument
+//   is formatted with DKString. (allocates heap memory)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
 {
+	enum DKLogLevel
+	{
+		DKLogLevelVerbose = 0,
+		DKLogLevelDebug,
+		DKLogLevelInfo,
+		DKLogLevelWarning,
+		DKLogLevelError,
+	};
+
 	struct DKLogger
 	{
 		virtual ~DKLogger(void) {}
 		virtual void Log(const DKString&) = 0;
+		virtual void Log(DKLogLevel, const DKString& str)	{ Log(str); }
 	};
 
 	DKGL_API void DKLoggerSet(DKLogger*);
@@ -33,12 +57,23 @@ namespace DKFoundation
 
 	DKGL_API void DKLogInit(DKLogCallbackProc proc);	// deprecated
 
+	DKGL_API void DKLogSetLevel(DKLogLevel level);
+	DKGL_API DKLogLevel DKLogCurrentLevel(void);
+
+	// enable or disable asynchronous mode, bufferSize is number of records.
+	// disabling waits until all messages are dispatched.
+	DKGL_API void DKLogSetAsync(bool async, size_t bufferSize = 4096);
+	DKGL_API bool DKLogIsAsync(void);
+	DKGL_API void DKLogFlush(void);
+
 	DKGL_API void DKLog(const DKFoundation::DKString& str);
 	DKGL_API void DKLog(const char* fmt, ...);
+	DKGL_API void DKLog(DKLogLevel level, const DKFoundation::DKString& str);
+	DKGL_API void DKLog(DKLogLevel level, const char* fmt, ...);
 }
 
 #ifdef DKGL_DEBUG_ENABLED
-#define DKLOG_DEBUG(...)	DKFoundation::DKLog(__VA_ARGS__)
+#define DKLOG_DEBUG(...)	DKFoundation::DKLog(DKFoundation::DKLogLevelDebug, __VA_ARGS__)
 #else
 #define DKLOG_DEBUG(...)	(void)0
 #endif
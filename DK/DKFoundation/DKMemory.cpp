@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #endif
 
 #include "DKMap.h"
@@ -40,6 +41,11 @@
 
 #define DKLog(...)	fprintf(stderr, __VA_ARGS__)
 
+// Enable per-thread cache of memory-pool units.
+#ifndef DKGL_MEMORY_POOL_THREAD_CACHE
+#define DKGL_MEMORY_POOL_THREAD_CACHE 1
+#endif
+
 namespace DKFoundation
 {
 	namespace Private
@@ -88,182 +94,164 @@ namespace DKFoundation
 		using SystemLargeHeapAllocator = DKMemoryVirtualAllocator;
 
 		// BackendAllocator : allocates all front-end allocators chunks.
+		//   Each chunk is aligned to UnitSize, so that the chunk can be found
+		//   by the page number of address. (see PageMap)
 		struct BackendAllocator
 		{
 			enum { UnitSize = (1 << 16) };
-			enum { IndexTableAlignment = 64 };
-			static_assert((IndexTableAlignment & (IndexTableAlignment-1)) == 0, "Alignment should be power of two.");
-			using Allocator = DKFixedSizeAllocator<UnitSize, 1, 64, DKDummyLock, SystemHeapAllocator, SystemLargeHeapAllocator>;
+			enum { UnitSizeBits = 16 };
+			static_assert(UnitSize == (1 << UnitSizeBits), "UnitSizeBits mismatch");
+			using Allocator = DKFixedSizeAllocator<UnitSize, UnitSize, 64, DKDummyLock, SystemHeapAllocator, SystemLargeHeapAllocator>;
 
 			static BackendAllocator* Instance();	// init by main allocator. (AllocatorPool)
 
 			using Index = short;
 			enum { IndexNotFound = (Index)-1 };
 
-#pragma pack(push, 2)
-			struct IndexedAddress
+			// PageMap : 3-level radix tree of page number (address / UnitSize).
+			//   Each leaf entry contains (Index + 1), zero for unused page.
+			//   Nodes are never removed until PageMap destroyed, so that
+			//   lookups can be done without lock. (modified with lock only)
+			struct PageMap
 			{
-				uintptr_t address;
-				Index index;
-			};
-#pragma pack(pop)
+				enum { AddressBits = (sizeof(void*) > 4) ? 48 : 32 };
+				enum { KeyBits = AddressBits - UnitSizeBits };
+				enum { LeafBits = KeyBits / 3 };
+				enum { MidBits = KeyBits / 3 };
+				enum { RootBits = KeyBits - MidBits - LeafBits };
 
-			void* AllocWithIndex(Index index)
-			{
-				ScopedLock guard(lock);
-				void* p = allocator.Alloc(UnitSize);
-				if (p)
+				struct Leaf { volatile Index entries[1 << LeafBits]; };
+				struct Mid { Leaf* volatile leaves[1 << MidBits]; };
+
+				Mid* volatile root[1 << RootBits];
+				size_t nodeBytes;
+
+				PageMap(void) : nodeBytes(0)
+				{
+					memset((void*)root, 0, sizeof(root));
+				}
+				~PageMap(void)
 				{
-					if (indexAddrsCapacity < numIndexAddrs + 1)
+					for (Mid* mid : root)
 					{
-						size_t caps = (indexAddrsCapacity + IndexTableAlignment) & ~(IndexTableAlignment - 1);
-						DKASSERT_MEM_DEBUG(caps >= (numIndexAddrs + 1));
-						IndexedAddress* tmp = (IndexedAddress*)SystemHeapAllocator::Realloc(indexAddrs, sizeof(IndexedAddress) * caps);
-						if (tmp)
+						if (mid)
 						{
-							indexAddrs = tmp;
-							indexAddrsCapacity = caps;
+							for (Leaf* leaf : mid->leaves)
+							{
+								if (leaf)
+									SystemHeapAllocator::Free(leaf);
+							}
+							SystemHeapAllocator::Free(mid);
 						}
-						else // out of memory!?
+					}
+				}
+				static bool IsValidAddress(uintptr_t addr)
+				{
+					return (static_cast<uint64_t>(addr) >> AddressBits) == 0;
+				}
+				FORCEINLINE Index Get(uintptr_t addr) const
+				{
+					if (IsValidAddress(addr))
+					{
+						uintptr_t key = addr >> UnitSizeBits;
+						const Mid* mid = root[key >> (MidBits + LeafBits)];
+						if (mid)
 						{
-							allocator.Dealloc(p);
-							return NULL;
+							const Leaf* leaf = mid->leaves[(key >> LeafBits) & ((1 << MidBits) - 1)];
+							if (leaf)
+								return leaf->entries[key & ((1 << LeafBits) - 1)] - 1;
 						}
 					}
+					return IndexNotFound;
+				}
+				bool Set(uintptr_t addr, Index index) // entry nodes will be created.
+				{
+					DKASSERT_MEM_DEBUG(IsValidAddress(addr));
+					DKASSERT_MEM_DEBUG((addr % UnitSize) == 0);
 
+					uintptr_t key = addr >> UnitSizeBits;
+					Mid* volatile& mid = root[key >> (MidBits + LeafBits)];
+					if (mid == NULL)
+					{
+						Mid* node = (Mid*)SystemHeapAllocator::Alloc(sizeof(Mid));
+						if (node == NULL)
+							return false;
+						memset((void*)node, 0, sizeof(Mid));
+						mid = node;
+						nodeBytes += sizeof(Mid);
+					}
+					Leaf* volatile& leaf = mid->leaves[(key >> LeafBits) & ((1 << MidBits) - 1)];
+					if (leaf == NULL)
+					{
+						Leaf* node = (Leaf*)SystemHeapAllocator::Alloc(sizeof(Leaf));
+						if (node == NULL)
+							return false;
+						memset((void*)node, 0, sizeof(Leaf));
+						leaf = node;
+						nodeBytes += sizeof(Leaf);
+					}
+					leaf->entries[key & ((1 << LeafBits) - 1)] = index + 1;
+					return true;
+				}
+				size_t Size(void) const
+				{
+					return sizeof(PageMap) + nodeBytes;
+				}
+			};
+
+			void* AllocWithIndex(Index index)
+			{
+				ScopedLock guard(lock);
+				void* p = allocator.Alloc(UnitSize);
+				if (p)
+				{
 					uintptr_t baseAddr = reinterpret_cast<uintptr_t>(p);
-					size_t addrIndex = 0;
-					if (numIndexAddrs > 0)
+					if (!PageMap::IsValidAddress(baseAddr) || !pageMap.Set(baseAddr, index))
 					{
-						addrIndex = FindAddress(baseAddr) + 1;
-						if (addrIndex < numIndexAddrs)
-						{
-#if 1
-							memmove(&indexAddrs[addrIndex + 1], &indexAddrs[addrIndex], sizeof(IndexedAddress) * (numIndexAddrs - addrIndex));
-#else
-							for (size_t i = numIndexAddrs; i > addrIndex; --i)
-								indexAddrs[i] = indexAddrs[i - 1];
-#endif
-						}
+						// out of memory or address is not supported.
+						allocator.Dealloc(p);
+						return NULL;
 					}
-					indexAddrs[addrIndex].index = index;
-					indexAddrs[addrIndex].address = baseAddr;
-					numIndexAddrs++;
 				}
 				return p;
 			}
 			Index Dealloc(void* p)
 			{
 				ScopedLock guard(lock);
-				DKASSERT_MEM_DEBUG(numIndexAddrs > 0);
-				size_t addrIndex = FindAddress(reinterpret_cast<uintptr_t>(p));
-				DKASSERT_MEM_DEBUG(addrIndex < numIndexAddrs);
-				Index index = indexAddrs[addrIndex].index;
-				numIndexAddrs--;
-				if (numIndexAddrs > 0)
-				{
-#if 1
-					if (addrIndex < numIndexAddrs)
-						memmove(&indexAddrs[addrIndex], &indexAddrs[addrIndex + 1], sizeof(IndexedAddress) * (numIndexAddrs - addrIndex));
-#else
-					for (size_t i = addrIndex; i < numIndexAddrs; ++i)
-						indexAddrs[i] = indexAddrs[i+1];
-#endif
-				}
+				uintptr_t baseAddr = reinterpret_cast<uintptr_t>(p);
+				Index index = pageMap.Get(baseAddr);
+				DKASSERT_MEM_DEBUG(index != IndexNotFound);
+				pageMap.Set(baseAddr, IndexNotFound);
 				allocator.Dealloc(p);
 				return index;
 			}
-			Index IndexForAddress(void* p)
+			// lock-free, address should be alive or not allocated from backend.
+			FORCEINLINE Index IndexForAddress(void* p) const
 			{
-				uintptr_t addr = reinterpret_cast<uintptr_t>(p);
-				ScopedLock guard(lock);
-				size_t addrIndex = FindAddress(addr);
-				if (addrIndex < numIndexAddrs && addr < indexAddrs[addrIndex].address + UnitSize)
-					return indexAddrs[addrIndex].index;
-				return IndexNotFound;
+				return pageMap.Get(reinterpret_cast<uintptr_t>(p));
 			}
 			size_t PurgeThreshold(size_t threshold)
 			{
 				ScopedLock guard(lock);
-				size_t r = allocator.ConditionalPurge(threshold);
-				if (r > 0 || threshold == 0)
-				{
-					size_t alignedNumIndexAddrs = (numIndexAddrs + IndexTableAlignment - 1) & ~(IndexTableAlignment - 1);
-					if (alignedNumIndexAddrs < indexAddrsCapacity)
-					{
-						if (numIndexAddrs > 0)
-						{
-							size_t caps = alignedNumIndexAddrs;
-							DKASSERT_MEM_DEBUG((caps % IndexTableAlignment) == 0);
-							IndexedAddress* tmp = (IndexedAddress*)SystemHeapAllocator::Realloc(indexAddrs, sizeof(IndexedAddress) * caps);
-							if (tmp)
-							{
-								indexAddrs = tmp;
-								indexAddrsCapacity = caps;
-							}
-							else
-							{
-								// out of memory! nothing changed.
-							}
-						}
-						else
-						{
-							SystemHeapAllocator::Free(indexAddrs);
-							indexAddrs = NULL;
-							indexAddrsCapacity = 0;
-						}
-					}
-				}
-				return r;
+				return allocator.ConditionalPurge(threshold);
 			}
 			size_t Size(void) const
 			{
 				ScopedLock guard(lock);
-				return (sizeof(IndexedAddress) * indexAddrsCapacity) + allocator.Size();
+				return pageMap.Size() + allocator.Size();
 			}
 			BackendAllocator(void)
-				: numIndexAddrs(0)
-				, indexAddrsCapacity(0)
-				, indexAddrs(NULL)
 			{
 			}
 			~BackendAllocator(void)
 			{
-				if (indexAddrsCapacity > 0)
-					SystemHeapAllocator::Free(indexAddrs);
 			}
 		private:
-			FORCEINLINE size_t FindAddress(uintptr_t addr)
-			{
-				// lower-bound search.
-				size_t start = 0;
-				size_t count = numIndexAddrs;
-				size_t med;
-				while (count > 1)
-				{
-					med = count >> 1;
-					if (addr < indexAddrs[start + med].address)
-					{
-						count = med;
-					}
-					else
-					{
-						start += med;
-						count -= med;
-					}
-				}
-				if (count > 0 && addr >= indexAddrs[start].address)
-					return start;
-				return (size_t)-1;
-			}
-
 			using Lock = DKSpinLock;
 			using ScopedLock = DKCriticalSection<Lock>;
 			Lock			lock;
 			Allocator		allocator;
-			IndexedAddress*	indexAddrs;
-			size_t			indexAddrsCapacity;
-			size_t			numIndexAddrs;
+			PageMap			pageMap;
 		};
 
 
@@ -286,6 +274,14 @@ namespace DKFoundation
 			}
 		};
 
+		// thread-cache capacity for each unit sizes. (see AllocatorPool)
+		enum
+		{
+			ThreadCacheBytesPerUnit = (1 << 15),
+			ThreadCacheMinUnits = 4,
+			ThreadCacheMaxUnits = 128,
+		};
+
 		struct AllocatorInterface
 		{
 			virtual ~AllocatorInterface(void) noexcept(!DKGL_MEMORY_DEBUG) {}
@@ -300,12 +296,16 @@ namespace DKFoundation
 			virtual size_t ConditionalPurge(size_t) = 0;
 			virtual bool ConditionalDeallocAndPurge(void*, size_t, size_t*) = 0;
 
+			virtual size_t AllocMultiple(void**, size_t) = 0;
+			virtual size_t ConditionalDeallocMultipleAndPurge(void* const*, size_t, size_t, size_t*) = 0;
+
 			virtual size_t NumberOfAllocatedUnits(void) const = 0;
 		};
 
 		struct AllocatorUnit
 		{
 			size_t unitSize;
+			size_t cacheCapacity;	// max units for thread-cache
 			AllocatorInterface* allocator;
 		};
 
@@ -342,6 +342,12 @@ namespace DKFoundation
 					return allocator.ConditionalDeallocAndPurge(p, s, bp);
 				}
 
+				size_t AllocMultiple(void** p, size_t n) override	{ return allocator.AllocMultiple(p, n); }
+				size_t ConditionalDeallocMultipleAndPurge(void* const* p, size_t n, size_t s, size_t* bp) override
+				{
+					return allocator.ConditionalDeallocMultipleAndPurge(p, n, s, bp);
+				}
+
 				size_t NumberOfAllocatedUnits(void) const override	{ return allocator.NumberOfAllocatedUnits(); }
 
 				using Allocator = DKFixedSizeAllocator<UnitSize, Alignment, NumUnits, DKSpinLock, SystemHeapAllocator, UnitAllocator>;
@@ -355,6 +361,7 @@ namespace DKFoundation
 					  Index, UnitSize, Alignment, NumUnits, Wrapper::Allocator::AlignedChunkSize, MaxChunkSize,
 					  ((double)Wrapper::Allocator::AlignedChunkSize / (double)MaxChunkSize) * 100.0);
 				units[Index].unitSize = UnitSize;
+				units[Index].cacheCapacity = Clamp(ThreadCacheBytesPerUnit / UnitSize, ThreadCacheMinUnits, ThreadCacheMaxUnits);
 				units[Index].allocator = ::new (SystemHeapAllocator::Alloc(sizeof(Wrapper))) Wrapper();
 				return 1 + Initializer<UnitSize + SizeOffset, SizeOffset, Alignment, Index+1, Count-1>::Init(units);
 			}
@@ -365,12 +372,43 @@ namespace DKFoundation
 			static int Init(AllocatorUnit*) { return 0; }
 		};
 
+		// AllocatorPool : front-end allocator of DKMemoryPool functions.
+		//   Each thread has own cache of freed units for each unit size,
+		//   units are allocated from or returned to shared allocators in
+		//   batches, that can reduce lock contention of shared allocators.
 		struct AllocatorPool : public DKAllocator
 		{
 			enum { NumAllocators = 136 };
 
-			AllocatorPool(void) : backend(NULL)
+			// ThreadCache : per-thread free-units list for each allocators.
+			//   freed unit's first pointer-sized bytes used as link.
+			struct ThreadCache
 			{
+				struct Bin
+				{
+					void* head;
+					size_t count;
+				};
+				Bin bins[NumAllocators];
+				volatile size_t hits;
+				volatile size_t misses;
+				volatile size_t purges;
+				ThreadCache* prev;
+				ThreadCache* next;
+			};
+
+			AllocatorPool(void) : backend(NULL), caches(NULL), cacheHits(0), cacheMisses(0), cachePurges(0)
+			{
+#if DKGL_MEMORY_POOL_THREAD_CACHE
+#ifdef _WIN32
+				cacheKey = ::FlsAlloc(ThreadCacheCleanupCallback);
+				cacheEnabled = cacheKey != FLS_OUT_OF_INDEXES;
+#else
+				cacheEnabled = ::pthread_key_create(&cacheKey, ThreadCacheCleanupCallback) == 0;
+#endif
+#else
+				cacheEnabled = false;
+#endif
 #ifdef _WIN32
 				// reserve 16MB heap
 				SystemHeapAllocator::heap = ::HeapCreate(0, (1<<24), 0);
@@ -408,6 +446,24 @@ namespace DKFoundation
 
 			~AllocatorPool(void)
 			{
+				if (cacheEnabled)
+				{
+#ifdef _WIN32
+					::FlsFree(cacheKey);
+#else
+					::pthread_key_delete(cacheKey);
+#endif
+					cacheEnabled = false;
+				}
+				// return all cached units. (including other threads)
+				while (caches)
+				{
+					ThreadCache* cache = caches;
+					caches = cache->next;
+					FlushThreadCache(cache);
+					SystemHeapAllocator::Free(cache);
+				}
+
 				bool cleanupHeap = true;
 				for (int i = 0; i < NumAllocators; ++i)
 				{
@@ -451,7 +507,7 @@ namespace DKFoundation
 				AllocatorUnit* unit = FindAllocatorForSize(s);
 				DKASSERT_MEM_DEBUG(unit != NULL);
 				DKASSERT_MEM_DEBUG(unit->unitSize >= s);
-				return unit->allocator->Alloc(s);
+				return AllocUnit(unit);
 			}
 
 			void* Realloc(void* p, size_t s)
@@ -471,16 +527,13 @@ namespace DKFoundation
 							AllocatorUnit* unit2 = FindAllocatorForSize(s);
 							if (unit2 == unit)
 								return p;
-							p2 = unit2->allocator->Alloc(s);
+							p2 = AllocUnit(unit2);
 						}
 						if (p2)
 						{
 							size_t bytesToCopy = Min(s, unit->unitSize);
 							memcpy(p2, p, bytesToCopy);
-							if (!DeallocAndPurge(unit, p))
-							{
-								DKASSERT_MEM_DEBUG(0);
-							}
+							DeallocUnit(unit, p);
 						}
 						return p2;
 					}
@@ -494,7 +547,7 @@ namespace DKFoundation
 						{
 							unit = FindAllocatorForSize(s);
 							DKASSERT_MEM_DEBUG(unit);
-							void* p2 = unit->allocator->Alloc(s);
+							void* p2 = AllocUnit(unit);
 							if (p2)
 							{
 								memcpy(p2, p, s);
@@ -514,10 +567,7 @@ namespace DKFoundation
 					AllocatorUnit* unit = FindAllocator(p);
 					if (unit)
 					{
-						if (!DeallocAndPurge(unit, p))
-						{
-							DKASSERT_MEM_DEBUG(0);
-						}
+						DeallocUnit(unit, p);
 						return;
 					}
 
@@ -527,6 +577,15 @@ namespace DKFoundation
 
 			size_t Purge(void)
 			{
+				// return units of calling thread's cache.
+				// (other thread's cache can not be accessed)
+				if (cacheEnabled)
+				{
+					ThreadCache* cache = reinterpret_cast<ThreadCache*>(GetThreadCacheValue());
+					if (cache)
+						FlushThreadCache(cache);
+				}
+
 				size_t bytesPurged = 0;
 				for (int i = 0; i < NumAllocators; ++i)
 				{
@@ -554,7 +613,172 @@ namespace DKFoundation
 				return backend;
 			}
 
+			void CacheStatistics(size_t* hits, size_t* misses, size_t* purges)
+			{
+				DKCriticalSection<DKSpinLock> guard(cacheLock);
+				size_t h = cacheHits;
+				size_t m = cacheMisses;
+				size_t p = cachePurges;
+				for (ThreadCache* cache = caches; cache; cache = cache->next)
+				{
+					h += cache->hits;
+					m += cache->misses;
+					p += cache->purges;
+				}
+				if (hits)	*hits = h;
+				if (misses)	*misses = m;
+				if (purges)	*purges = p;
+			}
+
 		private:
+			FORCEINLINE void* AllocUnit(AllocatorUnit* unit)
+			{
+				ThreadCache* cache = GetThreadCache();
+				if (cache)
+				{
+					ThreadCache::Bin& bin = cache->bins[unit - allocators];
+					if (bin.count > 0)
+					{
+						void* p = bin.head;
+						bin.head = *reinterpret_cast<void**>(p);
+						bin.count--;
+						cache->hits++;
+						return p;
+					}
+					cache->misses++;
+
+					// fill half of capacity with batch.
+					void* units[ThreadCacheMaxUnits];
+					size_t num = unit->allocator->AllocMultiple(units, Max(unit->cacheCapacity / 2, (size_t)1));
+					if (num == 0)
+						return NULL;	// out of memory!
+					for (size_t i = 1; i < num; ++i)
+					{
+						*reinterpret_cast<void**>(units[i]) = bin.head;
+						bin.head = units[i];
+					}
+					bin.count = num - 1;
+					return units[0];
+				}
+				return unit->allocator->Alloc(unit->unitSize);
+			}
+			FORCEINLINE void DeallocUnit(AllocatorUnit* unit, void* p)
+			{
+				ThreadCache* cache = GetThreadCache();
+				if (cache)
+				{
+					size_t index = unit - allocators;
+					ThreadCache::Bin& bin = cache->bins[index];
+					*reinterpret_cast<void**>(p) = bin.head;
+					bin.head = p;
+					bin.count++;
+					if (bin.count > unit->cacheCapacity)
+					{
+						// return half of units with batch.
+						FlushBin(index, bin, unit->cacheCapacity / 2);
+						cache->purges++;
+					}
+					return;
+				}
+				if (!DeallocAndPurge(unit, p))
+				{
+					DKASSERT_MEM_DEBUG(0);
+				}
+			}
+			// return cached units to shared allocator, until bin.count becomes 'remains'.
+			void FlushBin(size_t index, ThreadCache::Bin& bin, size_t remains)
+			{
+				AllocatorUnit* unit = &allocators[index];
+				while (bin.count > remains)
+				{
+					void* units[ThreadCacheMaxUnits];
+					size_t num = 0;
+					while (bin.count > remains && num < ThreadCacheMaxUnits)
+					{
+						units[num++] = bin.head;
+						bin.head = *reinterpret_cast<void**>(bin.head);
+						bin.count--;
+					}
+					size_t purged = 0;
+					size_t n = unit->allocator->ConditionalDeallocMultipleAndPurge(units, num, 0, &purged);
+					DKASSERT_MEM_DEBUG(n == num);
+					(void)n;
+					if (purged > 0)
+						backend->PurgeThreshold(16);
+				}
+			}
+			void FlushThreadCache(ThreadCache* cache)
+			{
+				bool flushed = false;
+				for (size_t i = 0; i < NumAllocators; ++i)
+				{
+					ThreadCache::Bin& bin = cache->bins[i];
+					if (bin.count > 0)
+					{
+						FlushBin(i, bin, 0);
+						flushed = true;
+					}
+				}
+				if (flushed)
+					cache->purges++;
+			}
+			FORCEINLINE void* GetThreadCacheValue(void) const
+			{
+#ifdef _WIN32
+				return ::FlsGetValue(cacheKey);
+#else
+				return ::pthread_getspecific(cacheKey);
+#endif
+			}
+			FORCEINLINE ThreadCache* GetThreadCache(void)
+			{
+				if (cacheEnabled)
+				{
+					ThreadCache* cache = reinterpret_cast<ThreadCache*>(GetThreadCacheValue());
+					if (cache == NULL)
+					{
+						cache = (ThreadCache*)SystemHeapAllocator::Alloc(sizeof(ThreadCache));
+						if (cache)
+						{
+							memset(cache, 0, sizeof(ThreadCache));
+#ifdef _WIN32
+							::FlsSetValue(cacheKey, cache);
+#else
+							::pthread_setspecific(cacheKey, cache);
+#endif
+							DKCriticalSection<DKSpinLock> guard(cacheLock);
+							cache->next = caches;
+							if (caches)
+								caches->prev = cache;
+							caches = cache;
+						}
+					}
+					return cache;
+				}
+				return NULL;
+			}
+			void ReleaseThreadCache(ThreadCache* cache)
+			{
+				FlushThreadCache(cache);
+
+				DKCriticalSection<DKSpinLock> guard(cacheLock);
+				cacheHits += cache->hits;
+				cacheMisses += cache->misses;
+				cachePurges += cache->purges;
+				if (cache->prev)
+					cache->prev->next = cache->next;
+				else
+					caches = cache->next;
+				if (cache->next)
+					cache->next->prev = cache->prev;
+				SystemHeapAllocator::Free(cache);
+			}
+#ifdef _WIN32
+			static VOID WINAPI ThreadCacheCleanupCallback(PVOID p);
+#else
+			static void ThreadCacheCleanupCallback(void* p);
+#endif
+
 			FORCEINLINE bool DeallocAndPurge(AllocatorUnit* unit, void* p)
 			{
 				DKASSERT_MEM_DEBUG(unit);
@@ -602,6 +826,19 @@ namespace DKFoundation
 			BackendAllocator* backend;
 			AllocatorUnit allocators[NumAllocators];
 			size_t maxUnitSize;
+
+			// thread-cache
+#ifdef _WIN32
+			DWORD cacheKey;
+#else
+			pthread_key_t cacheKey;
+#endif
+			bool cacheEnabled;
+			DKSpinLock cacheLock;
+			ThreadCache* caches;	// all thread-caches list
+			size_t cacheHits;		// statistics of released thread-caches.
+			size_t cacheMisses;
+			size_t cachePurges;
 		};
 
 		AllocatorPool* GetAllocatorPool(void)
@@ -629,6 +866,17 @@ namespace DKFoundation
 			return GetAllocatorPool()->Backend();
 		}
 
+#ifdef _WIN32
+		VOID WINAPI AllocatorPool::ThreadCacheCleanupCallback(PVOID p)
+#else
+		void AllocatorPool::ThreadCacheCleanupCallback(void* p)
+#endif
+		{
+			// called when thread exit.
+			if (p)
+				GetAllocatorPool()->ReleaseThreadCache(reinterpret_cast<ThreadCache*>(p));
+		}
+
 		// VMSizeInfo : keep track VM-address, size pair.
 		struct VMSizeInfo
 		{
@@ -1268,4 +1516,25 @@ namespace DKFoundation
 	{
 		return GetAllocatorPool()->Size();
 	}
+
+	DKGL_API size_t DKMemoryPoolCacheHits(void)
+	{
+		size_t hits = 0;
+		GetAllocatorPool()->CacheStatistics(&hits, NULL, NULL);
+		return hits;
+	}
+
+	DKGL_API size_t DKMemoryPoolCacheMisses(void)
+	{
+		size_t misses = 0;
+		GetAllocatorPool()->CacheStatistics(NULL, &misses, NULL);
+		return misses;
+	}
+
+	DKGL_API size_t DKMemoryPoolCachePurges(void)
+	{
+		size_t purges = 0;
+		GetAllocatorPool()->CacheStatistics(NULL, NULL, &purges);
+		return purges;
+	}
 }
@@ -14,6 +14,9 @@
 //
 // DKMemoryHeap-Alloc/Realloc/Free functions are same as malloc, realloc, free currently.
 //
+// DKMemoryPool-Alloc/Realloc/Free functions are using pre-allocated pool,
+// each thread keeps small cache of freed units to reduce lock contention.
+//
 // DKMemoryVirtual-Alloc/Realloc/Free functions are using Virtual Memory.
 // they should be aligned with DKMemoryVMPageSize value.
 //
@@ -49,6 +52,11 @@ namespace DKFoundation
 	// Optional pool management functions.
 	DKGL_API size_t DKMemoryPoolPurge(void);
 	DKGL_API size_t DKMemoryPoolSize(void);
+	// Pool thread-cache statistics. (number of cache hits, misses and
+	// purges which returns cached units to shared pool)
+	DKGL_API size_t DKMemoryPoolCacheHits(void);
+	DKGL_API size_t DKMemoryPoolCacheMisses(void);
+	DKGL_API size_t DKMemoryPoolCachePurges(void);
 
 
 	enum DKMemoryLocation
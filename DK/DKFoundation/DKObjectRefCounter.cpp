@@ -7,10 +7,10 @@
 
 #include "DKObjectRefCounter.h"
 #include "DKSpinLock.h"
-#include "DKMap.h"
-#include "DKArray.h"
+#include "DKCriticalSection.h"
+#include "DKAtomicNumber32.h"
+#include "DKAtomicNumber64.h"
 #include "DKMemory.h"
-#include "DKFixedSizeAllocator.h"
 
 
 namespace DKFoundation
@@ -19,61 +19,243 @@ namespace DKFoundation
 	{
 		static DKAllocator::StaticInitializer init;
 
-		enum {AllocatorTableLength = 977}; // should be prime-number.
-		struct AllocationNode
+		////////////////////////////////////////////////////////////////////////
+		// AllocationTable
+		// lock-free open-addressing hash table, (address, ref-counter state).
+		//
+		// Table consists of levels, each level is an array of slots twice as
+		// large as previous one. Slots never move once they are allocated,
+		// so that ref-count operations can be done with single CAS on slot's
+		// state value without any lock. A new level is allocated when all
+		// levels have live slots more than half. (growLock used only at that
+		// time) Released slots become tombstones and reused by insertion.
+		// Insertion takes first free slot within MaxProbeLength, lookup stops
+		// at empty slot or at longest probe length of level, lookup is bounded
+		// even if level is full of tombstones.
+		//
+		// Slot::key
+		//   SlotKeyEmpty (never used), SlotKeyDeleted (tombstone) or address.
+		// Slot::state
+		//   [generation:23][alive:1][ref-count:40]
+		//   generation is increased whenever slot being reused, to prevent ABA
+		//   problem. (pointer can be freed and reallocated with same address)
+		////////////////////////////////////////////////////////////////////////
+		namespace
 		{
-			struct NodeInfo
+			using RefCountValue = DKObjectRefCounter::RefCountValue;
+			using RefIdValue = DKObjectRefCounter::RefIdValue;
+			using StateValue = uint64_t;
+
+			enum : uintptr_t
 			{
-				DKAllocator*								allocator;
-				DKObjectRefCounter::RefIdValue				refId;
-				volatile DKObjectRefCounter::RefCountValue	refCount;
+				SlotKeyEmpty = 0,
+				SlotKeyDeleted = 1,
+			};
+			enum : StateValue
+			{
+				StateCountBits = 40,
+				StateCountMask = (StateValue(1) << StateCountBits) - 1,
+				StateAliveFlag = StateValue(1) << StateCountBits,
+				StateGenerationShift = StateCountBits + 1,
+			};
+			enum
+			{
+				InitialLevelCapacity = 1024,	// should be power of two.
+				MaxLevels = 24,
+				MaxProbeLength = 32,
 			};
-			typedef DKSpinLock							Lock;
-			typedef DKCriticalSection<Lock>				CriticalSection;
-
-			using Key = void*;
 
-			// use fixed-size allocator.
-			struct Allocator
+			struct Slot
 			{
-				enum { NodeSize = DKMap<Key, NodeInfo>::NodeSize() };
-				enum { Alignment = sizeof(void*) };
-				using FixedAllocator = DKFixedSizeAllocator<NodeSize, Alignment, 1024, Lock>;
+				DKAtomicNumber64 key;
+				DKAtomicNumber64 state;
+				DKAllocator* volatile allocator;
+				volatile RefIdValue refId;
+
+				Slot(void) : key(SlotKeyEmpty), state(0), allocator(NULL), refId(0) {}
 
-				static void* Alloc(size_t s)
+				StateValue State(void) const			{ return static_cast<StateValue>((DKAtomicNumber64::Value)state); }
+				uintptr_t Key(void) const				{ return static_cast<uintptr_t>((DKAtomicNumber64::Value)key); }
+				bool CompareAndSetState(StateValue c, StateValue v)
 				{
-					DKASSERT_STD_DEBUG(s <= NodeSize);
-					return FixedAllocator::AllocatorInstance().Alloc(s);
+					return state.CompareAndSet(static_cast<DKAtomicNumber64::Value>(c), static_cast<DKAtomicNumber64::Value>(v));
 				}
-				static void Free(void* p)
+				bool CompareAndSetKey(uintptr_t c, uintptr_t v)
 				{
-					FixedAllocator::AllocatorInstance().Dealloc(p);
+					return key.CompareAndSet(static_cast<DKAtomicNumber64::Value>(c), static_cast<DKAtomicNumber64::Value>(v));
 				}
 			};
+			inline bool IsAlive(StateValue s)				{ return (s & StateAliveFlag) != 0; }
+			inline RefCountValue StateCount(StateValue s)	{ return static_cast<RefCountValue>(s & StateCountMask); }
+			inline StateValue DeadState(StateValue s)		{ return s & ~(StateAliveFlag | StateCountMask); }
+			inline StateValue NewAliveState(StateValue prev, RefCountValue c)
+			{
+				StateValue gen = (prev >> StateGenerationShift) + 1;
+				return (gen << StateGenerationShift) | StateAliveFlag | (static_cast<StateValue>(c) & StateCountMask);
+			}
 
-			using Container = DKMap<Key, NodeInfo, DKDummyLock, DKMapKeyComparator<Key>, DKMapValueReplacer<NodeInfo>, Allocator>;
+			struct Level
+			{
+				size_t capacity;
+				size_t mask;
+				size_t limit;		// max number of live slots.
+				DKAtomicNumber32 live;
+				DKAtomicNumber32 probeLength;	// longest probe length of inserted keys.
+				Slot* slots;
 
-			Lock		lock;
-			Container	container;
-		};
+				Level(size_t c) : capacity(c), mask(c - 1), limit(c / 2), live(0), probeLength(0), slots(new Slot[c]) {}
+				~Level(void) { delete[] slots; }
+
+				bool Contains(const Slot* slot) const
+				{
+					return slot >= slots && slot < &slots[capacity];
+				}
+				void UpdateProbeLength(DKAtomicNumber32::Value length)
+				{
+					DKAtomicNumber32::Value current = probeLength;
+					while (current < length && !probeLength.CompareAndSet(current, length))
+						current = probeLength;
+				}
+			};
+
+			inline size_t HashAddress(uintptr_t p)
+			{
+				uint64_t h = static_cast<uint64_t>(p) * 0x9E3779B97F4A7C15ULL;
+				return static_cast<size_t>(h ^ (h >> 29));
+			}
 
-		////////////////////////////////////////////////////////////////////////
-		// GetAllocationNode
-		// generate map for object address, info pair and return address.
-		//
-		// Note:
-		//  The map (refMaps) instance which contains actual address,
-		//  should be static-variable inside of this function. If it declared
-		//  as global variable, it will not be initialized at time, becouse of
-		//  module's global variable initialize order.
-		//  It would be safe to be initialized, if it initalized by calling
-		//  function as static-variable. it will be initialized on first call.
-		namespace
-		{
 			struct AllocationTable
 			{
-				AllocationNode node[AllocatorTableLength];
-				DKSpinLock lock;
+				Level* volatile levels[MaxLevels];
+				DKAtomicNumber32 numLevels;
+				DKAtomicNumber64 refIdCounter;
+				DKSpinLock growLock;
+
+				AllocationTable(void) : numLevels(0), refIdCounter(0)
+				{
+					for (int i = 0; i < MaxLevels; ++i)
+						levels[i] = NULL;
+					AddLevel(InitialLevelCapacity);
+				}
+				~AllocationTable(void)
+				{
+					for (int i = 0; i < MaxLevels; ++i)
+					{
+						delete levels[i];
+						levels[i] = NULL;
+					}
+				}
+				// should be called with growLock locked (or from constructor)
+				bool AddLevel(size_t capacity)
+				{
+					int index = numLevels;
+					if (index < MaxLevels)
+					{
+						// store level before publishing count, readers iterate
+						// levels up to numLevels without lock.
+						levels[index] = new Level(capacity);
+						numLevels.Increment();	// memory barrier
+						return true;
+					}
+					return false;
+				}
+				// grow table, if no level was added since 'knownLevels' has read.
+				void Grow(int knownLevels)
+				{
+					DKCriticalSection<DKSpinLock> guard(growLock);
+					if (numLevels == knownLevels)
+					{
+						Level* last = levels[knownLevels - 1];
+						if (!AddLevel(last->capacity * 2))
+						{
+							DKERROR_THROW("DKObjectRefCounter table overflow!");
+						}
+					}
+				}
+				Slot* Find(void* ptr) const
+				{
+					uintptr_t key = reinterpret_cast<uintptr_t>(ptr);
+					size_t hash = HashAddress(key);
+					for (int i = 0; i < MaxLevels; ++i)
+					{
+						const Level* lv = levels[i];
+						if (lv == NULL)
+							break;
+						const size_t probeLength = (DKAtomicNumber32::Value)lv->probeLength;
+						for (size_t n = 0; n < probeLength; ++n)
+						{
+							Slot& slot = lv->slots[(hash + n) & lv->mask];
+							uintptr_t k = slot.Key();
+							if (k == key)
+								return &slot;
+							if (k == SlotKeyEmpty)
+								break;
+						}
+					}
+					return NULL;
+				}
+				Slot* Insert(void* ptr, DKAllocator* alloc, RefCountValue c, RefIdValue* refId)
+				{
+					uintptr_t key = reinterpret_cast<uintptr_t>(ptr);
+					size_t hash = HashAddress(key);
+					while (true)
+					{
+						int levelCount = numLevels;
+						for (int i = 0; i < levelCount; ++i)
+						{
+							Level* lv = levels[i];
+							// reserve live slot, level is full if exceeds limit.
+							if (lv->live.Increment() >= (DKAtomicNumber32::Value)lv->limit)
+							{
+								lv->live.Decrement();
+								continue;
+							}
+							// take first free slot, empty slot cannot be skipped
+							// because lookup stops at empty slot.
+							const size_t maxProbe = Min(lv->capacity, (size_t)MaxProbeLength);
+							for (size_t n = 0; n < maxProbe; ++n)
+							{
+								Slot& slot = lv->slots[(hash + n) & lv->mask];
+								uintptr_t k = slot.Key();
+								if (k == SlotKeyEmpty || k == SlotKeyDeleted)
+								{
+									// probe length should be updated before key published.
+									lv->UpdateProbeLength(static_cast<DKAtomicNumber32::Value>(n + 1));
+									if (slot.CompareAndSetKey(k, key))
+									{
+										RefIdValue id = static_cast<RefIdValue>(refIdCounter.Increment()) + 1;
+										slot.allocator = alloc;
+										slot.refId = id;
+										// publish slot. (nobody else modify dead slot's state)
+										slot.state = static_cast<DKAtomicNumber64::Value>(NewAliveState(slot.State(), c));
+										if (refId)
+											*refId = id;
+										return &slot;
+									}
+								}
+							}
+							lv->live.Decrement();
+						}
+						Grow(levelCount);
+					}
+					return NULL;
+				}
+				// called by thread which removed alive flag (owner of slot)
+				void Release(Slot* slot)
+				{
+					slot->key = static_cast<DKAtomicNumber64::Value>(SlotKeyDeleted);
+					for (int i = 0; i < MaxLevels; ++i)
+					{
+						Level* lv = levels[i];
+						if (lv == NULL)
+							break;
+						if (lv->Contains(slot))
+						{
+							lv->live.Decrement();
+							break;
+						}
+					}
+				}
 				static AllocationTable*& Instance(void)
 				{
 					static AllocationTable* table = NULL;
@@ -81,26 +263,33 @@ namespace DKFoundation
 				}
 			};
 
-			AllocationNode& GetAllocationNode(void* ptr)
+			////////////////////////////////////////////////////////////////////
+			// GetAllocationTable
+			//
+			// Note:
+			//  The table instance should be static-variable inside of function.
+			//  If it declared as global variable, it will not be initialized at
+			//  time, becouse of module's global variable initialize order.
+			//  It would be safe to be initialized, if it initalized by calling
+			//  function as static-variable. it will be initialized on first call.
+			AllocationTable& GetAllocationTable(void)
 			{
 				// StaticInitializer will initialize AllocationTable (see DKAllocatorChain.cpp)
 				static DKAllocator::StaticInitializer init;
-
-				AllocationTable* table = AllocationTable::Instance();
-				DKCriticalSection<DKSpinLock> guard(table->lock);
-				return table->node[reinterpret_cast<uintptr_t>(ptr) % AllocatorTableLength];
+				return *AllocationTable::Instance();
 			}
-			DKObjectRefCounter::RefIdValue GenerateRefId(void)
+			// find alive slot, returns slot state value.
+			Slot* FindSlot(void* p, StateValue& state)
 			{
-				// StaticInitializer will initialize AllocationTable (see DKAllocatorChain.cpp)
-				static DKAllocator::StaticInitializer init;
-
-				AllocationTable* table = AllocationTable::Instance();
-				DKCriticalSection<DKSpinLock> guard(table->lock);
-
-				static DKObjectRefCounter::RefIdValue counter = 0;
-				DKObjectRefCounter::RefIdValue value = ++counter;
-				return value;
+				Slot* slot = GetAllocationTable().Find(p);
+				if (slot)
+				{
+					state = slot->State();
+					// slot can be reused by other thread, check key again.
+					if (IsAlive(state) && slot->Key() == reinterpret_cast<uintptr_t>(p))
+						return slot;
+				}
+				return NULL;
 			}
 		}
 
@@ -129,16 +318,10 @@ bool DKObjectRefCounter::SetRefCounter(void* p, DKAllocator* alloc, RefCountValu
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair == NULL)
+		StateValue state;
+		if (FindSlot(p, state) == NULL)
 		{
-			AllocationNode::NodeInfo nodeInfo = {alloc, GenerateRefId(), c};
-			node.container.Insert(p, nodeInfo);
-			if (refId)
-				*refId = nodeInfo.refId;
-			return true;
+			return GetAllocationTable().Insert(p, alloc, c, refId) != NULL;
 		}
 	}
 	return false;
@@ -148,15 +331,18 @@ bool DKObjectRefCounter::UnsetRefCounterIfEqual(void* p, RefCountValue c, DKAllo
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair && pair->value.refCount == c)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			if (alloc)
-				*alloc = pair->value.allocator;
-			node.container.Remove(p);
-			return true;
+			if (StateCount(state) != c)
+				break;
+			if (slot->CompareAndSetState(state, DeadState(state)))
+			{
+				if (alloc)
+					*alloc = slot->allocator;
+				GetAllocationTable().Release(slot);
+				return true;
+			}
 		}
 	}
 	return false;
@@ -171,17 +357,18 @@ bool DKObjectRefCounter::UnsetRefCounter(void* p, RefCountValue* c, DKAllocator*
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			if (c)
-				*c = pair->value.refCount;
-			if (alloc)
-				*alloc = pair->value.allocator;
-			node.container.Remove(p);
-			return true;
+			if (slot->CompareAndSetState(state, DeadState(state)))
+			{
+				if (c)
+					*c = StateCount(state);
+				if (alloc)
+					*alloc = slot->allocator;
+				GetAllocationTable().Release(slot);
+				return true;
+			}
 		}
 	}
 	return false;
@@ -191,13 +378,14 @@ bool DKObjectRefCounter::IncrementRefCount(void* p, RefIdValue id)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair && pair->value.refId == id)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			++(pair->value.refCount);
-			return true;
+			if (slot->refId != id)
+				break;
+			// state has generation value, CAS fails if slot has been reused.
+			if (slot->CompareAndSetState(state, state + 1))
+				return true;
 		}
 	}
 	return false;
@@ -207,13 +395,11 @@ bool DKObjectRefCounter::IncrementRefCount(void* p)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			++(pair->value.refCount);
-			return true;
+			if (slot->CompareAndSetState(state, state + 1))
+				return true;
 		}
 	}
 	return false;
@@ -223,21 +409,16 @@ bool DKObjectRefCounter::DecrementRefCount(void* p)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			if (pair->value.refCount > 0)
-			{
-				--(pair->value.refCount);
-			}
-			else
+			if (StateCount(state) == 0)
 			{
 				DKERROR_THROW_DEBUG("Ref-Count already zero!");
 				return false;
 			}
-			return true;
+			if (slot->CompareAndSetState(state, state - 1))
+				return true;
 		}
 	}
 	return false;
@@ -247,21 +428,24 @@ bool DKObjectRefCounter::DecrementRefCountAndUnsetIfEqual(void* p, RefCountValue
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			DKASSERT_STD_DEBUG(pair->value.refCount > 0);
-
-			--(pair->value.refCount);
+			DKASSERT_STD_DEBUG(StateCount(state) > 0);
 
-			if (pair->value.refCount == c)
+			if (StateCount(state) - 1 == c)
 			{
-				if (alloc)
-					*alloc = pair->value.allocator;
-				node.container.Remove(p);
-				return true;
+				if (slot->CompareAndSetState(state, DeadState(state)))
+				{
+					if (alloc)
+						*alloc = slot->allocator;
+					GetAllocationTable().Release(slot);
+					return true;
+				}
+			}
+			else if (slot->CompareAndSetState(state, state - 1))
+			{
+				return false;
 			}
 		}
 	}
@@ -277,31 +461,32 @@ bool DKObjectRefCounter::RefCount(void* p, RefCountValue* c)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		if (FindSlot(p, state))
 		{
 			if (c)
-				*c = pair->value.refCount;
+				*c = StateCount(state);
 			return true;
 		}
 	}
-	return 0;
+	return false;
 }
 
 bool DKObjectRefCounter::RefId(void* p, RefIdValue* ref)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			if (ref)
-				*ref = pair->value.refId;
-			return true;
+			RefIdValue value = slot->refId;
+			// validate refId has been read from same generation.
+			if (((slot->State() ^ state) >> StateGenerationShift) == 0)
+			{
+				if (ref)
+					*ref = value;
+				return true;
+			}
 		}
 	}
 	return false;
@@ -309,44 +494,46 @@ bool DKObjectRefCounter::RefId(void* p, RefIdValue* ref)
 
 DKMemoryLocation DKObjectRefCounter::Location(void* p)
 {
-	if (p)
-	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
-		{
-			return pair->value.allocator->Location();
-		}
-	}
-	return DKMemoryLocationCustom;	
+	DKAllocator* alloc = Allocator(p);
+	if (alloc)
+		return alloc->Location();
+	return DKMemoryLocationCustom;
 }
 
 DKAllocator* DKObjectRefCounter::Allocator(void* p)
 {
 	if (p)
 	{
-		AllocationNode& node = GetAllocationNode(p);
-		AllocationNode::CriticalSection guard(node.lock);
-		AllocationNode::Container::Pair* pair = node.container.Find(p);
-		if (pair)
+		StateValue state;
+		for (Slot* slot = FindSlot(p, state); slot; slot = FindSlot(p, state))
 		{
-			return pair->value.allocator;
+			DKAllocator* alloc = slot->allocator;
+			if (((slot->State() ^ state) >> StateGenerationShift) == 0)
+				return alloc;
 		}
 	}
-	return NULL;	
+	return NULL;
 }
 
 size_t DKObjectRefCounter::TableSize(void)
 {
-	return Private::AllocatorTableLength;	
+	return Private::MaxLevels;
 }
 
 void DKObjectRefCounter::TableDump(size_t* tables)
 {
-	for (size_t i = 0; i < Private::AllocatorTableLength; ++i)
+	AllocationTable& table = GetAllocationTable();
+	for (size_t i = 0; i < Private::MaxLevels; ++i)
 	{
-		AllocationNode& node = GetAllocationNode(reinterpret_cast<void*>(i));
-		tables[i] = node.container.Count();
+		tables[i] = 0;
+		const Level* lv = table.levels[i];
+		if (lv)
+		{
+			for (size_t n = 0; n < lv->capacity; ++n)
+			{
+				if (IsAlive(lv->slots[n].State()))
+					tables[i]++;
+			}
+		}
 	}
 }
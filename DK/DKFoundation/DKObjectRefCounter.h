@@ -15,6 +15,10 @@
 // object ref-counter, weak-ref management.
 // You can determine whether object is alive or not, by using pointer or ref-id.
 //
+// Ref-count states are stored in lock-free open-addressing hash table,
+// every operations are done by atomic CAS on object's own slot, without any
+// global lock. (table grows by adding level, existing slots never moved)
+//
 // Note:
 //  Using this class is optinal.
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,6 +61,8 @@ namespace DKFoundation
 		static DKAllocator* Allocator(void*);
 
 		// functions for debugging.
+		// TableSize returns number of table levels, TableDump retrieves
+		// number of alive objects for each level.
 		static size_t TableSize(void);
 		static void TableDump(size_t*);
 	};
@@ -11,6 +11,7 @@
 #include "DKLog.h"
 #include "DKTimer.h"
 #include "DKCondition.h"
+#include "DKAtomicNumber32.h"
 
 namespace DKFoundation
 {
@@ -22,28 +23,38 @@ namespace DKFoundation
 		static inline void PerformOperationInsidePool(DKOperation* op) {op->Perform();}
 #endif
 
-		static DKCondition operationStateCond;
+		// conditions for operation state, selected by address of state object.
+		// waiting threads are not woken by completion of unrelated operations.
+		enum {NumOperationStateConds = 31};
+		static DKCondition operationStateConds[NumOperationStateConds];
+
 		struct OperationSyncState : public DKOperationQueue::OperationSync
 		{
 			State state;
+			bool running;
+			DKCondition& cond;
 
-			OperationSyncState(void) : state(StateUnknown)
+			OperationSyncState(void)
+				: state(StateUnknown)
+				, running(false)
+				, cond(operationStateConds[(reinterpret_cast<uintptr_t>(this) / sizeof(void*)) % NumOperationStateConds])
 			{
 			}
 			bool Sync(void)
 			{
-				DKCriticalSection<DKCondition> guard(operationStateCond);
+				DKCriticalSection<DKCondition> guard(cond);
 				while (state == State::StatePending)
-					operationStateCond.Wait();
+					cond.Wait();
 
 				return state == State::StateProcessed;
 			}
 			bool Cancel(void)
 			{
-				DKCriticalSection<DKCondition> guard(operationStateCond);
-				if (state == State::StatePending)
+				DKCriticalSection<DKCondition> guard(cond);
+				if (state == State::StatePending && !running)
 				{
 					state = State::StateCancelled;
+					cond.Broadcast();
 					return true;
 				}
 				return false;
@@ -52,6 +63,25 @@ namespace DKFoundation
 			{
 				return state;
 			}
+			// mark as running, returns false if operation has been cancelled.
+			// operation should be performed without lock.
+			bool Begin(void)
+			{
+				DKCriticalSection<DKCondition> guard(cond);
+				if (state == State::StatePending && !running)
+				{
+					running = true;
+					return true;
+				}
+				return false;
+			}
+			void Finish(State s)
+			{
+				DKCriticalSection<DKCondition> guard(cond);
+				state = s;
+				running = false;
+				cond.Broadcast();
+			}
 		};
 	}
 }
@@ -59,37 +89,238 @@ namespace DKFoundation
 using namespace DKFoundation;
 using namespace DKFoundation::Private;
 
-DKOperationQueue::DKOperationQueue(ThreadFilter* f)
+struct DKOperationQueue::WorkStealing
+{
+	enum {MaxWorkers = 64};
+	enum {MaxInjectedBatch = 32};	// number of injected operations can be moved to worker at once.
+	enum {IdleSpinCount = 16};		// number of yields before sleep.
+
+	struct Worker
+	{
+		DKThread::ThreadId threadId;
+		bool alive;						// thread is running. (modified with threadCond)
+		DKSpinLock lock;
+		OperationQueue operations;		// owner uses back, thieves use front.
+		DKCondition cond;				// wakeup this worker only.
+		bool signaled;
+	};
+
+	WorkStealing(void) : numWorkers(0), maxWorkers(0), aliveWorkers(0), pendingOperations(0), runningOperations(0)
+	{
+		for (Worker*& w : workers)
+			w = NULL;
+	}
+	~WorkStealing(void)
+	{
+		for (Worker* w : workers)
+			delete w;
+	}
+
+	Worker* workers[MaxWorkers];
+	DKAtomicNumber32 numWorkers;		// number of allocated workers, workers are not deleted.
+	DKAtomicNumber32 maxWorkers;		// workers at index greater than this, should be terminated.
+	DKAtomicNumber32 aliveWorkers;
+
+	DKSpinLock injectLock;
+	OperationQueue injected;			// operations posted from outside of worker threads.
+
+	DKSpinLock idleLock;
+	DKArray<size_t> idleWorkers;
+
+	DKAtomicNumber32 pendingOperations;	// posted but not finished.
+	DKAtomicNumber32 runningOperations;
+
+	long CurrentWorkerIndex(void) const
+	{
+		DKThread::ThreadId tid = DKThread::CurrentThreadId();
+		size_t n = numWorkers;
+		for (size_t i = 0; i < n; ++i)
+		{
+			const Worker* w = workers[i];
+			if (w && w->alive && w->threadId == tid)
+				return static_cast<long>(i);
+		}
+		return -1;
+	}
+	void Push(const Operation& op)
+	{
+		pendingOperations.Increment();
+		long index = CurrentWorkerIndex();
+		if (index >= 0)
+		{
+			Worker* w = workers[index];
+			DKCriticalSection<DKSpinLock> guard(w->lock);
+			w->operations.PushBack(op);
+		}
+		else
+		{
+			DKCriticalSection<DKSpinLock> guard(injectLock);
+			injected.PushBack(op);
+		}
+		WakeIdleWorker();
+	}
+	bool Fetch(size_t index, Operation& op)
+	{
+		Worker* self = workers[index];
+		self->lock.Lock();
+		bool found = self->operations.PopBack(op);
+		self->lock.Unlock();
+		if (found)
+			return true;
+
+		// take operations from shared queue, move some of them to own queue
+		// to reduce contention. (other workers can steal them)
+		injectLock.Lock();
+		found = injected.PopFront(op);
+		if (found && injected.Count() > 0)
+		{
+			size_t batch = Min(injected.Count() / Max((size_t)aliveWorkers, (size_t)1), (size_t)MaxInjectedBatch);
+			if (batch > 0)
+			{
+				Operation tmp;
+				self->lock.Lock();
+				for (size_t i = 0; i < batch && injected.PopFront(tmp); ++i)
+					self->operations.PushFront(tmp);
+				self->lock.Unlock();
+			}
+		}
+		injectLock.Unlock();
+		if (found)
+			return true;
+
+		// steal from other workers.
+		size_t n = numWorkers;
+		for (size_t i = 1; i < n; ++i)
+		{
+			Worker* w = workers[(index + i) % n];
+			if (w)
+			{
+				w->lock.Lock();
+				found = w->operations.PopFront(op);
+				w->lock.Unlock();
+				if (found)
+					return true;
+			}
+		}
+		return false;
+	}
+	void WakeIdleWorker(void)
+	{
+		size_t index;
+		bool found = false;
+		idleLock.Lock();
+		if (idleWorkers.Count() > 0)
+		{
+			index = idleWorkers.Value(idleWorkers.Count() - 1);
+			idleWorkers.Remove(idleWorkers.Count() - 1);
+			found = true;
+		}
+		idleLock.Unlock();
+		if (found)
+			Signal(workers[index]);
+	}
+	void WakeAllWorkers(void)
+	{
+		size_t n = numWorkers;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (workers[i])
+				Signal(workers[i]);
+		}
+	}
+	void Signal(Worker* w)
+	{
+		DKCriticalSection<DKCondition> guard(w->cond);
+		w->signaled = true;
+		w->cond.Signal();
+	}
+	void SetIdle(size_t index, bool idle)
+	{
+		DKCriticalSection<DKSpinLock> guard(idleLock);
+		for (size_t i = 0; i < idleWorkers.Count(); ++i)
+		{
+			if (idleWorkers.Value(i) == index)
+			{
+				if (!idle)
+					idleWorkers.Remove(i);
+				return;
+			}
+		}
+		if (idle)
+			idleWorkers.Add(index);
+	}
+	// remove all queued operations.
+	size_t Drain(DKArray<Operation>& ops)
+	{
+		Operation op;
+		injectLock.Lock();
+		while (injected.PopFront(op))
+			ops.Add(op);
+		injectLock.Unlock();
+
+		size_t n = numWorkers;
+		for (size_t i = 0; i < n; ++i)
+		{
+			Worker* w = workers[i];
+			if (w)
+			{
+				w->lock.Lock();
+				while (w->operations.PopFront(op))
+					ops.Add(op);
+				w->lock.Unlock();
+			}
+		}
+		return ops.Count();
+	}
+};
+
+DKOperationQueue::DKOperationQueue(ThreadFilter* f, Scheduling s)
 	: maxConcurrentOperations(16)
 	, threadCount(0)
 	, maxThreadCount(0)
 	, activeThreads(0)
 	, filter(f)
+	, scheduling(s)
+	, workStealing(NULL)
 {
+	if (scheduling == SchedulingWorkStealing)
+	{
+		workStealing = new WorkStealing();
+		workStealing->maxWorkers = static_cast<DKAtomicNumber32::Value>(Min(maxConcurrentOperations, (size_t)WorkStealing::MaxWorkers));
+	}
 }
 
 DKOperationQueue::~DKOperationQueue(void)
 {
 	threadCond.Lock();
 	maxThreadCount = 0;
+	if (workStealing)
+	{
+		workStealing->maxWorkers = 0;
+		workStealing->WakeAllWorkers();
+	}
 	threadCond.Broadcast();
 	while (threadCount > 0)
 		threadCond.Wait();
 
 	DKASSERT_DEBUG(activeThreads == 0);
 
-	operationStateCond.Lock();
 	auto cancelOps = [](Operation& op)
 	{
 		OperationSyncState* st = op.sync.StaticCast<OperationSyncState>();
-		if (st && st->state == OperationSync::StatePending)
-			st->state = OperationSync::StateCancelled;
+		if (st)
+			st->Cancel();
 	};
 	operationQueue.EnumerateForward(cancelOps);
 	operationQueue.Clear();
 
-	operationStateCond.Broadcast();
-	operationStateCond.Unlock();
+	if (workStealing)
+	{
+		DKArray<Operation> ops;
+		workStealing->Drain(ops);
+		ops.EnumerateForward(cancelOps);
+		delete workStealing;
+	}
 	threadCond.Unlock();
 }
 
@@ -97,6 +328,11 @@ void DKOperationQueue::SetMaxConcurrentOperations(size_t maxConcurrent)
 {
 	threadCond.Lock();
 	maxConcurrentOperations = Max(maxConcurrent, 1);
+	if (workStealing)
+	{
+		workStealing->maxWorkers = static_cast<DKAtomicNumber32::Value>(Min(maxConcurrentOperations, (size_t)WorkStealing::MaxWorkers));
+		workStealing->WakeAllWorkers();
+	}
 	threadCond.Unlock();
 
 	UpdateThreadPool();
@@ -115,10 +351,17 @@ void DKOperationQueue::Post(DKOperation* operation)
 	if (operation)
 	{
 		Operation op = {operation, NULL};
-		threadCond.Lock();
-		operationQueue.PushBack(op);
-		threadCond.Broadcast();
-		threadCond.Unlock();
+		if (workStealing)
+		{
+			workStealing->Push(op);
+		}
+		else
+		{
+			threadCond.Lock();
+			operationQueue.PushBack(op);
+			threadCond.Broadcast();
+			threadCond.Unlock();
+		}
 		UpdateThreadPool();
 	}
 }
@@ -130,10 +373,17 @@ DKObject<DKOperationQueue::OperationSync> DKOperationQueue::ProcessAsync(DKOpera
 		DKObject<OperationSyncState> sync = DKOBJECT_NEW OperationSyncState();
 		sync->state = OperationSync::StatePending;
 		Operation op = {operation, sync.StaticCast<OperationSync>()};
-		threadCond.Lock();
-		operationQueue.PushBack(op);
-		threadCond.Broadcast();
-		threadCond.Unlock();
+		if (workStealing)
+		{
+			workStealing->Push(op);
+		}
+		else
+		{
+			threadCond.Lock();
+			operationQueue.PushBack(op);
+			threadCond.Broadcast();
+			threadCond.Unlock();
+		}
 		UpdateThreadPool();
 
 		return sync.StaticCast<OperationSync>();
@@ -151,6 +401,49 @@ bool DKOperationQueue::Process(DKOperation* operation)
 
 void DKOperationQueue::UpdateThreadPool(void)
 {
+	if (workStealing)
+	{
+		// every workers are running, or enough workers for pending operations.
+		size_t alive = workStealing->aliveWorkers;
+		if (alive >= (size_t)workStealing->maxWorkers || alive >= (size_t)workStealing->pendingOperations)
+			return;
+
+		threadCond.Lock();
+		maxThreadCount = workStealing->maxWorkers;
+		for (size_t i = 0; i < maxThreadCount && threadCount < (size_t)workStealing->pendingOperations; ++i)
+		{
+			WorkStealing::Worker* w = workStealing->workers[i];
+			if (w == NULL)
+			{
+				w = new WorkStealing::Worker();
+				w->threadId = DKThread::invalidId;
+				w->alive = false;
+				w->signaled = false;
+				workStealing->workers[i] = w;
+				if ((size_t)workStealing->numWorkers <= i)
+					workStealing->numWorkers = static_cast<DKAtomicNumber32::Value>(i + 1);
+			}
+			if (!w->alive)
+			{
+				w->alive = true;
+				w->signaled = false;
+				DKObject<DKThread> thread = DKThread::Create(DKFunction(this, &DKOperationQueue::WorkerProc)->Invocation(i));
+				if (thread)
+				{
+					threadCount++;
+					workStealing->aliveWorkers.Increment();
+				}
+				else
+				{
+					w->alive = false;
+					break;
+				}
+			}
+		}
+		threadCond.Unlock();
+		return;
+	}
+
 	threadCond.Lock();
 	maxThreadCount = maxConcurrentOperations;
 	while (threadCount < maxThreadCount)
@@ -178,18 +471,22 @@ void DKOperationQueue::CancelAllOperations(void)
 {
 	threadCond.Lock();
 
-	operationStateCond.Lock();
 	auto cancelOps = [](Operation& op)
 	{
 		OperationSyncState* st = op.sync.StaticCast<OperationSyncState>();
-		if (st && st->state == OperationSync::StatePending)
-			st->state = OperationSync::StateCancelled;
+		if (st)
+			st->Cancel();
 	};
 	operationQueue.EnumerateForward(cancelOps);
 	operationQueue.Clear();
 
-	operationStateCond.Broadcast();
-	operationStateCond.Unlock();
+	if (workStealing)
+	{
+		DKArray<Operation> ops;
+		size_t numCancelled = workStealing->Drain(ops);
+		ops.EnumerateForward(cancelOps);
+		workStealing->pendingOperations.Add(-static_cast<DKAtomicNumber32::Value>(numCancelled));
+	}
 
 	threadCond.Broadcast();
 	threadCond.Unlock();
@@ -198,13 +495,26 @@ void DKOperationQueue::CancelAllOperations(void)
 void DKOperationQueue::WaitForCompletion(void) const
 {
 	threadCond.Lock();
-	while (operationQueue.Count() > 0 || activeThreads > 0)
-		threadCond.Wait();
+	if (workStealing)
+	{
+		while (workStealing->pendingOperations > 0)
+			threadCond.Wait();
+	}
+	else
+	{
+		while (operationQueue.Count() > 0 || activeThreads > 0)
+			threadCond.Wait();
+	}
 	threadCond.Unlock();
 }
 
 size_t DKOperationQueue::QueueLength(void) const
 {
+	if (workStealing)
+	{
+		long c = static_cast<long>(workStealing->pendingOperations) - static_cast<long>(workStealing->runningOperations);
+		return c > 0 ? c : 0;
+	}
 	threadCond.Lock();
 	size_t c = operationQueue.Count();
 	threadCond.Unlock();
@@ -213,6 +523,9 @@ size_t DKOperationQueue::QueueLength(void) const
 
 size_t DKOperationQueue::RunningOperations(void) const
 {
+	if (workStealing)
+		return workStealing->runningOperations;
+
 	threadCond.Lock();
 	size_t c = activeThreads;
 	threadCond.Unlock();
@@ -277,22 +590,19 @@ void DKOperationQueue::OperationProc(void)
 			OperationSyncState* st = op.sync.StaticCast<OperationSyncState>();
 			if (st)
 			{
-				operationStateCond.Lock();
-				if (st->state == OperationSync::StatePending)
+				if (st->Begin())
 				{
 					if (op.operation)
 					{
 						PerformOperation(op.operation);
 						numOps++;
-						st->state = OperationSync::StateProcessed;
+						st->Finish(OperationSync::StateProcessed);
 					}
 					else
 					{
-						st->state = OperationSync::StateCancelled;
+						st->Finish(OperationSync::StateCancelled);
 					}
-					operationStateCond.Broadcast();
 				}
-				operationStateCond.Unlock();
 			}
 			else  if (op.operation)
 			{
@@ -322,3 +632,132 @@ void DKOperationQueue::OperationProc(void)
 	threadCond.Broadcast();
 	threadCond.Unlock();
 }
+
+void DKOperationQueue::WorkerProc(size_t index)
+{
+	DKThread::ThreadId threadId = DKThread::CurrentThreadId();
+	DKTimer timer;
+	timer.Reset();
+	size_t numOps = 0;
+
+	WorkStealing* ws = workStealing;
+	WorkStealing::Worker* self = ws->workers[index];
+	self->threadId = threadId;
+
+	auto PerformOperation = [this](DKOperation* op)
+	{
+		struct Wrapper : public DKOperation
+		{
+			void Perform(void) const override
+			{
+				if (filter)
+					filter->PerformOperation(op);
+				else
+					op->Perform();
+			}
+			Wrapper(ThreadFilter* f, DKOperation* o) : filter(f), op(o) {}
+			ThreadFilter* filter;
+			DKOperation* op;
+		};
+		Wrapper wr(filter, op);
+		PerformOperationInsidePool(&wr);
+	};
+
+	if (filter)
+		filter->OnThreadInitialized();
+
+	DKLog("DKOperationQueue_Worker[%lu]:0x%x started.\n", index, threadId);
+
+	while (index < (size_t)ws->maxWorkers)
+	{
+		Operation op = {NULL, NULL};
+		bool found = ws->Fetch(index, op);
+		for (int i = 0; !found && i < WorkStealing::IdleSpinCount; ++i)
+		{
+			DKThread::Yield();
+			found = ws->Fetch(index, op);
+		}
+		if (!found)
+		{
+			// register as idle before checking queues again, operation
+			// posted after this will wake up this worker.
+			ws->SetIdle(index, true);
+			found = ws->Fetch(index, op);
+			if (!found)
+			{
+				self->cond.Lock();
+				while (!self->signaled)
+					self->cond.Wait();
+				self->signaled = false;
+				self->cond.Unlock();
+				ws->SetIdle(index, false);
+				continue;
+			}
+			ws->SetIdle(index, false);
+		}
+
+		ws->runningOperations.Increment();
+
+		OperationSyncState* st = op.sync.StaticCast<OperationSyncState>();
+		if (st)
+		{
+			if (st->Begin())
+			{
+				if (op.operation)
+				{
+					PerformOperation(op.operation);
+					numOps++;
+					st->Finish(OperationSync::StateProcessed);
+				}
+				else
+				{
+					st->Finish(OperationSync::StateCancelled);
+				}
+			}
+		}
+		else if (op.operation)
+		{
+			PerformOperation(op.operation);
+			numOps++;
+		}
+
+		op.operation = NULL;
+		op.sync = NULL;
+
+		ws->runningOperations.Decrement();
+		if (ws->pendingOperations.Decrement() == 1)
+		{
+			// all operations are done.
+			threadCond.Lock();
+			threadCond.Broadcast();
+			threadCond.Unlock();
+		}
+	}
+
+	// move remaining operations to shared queue.
+	ws->SetIdle(index, false);
+	DKArray<Operation> remains;
+	Operation op;
+	self->lock.Lock();
+	while (self->operations.PopFront(op))
+		remains.Add(op);
+	self->lock.Unlock();
+	ws->injectLock.Lock();
+	for (Operation& op : remains)
+		ws->injected.PushBack(op);
+	ws->injectLock.Unlock();
+	ws->WakeIdleWorker();
+
+	if (filter)
+		filter->OnThreadTerminate();
+
+	DKLog("DKOperationQueue_Worker[%lu]:0x%x terminated. (running %f seconds, %lu processed)\n", index, threadId, timer.Elapsed(), numOps);
+
+	threadCond.Lock();
+	self->alive = false;
+	self->threadId = DKThread::invalidId;
+	ws->aliveWorkers.Decrement();
+	threadCount--;
+	threadCond.Broadcast();
+	threadCond.Unlock();
+}
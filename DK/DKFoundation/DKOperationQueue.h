@@ -17,6 +17,15 @@
 // DKOperationQueue
 // processing operations with multi-threaded.
 // this class manages thread pool automatically.
+//
+// Scheduling modes:
+//  - SchedulingFIFO: all threads share single queue, operations are started
+//    in order of posted.
+//  - SchedulingWorkStealing: each thread has it's own queue, operation
+//    posted from worker thread is pushed to queue of that thread, and idle
+//    thread steals operations from other threads. order of operations is
+//    not guaranteed. good for large number of small operations, or
+//    operations which post another operations.
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -54,7 +63,13 @@ namespace DKFoundation
 			}
 		};
 
-		DKOperationQueue(ThreadFilter* filter = NULL);
+		enum Scheduling
+		{
+			SchedulingFIFO = 0,
+			SchedulingWorkStealing,
+		};
+
+		DKOperationQueue(ThreadFilter* filter = NULL, Scheduling scheduling = SchedulingFIFO);
 		~DKOperationQueue(void);
 
 		void SetMaxConcurrentOperations(size_t maxConcurrent);
@@ -70,6 +85,8 @@ namespace DKFoundation
 		size_t RunningOperations(void) const;
 		size_t RunningThreads(void) const;
 
+		Scheduling SchedulingMode(void) const	{return scheduling;}
+
 	private:
 		struct Operation
 		{
@@ -88,6 +105,12 @@ namespace DKFoundation
 		void UpdateThreadPool(void);
 		void OperationProc(void);
 
+		// work-stealing scheduler
+		struct WorkStealing;
+		const Scheduling scheduling;
+		WorkStealing* workStealing;
+		void WorkerProc(size_t index);
+
 		DKOperationQueue(const DKOperationQueue&);
 		DKOperationQueue& operator = (const DKOperationQueue&);
 	};
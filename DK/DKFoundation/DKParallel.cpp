@@ -0,0 +1,373 @@
+//
+//  File: DKParallel.cpp
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#include "DKParallel.h"
+#include "DKCondition.h"
+#include "DKSpinLock.h"
+#include "DKCriticalSection.h"
+#include "DKAtomicNumber32.h"
+#include "DKAtomicNumber64.h"
+#include "DKLog.h"
+
+namespace DKFoundation
+{
+	namespace Private
+	{
+		// job processed by operations posted to queue and waiting thread.
+		// each operation (runner) processes units until nothing left.
+		class ParallelJob
+		{
+		public:
+			ParallelJob(DKOperationQueue* q, size_t numUnits)
+				: queue(q)
+				, maxRunners(0)
+			{
+				remaining = (DKAtomicNumber64::Value)numUnits;
+				activeRunners = 0;
+				if (queue)
+					maxRunners = (DKAtomicNumber32::Value)Max(queue->MaxConcurrentOperations(), (size_t)1);
+			}
+			virtual ~ParallelJob(void)
+			{
+			}
+
+			// process one ready unit, returns false if nothing ready.
+			virtual bool RunOne(void) = 0;
+			virtual bool HasReadyUnits(void) const = 0;
+
+			// post runners to queue, up to maxRunners running at once.
+			void Spawn(size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (activeRunners.Increment() >= maxRunners)
+					{
+						activeRunners.Decrement();
+						break;
+					}
+					queue->Post(DKFunction(DKObject<ParallelJob>(this), &ParallelJob::Runner)->Invocation());
+				}
+			}
+			void Wait(void)
+			{
+				while (true)
+				{
+					while (RunOne()) {}
+
+					DKCriticalSection<DKCondition> guard(cond);
+					if (remaining == 0)
+						break;
+					if (!HasReadyUnits())
+						cond.Wait();
+				}
+			}
+			bool IsDone(void) const
+			{
+				return remaining == 0;
+			}
+
+		protected:
+			void UnitFinished(void)
+			{
+				if (remaining.Decrement() == 1)
+				{
+					DKCriticalSection<DKCondition> guard(cond);
+					cond.Broadcast();
+				}
+			}
+			void NotifyReady(void)
+			{
+				DKCriticalSection<DKCondition> guard(cond);
+				cond.Broadcast();
+			}
+
+			DKOperationQueue* queue;
+			DKAtomicNumber32::Value maxRunners;
+
+		private:
+			void Runner(void)
+			{
+				while (RunOne()) {}
+				activeRunners.Decrement();
+			}
+
+			DKAtomicNumber64 remaining;
+			DKAtomicNumber32 activeRunners;
+			DKCondition cond;
+		};
+
+		class ParallelForJob : public ParallelJob
+		{
+		public:
+			ParallelForJob(DKOperationQueue* q, size_t b, size_t e, size_t g, DKParallelForFunction* f)
+				: ParallelJob(q, (e - b + g - 1) / g)
+				, begin(b), end(e), grain(g)
+				, numChunks((e - b + g - 1) / g)
+				, fn(f)
+			{
+				next = 0;
+			}
+			bool RunOne(void) override
+			{
+				size_t index = (size_t)next.Increment();
+				if (index >= numChunks)
+					return false;
+
+				size_t b = begin + grain * index;
+				fn->Invoke(b, Min(b + grain, end));
+				UnitFinished();
+				return true;
+			}
+			bool HasReadyUnits(void) const override
+			{
+				return (size_t)next < numChunks;
+			}
+
+			const size_t begin;
+			const size_t end;
+			const size_t grain;
+			const size_t numChunks;
+			DKParallelForFunction* fn;
+			DKAtomicNumber64 next;
+		};
+
+		class TaskGraphJob : public ParallelJob
+		{
+		public:
+			TaskGraphJob(DKOperationQueue* q, size_t numTasks)
+				: ParallelJob(q, numTasks)
+				, pendingPredecessors(NULL)
+			{
+			}
+			~TaskGraphJob(void)
+			{
+				delete[] pendingPredecessors;
+			}
+			bool RunOne(void) override
+			{
+				size_t task;
+				readyLock.Lock();
+				if (readyTasks.Count() == 0)
+				{
+					readyLock.Unlock();
+					return false;
+				}
+				task = readyTasks.Value(readyTasks.Count() - 1);
+				readyTasks.Remove(readyTasks.Count() - 1);
+				readyLock.Unlock();
+
+				operations.Value(task)->Perform();
+
+				size_t numReady = 0;
+				for (size_t i = successorOffsets.Value(task), n = successorOffsets.Value(task + 1); i < n; ++i)
+				{
+					size_t s = successors.Value(i);
+					if (pendingPredecessors[s].Decrement() == 1)
+					{
+						DKCriticalSection<DKSpinLock> guard(readyLock);
+						readyTasks.Add(s);
+						numReady++;
+					}
+				}
+				if (numReady > 0)
+				{
+					// this thread takes one of ready tasks, others are for
+					// waiting thread and new runners.
+					NotifyReady();
+					if (queue && numReady > 1)
+						Spawn(numReady - 1);
+				}
+				UnitFinished();
+				return true;
+			}
+			bool HasReadyUnits(void) const override
+			{
+				DKCriticalSection<DKSpinLock> guard(readyLock);
+				return readyTasks.Count() > 0;
+			}
+			void Start(void)
+			{
+				if (queue)
+					Spawn(readyTasks.Count());
+			}
+
+			DKArray<DKObject<DKOperation>> operations;
+			DKArray<size_t> successorOffsets;	// successors of task N: [offsets[N], offsets[N+1])
+			DKArray<size_t> successors;
+			DKAtomicNumber32* pendingPredecessors;
+			DKArray<size_t> readyTasks;			// reserved for all tasks
+			DKSpinLock readyLock;
+		};
+
+		struct TaskGraphWaitHandle : public DKTaskGraph::WaitHandle
+		{
+			DKObject<TaskGraphJob> job;
+
+			~TaskGraphWaitHandle(void)
+			{
+				job->Wait();
+			}
+			void Wait(void) override
+			{
+				job->Wait();
+			}
+			bool IsDone(void) const override
+			{
+				return job->IsDone();
+			}
+		};
+	}
+}
+
+using namespace DKFoundation;
+
+void DKFoundation::DKParallelFor(DKOperationQueue* queue, size_t begin, size_t end, size_t grain, DKParallelForFunction* fn)
+{
+	if (end <= begin || fn == NULL)
+		return;
+	if (grain == 0)
+		grain = 1;
+
+	size_t numChunks = (end - begin + grain - 1) / grain;
+	if (queue == NULL || numChunks == 1)
+	{
+		for (size_t b = begin; b < end; b += grain)
+			fn->Invoke(b, Min(b + grain, end));
+		return;
+	}
+
+	DKObject<Private::ParallelForJob> job = DKOBJECT_NEW Private::ParallelForJob(queue, begin, end, grain, fn);
+	job->Spawn(numChunks - 1);	// calling thread processes chunks also.
+	job->Wait();
+}
+
+DKTaskGraph::DKTaskGraph(void)
+{
+}
+
+DKTaskGraph::~DKTaskGraph(void)
+{
+}
+
+DKTaskGraph::Task DKTaskGraph::AddTask(DKOperation* operation)
+{
+	DKASSERT_DEBUG(operation != NULL);
+	return tasks.Add(operation);
+}
+
+DKTaskGraph::Task DKTaskGraph::AddTask(DKOperation* operation, std::initializer_list<Task> predecessors)
+{
+	Task task = AddTask(operation);
+	for (Task p : predecessors)
+		AddDependency(p, task);
+	return task;
+}
+
+bool DKTaskGraph::AddDependency(Task predecessor, Task successor)
+{
+	if (predecessor < tasks.Count() && successor < tasks.Count() && predecessor != successor)
+	{
+		Dependency d = {predecessor, successor};
+		dependencies.Add(d);
+		return true;
+	}
+	return false;
+}
+
+size_t DKTaskGraph::NumberOfTasks(void) const
+{
+	return tasks.Count();
+}
+
+void DKTaskGraph::Clear(void)
+{
+	tasks.Clear();
+	dependencies.Clear();
+}
+
+DKObject<DKTaskGraph::WaitHandle> DKTaskGraph::Submit(DKOperationQueue* queue) const
+{
+	const size_t numTasks = tasks.Count();
+
+	DKObject<Private::TaskGraphJob> job = DKOBJECT_NEW Private::TaskGraphJob(queue, numTasks);
+	job->operations = tasks;
+	job->pendingPredecessors = new DKAtomicNumber32[numTasks];
+
+	// build successor lists, sorted by predecessor.
+	DKArray<size_t>& offsets = job->successorOffsets;
+	offsets.Add((size_t)0, numTasks + 1);
+	for (const Dependency& d : dependencies)
+		offsets.Value(d.predecessor + 1)++;
+	for (size_t i = 0; i < numTasks; ++i)
+		offsets.Value(i + 1) += offsets.Value(i);
+
+	DKArray<size_t> fill((const size_t*)offsets, numTasks);
+	job->successors.Add((size_t)0, dependencies.Count());
+	for (const Dependency& d : dependencies)
+	{
+		job->successors.Value(fill.Value(d.predecessor)++) = d.successor;
+		job->pendingPredecessors[d.successor].Increment();
+	}
+
+	// check cycle, visit tasks in topological order.
+	DKArray<DKAtomicNumber32::Value> inDegree;
+	inDegree.Reserve(numTasks);
+	DKArray<size_t> visit;
+	visit.Reserve(numTasks);
+	for (size_t i = 0; i < numTasks; ++i)
+	{
+		inDegree.Add(job->pendingPredecessors[i]);
+		if (inDegree.Value(i) == 0)
+			visit.Add(i);
+	}
+	for (size_t i = 0; i < visit.Count(); ++i)
+	{
+		size_t task = visit.Value(i);
+		for (size_t k = offsets.Value(task), n = offsets.Value(task + 1); k < n; ++k)
+		{
+			size_t s = job->successors.Value(k);
+			if (--inDegree.Value(s) == 0)
+				visit.Add(s);
+		}
+	}
+	if (visit.Count() != numTasks)
+	{
+		DKLog("DKTaskGraph: graph has cycle!\n");
+		return NULL;
+	}
+
+	job->readyTasks.Reserve(numTasks);
+	for (size_t i = 0; i < numTasks; ++i)
+	{
+		if (job->pendingPredecessors[i] == 0)
+			job->readyTasks.Add(i);
+	}
+	// ready tasks are popped from end of array, reverse them to begin
+	// with tasks added first.
+	for (size_t i = 0, n = job->readyTasks.Count(); i < n / 2; ++i)
+	{
+		size_t t = job->readyTasks.Value(i);
+		job->readyTasks.Value(i) = job->readyTasks.Value(n - i - 1);
+		job->readyTasks.Value(n - i - 1) = t;
+	}
+	job->Start();
+
+	DKObject<Private::TaskGraphWaitHandle> handle = DKOBJECT_NEW Private::TaskGraphWaitHandle();
+	handle->job = job;
+	return handle.SafeCast<WaitHandle>();
+}
+
+bool DKTaskGraph::Run(DKOperationQueue* queue) const
+{
+	DKObject<WaitHandle> handle = Submit(queue);
+	if (handle)
+	{
+		handle->Wait();
+		return true;
+	}
+	return false;
+}
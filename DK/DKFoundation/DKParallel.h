@@ -0,0 +1,109 @@
+//
+//  File: DKParallel.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include <initializer_list>
+#include "../DKInclude.h"
+#include "DKObject.h"
+#include "DKArray.h"
+#include "DKFunction.h"
+#include "DKOperation.h"
+#include "DKOperationQueue.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKParallelFor, DKParallelReduce, DKTaskGraph
+// structured parallelism over DKOperationQueue.
+//
+// DKParallelFor splits range into chunks of grain, and chunks are processed
+// by threads of queue. calling thread processes chunks also, and returns when
+// all chunks are done. (does not wait for other operations of queue)
+//
+// DKTaskGraph runs operations with dependencies. task is started after all
+// predecessors are done. Submit() returns wait handle, thread waiting with
+// handle processes ready tasks also. handle waits for tasks when released.
+//
+// Only one operation per thread is posted to queue, each operation processes
+// chunks or tasks until nothing left. no allocation per chunk or task.
+// If queue is NULL, chunks or tasks are processed by calling (waiting) thread.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	using DKParallelForFunction = DKFunctionSignature<void (size_t, size_t)>;
+
+	// fn is invoked with sub-range (begin, end) of each chunk.
+	// chunk is [begin + grain * n, Min(begin + grain * (n+1), end))
+	DKGL_API void DKParallelFor(DKOperationQueue* queue, size_t begin, size_t end, size_t grain, DKParallelForFunction* fn);
+
+	template <typename Fn> void DKParallelFor(DKOperationQueue* queue, size_t begin, size_t end, size_t grain, Fn&& fn)
+	{
+		DKParallelFor(queue, begin, end, grain, static_cast<DKParallelForFunction*>(DKFunction(std::forward<Fn>(fn))));
+	}
+
+	// fn: T (size_t begin, size_t end), returns result of chunk.
+	// combine: T (const T&, const T&), results are combined in order of chunks.
+	template <typename T, typename Fn, typename Combine>
+	T DKParallelReduce(DKOperationQueue* queue, size_t begin, size_t end, size_t grain, const T& identity, Fn&& fn, Combine&& combine)
+	{
+		if (end <= begin)
+			return identity;
+		if (grain == 0)
+			grain = 1;
+
+		DKArray<T> results;
+		results.Add(identity, (end - begin + grain - 1) / grain);
+		DKParallelFor(queue, begin, end, grain, [&](size_t b, size_t e)
+		{
+			results.Value((b - begin) / grain) = fn(b, e);
+		});
+
+		T result = identity;
+		for (const T& r : results)
+			result = combine(result, r);
+		return result;
+	}
+
+	class DKGL_API DKTaskGraph
+	{
+	public:
+		typedef size_t Task;
+
+		struct WaitHandle
+		{
+			virtual ~WaitHandle(void) {}
+			virtual void Wait(void) = 0;			// process tasks until all tasks are done.
+			virtual bool IsDone(void) const = 0;
+		};
+
+		DKTaskGraph(void);
+		~DKTaskGraph(void);
+
+		Task AddTask(DKOperation* operation);
+		Task AddTask(DKOperation* operation, std::initializer_list<Task> predecessors);
+		bool AddDependency(Task predecessor, Task successor);
+
+		size_t NumberOfTasks(void) const;
+		void Clear(void);
+
+		// start tasks, graph can be submitted multiple times.
+		// returns NULL if graph has cycle.
+		DKObject<WaitHandle> Submit(DKOperationQueue* queue) const;
+		bool Run(DKOperationQueue* queue) const;	// submit and wait.
+
+	private:
+		struct Dependency
+		{
+			Task predecessor;
+			Task successor;
+		};
+		DKArray<DKObject<DKOperation>> tasks;
+		DKArray<Dependency> dependencies;
+
+		DKTaskGraph(const DKTaskGraph&);
+		DKTaskGraph& operator = (const DKTaskGraph&);
+	};
+}
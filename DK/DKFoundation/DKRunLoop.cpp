@@ -165,6 +165,86 @@ namespace DKFoundation
 				return state == StatePending;
 			}
 		};
+
+		// 4-ary min-heap of commands, children of node N are 4N+1 ~ 4N+4.
+		// smaller depth than binary heap, and children are adjacent in memory.
+		enum {CommandHeapArity = 4};
+		template <typename T, typename Less> static void CommandHeapSiftUp(T* heap, size_t index, Less less)
+		{
+			T item = static_cast<T&&>(heap[index]);
+			while (index > 0)
+			{
+				size_t parent = (index - 1) / CommandHeapArity;
+				if (!less(item, heap[parent]))
+					break;
+				heap[index] = static_cast<T&&>(heap[parent]);
+				index = parent;
+			}
+			heap[index] = static_cast<T&&>(item);
+		}
+		template <typename T, typename Less> static void CommandHeapSiftDown(T* heap, size_t count, size_t index, Less less)
+		{
+			T item = static_cast<T&&>(heap[index]);
+			while (true)
+			{
+				size_t first = index * CommandHeapArity + 1;
+				if (first >= count)
+					break;
+				size_t last = Min(first + CommandHeapArity, count);
+				size_t child = first;
+				for (size_t i = first + 1; i < last; ++i)
+				{
+					if (less(heap[i], heap[child]))
+						child = i;
+				}
+				if (!less(heap[child], item))
+					break;
+				heap[index] = static_cast<T&&>(heap[child]);
+				index = child;
+			}
+			heap[index] = static_cast<T&&>(item);
+		}
+		template <typename T, typename Less> static void CommandHeapPush(DKArray<T>& heap, const T& cmd, Less less)
+		{
+			heap.Add(cmd);
+			CommandHeapSiftUp((T*)heap, heap.Count() - 1, less);
+		}
+		template <typename T, typename Less> static void CommandHeapPop(DKArray<T>& heap, T& cmd, Less less)
+		{
+			T* p = (T*)heap;
+			size_t last = heap.Count() - 1;
+			cmd = static_cast<T&&>(p[0]);
+			if (last > 0)
+			{
+				p[0] = static_cast<T&&>(p[last]);
+				CommandHeapSiftDown(p, last, 0, less);
+			}
+			heap.Remove(last);
+		}
+		// remove revoked commands and rebuild heap.
+		template <typename T, typename Less> static size_t CommandHeapPurge(DKArray<T>& heap, Less less)
+		{
+			T* p = (T*)heap;
+			size_t count = heap.Count();
+			size_t n = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const RunLoopResultCallback* callback = p[i].result.template StaticCast<RunLoopResultCallback>();
+				if (callback && callback->IsRevoked())
+					continue;
+				if (n != i)
+					p[n] = static_cast<T&&>(p[i]);
+				n++;
+			}
+			if (n < count)
+			{
+				heap.Remove(n, count - n);
+				for (size_t i = n / CommandHeapArity + 1; i > 0; --i)
+					CommandHeapSiftDown(p, n, i - 1, less);
+			}
+			return count - n;
+		}
+		enum {MinimumCommandPurgeThreshold = 1024};
 	}
 }
 
@@ -173,20 +253,24 @@ using namespace DKFoundation::Private;
 
 bool DKRunLoop::InternalCommandCompareOrder(const InternalCommandTick& lhs, const InternalCommandTick& rhs)
 {
+	if (lhs.fire == rhs.fire)
+		return lhs.sequence < rhs.sequence;
 	return lhs.fire < rhs.fire;
 }
 
 bool DKRunLoop::InternalCommandCompareOrder(const InternalCommandTime& lhs, const InternalCommandTime& rhs)
 {
+	if (lhs.fire == rhs.fire)
+		return lhs.sequence < rhs.sequence;
 	return lhs.fire < rhs.fire;
 }
 
 DKRunLoop::DKRunLoop(void)
-: terminate(true)
+: commandSequence(0)
+, purgeThreshold(MinimumCommandPurgeThreshold)
 , thread(NULL)
 , threadId(DKThread::invalidId)
-, commandQueueTick(&DKRunLoop::InternalCommandCompareOrder)
-, commandQueueTime(&DKRunLoop::InternalCommandCompareOrder)
+, terminate(true)
 {
 }
 
@@ -226,20 +310,65 @@ bool DKRunLoop::IsRunning(void) const
 	return false;
 }
 
-void DKRunLoop::InternalPostCommand(const InternalCommandTick& cmd)
+void DKRunLoop::InternalPostCommand(InternalCommandTick& cmd)
 {
+	bool (*less)(const InternalCommandTick&, const InternalCommandTick&) = &DKRunLoop::InternalCommandCompareOrder;
+
 	DKCriticalSection<DKCondition> guard(commandQueueCond);
-	commandQueueTick.Insert(cmd);
+	cmd.sequence = commandSequence++;
+	CommandHeapPush(commandQueueTick, cmd, less);
+	if (commandQueueTick.Count() + commandQueueTime.Count() >= purgeThreshold)
+		PurgeRevokedCommandsNL();
 	commandQueueCond.Signal();
 }
 
-void DKRunLoop::InternalPostCommand(const InternalCommandTime& cmd)
+void DKRunLoop::InternalPostCommand(InternalCommandTime& cmd)
 {
+	bool (*less)(const InternalCommandTime&, const InternalCommandTime&) = &DKRunLoop::InternalCommandCompareOrder;
+
 	DKCriticalSection<DKCondition> guard(commandQueueCond);
-	commandQueueTime.Insert(cmd);
+	cmd.sequence = commandSequence++;
+	CommandHeapPush(commandQueueTime, cmd, less);
+	if (commandQueueTick.Count() + commandQueueTime.Count() >= purgeThreshold)
+		PurgeRevokedCommandsNL();
 	commandQueueCond.Signal();
 }
 
+void DKRunLoop::PurgeRevokedCommandsNL(void)
+{
+	// revoked commands are remained in heap until fired,
+	// compact heap when it grows twice since last purge.
+	bool (*lessTick)(const InternalCommandTick&, const InternalCommandTick&) = &DKRunLoop::InternalCommandCompareOrder;
+	bool (*lessTime)(const InternalCommandTime&, const InternalCommandTime&) = &DKRunLoop::InternalCommandCompareOrder;
+
+	CommandHeapPurge(commandQueueTick, lessTick);
+	CommandHeapPurge(commandQueueTime, lessTime);
+	purgeThreshold = Max((commandQueueTick.Count() + commandQueueTime.Count()) * 2, (size_t)MinimumCommandPurgeThreshold);
+}
+
+size_t DKRunLoop::FetchExpiredCommandsNL(DKTimer::Tick currentTick, const DKDateTime& currentTime)
+{
+	bool (*lessTick)(const InternalCommandTick&, const InternalCommandTick&) = &DKRunLoop::InternalCommandCompareOrder;
+	bool (*lessTime)(const InternalCommandTime&, const InternalCommandTime&) = &DKRunLoop::InternalCommandCompareOrder;
+
+	size_t fetched = 0;
+	while (commandQueueTick.Count() > 0 && commandQueueTick.Value(0).fire <= currentTick)
+	{
+		InternalCommandTick cmd;
+		CommandHeapPop(commandQueueTick, cmd, lessTick);
+		readyCommands.PushBack(cmd);
+		fetched++;
+	}
+	while (commandQueueTime.Count() > 0 && commandQueueTime.Value(0).fire <= currentTime)
+	{
+		InternalCommandTime cmd;
+		CommandHeapPop(commandQueueTime, cmd, lessTime);
+		readyCommands.PushBack(cmd);
+		fetched++;
+	}
+	return fetched;
+}
+
 void DKRunLoop::Terminate(bool wait)
 {
 	if (thread && thread->IsAlive())
@@ -318,7 +447,7 @@ size_t DKRunLoop::RevokeAllOperations(void)
 
 	//DKTimer::Tick tick = DKTimer::SystemTick();
 
-	size_t numItems = this->commandQueueTick.Count() + this->commandQueueTime.Count();
+	size_t numItems = this->commandQueueTick.Count() + this->commandQueueTime.Count() + this->readyCommands.Count();
 
 	auto revoke = [](const InternalCommand& ic)
 	{
@@ -331,16 +460,23 @@ size_t DKRunLoop::RevokeAllOperations(void)
 		revoke(ic);
 	for (const InternalCommand& ic : this->commandQueueTime)
 		revoke(ic);
+	InternalCommand ic;
+	while (this->readyCommands.PopFront(ic))
+		revoke(ic);
 
 	this->commandQueueTick.Clear();
 	this->commandQueueTime.Clear();
+	this->purgeThreshold = MinimumCommandPurgeThreshold;
 	return numItems;
 }
 
-bool DKRunLoop::GetNextLoopIntervalNL(double* d) const
+bool DKRunLoop::GetNextLoopIntervalNL(DKTimer::Tick currentTick, const DKDateTime& currentDate, double* d) const
 {
-	DKTimer::Tick currentTick = DKTimer::SystemTick();
-	DKDateTime currentDate = DKDateTime::Now();
+	if (readyCommands.Count() > 0)
+	{
+		*d = 0.0;
+		return true;
+	}
 
 	size_t numTickCmd = 0;
 	size_t numTimeCmd = 0;
@@ -383,10 +519,13 @@ bool DKRunLoop::GetNextLoopIntervalNL(double* d) const
 
 void DKRunLoop::WaitNextLoop(void)
 {
+	DKTimer::Tick currentTick = DKTimer::SystemTick();
+	DKDateTime currentDate = DKDateTime::Now();
+
 	DKCriticalSection<DKCondition> guard(this->commandQueueCond);
 
 	double d = 0.0;
-	if (GetNextLoopIntervalNL(&d))
+	if (GetNextLoopIntervalNL(currentTick, currentDate, &d))
 	{
 		d = Max(d, 0.0);
 		if (d > 0.0)
@@ -402,10 +541,13 @@ bool DKRunLoop::WaitNextLoopTimeout(double t)
 {
 	if (t > 0.0)
 	{
+		DKTimer::Tick currentTick = DKTimer::SystemTick();
+		DKDateTime currentDate = DKDateTime::Now();
+
 		DKCriticalSection<DKCondition> guard(this->commandQueueCond);
 
 		double d = 0.0;
-		if (GetNextLoopIntervalNL(&d))
+		if (GetNextLoopIntervalNL(currentTick, currentDate, &d))
 		{
 			double delay = Clamp(d, 0.0, t);
 			if (delay > 0.0)
@@ -448,29 +590,28 @@ bool DKRunLoop::ProcessOne(bool processIdle)
 	DKObject<OperationResult> result = NULL;
 
 	commandQueueCond.Lock();
-
-	DKDateTime currentTime = DKDateTime::Now();
-	DKTimer::Tick currentTick = DKTimer::SystemTick();
-
-	if (operation == NULL && this->commandQueueTick.Count() > 0)
+	if (this->readyCommands.Count() == 0)
 	{
-		const InternalCommandTick& cmd = this->commandQueueTick.Value(0);
-		if (cmd.fire <= currentTick)
+		// ready queue is empty, fetch all expired commands at once.
+		// read clock outside of lock, ready queue is modified by this
+		// thread only. (except for revoking all)
+		bool hasTickCmd = this->commandQueueTick.Count() > 0;
+		bool hasTimeCmd = this->commandQueueTime.Count() > 0;
+		if (hasTickCmd || hasTimeCmd)
 		{
-			operation = cmd.operation;
-			result = cmd.result;
-			this->commandQueueTick.Remove(0);
+			commandQueueCond.Unlock();
+			DKTimer::Tick currentTick = hasTickCmd ? DKTimer::SystemTick() : 0;
+			DKDateTime currentTime = hasTimeCmd ? DKDateTime::Now() : DKDateTime(0, 0);
+			commandQueueCond.Lock();
+
+			FetchExpiredCommandsNL(currentTick, currentTime);
 		}
 	}
-	if (operation == NULL && this->commandQueueTime.Count() > 0)
+	InternalCommand cmd;
+	if (this->readyCommands.PopFront(cmd))
 	{
-		const InternalCommandTime& cmd = this->commandQueueTime.Value(0);
-		if (cmd.fire <= currentTime)
-		{
-			operation = cmd.operation;
-			result = cmd.result;
-			this->commandQueueTime.Remove(0);
-		}
+		operation = static_cast<DKObject<DKOperation>&&>(cmd.operation);
+		result = static_cast<DKObject<OperationResult>&&>(cmd.result);
 	}
 	commandQueueCond.Unlock();
 
@@ -14,7 +14,6 @@
 #include "DKQueue.h"
 #include "DKSpinLock.h"
 #include "DKArray.h"
-#include "DKOrderedArray.h"
 #include "DKTimer.h"
 #include "DKCondition.h"
 
@@ -40,6 +39,12 @@
 //   tick-based: system-tick based, calling operation with delayed time.
 //   time-based: system time based, calling operation at specified system time.
 //               if system time has changed, calling operations will adjusted.
+//
+// Scheduled operations are stored in 4-ary heap ordered by fire time, and
+// operations posted with same fire time are processed in order of posted.
+// All expired operations are moved to ready queue at once, and processed
+// without checking time again. Revoked operation is removed from heap when
+// it reaches top of heap, or when heap is compacted.
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -93,23 +98,27 @@ namespace DKFoundation
 	private:
 		size_t RevokeAllOperations(void);
 		void RunLoopProc(void);
-		bool GetNextLoopIntervalNL(double*) const;
+		bool GetNextLoopIntervalNL(DKTimer::Tick currentTick, const DKDateTime& currentTime, double*) const;
 
 		struct InternalCommand
 		{
 			DKObject<DKOperation>		operation;
 			DKObject<OperationResult>	result;
-
-			virtual ~InternalCommand(void) {}
+			unsigned long long			sequence;	// order of posted
 		};
 		struct InternalCommandTick : public InternalCommand { DKTimer::Tick fire; };
 		struct InternalCommandTime : public InternalCommand { DKDateTime fire; };
-		void InternalPostCommand(const InternalCommandTick& cmd);
-		void InternalPostCommand(const InternalCommandTime& cmd);
-
-		DKCondition								commandQueueCond;
-		DKOrderedArray<InternalCommandTick>		commandQueueTick;
-		DKOrderedArray<InternalCommandTime>		commandQueueTime;
+		void InternalPostCommand(InternalCommandTick& cmd);
+		void InternalPostCommand(InternalCommandTime& cmd);
+		size_t FetchExpiredCommandsNL(DKTimer::Tick currentTick, const DKDateTime& currentTime);
+		void PurgeRevokedCommandsNL(void);
+
+		DKCondition							commandQueueCond;
+		DKArray<InternalCommandTick>		commandQueueTick;	// heap
+		DKArray<InternalCommandTime>		commandQueueTime;	// heap
+		DKQueue<InternalCommand>			readyCommands;		// expired, in order of fire
+		unsigned long long					commandSequence;
+		size_t								purgeThreshold;
 
 		DKObject<DKThread>	thread;
 		DKThread::ThreadId	threadId;
@@ -0,0 +1,337 @@
+//
+//  File: DKSmallArray.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../DKInclude.h"
+#include <initializer_list>
+#include "DKTypeTraits.h"
+#include "DKMemory.h"
+#include "DKStaticArray.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// DKSmallArray
+// array class with inline storage for 'INLINE' items.
+// no heap allocation until item count exceeds INLINE, items are moved to
+// heap buffer after that. useful for temporary arrays which have few items
+// usually. (ex: per-frame, per-draw temporary buffers)
+//
+// This class is not thread safe, has no lock.
+// object does not point itself, it can be relocated by memcpy. (DKArray)
+// items are always relocated bitwise, VALUE should be relocatable by memcpy.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	template <typename VALUE, size_t INLINE = 16, typename ALLOC = DKMemoryDefaultAllocator>
+	class DKSmallArray
+	{
+		static_assert(INLINE > 0, "INLINE must be greater than zero");
+	public:
+		typedef size_t					Index;
+		typedef DKTypeTraits<VALUE>		ValueTraits;
+		typedef ALLOC					Allocator;
+
+		constexpr static size_t NodeSize(void)		{ return sizeof(VALUE); }
+		constexpr static size_t InlineCapacity(void)	{ return INLINE; }
+
+		enum : Index { IndexNotFound = (Index)-1 };
+
+		// implementation for range-based-for-loop.
+		typedef DKArrayRBIterator<DKSmallArray, VALUE&>				RBIterator;
+		typedef DKArrayRBIterator<const DKSmallArray, const VALUE&>	ConstRBIterator;
+		RBIterator begin(void)				{return RBIterator(*this, 0);}
+		ConstRBIterator begin(void) const	{return ConstRBIterator(*this, 0);}
+		RBIterator end(void)				{return RBIterator(*this, this->Count());}
+		ConstRBIterator end(void) const		{return ConstRBIterator(*this, this->Count());}
+
+		DKSmallArray(void)
+			: heapData(NULL), count(0), capacity(0)
+		{
+		}
+		DKSmallArray(const VALUE* v, size_t c)
+			: heapData(NULL), count(0), capacity(0)
+		{
+			Add(v, c);
+		}
+		DKSmallArray(DKSmallArray&& v)
+			: heapData(v.heapData), count(v.count), capacity(v.capacity)
+		{
+			if (capacity == 0)
+				memcpy((void*)inlineStorage, (const void*)v.inlineStorage, sizeof(VALUE) * count);
+			v.heapData = NULL;
+			v.count = 0;
+			v.capacity = 0;
+		}
+		DKSmallArray(const DKSmallArray& v)
+			: heapData(NULL), count(0), capacity(0)
+		{
+			Add(v.Data(), v.count);
+		}
+		DKSmallArray(std::initializer_list<VALUE> il)
+			: heapData(NULL), count(0), capacity(0)
+		{
+			Add(il);
+		}
+		~DKSmallArray(void)
+		{
+			Clear();
+
+			if (heapData)
+				Allocator::Free(heapData);
+		}
+		bool IsEmpty(void) const
+		{
+			return count == 0;
+		}
+		// append one item to tail.
+		Index Add(const VALUE& value)
+		{
+			ReserveItemCaps(1);
+			new(&Data()[count]) VALUE(value);
+			return count++;
+		}
+		Index Add(VALUE&& value)
+		{
+			ReserveItemCaps(1);
+			new(&Data()[count]) VALUE(static_cast<VALUE&&>(value));
+			return count++;
+		}
+		// construct one item at tail with arguments.
+		template <typename... Args> Index Emplace(Args&&... args)
+		{
+			ReserveItemCaps(1);
+			new(&Data()[count]) VALUE(std::forward<Args>(args)...);
+			return count++;
+		}
+		// append 's' length of value to tail.
+		Index Add(const VALUE* value, size_t s)
+		{
+			ReserveItemCaps(s);
+			VALUE* data = Data();
+			for (Index i = 0; i < s; i++)
+				new(&data[count+i]) VALUE(value[i]);
+			count += s;
+			return count - s;
+		}
+		// append initializer-list items to tail.
+		Index Add(std::initializer_list<VALUE> il)
+		{
+			size_t s = il.size();
+			ReserveItemCaps(s);
+			VALUE* data = Data();
+			for (const VALUE& v : il)
+			{
+				new(&data[count]) VALUE(v);
+				count++;
+			}
+			return count - s;
+		}
+		// insert one value into position 'pos'.
+		Index Insert(const VALUE& value, Index pos)
+		{
+			ReserveItemCaps(1);
+			VALUE* data = Data();
+			if (pos > count)
+				pos = count;
+			if (pos < count)
+				memmove((void*)&data[pos+1], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+			new(&data[pos]) VALUE(value);
+			count++;
+			return pos;
+		}
+		Index Insert(VALUE&& value, Index pos)
+		{
+			ReserveItemCaps(1);
+			VALUE* data = Data();
+			if (pos > count)
+				pos = count;
+			if (pos < count)
+				memmove((void*)&data[pos+1], (void*)&data[pos], sizeof(VALUE) * (count - pos));
+			new(&data[pos]) VALUE(static_cast<VALUE&&>(value));
+			count++;
+			return pos;
+		}
+		// remove one element at pos.
+		size_t Remove(Index pos)
+		{
+			if (pos < count)
+			{
+				VALUE* data = Data();
+				data[pos].~VALUE();
+				if (count - pos > 1)
+					memmove((void*)&data[pos], (void*)&data[pos+1], sizeof(VALUE) * (count-pos-1));
+				count--;
+			}
+			return count;
+		}
+		// remove 'c' items at pos. (c = count)
+		size_t Remove(Index pos, size_t c)
+		{
+			if (pos < count)
+			{
+				VALUE* data = Data();
+				Index i = 0;
+				for (; i < count - pos && i < c; i++)
+					data[pos+i].~VALUE();
+				if (i > 0)
+					memmove((void*)&data[pos], (void*)&data[pos+i], sizeof(VALUE) * (count-pos-i));
+				count -= i;
+			}
+			return count;
+		}
+		// destroy items, buffer is not released.
+		void Clear(void)
+		{
+			VALUE* data = Data();
+			for (Index i = 0; i < count; i++)
+				data[i].~VALUE();
+
+			count = 0;
+		}
+		size_t Count(void) const
+		{
+			return count;
+		}
+		size_t Capacity(void) const
+		{
+			return capacity ? capacity : INLINE;
+		}
+		void Resize(size_t s)
+		{
+			if (count > s)			// shrink
+			{
+				VALUE* data = Data();
+				for (Index i = s; i < count; i++)
+					data[i].~VALUE();
+			}
+			else if (count < s)		// extend
+			{
+				Reserve(s);
+				VALUE* data = Data();
+				for (Index i = count; i < s; i++)
+					new(&data[i]) VALUE();
+			}
+			count = s;
+		}
+		void Reserve(size_t c)
+		{
+			if (c <= Capacity())
+				return;
+
+			if (heapData)
+			{
+				heapData = (VALUE*)Allocator::Realloc(heapData, sizeof(VALUE) * c);
+			}
+			else
+			{
+				heapData = (VALUE*)Allocator::Alloc(sizeof(VALUE) * c);
+				memcpy((void*)heapData, (const void*)inlineStorage, sizeof(VALUE) * count);
+			}
+			DKASSERT_DEBUG(heapData != NULL);
+			capacity = c;
+		}
+		VALUE& Value(Index index)
+		{
+			DKASSERT_DEBUG(count > index);
+			return Data()[index];
+		}
+		const VALUE& Value(Index index) const
+		{
+			DKASSERT_DEBUG(count > index);
+			return Data()[index];
+		}
+		// To use items directly.
+		operator VALUE* (void)
+		{
+			if (count > 0)
+				return Data();
+			return NULL;
+		}
+		operator const VALUE* (void) const
+		{
+			if (count > 0)
+				return Data();
+			return NULL;
+		}
+		DKSmallArray& operator = (DKSmallArray&& other)
+		{
+			if (this != &other)
+			{
+				Clear();
+				if (heapData)
+					Allocator::Free(heapData);
+
+				heapData = other.heapData;
+				count = other.count;
+				capacity = other.capacity;
+				if (capacity == 0)
+					memcpy((void*)inlineStorage, (const void*)other.inlineStorage, sizeof(VALUE) * count);
+
+				other.heapData = NULL;
+				other.count = 0;
+				other.capacity = 0;
+			}
+			return *this;
+		}
+		DKSmallArray& operator = (const DKSmallArray& other)
+		{
+			if (this != &other)
+			{
+				Clear();
+				Add(other.Data(), other.count);
+			}
+			return *this;
+		}
+		DKSmallArray& operator = (std::initializer_list<VALUE> il)
+		{
+			Clear();
+			Add(il);
+			return *this;
+		}
+		bool Swap(Index v1, Index v2)
+		{
+			if (v1 != v2 && v1 < count && v2 < count)
+			{
+				DKStaticArray<VALUE>(Data(), count).Swap(v1, v2);
+				return true;
+			}
+			return false;
+		}
+		template <typename CompareFunc> void Sort(CompareFunc cmp)
+		{
+			Sort<CompareFunc>(0, count, cmp);
+		}
+		template <typename CompareFunc> void Sort(Index start, size_t count, CompareFunc cmp)
+		{
+			if (count > 1 && (start + count) <= this->count)
+			{
+				DKStaticArray<VALUE>(&Data()[start], count).template Sort<CompareFunc>(cmp);
+			}
+		}
+	private:
+		VALUE* Data(void)				{ return capacity ? heapData : reinterpret_cast<VALUE*>(inlineStorage); }
+		const VALUE* Data(void) const	{ return capacity ? heapData : reinterpret_cast<const VALUE*>(inlineStorage); }
+
+		void ReserveItemCaps(size_t c)
+		{
+			size_t cap = Capacity();
+			if (count + c > cap)
+			{
+				size_t grow = cap / 2;
+				Reserve(count + (grow > c ? grow : c));
+			}
+		}
+
+		typedef typename std::aligned_storage<sizeof(VALUE), alignof(VALUE)>::type Storage;
+
+		VALUE*	heapData;		// heap buffer, NULL if items are stored inline.
+		size_t	count;
+		size_t	capacity;		// capacity of heapData, 0 if items are stored inline.
+		Storage	inlineStorage[INLINE];
+	};
+}
@@ -0,0 +1,224 @@
+//
+//  File: DKStringAtom.cpp
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#include <string.h>
+#include <wchar.h>
+#include "DKStringAtom.h"
+#include "DKSharedLock.h"
+#include "DKCriticalSection.h"
+#include "DKMemory.h"
+
+namespace DKFoundation
+{
+	namespace Private
+	{
+		inline size_t StringAtomCharHash(DKUniCharW c) { return (size_t)c; }
+		inline size_t StringAtomCharHash(DKUniChar8 c) { return (size_t)(unsigned char)c; }
+
+		// key of string, characters are not copied.
+		template <typename Char> struct StringAtomKey
+		{
+			const Char* str;
+			size_t length;
+			size_t hash;
+
+			StringAtomKey(const Char* s, size_t len) : str(s), length(len)
+			{
+				hash = (size_t)2166136261U;
+				for (size_t i = 0; i < len; ++i)
+					hash = (hash ^ StringAtomCharHash(s[i])) * (size_t)16777619U;
+			}
+		};
+		template <typename Char> struct StringAtomItem
+		{
+			StringAtomKey<Char> key;
+			const DKStringAtom::Entry* entry;
+		};
+		template <typename Char> struct StringAtomItemKey
+		{
+			FORCEINLINE const StringAtomKey<Char>& operator () (const StringAtomItem<Char>& item) const
+			{
+				return item.key;
+			}
+		};
+		template <typename Char> struct StringAtomKeyHasher
+		{
+			FORCEINLINE size_t operator () (const StringAtomKey<Char>& k) const
+			{
+				return k.hash;
+			}
+		};
+		template <typename Char> struct StringAtomKeyEqual
+		{
+			FORCEINLINE bool operator () (const StringAtomKey<Char>& lhs, const StringAtomKey<Char>& rhs) const
+			{
+				return lhs.hash == rhs.hash && lhs.length == rhs.length &&
+					memcmp(lhs.str, rhs.str, sizeof(Char) * lhs.length) == 0;
+			}
+		};
+		template <typename Char> using StringAtomIndex = DKHashTable<StringAtomItem<Char>, StringAtomKey<Char>, StringAtomItemKey<Char>, StringAtomKeyHasher<Char>, StringAtomKeyEqual<Char>>;
+
+		// entries are not released, table is not destroyed at exit.
+		// atom can be used while other static objects are being destroyed.
+		struct StringAtomTable
+		{
+			DKSharedLock lock;
+			StringAtomIndex<DKUniCharW> wideIndex;
+			StringAtomIndex<DKUniChar8> utf8Index;	// UTF-8 aliases of entries in wideIndex.
+
+			static StringAtomTable& Instance(void)
+			{
+				static StringAtomTable* table = new StringAtomTable();
+				return *table;
+			}
+
+			const DKStringAtom::Entry* Find(const StringAtomKey<DKUniCharW>& key) const
+			{
+				DKSharedLockReadOnlySection guard(lock);
+				const StringAtomItem<DKUniCharW>* item = wideIndex.Find(key);
+				return item ? item->entry : NULL;
+			}
+			const DKStringAtom::Entry* Find(const StringAtomKey<DKUniChar8>& key) const
+			{
+				DKSharedLockReadOnlySection guard(lock);
+				const StringAtomItem<DKUniChar8>* item = utf8Index.Find(key);
+				return item ? item->entry : NULL;
+			}
+			// lock must be held exclusively.
+			const DKStringAtom::Entry* InternNL(const StringAtomKey<DKUniCharW>& key)
+			{
+				const StringAtomItem<DKUniCharW>* item = wideIndex.Find(key);
+				if (item)
+					return item->entry;
+
+				DKStringAtom::Entry* e = new DKStringAtom::Entry();
+				e->string = DKStringW(key.str, key.length);
+				StringAtomItem<DKUniCharW> newItem = { StringAtomKey<DKUniCharW>(e->string, e->string.Length()), e };
+				e->hash = newItem.key.hash;
+				wideIndex.Insert(newItem);
+				return e;
+			}
+			const DKStringAtom::Entry* Intern(const StringAtomKey<DKUniCharW>& key)
+			{
+				const DKStringAtom::Entry* e = Find(key);
+				if (e == NULL)
+				{
+					DKCriticalSection<DKSharedLock> guard(lock);
+					e = InternNL(key);
+				}
+				return e;
+			}
+			const DKStringAtom::Entry* Intern(const StringAtomKey<DKUniChar8>& key)
+			{
+				const DKStringAtom::Entry* e = Find(key);
+				if (e == NULL)
+				{
+					// convert string outside of lock.
+					DKStringW str(key.str, key.length);
+					if (str.Length() == 0)
+						return NULL;
+
+					DKCriticalSection<DKSharedLock> guard(lock);
+					const StringAtomItem<DKUniChar8>* item = utf8Index.Find(key);
+					if (item)
+						return item->entry;
+
+					e = InternNL(StringAtomKey<DKUniCharW>(str, str.Length()));
+
+					DKUniChar8* bytes = (DKUniChar8*)DKMemoryHeapAlloc(key.length * sizeof(DKUniChar8) + 1);
+					memcpy(bytes, key.str, key.length * sizeof(DKUniChar8));
+					bytes[key.length] = 0;
+					StringAtomItem<DKUniChar8> alias = { key, e };
+					alias.key.str = bytes;
+					utf8Index.Insert(alias);
+				}
+				return e;
+			}
+		};
+	}
+}
+
+using namespace DKFoundation;
+using namespace DKFoundation::Private;
+
+DKStringAtom::DKStringAtom(const DKUniCharW* str, size_t len)
+	: entry(NULL)
+{
+	if (str)
+	{
+		if (len == (size_t)-1)
+			len = wcslen(str);
+		if (len > 0)
+			entry = StringAtomTable::Instance().Intern(StringAtomKey<DKUniCharW>(str, len));
+	}
+}
+
+DKStringAtom::DKStringAtom(const DKUniChar8* str, size_t len)
+	: entry(NULL)
+{
+	if (str)
+	{
+		if (len == (size_t)-1)
+			len = strlen((const char*)str);
+		if (len > 0)
+			entry = StringAtomTable::Instance().Intern(StringAtomKey<DKUniChar8>(str, len));
+	}
+}
+
+DKStringAtom::DKStringAtom(const DKStringW& str)
+	: DKStringAtom((const DKUniCharW*)str, str.Length())
+{
+}
+
+DKStringAtom::DKStringAtom(const DKStringU8& str)
+	: DKStringAtom((const DKUniChar8*)str, str.Bytes())
+{
+}
+
+DKStringAtom DKStringAtom::Find(const DKUniCharW* str, size_t len)
+{
+	if (str)
+	{
+		if (len == (size_t)-1)
+			len = wcslen(str);
+		if (len > 0)
+			return DKStringAtom(StringAtomTable::Instance().Find(StringAtomKey<DKUniCharW>(str, len)));
+	}
+	return DKStringAtom();
+}
+
+DKStringAtom DKStringAtom::Find(const DKUniChar8* str, size_t len)
+{
+	if (str)
+	{
+		if (len == (size_t)-1)
+			len = strlen((const char*)str);
+		if (len > 0)
+		{
+			const Entry* e = StringAtomTable::Instance().Find(StringAtomKey<DKUniChar8>(str, len));
+			if (e == NULL)
+			{
+				DKStringW s(str, len);
+				return Find((const DKUniCharW*)s, s.Length());
+			}
+			return DKStringAtom(e);
+		}
+	}
+	return DKStringAtom();
+}
+
+DKStringAtom DKStringAtom::Find(const DKStringW& str)
+{
+	return Find((const DKUniCharW*)str, str.Length());
+}
+
+size_t DKStringAtom::NumberOfAtoms(void)
+{
+	StringAtomTable& table = StringAtomTable::Instance();
+	DKSharedLockReadOnlySection guard(table.lock);
+	return table.wideIndex.Count();
+}
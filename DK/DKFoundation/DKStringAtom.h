@@ -0,0 +1,87 @@
+//
+//  File: DKStringAtom.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../DKInclude.h"
+#include "DKString.h"
+#include "DKStringU8.h"
+#include "DKHashTable.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKStringAtom
+// interned string handle. same strings are interned to one global entry,
+// atom is pointer of entry. comparison and hashing of atoms are O(1),
+// characters are not compared.
+//
+// strings can be interned from DKStringW, DKStringU8, wchar_t string,
+// UTF-8 string. UTF-8 strings have own index, interning same UTF-8 string
+// again does not convert string.
+// empty string is null atom (default constructed).
+//
+// Find() looks up string which already interned, does not intern new string.
+// useful for searching with string from outside. (string not interned
+// cannot be matched with any atom)
+//
+// Note:
+//   interned strings are never released until process terminates.
+//   do not intern unbounded strings. (ex: user input, generated names)
+//
+//   order of atoms (operator <, >) is not order of strings. it may differ
+//   for each time process runs.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFoundation
+{
+	class DKGL_API DKStringAtom
+	{
+	public:
+		struct Entry
+		{
+			DKStringW string;
+			size_t hash;
+		};
+
+		DKStringAtom(void) : entry(NULL) {}
+		DKStringAtom(const DKUniCharW* str, size_t len = (size_t)-1);
+		DKStringAtom(const DKUniChar8* str, size_t len = (size_t)-1);
+		DKStringAtom(const DKStringW& str);
+		DKStringAtom(const DKStringU8& str);
+
+		static DKStringAtom Find(const DKUniCharW* str, size_t len = (size_t)-1);
+		static DKStringAtom Find(const DKUniChar8* str, size_t len = (size_t)-1);
+		static DKStringAtom Find(const DKStringW& str);
+
+		// number of interned strings.
+		static size_t NumberOfAtoms(void);
+
+		const DKStringW& String(void) const
+		{
+			return entry ? entry->string : DKStringW::EmptyString();
+		}
+		operator const DKStringW& (void) const		{ return String(); }
+		size_t Length(void) const					{ return entry ? entry->string.Length() : 0; }
+		bool IsEmpty(void) const					{ return entry == NULL; }
+		size_t Hash(void) const						{ return entry ? entry->hash : 0; }
+
+		bool operator == (const DKStringAtom& a) const	{ return entry == a.entry; }
+		bool operator != (const DKStringAtom& a) const	{ return entry != a.entry; }
+		bool operator < (const DKStringAtom& a) const	{ return entry < a.entry; }
+		bool operator > (const DKStringAtom& a) const	{ return entry > a.entry; }
+
+	private:
+		explicit DKStringAtom(const Entry* e) : entry(e) {}
+		const Entry* entry;
+	};
+
+	template <> struct DKHashTableHasher<DKStringAtom, false>
+	{
+		FORCEINLINE size_t operator () (const DKStringAtom& atom) const
+		{
+			return atom.Hash();
+		}
+	};
+}
@@ -70,6 +70,7 @@ namespace DKFoundation
 
 		bool IsLegalUTF8String(const DKUniChar8* input, size_t inputLen);
 		size_t NumberOfCharactersInUTF8(const DKUniChar8* input, size_t length);
+		size_t ConvertWideCharsToUTF8(const DKUniCharW* input, size_t length, DKUniChar8* output);
 	}
 }
 using namespace DKFoundation;
@@ -86,57 +87,66 @@ DKStringEncoding DKStringU8::SystemEncoding(void)
 }
 
 DKStringU8::DKStringU8(void)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 }
 
 DKStringU8::DKStringU8(DKStringU8&& str)
-	: stringData(NULL)
+	: length(str.length), capacity(str.capacity)
 {
-	stringData = str.stringData;
-	str.stringData = NULL;
+	memcpy(inlineData, str.inlineData, sizeof(inlineData));
+	str.length = 0;
+	str.capacity = 0;
+	str.inlineData[0] = 0;
 }
 
 DKStringU8::DKStringU8(const DKStringU8& str)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str);
 }
 
 DKStringU8::DKStringU8(const DKUniChar8* str, size_t len)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, len);
 }
 
 DKStringU8::DKStringU8(const DKUniCharW* str, size_t len)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, len);
 }
 
 DKStringU8::DKStringU8(const void* str, size_t bytes, DKStringEncoding e)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, bytes, e);
 }
 
 DKStringU8::DKStringU8(DKUniCharW c)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(&c, 1);
 }
 
 DKStringU8::DKStringU8(DKUniChar8 c)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(&c, 1);
 }
 
 DKStringU8::~DKStringU8(void)
 {
-	if (stringData)
-		DKMemoryDefaultAllocator::Free(stringData);
+	if (capacity)
+		DKMemoryDefaultAllocator::Free(heapData);
 }
 
 DKStringU8 DKStringU8::Format(const DKUniChar8* fmt, ...)
@@ -199,39 +209,58 @@ DKStringU8 DKStringU8::FormatV(const DKUniCharW* fmt, va_list v)
 	return ret;
 }
 
+void DKStringU8::Reserve(size_t bytes)
+{
+	size_t cap = capacity ? capacity : (size_t)InlineCapacity;
+	if (bytes < cap)
+		return;
+
+	size_t newCapacity = cap + cap / 2;
+	if (newCapacity < bytes + 1)
+		newCapacity = bytes + 1;
+
+	if (capacity)
+	{
+		heapData = (DKUniChar8*)DKMemoryDefaultAllocator::Realloc(heapData, newCapacity);
+	}
+	else
+	{
+		DKUniChar8* buff = (DKUniChar8*)DKMemoryDefaultAllocator::Alloc(newCapacity);
+		memcpy(buff, inlineData, length + 1);
+		heapData = buff;
+	}
+	DKASSERT_DEBUG(heapData != NULL);
+	capacity = newCapacity;
+}
+
 DKStringU8& DKStringU8::Append(const DKStringU8& str)
 {
-	return Append((const DKUniChar8*)str);
+	return Append(str.Data(), str.length);
 }
 
 DKStringU8& DKStringU8::Append(const DKUniChar8* str, size_t len)
 {
 	if (str && str[0])
 	{
-		size_t len1 = this->Length();
 		size_t len2 = 0;
-		for (len2 = 0; str[len2] && len2 < len; len2++) {}
+		for (len2 = 0; len2 < len && str[len2]; len2++) {}
 
-		size_t totalLen = len1 + len2;
-		if (totalLen > 0)
+		if (len2 > 0)
 		{
-			DKUniChar8* buff = (DKUniChar8*)DKMemoryDefaultAllocator::Alloc(totalLen + 1);
-			DKUniChar8* p = buff;
-			if (len1 > 0)
+			const DKUniChar8* data = Data();
+			if (str >= data && str <= &data[length])
 			{
-				memcpy(p, stringData, len1);
-				p += len1;
+				// str is part of this string, buffer can be reallocated.
+				size_t offset = str - data;
+				Reserve(length + len2);
+				str = &Data()[offset];
 			}
-			if (len2 > 0)
+			else
 			{
-				memcpy(p, str, len2);
-				p += len2;
+				Reserve(length + len2);
 			}
-			*p = 0;
-
-			if (stringData)
-				DKMemoryDefaultAllocator::Free(stringData);
-			stringData = buff;
+			memcpy(&Data()[length], str, len2);
+			SetLength(length + len2);
 		}
 	}
 	return *this;
@@ -239,9 +268,25 @@ DKStringU8& DKStringU8::Append(const DKUniChar8* str, size_t len)
 
 DKStringU8& DKStringU8::Append(const DKUniCharW* str, size_t len)
 {
-	DKStringU8 s = "";
-	DKStringSetValue(s, str, len);
-	return this->Append(s);
+	if (str && str[0])
+	{
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (str[i] == 0)
+			{
+				len = i;
+				break;
+			}
+		}
+		size_t bytes = Private::ConvertWideCharsToUTF8(str, len, NULL);
+		if (bytes != (size_t)-1 && bytes > 0)
+		{
+			Reserve(length + bytes);
+			Private::ConvertWideCharsToUTF8(str, len, &Data()[length]);
+			SetLength(length + bytes);
+		}
+	}
+	return *this;
 }
 
 DKStringU8& DKStringU8::Append(const void* str, size_t bytes, DKStringEncoding e)
@@ -253,72 +298,50 @@ DKStringU8& DKStringU8::Append(const void* str, size_t bytes, DKStringEncoding e
 
 DKStringU8& DKStringU8::SetValue(const DKStringU8& str)
 {
-	if (str.stringData == this->stringData)
+	if (&str == this)
 		return *this;
-	
-	if (this->stringData)
-		DKMemoryDefaultAllocator::Free(this->stringData);
-	this->stringData = NULL;
-	
-	size_t len = str.Length();
-	if (len > 0)
-	{
-		DKASSERT_DEBUG(str.stringData != NULL);
-		this->stringData = (DKUniChar8*)DKMemoryDefaultAllocator::Alloc(len+1);
-		memcpy(this->stringData, str.stringData, len);
-		this->stringData[len] = 0;
-	}
+
+	Reserve(str.length);
+	memcpy(Data(), str.Data(), str.length + 1);
+	length = str.length;
 	return *this;
 }
 
 DKStringU8& DKStringU8::SetValue(const DKUniChar8* str, size_t len)
 {
-	if (str == stringData && len >= this->Length())
-	{
-		return *this;
-	}
-	
-	DKUniChar8* buff = NULL;
-	if (str && str[0])
+	if (str == NULL)
+		len = 0;
+
+	for (size_t i = 0; i < len; ++i)
 	{
-		for (size_t i = 0; i < len; ++i)
-		{
-			if (str[i] == 0)
-			{
-				len = i;
-				break;
-			}
-		}
-		
-		if (len > 0)
+		if (str[i] == 0)
 		{
-			buff = (DKUniChar8*)DKMemoryDefaultAllocator::Alloc(len+1);
-			memcpy(buff, str, len);
-			buff[len] = NULL;
+			len = i;
+			break;
 		}
 	}
-	if (stringData)
-		DKMemoryDefaultAllocator::Free(stringData);
-	stringData = buff;
-	
-	return *this;
-}
 
-DKStringU8& DKStringU8::SetValue(const DKUniCharW* str, size_t len)
-{
-	if (str && str[0])
+	DKUniChar8* data = Data();
+	if (str >= data && str <= &data[length])
 	{
-		DKStringSetValue(*this, str, len);
+		// str is part of this string.
+		memmove(data, str, len);
 	}
-	else
+	else if (len > 0)
 	{
-		if (stringData)
-			DKMemoryDefaultAllocator::Free(stringData);
-		stringData = NULL;
+		Reserve(len);
+		memcpy(Data(), str, len);
 	}
+	SetLength(len);
 	return *this;
 }
 
+DKStringU8& DKStringU8::SetValue(const DKUniCharW* str, size_t len)
+{
+	SetLength(0);
+	return Append(str, len);
+}
+
 DKStringU8& DKStringU8::SetValue(const void* str, size_t bytes, DKStringEncoding e)
 {
 	DKStringSetValue(*this, str, bytes, e);
@@ -334,38 +357,32 @@ DKObject<DKData> DKStringU8::Encode(DKStringEncoding e) const
 
 size_t DKStringU8::Length(void) const
 {
-	return Private::NumberOfCharactersInUTF8(stringData, Bytes());
+	return Private::NumberOfCharactersInUTF8(Data(), length);
 }
 
 size_t DKStringU8::Bytes(void) const
 {
-	size_t len = 0;
-	if (stringData)
-	{
-		while (stringData[len])
-			len++;
-	}
-	return len;
+	return length;
 }
 
 int DKStringU8::Compare(const DKUniChar8* str) const
 {
-	return Private::CompareCaseSensitive(stringData, str);
+	return Private::CompareCaseSensitive(Data(), str);
 }
 
 int DKStringU8::Compare(const DKStringU8& str) const
 {
-	return Private::CompareCaseSensitive(stringData, str.stringData);
+	return Private::CompareCaseSensitive(Data(), str.Data());
 }
 
 int DKStringU8::CompareNoCase(const DKUniChar8* str) const
 {
-	return Private::CompareCaseInsensitive(stringData, str);
+	return Private::CompareCaseInsensitive(Data(), str);
 }
 
 int DKStringU8::CompareNoCase(const DKStringU8& str) const
 {
-	return Private::CompareCaseInsensitive(stringData, str.stringData);
+	return Private::CompareCaseInsensitive(Data(), str.Data());
 }
 
 // assignment operators
@@ -373,11 +390,16 @@ DKStringU8& DKStringU8::operator = (DKStringU8&& str)
 {
 	if (this != &str)
 	{
-		if (stringData)
-			DKMemoryDefaultAllocator::Free(stringData);
+		if (capacity)
+			DKMemoryDefaultAllocator::Free(heapData);
+
+		length = str.length;
+		capacity = str.capacity;
+		memcpy(inlineData, str.inlineData, sizeof(inlineData));
 
-		stringData = str.stringData;
-		str.stringData = NULL;
+		str.length = 0;
+		str.capacity = 0;
+		str.inlineData[0] = 0;
 	}
 	return *this;
 }
@@ -412,9 +434,7 @@ DKStringU8& DKStringU8::operator = (DKUniChar8 ch)
 // conversion operators
 DKStringU8::operator const DKUniChar8* (void) const
 {
-	if (stringData)
-		return stringData;
-	return "";
+	return Data();
 }
 
 // concatention operators
@@ -435,59 +455,96 @@ DKStringU8& DKStringU8::operator += (const DKUniChar8* str)
 
 DKStringU8& DKStringU8::operator += (DKUniCharW ch)
 {
-	DKUniCharW str[2] = {ch, 0};
-	return Append(str);
+	return Append(&ch, 1);
 }
 
 DKStringU8& DKStringU8::operator += (DKUniChar8 ch)
 {
-	DKUniChar8 str[2] = {ch, 0};
-	return Append(str);
+	return Append(&ch, 1);
+}
+
+DKStringU8 DKStringU8::operator + (const DKStringU8& str) const &
+{
+	DKStringU8 s;
+	s.Reserve(length + str.length);
+	s.SetValue(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringU8 DKStringU8::operator + (const DKUniCharW* str) const &
+{
+	DKStringU8 s(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringU8 DKStringU8::operator + (const DKUniChar8* str) const &
+{
+	DKStringU8 s;
+	s.Reserve(length + (str ? strlen(str) : 0));
+	s.SetValue(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringU8 DKStringU8::operator + (DKUniCharW c) const &
+{
+	DKStringU8 s(*this);
+	s.Append(&c, 1);
+	return s;
+}
+
+DKStringU8 DKStringU8::operator + (DKUniChar8 c) const &
+{
+	DKStringU8 s(*this);
+	s.Append(&c, 1);
+	return s;
 }
 
-DKStringU8 DKStringU8::operator + (const DKStringU8& str) const
+DKStringU8 DKStringU8::operator + (const DKStringU8& str) &&
 {
-	return DKStringU8(*this).Append(str);
+	return static_cast<DKStringU8&&>(this->Append(str));
 }
 
-DKStringU8 DKStringU8::operator + (const DKUniCharW* str) const
+DKStringU8 DKStringU8::operator + (const DKUniCharW* str) &&
 {
-	return DKStringU8(*this).Append(str);
+	return static_cast<DKStringU8&&>(this->Append(str));
 }
 
-DKStringU8 DKStringU8::operator + (const DKUniChar8* str) const
+DKStringU8 DKStringU8::operator + (const DKUniChar8* str) &&
 {
-	return DKStringU8(*this).Append(str);
+	return static_cast<DKStringU8&&>(this->Append(str));
 }
 
-DKStringU8 DKStringU8::operator + (DKUniCharW c) const
+DKStringU8 DKStringU8::operator + (DKUniCharW c) &&
 {
-	return DKStringU8(*this).Append(&c, 1);
+	return static_cast<DKStringU8&&>(this->Append(&c, 1));
 }
 
-DKStringU8 DKStringU8::operator + (DKUniChar8 c) const
+DKStringU8 DKStringU8::operator + (DKUniChar8 c) &&
 {
-	return DKStringU8(*this).Append(&c, 1);
+	return static_cast<DKStringU8&&>(this->Append(&c, 1));
 }
 
 // convert numeric values.
 long long DKStringU8::ToInteger(void) const
 {
-	if (stringData && stringData[0])
-		return strtoll(stringData, 0, 0);
+	if (length > 0)
+		return strtoll(Data(), 0, 0);
 	return 0LL;
 }
 
 unsigned long long DKStringU8::ToUnsignedInteger(void) const
 {
-	if (stringData && stringData[0])
-		return strtoull(stringData, 0, 0);
+	if (length > 0)
+		return strtoull(Data(), 0, 0);
 	return 0ULL;
 }
 
 double DKStringU8::ToRealNumber(void) const
 {
-	if (stringData && stringData[0])
-		return strtod(stringData, 0);
+	if (length > 0)
+		return strtod(Data(), 0);
 	return 0.0;
 }
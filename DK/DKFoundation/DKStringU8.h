@@ -14,6 +14,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 // DKStringU8
 // a string class with UTF-8 encoded character string.
+// string is stored as UTF-8, converted from/to wchar_t string directly.
+//
+// short strings (shorter than InlineCapacity bytes) are stored in object
+// itself, no heap allocation. longer strings are stored in heap buffer
+// which grows geometrically, buffer is kept when string become shorter.
+// number of bytes is cached, Bytes() is O(1). (Length() is not)
+// object does not point itself, it can be relocated by memcpy. (DKArray)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -55,6 +62,8 @@ namespace DKFoundation
 
 		size_t Length(void) const;		// number of characters. (not bytes!)
 		size_t Bytes(void) const;
+		// reserve buffer for 'bytes' length (without null-terminator).
+		void Reserve(size_t bytes);
 
 		int Compare(const DKUniChar8* str) const;
 		int Compare(const DKStringU8& str) const;
@@ -78,11 +87,17 @@ namespace DKFoundation
 		DKStringU8& operator += (const DKUniChar8* str);
 		DKStringU8& operator += (DKUniCharW ch);
 		DKStringU8& operator += (DKUniChar8 ch);
-		DKStringU8 operator + (const DKStringU8& str) const;
-		DKStringU8 operator + (const DKUniCharW* str) const;
-		DKStringU8 operator + (const DKUniChar8* str) const;
-		DKStringU8 operator + (DKUniCharW c) const;
-		DKStringU8 operator + (DKUniChar8 c) const;
+		DKStringU8 operator + (const DKStringU8& str) const &;
+		DKStringU8 operator + (const DKUniCharW* str) const &;
+		DKStringU8 operator + (const DKUniChar8* str) const &;
+		DKStringU8 operator + (DKUniCharW c) const &;
+		DKStringU8 operator + (DKUniChar8 c) const &;
+		// concatenation of temporary object appends to itself.
+		DKStringU8 operator + (const DKStringU8& str) &&;
+		DKStringU8 operator + (const DKUniCharW* str) &&;
+		DKStringU8 operator + (const DKUniChar8* str) &&;
+		DKStringU8 operator + (DKUniCharW c) &&;
+		DKStringU8 operator + (DKUniChar8 c) &&;
 
 		// comparison operators
 		bool operator > (const DKStringU8& str) const			{return Compare(str) > 0;}
@@ -104,6 +119,18 @@ namespace DKFoundation
 		double ToRealNumber(void) const;
 
 	private:
-		DKUniChar8* stringData;
+		enum : size_t { InlineCapacity = 64 - sizeof(size_t) * 2 };	// including null-terminator.
+
+		DKUniChar8* Data(void)				{ return capacity ? heapData : inlineData; }
+		const DKUniChar8* Data(void) const	{ return capacity ? heapData : inlineData; }
+		void SetLength(size_t len)			{ length = len; Data()[len] = 0; }
+
+		size_t length;		// number of bytes, without null-terminator.
+		size_t capacity;	// capacity of heapData, 0 if string stored inline.
+		union
+		{
+			DKUniChar8* heapData;
+			DKUniChar8 inlineData[InlineCapacity];
+		};
 	};
 }
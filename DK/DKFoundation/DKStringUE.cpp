@@ -432,6 +432,76 @@ namespace DKFoundation
 				return ConvertUTF32toUTF16(reinterpret_cast<const UIntUTF32*>(input), reinterpret_cast<const UIntUTF32*>(&input[length]), true, UniCharArraySetter<UIntUTF16, DKUniChar16>(output));
 			return false;
 		}
+		template <typename OUT> struct UniCharPointerSetter
+		{
+			OUT* output;
+			template <typename IN> void operator () (IN ch) { *(output++) = static_cast<OUT>(ch); }
+		};
+		struct UniCharCounter
+		{
+			size_t count;
+			template <typename IN> void operator () (IN) { count++; }
+		};
+		// convert UTF-8 to wide-chars, output should be able to hold 'length' characters.
+		// returns number of characters converted, (size_t)-1 if input is not legal.
+		size_t ConvertUTF8ToWideChars(const DKUniChar8* input, size_t length, DKUniCharW* output)
+		{
+			const UIntUTF8* p = reinterpret_cast<const UIntUTF8*>(input);
+			const UIntUTF8* end = p + length;
+			DKUniCharW* q = output;
+			while (p < end && *p < 0x80)		// ASCII
+				*(q++) = static_cast<DKUniCharW>(*(p++));
+			if (p == end)
+				return q - output;
+
+			UniCharPointerSetter<DKUniCharW> setter = { q };
+			bool result = sizeof(DKUniCharW) == 4 ?
+				ConvertUTF8toUTF32(p, end, true, setter) :
+				ConvertUTF8toUTF16(p, end, true, setter);
+			if (result)
+				return setter.output - output;
+			return (size_t)-1;
+		}
+		// convert wide-chars to UTF-8, returns number of bytes converted.
+		// if output is NULL, returns number of bytes required only.
+		// returns (size_t)-1 if input is not legal.
+		size_t ConvertWideCharsToUTF8(const DKUniCharW* input, size_t length, DKUniChar8* output)
+		{
+			const DKUniCharW* p = input;
+			const DKUniCharW* end = p + length;
+			size_t ascii = 0;
+			while (p < end && static_cast<UIntUTF32>(*p) < 0x80)		// ASCII
+			{
+				if (output)
+					output[ascii] = static_cast<DKUniChar8>(*p);
+				++p;
+				++ascii;
+			}
+			if (p == end)
+				return ascii;
+
+			bool result;
+			size_t count;
+			if (output)
+			{
+				UniCharPointerSetter<DKUniChar8> setter = { &output[ascii] };
+				result = sizeof(DKUniCharW) == 4 ?
+					ConvertUTF32toUTF8(reinterpret_cast<const UIntUTF32*>(p), reinterpret_cast<const UIntUTF32*>(end), true, setter) :
+					ConvertUTF16toUTF8(reinterpret_cast<const UIntUTF16*>(p), reinterpret_cast<const UIntUTF16*>(end), true, setter);
+				count = setter.output - output;
+			}
+			else
+			{
+				UniCharCounter counter = { ascii };
+				result = sizeof(DKUniCharW) == 4 ?
+					ConvertUTF32toUTF8(reinterpret_cast<const UIntUTF32*>(p), reinterpret_cast<const UIntUTF32*>(end), true, counter) :
+					ConvertUTF16toUTF8(reinterpret_cast<const UIntUTF16*>(p), reinterpret_cast<const UIntUTF16*>(end), true, counter);
+				count = counter.count;
+			}
+			if (result)
+				return count;
+			return (size_t)-1;
+		}
 		size_t NumberOfCharactersInUTF8(const DKUniChar8* input, size_t length)
 		{
 			size_t count = 0;
@@ -1130,60 +1200,14 @@ namespace DKFoundation
 
 	DKGL_API bool DKStringSetValue(DKStringU8& strOut, const DKStringW& strIn)
 	{
-		const DKUniCharW* s = strIn;
-		DKArray<DKUniChar8> utf8bytes;
-		size_t len = Private::UniCharLength(s);
-		utf8bytes.Reserve(len * 4 + 2);
-
-		if (sizeof(DKUniCharW) == 4)
-		{
-			if (Private::ConvertUniChars(reinterpret_cast<const DKUniChar32*>(s), len, utf8bytes))
-			{
-				strOut.SetValue((DKUniChar8*)utf8bytes, utf8bytes.Count());
-				return true;
-			}
-		}
-		else
-		{
-			if (Private::ConvertUniChars(reinterpret_cast<const DKUniChar16*>(s), len, utf8bytes))
-			{
-				strOut.SetValue((DKUniChar8*)utf8bytes, utf8bytes.Count());
-				return true;
-			}
-		}
-		strOut.SetValue(DKStringU8::EmptyString());
-		return false;
+		strOut.SetValue((const DKUniCharW*)strIn, strIn.Length());
+		return strOut.Bytes() > 0;
 	}
 
 	DKGL_API bool DKStringSetValue(DKStringW& strOut, const DKStringU8& strIn)
 	{
-		const DKUniChar8* s = strIn;
-		if (sizeof(DKUniCharW) == 4)
-		{
-			DKArray<DKUniChar32> utf32bytes;
-			size_t len = Private::UniCharLength(s);
-			utf32bytes.Reserve(len + 2);
-
-			if (Private::ConvertUniChars(reinterpret_cast<const DKUniChar8*>(s), len, utf32bytes))
-			{
-				strOut.SetValue(reinterpret_cast<const DKUniCharW*>((DKUniChar32*)utf32bytes), utf32bytes.Count());
-				return true;
-			}
-		}
-		else
-		{
-			DKArray<DKUniChar16> utf16bytes;
-			size_t len = Private::UniCharLength(s);
-			utf16bytes.Reserve(len + 2);
-
-			if (Private::ConvertUniChars(reinterpret_cast<const DKUniChar8*>(s), len, utf16bytes))
-			{
-				strOut.SetValue(reinterpret_cast<const DKUniCharW*>((DKUniChar16*)utf16bytes), utf16bytes.Count());
-				return true;
-			}
-		}
-		strOut.SetValue(DKStringW::EmptyString());
-		return false;
+		strOut.SetValue((const DKUniChar8*)strIn, strIn.Bytes());
+		return strOut.Length() > 0;
 	}
 
 	DKGL_API bool DKStringSetValue(DKStringU8& strOut, const DKUniChar8* strIn, size_t len)
@@ -1230,25 +1254,14 @@ namespace DKFoundation
 
 	DKGL_API bool DKStringSetValue(DKStringU8& strOut, const DKUniCharW* strIn, size_t len)
 	{
-		return DKStringSetValue(strOut, reinterpret_cast<const Private::StringWTraits::BaseCharT*>(strIn), Private::UniCharLength(strIn, len));
+		strOut.SetValue(strIn, len);
+		return strOut.Bytes() > 0;
 	}
 
 	DKGL_API bool DKStringSetValue(DKStringW& strOut, const DKUniChar8* strIn, size_t len)
 	{
-		if (strIn && len > 0)
-		{
-			DKArray<Private::StringWTraits::BaseCharT> buff;
-			len = Private::UniCharLength(strIn, len);
-			buff.Reserve(len + 2);
-
-			if (Private::ConvertUniChars(strIn, len, buff))
-			{
-				strOut.SetValue(reinterpret_cast<DKUniCharW*>((Private::StringWTraits::BaseCharT*)buff), buff.Count());
-				return true;
-			}
-		}
-		strOut.SetValue(DKStringW::EmptyString());
-		return false;
+		strOut.SetValue(strIn, len);
+		return strOut.Length() > 0;
 	}
 
 	DKGL_API bool DKStringSetValue(DKStringW& strOut, const DKUniChar16* strIn, size_t len)
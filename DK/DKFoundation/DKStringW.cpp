@@ -109,6 +109,8 @@ namespace DKFoundation
 				return (*p) - (*q);
 			}
 		}
+
+		size_t ConvertUTF8ToWideChars(const DKUniChar8* input, size_t length, DKUniCharW* output);
 	}
 }
 
@@ -127,57 +129,66 @@ DKStringEncoding DKStringW::SystemEncoding(void)
 
 // DKStringW class
 DKStringW::DKStringW(void)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 }
 
 DKStringW::DKStringW(DKStringW&& str)
-	: stringData(NULL)
+	: length(str.length), capacity(str.capacity)
 {
-	stringData = str.stringData;
-	str.stringData = NULL;
+	memcpy(inlineData, str.inlineData, sizeof(inlineData));
+	str.length = 0;
+	str.capacity = 0;
+	str.inlineData[0] = 0;
 }
 
 DKStringW::DKStringW(const DKStringW& str)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str);
 }
 
 DKStringW::DKStringW(const DKUniCharW* str, size_t len)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, len);
 }
 
 DKStringW::DKStringW(const DKUniChar8* str, size_t len)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, len);
 }
 
 DKStringW::DKStringW(const void* str, size_t len, DKStringEncoding e)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(str, len, e);
 }
 
 DKStringW::DKStringW(DKUniCharW c)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(&c, 1);
 }
 
 DKStringW::DKStringW(DKUniChar8 c)
-	: stringData(NULL)
+	: length(0), capacity(0)
 {
+	inlineData[0] = 0;
 	this->SetValue(&c, 1);
 }
 
 DKStringW::~DKStringW(void)
 {
-	if (stringData)
-		DKMemoryDefaultAllocator::Free(stringData);
+	if (capacity)
+		DKMemoryDefaultAllocator::Free(heapData);
 }
 
 DKStringW DKStringW::Format(const DKUniChar8* fmt, ...)
@@ -242,27 +253,44 @@ DKStringW DKStringW::FormatV(const DKUniCharW* fmt, va_list v)
 
 size_t DKStringW::Length(void) const
 {
-	size_t len = 0;
-	if (stringData)
-	{
-		while (stringData[len])
-			len++;
-	}
-	return len;
+	return length;
 }
 
 size_t DKStringW::Bytes(void) const
 {
-	return Length() * sizeof(DKUniCharW);
+	return length * sizeof(DKUniCharW);
+}
+
+void DKStringW::Reserve(size_t len)
+{
+	size_t cap = capacity ? capacity : (size_t)InlineCapacity;
+	if (len < cap)
+		return;
+
+	size_t newCapacity = cap + cap / 2;
+	if (newCapacity < len + 1)
+		newCapacity = len + 1;
+
+	if (capacity)
+	{
+		heapData = (DKUniCharW*)DKMemoryDefaultAllocator::Realloc(heapData, newCapacity * sizeof(DKUniCharW));
+	}
+	else
+	{
+		DKUniCharW* buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc(newCapacity * sizeof(DKUniCharW));
+		memcpy(buff, inlineData, (length + 1) * sizeof(DKUniCharW));
+		heapData = buff;
+	}
+	DKASSERT_DEBUG(heapData != NULL);
+	capacity = newCapacity;
 }
 
 long DKStringW::Find(DKUniCharW c, long begin) const
 {
 	if (begin < 0)	begin = 0;
 
-	const DKUniCharW *data = stringData;
-	size_t len = Length();
-	for (long i = begin; i < (long)len; ++i)
+	const DKUniCharW *data = Data();
+	for (long i = begin; i < (long)length; ++i)
 	{
 		if (data[i] == c)
 			return (long)i;
@@ -277,12 +305,13 @@ long DKStringW::Find(const DKUniCharW* str, long begin) const
 
 	if (begin < 0)	begin = 0;
 
+	const DKUniCharW *data = Data();
 	long strLength = (long)wcslen(str);
-	long maxLength = (long)Length() - strLength;
+	long maxLength = (long)length - strLength;
 
 	for (long i = begin; i <= maxLength; ++i)
 	{
-		if (wcsncmp(&stringData[i], str, strLength) == 0)
+		if (wcsncmp(&data[i], str, strLength) == 0)
 			return (long)i;
 	}
 	return -1;
@@ -302,10 +331,10 @@ long DKStringW::FindAnyCharactersInSet(const CharacterSet& cs, long begin) const
 {
 	if (cs.Count() > 0)
 	{
-		size_t len = Length();
-		for (size_t i = begin; i < len; ++i)
+		const DKUniCharW *data = Data();
+		for (size_t i = begin; i < length; ++i)
 		{
-			if (cs.Contains(this->stringData[i]))
+			if (cs.Contains(data[i]))
 				return (long)i;
 		}
 	}
@@ -315,23 +344,12 @@ long DKStringW::FindAnyCharactersInSet(const CharacterSet& cs, long begin) const
 DKStringW DKStringW::Right(long index) const
 {
 	DKStringW string;
-	size_t len = Length();
-	if (index < (long)len)
+	if (index < (long)length)
 	{
 		if (index < 0)
 			index = 0;
 
-		int count = len - index;
-		if (count < 0)
-			count = 0;
-
-		DKUniCharW* tmp = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len+1) * sizeof(DKUniCharW));
-		memset(tmp, 0, sizeof(DKUniCharW) * (len+1));
-		wcsncpy(tmp, &stringData[index], count);
-
-		string = tmp;
-
-		DKMemoryDefaultAllocator::Free(tmp);
+		string.SetValue(&Data()[index], length - index);
 	}
 	return string;
 }
@@ -341,139 +359,107 @@ DKStringW DKStringW::Left(size_t count) const
 	DKStringW string;
 	if (count > 0)
 	{
-		size_t len = Length();
-		if (count > len)
-			count = len;
-
-		DKUniCharW* tmp = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len+1) * sizeof(DKUniCharW));
-		memset(tmp, 0 , sizeof(DKUniCharW) * (len+1));
-		wcsncpy(tmp, stringData, count);
-
-		string = tmp;
+		if (count > length)
+			count = length;
 
-		DKMemoryDefaultAllocator::Free(tmp);
+		string.SetValue(Data(), count);
 	}
 	return string;
 }
 
 DKStringW DKStringW::Mid(long index, size_t count) const
 {
-	DKStringW string = L"";
+	DKStringW string;
 
 	if (count == 0)
 		return string;
-	size_t len = Length();
-
-	if (count > 0 && index + count < len)
-	{
-		DKUniCharW* buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((count+1) * sizeof(DKUniCharW));
-		wcsncpy(buff, &stringData[index], count);
-		buff[count] = 0;
 
-		string = buff;
-
-		DKMemoryDefaultAllocator::Free(buff);
-	}
+	if (index + count < length)
+		string.SetValue(&Data()[index], count);
 	else
-	{
 		string = Right(index);
-	}
+
 	return string;
 }
 
 DKStringW DKStringW::LowercaseString(void) const
 {
-	if (stringData)
-	{
-		DKUniCharW *buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((Length()+1) * sizeof(DKUniCharW));
-		int i;
-		for (i = 0 ; stringData[i] != 0; ++i)
-		{
-			buff[i] = towlower(stringData[i]);
-		}
-		buff[i] = 0;
+	DKStringW ret;
+	ret.Reserve(length);
 
-		DKStringW ret = buff;
-		DKMemoryDefaultAllocator::Free(buff);
-		return ret;
-	}
-	return DKStringW(L"");			
+	const DKUniCharW* src = Data();
+	DKUniCharW* dst = ret.Data();
+	for (size_t i = 0; i < length; ++i)
+		dst[i] = towlower(src[i]);
+	ret.SetLength(length);
+	return ret;
 }
 
 DKStringW DKStringW::UppercaseString(void) const
 {
-	if (stringData)
-	{
-		DKUniCharW *buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((Length()+1) * sizeof(DKUniCharW));
-		int i;
-		for (i = 0 ; stringData[i] != 0; ++i)
-		{
-			buff[i] = towupper(stringData[i]);
-		}
-		buff[i] = 0;
+	DKStringW ret;
+	ret.Reserve(length);
 
-		DKStringW ret = buff;
-		DKMemoryDefaultAllocator::Free(buff);
-		return ret;
-	}
-	return DKStringW(L"");			
+	const DKUniCharW* src = Data();
+	DKUniCharW* dst = ret.Data();
+	for (size_t i = 0; i < length; ++i)
+		dst[i] = towupper(src[i]);
+	ret.SetLength(length);
+	return ret;
 }
 
 int DKStringW::Compare(const DKUniCharW* str) const
 {
-	return Private::CompareCaseSensitive(stringData, str);
+	return Private::CompareCaseSensitive(Data(), str);
 }
 
 int DKStringW::Compare(const DKStringW& str) const
 {
-	return Private::CompareCaseSensitive(stringData, str.stringData);
+	return Private::CompareCaseSensitive(Data(), str.Data());
 }
 
 int DKStringW::CompareNoCase(const DKUniCharW* str) const
 {
-	return Private::CompareCaseInsensitive(stringData, str);
+	return Private::CompareCaseInsensitive(Data(), str);
 }
 
 int DKStringW::CompareNoCase(const DKStringW& str) const
 {
-	return Private::CompareCaseInsensitive(stringData, str.stringData);
+	return Private::CompareCaseInsensitive(Data(), str.Data());
 }
 
 int DKStringW::Replace(const DKUniCharW c1, const DKUniCharW c2)
 {
-	if (!stringData)
+	if (length == 0)
 		return 0;
 	if (c1 == c2)
 		return 0;
 	int result = 0;
 	if (c1)
 	{
+		DKUniCharW* data = Data();
 		if (c2)
 		{
-			for (size_t i = 0; stringData[i]; ++i)
+			for (size_t i = 0; i < length; ++i)
 			{
-				if (stringData[i] == c1)
+				if (data[i] == c1)
 				{
-					stringData[i] = c2;
+					data[i] = c2;
 					++result;
 				}
 			}
 		}
 		else
 		{
-			size_t len = Length();
-			DKUniCharW* tmp = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len+1) * sizeof(DKUniCharW));
-			size_t tmpLen = 0;
-			for (size_t i = 0; stringData[i]; ++i)
+			size_t newLength = 0;
+			for (size_t i = 0; i < length; ++i)
 			{
-				if (stringData[i] == c1)
+				if (data[i] == c1)
 					++result;
 				else
-					tmp[tmpLen++] = stringData[i];
+					data[newLength++] = data[i];
 			}
-			tmp[tmpLen] = 0;
-			this->SetValue(tmp, tmpLen);
-			DKMemoryDefaultAllocator::Free(tmp);
+			SetLength(newLength);
 		}
 	}
 	return result;
@@ -483,29 +469,40 @@ int DKStringW::Replace(const DKUniCharW* strOld, const DKUniCharW* strNew)
 {
 	if (strOld == NULL || strOld[0] == 0)
 		return 0;
-	size_t len = Length();
-	if (len == 0)
+	if (length == 0)
 		return 0;
 
 	if (strNew == NULL)
 		strNew = L"";
 
 	size_t len1 = (size_t)wcslen(strOld);
+	size_t len2 = (size_t)wcslen(strNew);
 
-	if (len < len1)
+	if (length < len1)
 		return 0;
 
 	long index = Find(strOld);
 	if (index < 0)
 		return 0;
 
-	DKStringW prev = Left(index) + strNew;
-	DKStringW next = Right(index + len1);
+	// strNew can be part of this string, build result in another string.
+	DKStringW result;
+	result.Reserve(length);
 
-	int ret = next.Replace(strOld, strNew) + 1;
-
-	this->SetValue(prev + next);
+	const DKUniCharW* data = Data();
+	size_t begin = 0;
+	int ret = 0;
+	while (index >= 0)
+	{
+		result.Append(&data[begin], index - begin);
+		result.Append(strNew, len2);
+		begin = index + len1;
+		index = Find(strOld, begin);
+		++ret;
+	}
+	result.Append(&data[begin], length - begin);
 
+	*this = static_cast<DKStringW&&>(result);
 	return ret;
 }
 
@@ -519,33 +516,38 @@ DKStringW& DKStringW::Insert(long index, const DKUniCharW* str)
 	if (str == NULL)
 		return *this;
 
-	size_t len = Length();
-	if (index > (long)len)
+	if (index > (long)length)
 	{
 		return Append(str);
 	}
-	int newStrLen = (int)wcslen(str);
+	if (index < 0)
+		index = 0;
+
+	size_t newStrLen = wcslen(str);
 	if (newStrLen)
 	{
-		DKUniCharW* tmp = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len + newStrLen + 4) * sizeof(DKUniCharW));
-		memset(tmp, 0, sizeof(DKUniCharW) * (len + newStrLen + 4));
-		if (index > 0)
+		const DKUniCharW* data = Data();
+		if (str >= data && str <= &data[length])
 		{
-			wcsncpy(tmp, stringData, index);
+			// str is part of this string.
+			DKStringW tmp(str, newStrLen);
+			return Insert(index, (const DKUniCharW*)tmp);
 		}
-		wcscat(tmp, str);
-		wcscat(tmp, &stringData[index]);
 
-		this->SetValue(tmp);
+		Reserve(length + newStrLen);
 
-		DKMemoryDefaultAllocator::Free(tmp);;
+		DKUniCharW* buff = Data();
+		memmove(&buff[index + newStrLen], &buff[index], (length - index) * sizeof(DKUniCharW));
+		memcpy(&buff[index], str, newStrLen * sizeof(DKUniCharW));
+		SetLength(length + newStrLen);
 	}
 	return *this;
 }
 
 DKStringW& DKStringW::Insert(long index, DKUniCharW ch)
 {
-	return Insert(index, (const DKUniCharW*)DKStringW(ch));
+	DKUniCharW str[2] = {ch, 0};
+	return Insert(index, str);
 }
 
 DKStringW DKStringW::FilePathString(void) const
@@ -610,12 +612,12 @@ DKStringW::StringArray DKStringW::PathComponents(void) const
 bool DKStringW::IsWhitespaceCharacterAtIndex(long index) const
 {
 	DKASSERT_DEBUG(Length() > index);
-	return Private::WhitespaceCharacterSet().Contains(stringData[index]);
+	return Private::WhitespaceCharacterSet().Contains(Data()[index]);
 }
 
 DKStringW& DKStringW::TrimWhitespaces(void)
 {
-	size_t len = Length();
+	size_t len = length;
 	if (len == 0)
 		return *this;
 
@@ -640,14 +642,17 @@ DKStringW& DKStringW::TrimWhitespaces(void)
 		}
 		if (end >= begin)
 		{
-			DKStringW tmp = this->Mid(begin, end - begin + 1);
-			return SetValue(tmp);
+			DKUniCharW* data = Data();
+			size_t newLength = end - begin + 1;
+			if (begin > 0)
+				memmove(data, &data[begin], newLength * sizeof(DKUniCharW));
+			SetLength(newLength);
 		}
 	}
 	else
 	{
 		// string is whitespaces entirely.
-		return this->SetValue(L"");
+		SetLength(0);
 	}
 	return *this;
 }
@@ -656,8 +661,6 @@ DKStringW& DKStringW::RemoveWhitespaces(long begin, long count)
 {
 	begin = Max(begin, 0);
 
-	size_t length = Length();
-
 	if (begin >= length)
 		return *this;
 
@@ -669,40 +672,37 @@ DKStringW& DKStringW::RemoveWhitespaces(long begin, long count)
 	if (count <= 0)
 		return *this;
 
-	DKUniCharW* buffer = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((count+2) * sizeof(DKUniCharW));
-	size_t bufferIndex = 0;
-
-	for (long i = 0; i < count; i++)
+	DKUniCharW* data = Data();
+	size_t newLength = begin;
+	for (long i = begin; i < begin + count; i++)
 	{
-		if (!IsWhitespaceCharacterAtIndex(i + begin))
-		{
-			buffer[bufferIndex++] = stringData[i+begin];
-		}
+		if (!IsWhitespaceCharacterAtIndex(i))
+			data[newLength++] = data[i];
 	}
-	buffer[bufferIndex] = NULL;
-
-	DKStringW tmp = DKStringW(buffer) + Right(begin + count);
-
-	DKMemoryDefaultAllocator::Free(buffer);
+	size_t remains = length - (begin + count);
+	memmove(&data[newLength], &data[begin + count], remains * sizeof(DKUniCharW));
+	SetLength(newLength + remains);
 
-	return *this = tmp;
+	return *this;
 }
 
 bool DKStringW::HasPrefix(const DKStringW& str) const
 {
-	return str.Compare(this->Left( str.Length() )) == 0;
+	return str.length <= length &&
+		memcmp(Data(), str.Data(), str.length * sizeof(DKUniCharW)) == 0;
 }
 
 bool DKStringW::HasSuffix(const DKStringW& str) const
 {
-	return str.Compare(this->Right( this->Length() - str.Length() )) == 0;
+	return str.length <= length &&
+		memcmp(&Data()[length - str.length], str.Data(), str.length * sizeof(DKUniCharW)) == 0;
 }
 
 DKStringW& DKStringW::RemovePrefix(const DKStringW& str)
 {
 	if (HasPrefix(str))
 	{
-		this->SetValue( this->Right( str.Length() ) );
+		this->SetValue(&Data()[str.length], length - str.length);
 	}
 	return *this;
 }
@@ -711,43 +711,39 @@ DKStringW& DKStringW::RemoveSuffix(const DKStringW& str)
 {
 	if (HasSuffix(str))
 	{
-		this->SetValue( this->Left( this->Length() - str.Length()) );
+		SetLength(length - str.length);
 	}
 	return *this;
 }
 
 DKStringW& DKStringW::Append(const DKStringW& str)
 {
-	return Append((const DKUniCharW*)str);
+	return Append(str.Data(), str.length);
 }
 
 DKStringW& DKStringW::Append(const DKUniCharW* str, size_t len)
 {
 	if (str && str[0])
 	{
-		size_t len1 = Length();
 		size_t len2 = 0;
-		for (len2 = 0; str[len2] && len2 < len; len2++) {}
-
-		size_t totalLen = len1 + len2;
+		for (len2 = 0; len2 < len && str[len2]; len2++) {}
 
-		if (totalLen > 0)
+		if (len2 > 0)
 		{
-			DKUniCharW* buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len1 + len2 + 1) * sizeof(DKUniCharW));
-			memset(buff, 0, sizeof(DKUniCharW) * (len1 + len2 + 1));
-
-			if (stringData && stringData[0])
+			const DKUniCharW* data = Data();
+			if (str >= data && str <= &data[length])
 			{
-				wcscat(buff, stringData);
-				//wcscat_s(pNewBuff, nLen+nLen2+4, stringData);
+				// str is part of this string, buffer can be reallocated.
+				size_t offset = str - data;
+				Reserve(length + len2);
+				str = &Data()[offset];
 			}
-
-			wcscat(buff, str);
-			//wcscat_s(pNewBuff, nLen+nLen2+4, str);
-
-			if (stringData)
-				DKMemoryDefaultAllocator::Free(stringData);
-			stringData = buff;
+			else
+			{
+				Reserve(length + len2);
+			}
+			memcpy(&Data()[length], str, len2 * sizeof(DKUniCharW));
+			SetLength(length + len2);
 		}
 	}
 	return *this;
@@ -755,9 +751,25 @@ DKStringW& DKStringW::Append(const DKUniCharW* str, size_t len)
 
 DKStringW& DKStringW::Append(const DKUniChar8* str, size_t len)
 {
-	DKStringW s = L"";
-	DKStringSetValue(s, str, len);
-	return this->Append(s);
+	if (str && str[0])
+	{
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (str[i] == 0)
+			{
+				len = i;
+				break;
+			}
+		}
+		// number of characters cannot exceed number of UTF-8 bytes.
+		Reserve(length + len);
+		size_t converted = Private::ConvertUTF8ToWideChars(str, len, &Data()[length]);
+		if (converted == (size_t)-1)
+			SetLength(length);		// invalid input, restore null-terminator.
+		else
+			SetLength(length + converted);
+	}
+	return *this;
 }
 
 DKStringW& DKStringW::Append(const void* str, size_t bytes, DKStringEncoding e)
@@ -769,62 +781,48 @@ DKStringW& DKStringW::Append(const void* str, size_t bytes, DKStringEncoding e)
 
 DKStringW& DKStringW::SetValue(const DKStringW& str)
 {
-	if (str.stringData == this->stringData)
+	if (&str == this)
 		return *this;
 
-	if (this->stringData)
-		DKMemoryDefaultAllocator::Free(this->stringData);
-	this->stringData = NULL;
-
-	size_t len = str.Length();
-	if (len > 0)
-	{
-		DKASSERT_DEBUG(str.stringData != NULL);
-		this->stringData = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len+1) * sizeof(DKUniCharW));
-		wcscpy(this->stringData, str.stringData);
-	}
+	Reserve(str.length);
+	memcpy(Data(), str.Data(), (str.length + 1) * sizeof(DKUniCharW));
+	length = str.length;
 	return *this;
 }
 
 DKStringW& DKStringW::SetValue(const DKUniCharW* str, size_t len)
 {
-	if (str == stringData && len >= this->Length())
-		return *this;
+	if (str == NULL)
+		len = 0;
 
-	DKUniCharW* buff = NULL;
-	if (str && str[0])
+	for (size_t i = 0; i < len; ++i)
 	{
-		for (size_t i = 0; i < len; ++i)
-		{
-			if (str[i] == 0)
-			{
-				len = i;
-				break;
-			}
-		}
-
-		if (len > 0)
+		if (str[i] == 0)
 		{
-			buff = (DKUniCharW*)DKMemoryDefaultAllocator::Alloc((len+1) * sizeof(DKUniCharW));
-			memcpy(buff, str, len * sizeof(DKUniCharW));
-			buff[len] = NULL;
+			len = i;
+			break;
 		}
 	}
-	if (stringData)
-		DKMemoryDefaultAllocator::Free(stringData);
-	stringData = buff;
 
+	DKUniCharW* data = Data();
+	if (str >= data && str <= &data[length])
+	{
+		// str is part of this string.
+		memmove(data, str, len * sizeof(DKUniCharW));
+	}
+	else if (len > 0)
+	{
+		Reserve(len);
+		memcpy(Data(), str, len * sizeof(DKUniCharW));
+	}
+	SetLength(len);
 	return *this;
 }
 
 DKStringW& DKStringW::SetValue(const DKUniChar8* str, size_t len)
 {
-	if (str && str[0])
-		DKStringSetValue(*this, str, len);
-	else
-		SetValue((const DKUniCharW*)NULL, 0);
-
-	return *this;
+	SetLength(0);
+	return Append(str, len);
 }
 
 DKStringW& DKStringW::SetValue(const void* str, size_t bytes, DKStringEncoding e)
@@ -838,11 +836,16 @@ DKStringW& DKStringW::operator = (DKStringW&& str)
 {
 	if (this != &str)
 	{
-		if (stringData)
-			DKMemoryDefaultAllocator::Free(stringData);
+		if (capacity)
+			DKMemoryDefaultAllocator::Free(heapData);
 
-		stringData = str.stringData;
-		str.stringData = NULL;
+		length = str.length;
+		capacity = str.capacity;
+		memcpy(inlineData, str.inlineData, sizeof(inlineData));
+
+		str.length = 0;
+		str.capacity = 0;
+		str.inlineData[0] = 0;
 	}
 	return *this;
 }
@@ -877,8 +880,8 @@ DKStringW& DKStringW::operator = (DKUniChar8 ch)
 // conversion operators
 DKStringW::operator const DKUniCharW*(void) const
 {
-	if (this && this->stringData)
-		return (const DKUniCharW*)this->stringData;
+	if (this)
+		return Data();
 	return L"";
 }
 
@@ -908,29 +911,68 @@ DKStringW& DKStringW::operator += (DKUniChar8 ch)
 	return Append(&ch, 1);
 }
 
-DKStringW DKStringW::operator + (const DKStringW& str) const
+DKStringW DKStringW::operator + (const DKStringW& str) const &
+{
+	DKStringW s;
+	s.Reserve(length + str.length);
+	s.SetValue(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringW DKStringW::operator + (const DKUniCharW* str) const &
+{
+	DKStringW s;
+	s.Reserve(length + (str ? wcslen(str) : 0));
+	s.SetValue(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringW DKStringW::operator + (const DKUniChar8* str) const &
+{
+	DKStringW s(*this);
+	s.Append(str);
+	return s;
+}
+
+DKStringW DKStringW::operator + (DKUniCharW c) const &
+{
+	DKStringW s(*this);
+	s.Append(&c, 1);
+	return s;
+}
+
+DKStringW DKStringW::operator + (DKUniChar8 c) const &
+{
+	DKStringW s(*this);
+	s.Append(&c, 1);
+	return s;
+}
+
+DKStringW DKStringW::operator + (const DKStringW& str) &&
 {
-	return DKStringW(*this).Append(str);
+	return static_cast<DKStringW&&>(this->Append(str));
 }
 
-DKStringW DKStringW::operator + (const DKUniCharW* str) const
+DKStringW DKStringW::operator + (const DKUniCharW* str) &&
 {
-	return DKStringW(*this).Append(str);
+	return static_cast<DKStringW&&>(this->Append(str));
 }
 
-DKStringW DKStringW::operator + (const DKUniChar8* str) const
+DKStringW DKStringW::operator + (const DKUniChar8* str) &&
 {
-	return DKStringW(*this).Append(str);
+	return static_cast<DKStringW&&>(this->Append(str));
 }
 
-DKStringW DKStringW::operator + (DKUniCharW c) const
+DKStringW DKStringW::operator + (DKUniCharW c) &&
 {
-	return DKStringW(*this).Append(&c, 1);
+	return static_cast<DKStringW&&>(this->Append(&c, 1));
 }
 
-DKStringW DKStringW::operator + (DKUniChar8 c) const
+DKStringW DKStringW::operator + (DKUniChar8 c) &&
 {
-	return DKStringW(*this).Append(&c, 1);
+	return static_cast<DKStringW&&>(this->Append(&c, 1));
 }
 
 DKObject<DKData> DKStringW::Encode(DKStringEncoding e) const
@@ -942,22 +984,22 @@ DKObject<DKData> DKStringW::Encode(DKStringEncoding e) const
 
 long long DKStringW::ToInteger(void) const
 {
-	if (stringData && stringData[0])
-		return wcstoll(stringData, 0, 0);
+	if (length > 0)
+		return wcstoll(Data(), 0, 0);
 	return 0LL;
 }
 
 unsigned long long DKStringW::ToUnsignedInteger(void) const
 {
-	if (stringData && stringData[0])
-		return wcstoull(stringData, 0, 0);
+	if (length > 0)
+		return wcstoull(Data(), 0, 0);
 	return 0ULL;
 }
 
 double DKStringW::ToRealNumber(void) const
 {
-	if (stringData && stringData[0])
-		return wcstod(stringData, 0);
+	if (length > 0)
+		return wcstod(Data(), 0);
 	return 0.0;
 }
 
@@ -1013,14 +1055,14 @@ DKStringW::StringArray DKStringW::Split(const DKStringW& delimiter, bool ignoreE
 		{
 			DKStringW subString = this->Mid(begin, next - begin);
 			if (ignoreEmptyString == false || subString.Length() > 0)
-				strings.Add(this->Mid(begin, next - begin));
+				strings.Add(static_cast<DKStringW&&>(subString));
 			begin = next + dlen;
 		}
 		else
 		{
 			DKStringW subString = this->Right(begin);
 			if (subString.Length() > 0)
-				strings.Add(subString);
+				strings.Add(static_cast<DKStringW&&>(subString));
 			break;
 		}
 	}
@@ -1046,14 +1088,14 @@ DKStringW::StringArray DKStringW::SplitByCharactersInSet(const CharacterSet& cs,
 		{
 			DKStringW subString = this->Mid(begin, next - begin);
 			if (ignoreEmptyString == false || subString.Length() > 0)
-				strings.Add(subString);
+				strings.Add(static_cast<DKStringW&&>(subString));
 			begin = next + 1;
 		}
 		else
 		{
 			DKStringW subString = this->Right(begin);
 			if (subString.Length() > 0)
-				strings.Add(subString);
+				strings.Add(static_cast<DKStringW&&>(subString));
 			break;
 		}
 	}
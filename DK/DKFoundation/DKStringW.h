@@ -18,6 +18,12 @@
 // a unicode string class with wchar_t character string.
 // UTF-8, CP367 (ISO-8859, ASCII) are available also.
 // (but convert and store with wchar_t string internally.)
+//
+// short strings (shorter than InlineCapacity) are stored in object itself,
+// no heap allocation. longer strings are stored in heap buffer which grows
+// geometrically, buffer is kept when string become shorter.
+// length is cached, Length() is O(1).
+// object does not point itself, it can be relocated by memcpy. (DKArray)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -60,6 +66,8 @@ namespace DKFoundation
 
 		size_t Length(void) const;
 		size_t Bytes(void) const;
+		// reserve buffer for 'len' characters (without null-terminator).
+		void Reserve(size_t len);
 
 		long Find(DKUniCharW c, long begin = 0) const;
 		long Find(const DKUniCharW* str, long begin = 0) const;
@@ -131,11 +139,17 @@ namespace DKFoundation
 		DKStringW& operator += (const DKUniChar8* str);
 		DKStringW& operator += (DKUniCharW ch);
 		DKStringW& operator += (DKUniChar8 ch);
-		DKStringW operator + (const DKStringW& str) const;
-		DKStringW operator + (const DKUniCharW* str) const;
-		DKStringW operator + (const DKUniChar8* str) const;
-		DKStringW operator + (DKUniCharW c) const;
-		DKStringW operator + (DKUniChar8 c) const;
+		DKStringW operator + (const DKStringW& str) const &;
+		DKStringW operator + (const DKUniCharW* str) const &;
+		DKStringW operator + (const DKUniChar8* str) const &;
+		DKStringW operator + (DKUniCharW c) const &;
+		DKStringW operator + (DKUniChar8 c) const &;
+		// concatenation of temporary object appends to itself.
+		DKStringW operator + (const DKStringW& str) &&;
+		DKStringW operator + (const DKUniCharW* str) &&;
+		DKStringW operator + (const DKUniChar8* str) &&;
+		DKStringW operator + (DKUniCharW c) &&;
+		DKStringW operator + (DKUniChar8 c) &&;
 
 		// comparison operators
 		bool operator > (const DKStringW& str) const			{return Compare(str) > 0;}
@@ -166,6 +180,18 @@ namespace DKFoundation
 		StringArray SplitByWhitespace(void) const;
 
 	private:
-		DKUniCharW* stringData;
+		enum : size_t { InlineCapacity = (64 - sizeof(size_t) * 2) / sizeof(DKUniCharW) };	// including null-terminator.
+
+		DKUniCharW* Data(void)				{ return capacity ? heapData : inlineData; }
+		const DKUniCharW* Data(void) const	{ return capacity ? heapData : inlineData; }
+		void SetLength(size_t len)			{ length = len; Data()[len] = 0; }
+
+		size_t length;		// number of characters, without null-terminator.
+		size_t capacity;	// capacity of heapData, 0 if string stored inline.
+		union
+		{
+			DKUniCharW* heapData;
+			DKUniCharW inlineData[InlineCapacity];
+		};
 	};
 }
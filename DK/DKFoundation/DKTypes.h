@@ -42,6 +42,17 @@ namespace DKFoundation
 		template <typename U> constexpr static bool IsBaseOf()	{return __is_base_of(U, T);} // __is_base_of(base, derived)
 	};
 
+	// relocation traits for container (DKArray).
+	// items are relocated bitwise (realloc, memmove) by default.
+	// specialize this with IsBitwiseRelocatable = false, for type which
+	// cannot be relocated bitwise. (ex: object holds pointer of itself)
+	// then items will be relocated with move-constructor and destructor.
+	// NOTE: DKStaticArray (Sort, Swap, Rotate), DKQueue relocate bitwise always.
+	template <typename T> struct DKRelocationTraits
+	{
+		enum {IsBitwiseRelocatable = true};
+	};
+
 	// type number
 	template <int i> struct DKNumber {enum {Value = i};	};
 	// boolean type value (for SFINAE)
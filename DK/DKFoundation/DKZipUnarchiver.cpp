@@ -10,6 +10,10 @@
 #include "DKZipUnarchiver.h"
 #include "DKString.h"
 #include "DKLog.h"
+#include "DKHash.h"
+#include "DKFileMap.h"
+#include "DKDataStream.h"
+#include "DKFunction.h"
 
 namespace DKFoundation
 {
@@ -23,9 +27,9 @@ namespace DKFoundation
 		class UnZipFile : public DKStream
 		{
 		public:
-			static DKObject<UnZipFile> Create(const DKString& zipFile, const DKString& file, const char* password)
+			static DKObject<UnZipFile> Create(const DKString& zipFile, const unz64_file_pos& pos, const DKString& file, const char* password)
 			{
-				if (zipFile.Length() == 0 || file.Length() == 0)
+				if (zipFile.Length() == 0)
 					return NULL;
 
 				DKString filename = zipFile.FilePathString();
@@ -47,9 +51,7 @@ namespace DKFoundation
 				if (uf)
 				{
 					unz_file_info64 file_info;
-					DKStringU8 fileUTF8(file);
-					if (fileUTF8.Bytes() > 0 &&
-						unzLocateFile(uf, (const char*)fileUTF8, 0) == UNZ_OK &&
+					if (unzGoToFilePos64(uf, &pos) == UNZ_OK &&
 						unzGetCurrentFileInfo64(uf, &file_info, NULL, 0, NULL, 0, NULL, 0) == UNZ_OK &&
 						file_info.uncompressed_size > 0)
 					{
@@ -63,6 +65,7 @@ namespace DKFoundation
 							DKLog("[%s] failed to open file: %ls.\n", DKGL_FUNCTION_NAME, (const wchar_t*)file);
 						}
 					}
+					unzClose(uf);
 				}
 				return NULL;
 			}
@@ -164,23 +167,298 @@ namespace DKFoundation
 			const unz_file_info64	fileInfo;
 			DKArray<char>			password;
 		};
+
+		// decompress deflated file from mapped archive data.
+		// decompression state is copied at every CheckpointInterval bytes of
+		// output, seeking backward resumes from nearest checkpoint instead of
+		// beginning of file.
+		class InflateFile : public DKStream
+		{
+		public:
+			enum : size_t { CheckpointInterval = 0x100000 };
+
+			static DKObject<InflateFile> Create(DKData* archive, const unsigned char* data, uint64_t compressedSize, uint64_t uncompressedSize)
+			{
+				DKObject<InflateFile> p = DKOBJECT_NEW InflateFile(archive, data, compressedSize, uncompressedSize);
+				if (inflateInit2(&p->stream, -MAX_WBITS) == Z_OK)
+				{
+					p->initialized = true;
+					p->ResetInput();
+					return p;
+				}
+				return NULL;
+			}
+			~InflateFile(void)
+			{
+				for (Checkpoint& cp : checkpoints)
+				{
+					inflateEnd(cp.stream);
+					delete cp.stream;
+				}
+				if (initialized)
+					inflateEnd(&stream);
+				archive->UnlockShared();
+			}
+			Position SetPos(Position p)
+			{
+				if (p == position)
+					return p;
+				if (p < 0 || static_cast<uint64_t>(p) > uncompressedSize)
+					return -1;
+
+				// resume from checkpoint, if it is closer than current position.
+				size_t index = p / CheckpointInterval;
+				if (p < position || (index > 0 && index <= checkpoints.Count() && checkpoints.Value(index - 1).position > position))
+				{
+					if (!RestoreCheckpoint(Min(index, checkpoints.Count())))
+						return -1;
+				}
+				if (!Skip(p - position))
+					return -1;
+				return position;
+			}
+			Position GetPos(void) const
+			{
+				return position;
+			}
+			Position RemainLength(void) const
+			{
+				return uncompressedSize - position;
+			}
+			Position TotalLength(void) const
+			{
+				return uncompressedSize;
+			}
+			size_t Read(void* p, size_t s)
+			{
+				if (s == 0 || p == NULL)
+					return 0;
+
+				unsigned char* cp = reinterpret_cast<unsigned char*>(p);
+				size_t totalRead = 0;
+				while (s > 0 && !finished && static_cast<uint64_t>(position) < uncompressedSize)
+				{
+					// stop at next checkpoint to copy state.
+					uint64_t nextCheckpoint = static_cast<uint64_t>(checkpoints.Count() + 1) * CheckpointInterval;
+					size_t toRead = s;
+					if (nextCheckpoint > static_cast<uint64_t>(position))
+						toRead = static_cast<size_t>(Min(static_cast<uint64_t>(toRead), nextCheckpoint - static_cast<uint64_t>(position)));
+					toRead = Min(toRead, static_cast<size_t>(0x7fffffff));
+
+					if (stream.avail_in == 0)
+						FillInput();
+
+					stream.next_out = cp + totalRead;
+					stream.avail_out = static_cast<uInt>(toRead);
+					int err = inflate(&stream, Z_NO_FLUSH);
+					size_t numRead = toRead - stream.avail_out;
+					s -= numRead;
+					totalRead += numRead;
+					position += numRead;
+
+					if (err == Z_STREAM_END)
+						finished = true;
+					else if (err != Z_OK && !(err == Z_BUF_ERROR && numRead > 0))
+					{
+						DKLog("[%s] inflate failed: %d\n", DKGL_FUNCTION_NAME, err);
+						break;
+					}
+
+					if (static_cast<uint64_t>(position) == nextCheckpoint)
+						SaveCheckpoint();
+				}
+				return totalRead;
+			}
+			size_t Write(const void* p, size_t s)
+			{
+				return 0;
+			}
+
+			bool IsReadable(void) const	{return true;}
+			bool IsWritable(void) const	{return false;}
+			bool IsSeekable(void) const	{return true;}
+		protected:
+			InflateFile(DKData* a, const unsigned char* d, uint64_t cs, uint64_t us)
+				: archive(a)
+				, data(d)
+				, compressedSize(cs)
+				, uncompressedSize(us)
+				, position(0)
+				, finished(false)
+				, initialized(false)
+			{
+				DKASSERT_DEBUG(archive != NULL);
+				archive->LockShared();
+				memset(&stream, 0, sizeof(stream));
+			}
+		private:
+			struct Checkpoint
+			{
+				Position position;
+				z_stream* stream;
+			};
+			void ResetInput(void)
+			{
+				stream.next_in = const_cast<unsigned char*>(data);
+				stream.avail_in = 0;
+				FillInput();
+			}
+			void FillInput(void)
+			{
+				// input can be larger than uInt.
+				uint64_t consumed = stream.next_in - data;
+				stream.avail_in = static_cast<uInt>(Min(compressedSize - consumed, static_cast<uint64_t>(0x7fffffff)));
+			}
+			void SaveCheckpoint(void)
+			{
+				z_stream* copy = new z_stream;
+				if (inflateCopy(copy, &stream) == Z_OK)
+				{
+					Checkpoint cp = { position, copy };
+					checkpoints.Add(cp);
+				}
+				else
+					delete copy;
+			}
+			bool RestoreCheckpoint(size_t index)
+			{
+				finished = false;
+				if (index == 0)
+				{
+					if (inflateReset(&stream) != Z_OK)
+						return false;
+					ResetInput();
+					position = 0;
+					return true;
+				}
+				const Checkpoint& cp = checkpoints.Value(index - 1);
+				inflateEnd(&stream);
+				initialized = inflateCopy(&stream, cp.stream) == Z_OK;
+				if (!initialized)
+					return false;
+				position = cp.position;
+				return true;
+			}
+			bool Skip(uint64_t length)
+			{
+				if (length == 0)
+					return true;
+				size_t bufferSize = static_cast<size_t>(Min(length, static_cast<uint64_t>(0x10000)));
+				void* tmp = DKMemoryDefaultAllocator::Alloc(bufferSize);
+				while (length > 0)
+				{
+					size_t numRead = Read(tmp, static_cast<size_t>(Min(length, static_cast<uint64_t>(bufferSize))));
+					if (numRead == 0)
+						break;
+					length -= numRead;
+				}
+				DKMemoryDefaultAllocator::Free(tmp);
+				return length == 0;
+			}
+
+			DKObject<DKData>		archive;	// locked while stream is alive.
+			const unsigned char*	data;		// compressed data in archive
+			const uint64_t			compressedSize;
+			const uint64_t			uncompressedSize;
+			z_stream				stream;
+			Position				position;
+			bool					finished;
+			bool					initialized;
+			DKArray<Checkpoint>		checkpoints;
+		};
+
+		// read little-endian value from archive data.
+		template <typename T> inline T ReadZipValue(const unsigned char* p)
+		{
+			T value = 0;
+			for (size_t i = 0; i < sizeof(T); ++i)
+				value |= static_cast<T>(p[i]) << (i * 8);
+			return value;
+		}
+
+		// locate file data in mapped archive with central directory entry.
+		// returns NULL if archive has prefixed data (self-extracting) or data is invalid.
+		static const unsigned char* LocateZipFileData(const unsigned char* archive, uint64_t archiveLength, uint64_t directoryOffset, uint64_t compressedSize)
+		{
+			enum : uint32_t
+			{
+				CentralHeaderSignature = 0x02014b50,
+				CentralHeaderSize = 46,
+				LocalHeaderSignature = 0x04034b50,
+				LocalHeaderSize = 30,
+			};
+
+			if (directoryOffset + CentralHeaderSize > archiveLength)
+				return NULL;
+			const unsigned char* entry = archive + directoryOffset;
+			if (ReadZipValue<uint32_t>(entry) != CentralHeaderSignature)
+				return NULL;
+
+			uint64_t uncompressed = ReadZipValue<uint32_t>(&entry[24]);
+			uint64_t compressed = ReadZipValue<uint32_t>(&entry[20]);
+			uint64_t localHeaderOffset = ReadZipValue<uint32_t>(&entry[42]);
+			uint16_t nameLength = ReadZipValue<uint16_t>(&entry[28]);
+			uint16_t extraLength = ReadZipValue<uint16_t>(&entry[30]);
+			if (directoryOffset + CentralHeaderSize + nameLength + extraLength > archiveLength)
+				return NULL;
+
+			if (localHeaderOffset == 0xffffffff)
+			{
+				// zip64 extended information, fields are stored only if original value is 0xffffffff.
+				const unsigned char* extra = entry + CentralHeaderSize + nameLength;
+				const unsigned char* extraEnd = extra + extraLength;
+				while (extra + 4 <= extraEnd)
+				{
+					uint16_t tag = ReadZipValue<uint16_t>(extra);
+					uint16_t size = ReadZipValue<uint16_t>(&extra[2]);
+					const unsigned char* field = extra + 4;
+					if (field + size > extraEnd)
+						break;
+					if (tag == 0x0001)
+					{
+						const unsigned char* fieldEnd = field + size;
+						if (uncompressed == 0xffffffff)		field += 8;
+						if (compressed == 0xffffffff)		field += 8;
+						if (field + 8 <= fieldEnd)
+							localHeaderOffset = ReadZipValue<uint64_t>(field);
+						break;
+					}
+					extra = field + size;
+				}
+				if (localHeaderOffset == 0xffffffff)
+					return NULL;
+			}
+
+			if (localHeaderOffset + LocalHeaderSize > archiveLength)
+				return NULL;
+			const unsigned char* local = archive + localHeaderOffset;
+			if (ReadZipValue<uint32_t>(local) != LocalHeaderSignature)
+				return NULL;
+
+			uint64_t dataOffset = localHeaderOffset + LocalHeaderSize + ReadZipValue<uint16_t>(&local[26]) + ReadZipValue<uint16_t>(&local[28]);
+			if (dataOffset + compressedSize > archiveLength)
+				return NULL;
+			return archive + dataOffset;
+		}
+
+		static uint32_t ZipFileNameHash(const DKString& name)
+		{
+			DKString lower = name.LowercaseString();
+			return DKHashCRC32((const DKUniCharW*)lower, lower.Length() * sizeof(DKUniCharW)).digest[0];
+		}
 	}
 }
 
 using namespace DKFoundation;
 
 DKZipUnarchiver::DKZipUnarchiver(void)
-: zipHandle(NULL)
 {
 }
 
 DKZipUnarchiver::~DKZipUnarchiver(void)
 {
-	if (zipHandle)
-	{
-		if (unzClose(zipHandle) != UNZ_OK)
-			DKERROR_THROW_DEBUG("unzClose failed!");
-	}
+	if (archiveData)
+		archiveData->UnlockShared();
 }
 
 DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
@@ -207,16 +485,21 @@ DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
 	if (uf)
 	{
 		DKArray<FileInfo>	filesArray;
+		DKArray<FileLocation> locationsArray;
 		unz_global_info64 gi;
 		int err = unzGetGlobalInfo64(uf,&gi);
 		if (err == UNZ_OK)
 		{
 			filesArray.Reserve(gi.number_entry);
+			locationsArray.Reserve(gi.number_entry);
 			for (int i = 0; i < gi.number_entry; i++)
 			{
 				DKUniChar8 filename_inzip[1024];
 				unz_file_info64 file_info;
+				unz64_file_pos file_pos;
 				err = unzGetCurrentFileInfo64(uf,&file_info,filename_inzip,sizeof(filename_inzip),NULL,0,NULL,0);
+				if (err == UNZ_OK)
+					err = unzGetFilePos64(uf, &file_pos);
 				if (err == UNZ_OK)
 				{
 					FileInfo	file;
@@ -254,6 +537,9 @@ DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
 						file.crc32 = file_info.crc;
 						file.date = DKDateTime(file_info.tmu_date.tm_year, file_info.tmu_date.tm_mon, file_info.tmu_date.tm_mday, file_info.tmu_date.tm_hour, file_info.tmu_date.tm_min, file_info.tmu_date.tm_sec, 0);
 						filesArray.Add(file);
+
+						FileLocation loc = { file_pos.pos_in_zip_directory, file_pos.num_of_file };
+						locationsArray.Add(loc);
 					}
 				}
 				else
@@ -267,14 +553,37 @@ DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
 				if (err != UNZ_OK)
 				{
 					DKLog("error %d with zipfile in unzGoToNextFile\n",err);
+					unzClose(uf);
 					return NULL;
 				}
 			}
+			unzClose(uf);
+
+			// build hash index, sorted by hash and file order.
+			DKArray<FileHash> hashes;
+			hashes.Reserve(filesArray.Count());
+			for (size_t i = 0; i < filesArray.Count(); ++i)
+			{
+				FileHash fh = { Private::ZipFileNameHash(filesArray.Value(i).name), static_cast<uint32_t>(i) };
+				hashes.Add(fh);
+			}
+			hashes.Sort([](const FileHash& lhs, const FileHash& rhs)
+			{
+				if (lhs.hash == rhs.hash)
+					return lhs.index < rhs.index;
+				return lhs.hash < rhs.hash;
+			});
 
 			DKObject<DKZipUnarchiver> unarchiver = DKObject<DKZipUnarchiver>::New();
-			unarchiver->zipHandle = uf;
 			unarchiver->filename = filename;
-			unarchiver->files = filesArray;
+			unarchiver->files = static_cast<DKArray<FileInfo>&&>(filesArray);
+			unarchiver->locations = static_cast<DKArray<FileLocation>&&>(locationsArray);
+			unarchiver->fileHashes = static_cast<DKArray<FileHash>&&>(hashes);
+
+			// map entire archive, files are read from mapped memory if possible.
+			DKObject<DKFileMap> map = DKFileMap::Open(filename, 0, false);
+			if (map && map->LockShared())
+				unarchiver->archiveData = map.SafeCast<DKData>();
 
 			return unarchiver;
 		}
@@ -282,6 +591,7 @@ DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
 		{
 			DKLog("[%s] error %d with file: %ls.\n", DKGL_FUNCTION_NAME, err, (const wchar_t*)file);
 		}
+		unzClose(uf);
 	}
 	else
 	{
@@ -291,29 +601,88 @@ DKObject<DKZipUnarchiver> DKZipUnarchiver::Create(const DKString& file)
 	return NULL;
 }
 
-const DKZipUnarchiver::FileInfo* DKZipUnarchiver::GetFileInfo(const DKString& file) const
+long DKZipUnarchiver::FindFileIndex(const DKString& file) const
 {
-	for (int i = 0; i < files.Count(); i++)
+	uint32_t hash = Private::ZipFileNameHash(file);
+
+	// first entry of hash
+	size_t begin = 0;
+	size_t count = fileHashes.Count();
+	while (count > 0)
+	{
+		size_t mid = count / 2;
+		if (fileHashes.Value(begin + mid).hash < hash)
+		{
+			begin += mid + 1;
+			count -= mid + 1;
+		}
+		else
+			count = mid;
+	}
+
+	// exact matched file first, case-insensitive matched file otherwise.
+	long found = -1;
+	for (size_t i = begin; i < fileHashes.Count() && fileHashes.Value(i).hash == hash; ++i)
 	{
-		if (file.CompareNoCase(files.Value(i).name) == 0)
-			return &(files.Value(i));
+		const FileInfo& info = files.Value(fileHashes.Value(i).index);
+		if (file.Compare(info.name) == 0)
+			return fileHashes.Value(i).index;
+		if (found < 0 && file.CompareNoCase(info.name) == 0)
+			found = fileHashes.Value(i).index;
 	}
+	return found;
+}
+
+const DKZipUnarchiver::FileInfo* DKZipUnarchiver::GetFileInfo(const DKString& file) const
+{
+	long index = FindFileIndex(file);
+	if (index >= 0)
+		return &(files.Value(index));
 	return NULL;
 }
 
 DKObject<DKStream> DKZipUnarchiver::OpenFileStream(const DKString& file, const char* password) const
 {
-	// check file is exists, open if file exists.
-	DKStringU8 fileUTF8(file);
+	long index = FindFileIndex(file);
+	if (index < 0)
+		return NULL;
 
-	unz_file_info64 file_info;
+	const FileInfo& info = files.Value(index);
+	const FileLocation& loc = locations.Value(index);
+	if (info.directory || info.uncompressedSize == 0)
+		return NULL;
 
-	if (fileUTF8.Bytes() > 0 &&
-		unzLocateFile(zipHandle, (const char*)fileUTF8, 0) == UNZ_OK &&
-		unzGetCurrentFileInfo64(zipHandle, &file_info, NULL, 0, NULL, 0, NULL, 0) == UNZ_OK &&
-		file_info.uncompressed_size > 0)
+	if (archiveData && !info.crypted && (info.method == MethodStored || info.method == MethodDeflated))
 	{
-		return Private::UnZipFile::Create(filename, file, password).SafeCast<DKStream>();
+		// archive is locked by unarchiver, pointer is valid while archive is alive.
+		DKObject<DKData> archive = archiveData;
+		const unsigned char* base = reinterpret_cast<const unsigned char*>(archive->LockShared());
+		const unsigned char* data = Private::LocateZipFileData(base, archive->Length(), loc.directoryOffset, info.compressedSize);
+		archive->UnlockShared();
+
+		if (data)
+		{
+			if (info.method == MethodStored)
+			{
+				if (info.compressedSize == info.uncompressedSize)
+				{
+					// zero-copy, archive is unlocked when content released.
+					archive->LockShared();
+					DKObject<DKData> content = DKData::StaticData(data, info.uncompressedSize, true,
+						DKFunction([archive]() { archive->UnlockShared(); })->Invocation());
+					return DKOBJECT_NEW DKDataStream(content);
+				}
+			}
+			else
+			{
+				DKObject<DKStream> stream = Private::InflateFile::Create(archive, data, info.compressedSize, info.uncompressedSize).SafeCast<DKStream>();
+				if (stream)
+					return stream;
+			}
+		}
 	}
-	return NULL;
+
+	// open with separated handle.
+	unz64_file_pos pos = { loc.directoryOffset, loc.fileNumber };
+	return Private::UnZipFile::Create(filename, pos, file, password).SafeCast<DKStream>();
 }
@@ -12,11 +12,20 @@
 #include "DKDateTime.h"
 #include "DKArray.h"
 #include "DKStream.h"
+#include "DKData.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // DKZipUnarchiver
 // a zip file reader.
 // read and decompress from zip-archive file.
+//
+// central directory is indexed with hash of file name when archive opened,
+// file stream opened without scanning directory.
+// archive file is mapped to memory, stored (not compressed) file is provided
+// as DKDataStream with mapped memory (zero-copy, see DKDataStream::DataSource)
+// and deflated file is decompressed from mapped memory, with checkpoints for
+// random access.
+// crypted or other compressed files are opened with separated zip handle.
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFoundation
@@ -56,8 +65,22 @@ namespace DKFoundation
 
 		const DKString& GetArchiveName(void) const		{return filename;}
 	private:
-		void*							zipHandle;
+		struct FileLocation		// location of file in central directory.
+		{
+			uint64_t	directoryOffset;
+			uint64_t	fileNumber;
+		};
+		struct FileHash
+		{
+			uint32_t	hash;
+			uint32_t	index;
+		};
+		long FindFileIndex(const DKString& file) const;
+
 		DKArray<FileInfo>				files;
+		DKArray<FileLocation>			locations;	// same order with files
+		DKArray<FileHash>				fileHashes;	// sorted by hash
+		DKObject<DKData>				archiveData;	// mapped archive, can be NULL.
 		DKString						filename;
 	};
 }
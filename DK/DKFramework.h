@@ -2,6 +2,7 @@
 #include "DKInclude.h"
 
 #include "DKFramework/DKAabb.h"
+#include "DKFramework/DKAabbTree.h"
 #include "DKFramework/DKActionController.h"
 #include "DKFramework/DKAffineTransform2.h"
 #include "DKFramework/DKAffineTransform3.h"
@@ -52,6 +53,7 @@
 #include "DKFramework/DKMultiSphereShape.h"
 #include "DKFramework/DKOpenALContext.h"
 #include "DKFramework/DKOpenGLContext.h"
+#include "DKFramework/DKOpenGLRecorder.h"
 #include "DKFramework/DKPlane.h"
 #include "DKFramework/DKPoint.h"
 #include "DKFramework/DKPoint2PointConstraint.h"
@@ -105,6 +107,7 @@
 #include "DKFramework/DKVoxel32SparseVolume.h"
 #include "DKFramework/DKVoxel32Storage.h"
 #include "DKFramework/DKVoxelIsosurfacePolygonizer.h"
+#include "DKFramework/DKVoxelMesher.h"
 #include "DKFramework/DKVoxelPolygonizer.h"
 #include "DKFramework/DKVoxelVolume.h"
 #include "DKFramework/DKWindow.h"
@@ -0,0 +1,403 @@
+//
+//  File: DKAabbTree.cpp
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#include "DKMath.h"
+#include "DKAabbTree.h"
+
+using namespace DKFoundation;
+using namespace DKFramework;
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		inline float SurfaceArea(const DKAabb& aabb)
+		{
+			DKVector3 d = aabb.positionMax - aabb.positionMin;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+		inline bool IsAabbEnclosed(const DKAabb& outer, const DKAabb& inner)
+		{
+			return outer.positionMin.x <= inner.positionMin.x &&
+				outer.positionMin.y <= inner.positionMin.y &&
+				outer.positionMin.z <= inner.positionMin.z &&
+				outer.positionMax.x >= inner.positionMax.x &&
+				outer.positionMax.y >= inner.positionMax.y &&
+				outer.positionMax.z >= inner.positionMax.z;
+		}
+	}
+}
+using namespace DKFramework::Private;
+
+
+DKAabbTree::DKAabbTree(float m)
+	: root(NullProxy)
+	, freeList(NullProxy)
+	, numProxies(0)
+	, margin(Max(m, 0.0f))
+{
+}
+
+DKAabbTree::~DKAabbTree(void)
+{
+}
+
+int DKAabbTree::AllocateNode(void)
+{
+	int index = freeList;
+	if (index == NullProxy)
+	{
+		Node node;
+		node.height = -1;
+		index = static_cast<int>(nodes.Add(node));
+	}
+	else
+	{
+		freeList = nodes.Value(index).next;
+	}
+	Node& node = nodes.Value(index);
+	node.aabb = DKAabb();
+	node.userData = NULL;
+	node.parent = NullProxy;
+	node.child1 = NullProxy;
+	node.child2 = NullProxy;
+	node.height = 0;
+	return index;
+}
+
+void DKAabbTree::FreeNode(int index)
+{
+	Node& node = nodes.Value(index);
+	DKASSERT_DEBUG(node.height >= 0);
+	node.userData = NULL;
+	node.height = -1;
+	node.next = freeList;
+	freeList = index;
+}
+
+int DKAabbTree::CreateProxy(const DKAabb& aabb, void* userData)
+{
+	int proxy = AllocateNode();
+	Node& node = nodes.Value(proxy);
+	const DKVector3 ext(margin, margin, margin);
+	node.aabb = DKAabb(aabb.positionMin - ext, aabb.positionMax + ext);
+	node.userData = userData;
+	node.height = 0;
+
+	InsertLeaf(proxy);
+	numProxies++;
+	return proxy;
+}
+
+void DKAabbTree::DestroyProxy(int proxy)
+{
+	DKASSERT_DEBUG(proxy >= 0 && proxy < nodes.Count());
+	DKASSERT_DEBUG(nodes.Value(proxy).IsLeaf());
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	DKASSERT_DEBUG(numProxies > 0);
+	numProxies--;
+}
+
+bool DKAabbTree::MoveProxy(int proxy, const DKAabb& aabb)
+{
+	DKASSERT_DEBUG(proxy >= 0 && proxy < nodes.Count());
+	DKASSERT_DEBUG(nodes.Value(proxy).IsLeaf());
+
+	const DKVector3 ext(margin, margin, margin);
+	const DKAabb fatAabb(aabb.positionMin - ext, aabb.positionMax + ext);
+	const DKAabb& current = nodes.Value(proxy).aabb;
+	if (IsAabbEnclosed(current, aabb))
+	{
+		// reinsert if object has been shrunken too much.
+		const DKVector3 ext4 = ext * 4.0f;
+		const DKAabb hugeAabb(fatAabb.positionMin - ext4, fatAabb.positionMax + ext4);
+		if (IsAabbEnclosed(hugeAabb, current))
+			return false;
+	}
+
+	RemoveLeaf(proxy);
+	nodes.Value(proxy).aabb = fatAabb;
+	InsertLeaf(proxy);
+	return true;
+}
+
+void* DKAabbTree::UserData(int proxy) const
+{
+	DKASSERT_DEBUG(proxy >= 0 && proxy < nodes.Count());
+	return nodes.Value(proxy).userData;
+}
+
+const DKAabb& DKAabbTree::FatAabb(int proxy) const
+{
+	DKASSERT_DEBUG(proxy >= 0 && proxy < nodes.Count());
+	return nodes.Value(proxy).aabb;
+}
+
+void DKAabbTree::Clear(void)
+{
+	nodes.Clear();
+	root = NullProxy;
+	freeList = NullProxy;
+	numProxies = 0;
+}
+
+void DKAabbTree::SetMargin(float m)
+{
+	margin = Max(m, 0.0f);
+}
+
+int DKAabbTree::Height(void) const
+{
+	if (root == NullProxy)
+		return 0;
+	return nodes.Value(root).height;
+}
+
+void DKAabbTree::InsertLeaf(int leaf)
+{
+	if (root == NullProxy)
+	{
+		root = leaf;
+		nodes.Value(root).parent = NullProxy;
+		return;
+	}
+
+	// find the best sibling, by surface area heuristic.
+	const DKAabb leafAabb = nodes.Value(leaf).aabb;
+	int index = root;
+	while (nodes.Value(index).IsLeaf() == false)
+	{
+		const Node& node = nodes.Value(index);
+		const Node& child1 = nodes.Value(node.child1);
+		const Node& child2 = nodes.Value(node.child2);
+
+		float area = SurfaceArea(node.aabb);
+		float combinedArea = SurfaceArea(DKAabb::Union(node.aabb, leafAabb));
+
+		// cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combinedArea;
+		// minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float cost1 = SurfaceArea(DKAabb::Union(leafAabb, child1.aabb)) + inheritanceCost;
+		if (!child1.IsLeaf())
+			cost1 -= SurfaceArea(child1.aabb);
+		float cost2 = SurfaceArea(DKAabb::Union(leafAabb, child2.aabb)) + inheritanceCost;
+		if (!child2.IsLeaf())
+			cost2 -= SurfaceArea(child2.aabb);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+	int sibling = index;
+
+	// create a new parent. (node array can be reallocated)
+	int newParent = AllocateNode();
+	int oldParent = nodes.Value(sibling).parent;
+	if (true)
+	{
+		Node& parent = nodes.Value(newParent);
+		parent.parent = oldParent;
+		parent.userData = NULL;
+		parent.aabb = DKAabb::Union(leafAabb, nodes.Value(sibling).aabb);
+		parent.height = nodes.Value(sibling).height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+	}
+	if (oldParent != NullProxy)
+	{
+		Node& p = nodes.Value(oldParent);
+		if (p.child1 == sibling)
+			p.child1 = newParent;
+		else
+			p.child2 = newParent;
+	}
+	else
+	{
+		root = newParent;
+	}
+	nodes.Value(sibling).parent = newParent;
+	nodes.Value(leaf).parent = newParent;
+
+	// walk back up the tree fixing heights and volumes
+	index = nodes.Value(leaf).parent;
+	while (index != NullProxy)
+	{
+		index = Balance(index);
+
+		Node& node = nodes.Value(index);
+		const Node& child1 = nodes.Value(node.child1);
+		const Node& child2 = nodes.Value(node.child2);
+		node.height = 1 + Max(child1.height, child2.height);
+		node.aabb = DKAabb::Union(child1.aabb, child2.aabb);
+
+		index = node.parent;
+	}
+}
+
+void DKAabbTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = NullProxy;
+		return;
+	}
+
+	int parent = nodes.Value(leaf).parent;
+	int grandParent = nodes.Value(parent).parent;
+	int sibling = nodes.Value(parent).child1 == leaf ? nodes.Value(parent).child2 : nodes.Value(parent).child1;
+
+	if (grandParent != NullProxy)
+	{
+		// destroy parent and connect sibling to grandParent.
+		Node& gp = nodes.Value(grandParent);
+		if (gp.child1 == parent)
+			gp.child1 = sibling;
+		else
+			gp.child2 = sibling;
+		nodes.Value(sibling).parent = grandParent;
+		FreeNode(parent);
+
+		int index = grandParent;
+		while (index != NullProxy)
+		{
+			index = Balance(index);
+
+			Node& node = nodes.Value(index);
+			const Node& child1 = nodes.Value(node.child1);
+			const Node& child2 = nodes.Value(node.child2);
+			node.aabb = DKAabb::Union(child1.aabb, child2.aabb);
+			node.height = 1 + Max(child1.height, child2.height);
+
+			index = node.parent;
+		}
+	}
+	else
+	{
+		root = sibling;
+		nodes.Value(sibling).parent = NullProxy;
+		FreeNode(parent);
+	}
+}
+
+int DKAabbTree::Balance(int iA)
+{
+	DKASSERT_DEBUG(iA != NullProxy);
+
+	Node& A = nodes.Value(iA);
+	if (A.IsLeaf() || A.height < 2)
+		return iA;
+
+	int iB = A.child1;
+	int iC = A.child2;
+	Node& B = nodes.Value(iB);
+	Node& C = nodes.Value(iC);
+
+	int balance = C.height - B.height;
+
+	// rotate C up
+	if (balance > 1)
+	{
+		int iF = C.child1;
+		int iG = C.child2;
+		Node& F = nodes.Value(iF);
+		Node& G = nodes.Value(iG);
+
+		// swap A and C
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if (C.parent != NullProxy)
+		{
+			Node& p = nodes.Value(C.parent);
+			if (p.child1 == iA)
+				p.child1 = iC;
+			else
+				p.child2 = iC;
+		}
+		else
+			root = iC;
+
+		// rotate
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.aabb = DKAabb::Union(B.aabb, G.aabb);
+			C.aabb = DKAabb::Union(A.aabb, F.aabb);
+			A.height = 1 + Max(B.height, G.height);
+			C.height = 1 + Max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.aabb = DKAabb::Union(B.aabb, F.aabb);
+			C.aabb = DKAabb::Union(A.aabb, G.aabb);
+			A.height = 1 + Max(B.height, F.height);
+			C.height = 1 + Max(A.height, G.height);
+		}
+		return iC;
+	}
+	// rotate B up
+	if (balance < -1)
+	{
+		int iD = B.child1;
+		int iE = B.child2;
+		Node& D = nodes.Value(iD);
+		Node& E = nodes.Value(iE);
+
+		// swap A and B
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if (B.parent != NullProxy)
+		{
+			Node& p = nodes.Value(B.parent);
+			if (p.child1 == iA)
+				p.child1 = iB;
+			else
+				p.child2 = iB;
+		}
+		else
+			root = iB;
+
+		// rotate
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.aabb = DKAabb::Union(C.aabb, E.aabb);
+			B.aabb = DKAabb::Union(A.aabb, D.aabb);
+			A.height = 1 + Max(C.height, E.height);
+			B.height = 1 + Max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.aabb = DKAabb::Union(C.aabb, D.aabb);
+			B.aabb = DKAabb::Union(A.aabb, E.aabb);
+			A.height = 1 + Max(C.height, D.height);
+			B.height = 1 + Max(A.height, E.height);
+		}
+		return iB;
+	}
+	return iA;
+}
@@ -0,0 +1,172 @@
+//
+//  File: DKAabbTree.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../DKInclude.h"
+#include "../DKFoundation.h"
+#include "DKAabb.h"
+#include "DKPlane.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKAabbTree
+// dynamic bounding volume hierarchy with axis aligned bounding boxes.
+// every object is stored in leaf node (proxy) with enlarged box (fat-aabb),
+// small movement of object does not modify tree structure.
+// tree is kept balanced by rotations when proxies are inserted or removed.
+//
+// Query with planes (camera frustum) tests volumes hierarchically, planes
+// that enclose whole sub-tree will not be tested for descendants, and
+// descendants of completely enclosed node are reported without any test.
+//
+// Note:
+//    This class is not thread-safe. caller should synchronize if needed.
+//    Proxy ID can be reused after proxy destroyed.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFramework
+{
+	class DKGL_API DKAabbTree
+	{
+	public:
+		enum : int { NullProxy = -1 };
+
+		DKAabbTree(float margin = 0.1f);
+		~DKAabbTree(void);
+
+		// create proxy and returns proxy ID.
+		int CreateProxy(const DKAabb& aabb, void* userData);
+		void DestroyProxy(int proxy);
+		// update proxy's volume. proxy will be reinserted if aabb is not
+		// enclosed by current fat-aabb. returns true if reinserted.
+		bool MoveProxy(int proxy, const DKAabb& aabb);
+
+		void* UserData(int proxy) const;
+		const DKAabb& FatAabb(int proxy) const;
+
+		void Clear(void);
+		size_t NumberOfProxies(void) const		{ return numProxies; }
+		int Height(void) const;
+
+		void SetMargin(float m);
+		float Margin(void) const				{ return margin; }
+
+		// query proxies which is intersects with convex volume.
+		// normal of planes should point inside of volume. (maximum 32 planes)
+		// callback signature: void (void* userData)
+		template <typename Callback> void Query(const DKPlane* planes, size_t numPlanes, Callback&& cb) const
+		{
+			if (root != NullProxy)
+			{
+				DKASSERT_DEBUG(numPlanes <= 32);
+				if (numPlanes > 32)
+					numPlanes = 32;
+				uint32_t mask = numPlanes < 32 ? ((uint32_t)1 << numPlanes) - 1 : 0xffffffff;
+				QueryPlanes(root, planes, mask, cb);
+			}
+		}
+		// query proxies which is intersects with aabb.
+		template <typename Callback> void Query(const DKAabb& aabb, Callback&& cb) const
+		{
+			if (root != NullProxy)
+				QueryAabb(root, aabb, cb);
+		}
+		// enumerate all proxies.
+		template <typename Callback> void EnumerateForward(Callback&& cb) const
+		{
+			if (root != NullProxy)
+				EnumerateLeaves(root, cb);
+		}
+
+	private:
+		struct Node
+		{
+			DKAabb aabb;
+			void* userData;
+			union
+			{
+				int parent;
+				int next;		// free-list
+			};
+			int child1;
+			int child2;
+			int height;			// leaf = 0, free node = -1
+
+			bool IsLeaf(void) const	{ return child1 == NullProxy; }
+		};
+
+		int AllocateNode(void);
+		void FreeNode(int);
+		void InsertLeaf(int);
+		void RemoveLeaf(int);
+		int Balance(int);
+
+		template <typename Callback> void EnumerateLeaves(int index, Callback& cb) const
+		{
+			const Node& node = nodes.Value(index);
+			if (node.IsLeaf())
+				cb(node.userData);
+			else
+			{
+				EnumerateLeaves(node.child1, cb);
+				EnumerateLeaves(node.child2, cb);
+			}
+		}
+		template <typename Callback> void QueryAabb(int index, const DKAabb& aabb, Callback& cb) const
+		{
+			const Node& node = nodes.Value(index);
+			if (node.aabb.Intersect(aabb))
+			{
+				if (node.IsLeaf())
+					cb(node.userData);
+				else
+				{
+					QueryAabb(node.child1, aabb, cb);
+					QueryAabb(node.child2, aabb, cb);
+				}
+			}
+		}
+		template <typename Callback> void QueryPlanes(int index, const DKPlane* planes, uint32_t mask, Callback& cb) const
+		{
+			const Node& node = nodes.Value(index);
+			const DKVector3& bmin = node.aabb.positionMin;
+			const DKVector3& bmax = node.aabb.positionMax;
+			for (uint32_t i = 0, bit = 1; bit <= mask && bit != 0; ++i, bit <<= 1)
+			{
+				if (mask & bit)
+				{
+					const DKPlane& p = planes[i];
+					// farthest corner along the plane normal
+					DKVector3 pv(p.a >= 0 ? bmax.x : bmin.x, p.b >= 0 ? bmax.y : bmin.y, p.c >= 0 ? bmax.z : bmin.z);
+					if (p.Dot(pv) < 0)
+						return;			// completely outside.
+					// nearest corner along the plane normal
+					DKVector3 nv(p.a >= 0 ? bmin.x : bmax.x, p.b >= 0 ? bmin.y : bmax.y, p.c >= 0 ? bmin.z : bmax.z);
+					if (p.Dot(nv) >= 0)
+						mask &= ~bit;	// descendants are inside of this plane.
+				}
+			}
+			if (mask == 0)
+				EnumerateLeaves(index, cb);
+			else if (node.IsLeaf())
+				cb(node.userData);
+			else
+			{
+				QueryPlanes(node.child1, planes, mask, cb);
+				QueryPlanes(node.child2, planes, mask, cb);
+			}
+		}
+
+		DKFoundation::DKArray<Node> nodes;
+		int root;
+		int freeList;
+		size_t numProxies;
+		float margin;
+
+		DKAabbTree(const DKAabbTree&);
+		DKAabbTree& operator = (const DKAabbTree&);
+	};
+}
@@ -7,6 +7,7 @@
 
 #include "DKMath.h"
 #include "DKAnimation.h"
+#include "Private/QuaternionUtils.h"
 
 using namespace DKFoundation;
 namespace DKFramework
@@ -132,6 +133,202 @@ namespace DKFramework
 			{
 				return FindNearKeyFrames(frames, 0, frames.Count(), prev, next, time);
 			}
+			// index of previous key of two nearest keys, same as FindNearKeyFrames.
+			// search from hint (index of last sampling), sequential playback
+			// will be found in few steps.
+			inline size_t FindKeyIndex(const float* times, size_t count, size_t hint, float time)
+			{
+				DKASSERT_DEBUG(count > 1);
+				const size_t last = count - 2;
+				size_t index = Min(hint, last);
+				if (times[index] < time)
+				{
+					for (int i = 0; i < 4; ++i)
+					{
+						if (index == last || !(times[index + 1] < time))
+							return index;
+						index++;
+					}
+				}
+				else if (index == 0 || times[index - 1] < time)
+				{
+					return index > 0 ? index - 1 : 0;
+				}
+				// binary search, first key not less than time.
+				size_t begin = 0;
+				size_t end = count;
+				while (begin < end)
+				{
+					size_t middle = (begin + end) / 2;
+					if (times[middle] < time)
+						begin = middle + 1;
+					else
+						end = middle;
+				}
+				return begin > 0 ? Min(begin - 1, last) : 0;
+			}
+			// bit stream of compressed node, frames are packed in 32bit words.
+			// one more word is padded at the end, to read two words at once.
+			const unsigned int maxCompressedBits = 24;
+			inline unsigned int ReadBits(const unsigned int* stream, size_t offset, unsigned int bits)
+			{
+				if (bits == 0)
+					return 0;
+				const unsigned int* p = &stream[offset / 32];
+				unsigned long long v = static_cast<unsigned long long>(p[0]) | (static_cast<unsigned long long>(p[1]) << 32);
+				return static_cast<unsigned int>(v >> (offset % 32)) & ((1U << bits) - 1);
+			}
+			inline void WriteBits(unsigned int* stream, size_t offset, unsigned int value, unsigned int bits)
+			{
+				if (bits == 0)
+					return;
+				unsigned int* p = &stream[offset / 32];
+				unsigned long long v = static_cast<unsigned long long>(value & ((1U << bits) - 1)) << (offset % 32);
+				p[0] |= static_cast<unsigned int>(v);
+				p[1] |= static_cast<unsigned int>(v >> 32);
+			}
+			// bits for quantizing range with error (step <= error * 2)
+			inline unsigned int QuantizationBits(float range, float error)
+			{
+				error = Max(error, FLT_EPSILON);
+				unsigned int bits = 1;
+				while (bits < maxCompressedBits && range > error * 2 * static_cast<float>((1U << bits) - 1))
+					bits++;
+				return bits;
+			}
+			inline unsigned int Quantize(float value, float base, float step, unsigned int bits)
+			{
+				float q = floor((value - base) / step + 0.5f);
+				return static_cast<unsigned int>(Clamp(q, 0.0f, static_cast<float>((1U << bits) - 1)));
+			}
+
+			using CompressedNode = DKAnimation::CompressedNode;
+			void SetupVectorTrack(const DKArray<DKVector3>& values, float error, CompressedNode::VectorTrack& track)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					float minValue = values.Value(0).val[i];
+					float maxValue = minValue;
+					for (const DKVector3& v : values)
+					{
+						minValue = Min(minValue, v.val[i]);
+						maxValue = Max(maxValue, v.val[i]);
+					}
+					float range = maxValue - minValue;
+					if (range <= error * 2)		// constant
+					{
+						track.base[i] = minValue + range * 0.5f;
+						track.step[i] = 0.0f;
+						track.bits[i] = 0;
+					}
+					else
+					{
+						track.bits[i] = QuantizationBits(range, error);
+						track.base[i] = minValue;
+						track.step[i] = range / static_cast<float>((1U << track.bits[i]) - 1);
+					}
+				}
+			}
+			void EncodeVector(const CompressedNode::VectorTrack& track, const DKVector3& v, unsigned int* stream, size_t& offset)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					if (track.bits[i] > 0)
+					{
+						WriteBits(stream, offset, Quantize(v.val[i], track.base[i], track.step[i], track.bits[i]), track.bits[i]);
+						offset += track.bits[i];
+					}
+				}
+			}
+			inline void DecodeVector(const CompressedNode::VectorTrack& track, const unsigned int* stream, size_t& offset, DKVector3& v)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					v.val[i] = track.base[i] + track.step[i] * static_cast<float>(ReadBits(stream, offset, track.bits[i]));
+					offset += track.bits[i];
+				}
+			}
+			// smallest three components are in range of (-1/sqrt(2), 1/sqrt(2))
+			const float smallestThreeRange = 1.41421356f;
+			const float smallestThreeMin = -0.70710678f;
+			void SetupRotationTrack(DKArray<DKQuaternion>& values, float error, CompressedNode::RotationTrack& track)
+			{
+				const DKQuaternion& first = values.Value(0).Normalize();
+				bool constant = true;
+				for (DKQuaternion& q : values)
+				{
+					q.Normalize();
+					float sign = DKQuaternion::Dot(q, first) < 0.0f ? -1.0f : 1.0f;
+					for (int i = 0; i < 4 && constant; ++i)
+					{
+						if (fabs(q.val[i] * sign - first.val[i]) > error)
+							constant = false;
+					}
+				}
+				track.constant = first;
+				track.bits = constant ? 0 : QuantizationBits(smallestThreeRange, error);
+			}
+			void EncodeRotation(const CompressedNode::RotationTrack& track, const DKQuaternion& q, unsigned int* stream, size_t& offset)
+			{
+				if (track.bits == 0)
+					return;
+				unsigned int largest = 0;
+				for (unsigned int i = 1; i < 4; ++i)
+				{
+					if (fabs(q.val[i]) > fabs(q.val[largest]))
+						largest = i;
+				}
+				// q and -q are same rotation, largest component is always positive.
+				float sign = q.val[largest] < 0.0f ? -1.0f : 1.0f;
+				const float step = smallestThreeRange / static_cast<float>((1U << track.bits) - 1);
+
+				WriteBits(stream, offset, largest, 2);
+				offset += 2;
+				for (unsigned int i = 0; i < 4; ++i)
+				{
+					if (i != largest)
+					{
+						WriteBits(stream, offset, Quantize(q.val[i] * sign, smallestThreeMin, step, track.bits), track.bits);
+						offset += track.bits;
+					}
+				}
+			}
+			inline void DecodeRotation(const CompressedNode::RotationTrack& track, const unsigned int* stream, size_t& offset, DKQuaternion& q)
+			{
+				if (track.bits == 0)
+				{
+					q = track.constant;
+					return;
+				}
+				const float step = smallestThreeRange / static_cast<float>((1U << track.bits) - 1);
+				unsigned int largest = ReadBits(stream, offset, 2);
+				offset += 2;
+				float sum = 0.0f;
+				for (unsigned int i = 0; i < 4; ++i)
+				{
+					if (i != largest)
+					{
+						float c = smallestThreeMin + step * static_cast<float>(ReadBits(stream, offset, track.bits));
+						offset += track.bits;
+						q.val[i] = c;
+						sum += c * c;
+					}
+				}
+				q.val[largest] = sqrt(Max(1.0f - sum, 0.0f));
+			}
+			// validate restored or copied node, stream should have all frames.
+			bool IsValidCompressedNode(const CompressedNode& node)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					if (node.scale.bits[i] > maxCompressedBits || node.translation.bits[i] > maxCompressedBits)
+						return false;
+				}
+				if (node.rotation.bits > maxCompressedBits)
+					return false;
+				size_t words = (node.frameCount * node.FrameBits() + 31) / 32 + 1;
+				return node.frameCount > 0 && node.stream.Count() >= words;
+			}
 		}
 	}
 }
@@ -166,6 +363,11 @@ bool DKAnimation::GetNodeTransform(const DKFoundation::DKString& name, float t,
 	return GetNodeTransform(IndexOfNode(name), t, output);
 }
 
+bool DKAnimation::GetNodeTransform(const DKFoundation::DKStringAtom& name, float t, DKTransformUnit& output) const
+{
+	return GetNodeTransform(IndexOfNode(name), t, output);
+}
+
 void DKAnimation::SetDuration(float d)
 {
 	if (d > 0)
@@ -263,6 +465,17 @@ bool DKAnimation::AddNode(const Node* node)
 									 k->rotationKeys, k->rotationKeys.Count(),
 									 k->translationKeys, k->translationKeys.Count());
 	}
+	else if (node->type == Node::NodeTypeCompressed)
+	{
+		const CompressedNode* c = static_cast<const CompressedNode*>(node);
+		if (IsValidCompressedNode(*c))
+		{
+			CompressedNode* copied = new (DKMemoryDefaultAllocator::Alloc(sizeof(CompressedNode))) CompressedNode(*c);
+			nodeIndexMap.Update(copied->name, nodes.Add(copied));
+			AppendNodeTracks(copied);
+			return true;
+		}
+	}
 
 	return false;
 }
@@ -277,6 +490,7 @@ bool DKAnimation::AddSamplingNode(const DKString& name, const DKTransformUnit* f
 		node->name = name;
 		node->frames.Add(frames, numFrames);
 		nodeIndexMap.Update(node->name, nodes.Add(node)); // add new node, and update indexes.
+		AppendNodeTracks(node);
 		return true;
 	}
 	return false;
@@ -302,6 +516,7 @@ bool DKAnimation::AddKeyframeNode(const DKString& name,
 		if (!node->IsEmpty())
 		{
 			nodeIndexMap.Update(node->name, nodes.Add(node));
+			AppendNodeTracks(node);
 			return true;
 		}
 		node->~KeyframeNode();
@@ -312,7 +527,11 @@ bool DKAnimation::AddKeyframeNode(const DKString& name,
 
 void DKAnimation::RemoveNode(const DKFoundation::DKString& name)
 {
-	DKMap<DKString, size_t>::Pair* indexPtr = nodeIndexMap.Find(name);
+	DKStringAtom key = DKStringAtom::Find(name);
+	if (key.IsEmpty() && name.Length() > 0)
+		return;		// name not interned, no node has this name.
+
+	DKHashMap<DKStringAtom, size_t>::Pair* indexPtr = nodeIndexMap.Find(key);
 	if (indexPtr)
 	{
 		size_t index = indexPtr->value;
@@ -320,8 +539,13 @@ void DKAnimation::RemoveNode(const DKFoundation::DKString& name)
 		nodes.Remove(index);
 		n->~Node();
 		DKMemoryDefaultAllocator::Free(n);
+
+		// indexes of following nodes are changed.
+		nodeIndexMap.Remove(key);
+		for (size_t i = index; i < nodes.Count(); ++i)
+			nodeIndexMap.Update(nodes.Value(i)->name, i);
+		RebuildNodeTracks();
 	}
-	nodeIndexMap.Remove(name);
 }
 
 void DKAnimation::RemoveAllNodes(void)
@@ -334,6 +558,80 @@ void DKAnimation::RemoveAllNodes(void)
 	}
 	nodes.Clear();
 	nodeIndexMap.Clear();
+	RebuildNodeTracks();
+}
+
+void DKAnimation::AppendNodeTracks(const Node* node)
+{
+	auto addVectorKey = [this](float time, const DKVector3& v)
+	{
+		vectorKeyTimes.Add(time);
+		vectorKeys[0].Add(v.x);
+		vectorKeys[1].Add(v.y);
+		vectorKeys[2].Add(v.z);
+	};
+	auto addRotationKey = [this](float time, const DKQuaternion& q)
+	{
+		rotationKeyTimes.Add(time);
+		rotationKeys[0].Add(q.x);
+		rotationKeys[1].Add(q.y);
+		rotationKeys[2].Add(q.z);
+		rotationKeys[3].Add(q.w);
+	};
+
+	NodeTracks tracks = { NULL, false, { 0, 0 }, { 0, 0 }, { 0, 0 } };
+	if (node->type == Node::NodeTypeCompressed)
+	{
+		tracks.compressed = static_cast<const CompressedNode*>(node);
+	}
+	else if (node->type == Node::NodeTypeSampling)
+	{
+		const DKArray<DKTransformUnit>& frames = static_cast<const SamplingNode*>(node)->frames;
+		const size_t count = frames.Count();
+		const float interval = count > 1 ? 1.0f / static_cast<float>(count - 1) : 0.0f;
+
+		tracks.uniform = true;
+		tracks.scale = { vectorKeyTimes.Count(), count };
+		for (size_t i = 0; i < count; ++i)
+			addVectorKey(interval * i, frames.Value(i).scale);
+		tracks.translation = { vectorKeyTimes.Count(), count };
+		for (size_t i = 0; i < count; ++i)
+			addVectorKey(interval * i, frames.Value(i).translation);
+		tracks.rotation = { rotationKeyTimes.Count(), count };
+		for (size_t i = 0; i < count; ++i)
+			addRotationKey(interval * i, frames.Value(i).rotation);
+	}
+	else
+	{
+		DKASSERT_DEBUG(node->type == Node::NodeTypeKeyframe);
+		const KeyframeNode* kn = static_cast<const KeyframeNode*>(node);
+
+		tracks.uniform = false;
+		tracks.scale = { vectorKeyTimes.Count(), kn->scaleKeys.Count() };
+		for (const KeyframeNode::ScaleKey& k : kn->scaleKeys)
+			addVectorKey(k.time, k.key);
+		tracks.translation = { vectorKeyTimes.Count(), kn->translationKeys.Count() };
+		for (const KeyframeNode::TranslationKey& k : kn->translationKeys)
+			addVectorKey(k.time, k.key);
+		tracks.rotation = { rotationKeyTimes.Count(), kn->rotationKeys.Count() };
+		for (const KeyframeNode::RotationKey& k : kn->rotationKeys)
+			addRotationKey(k.time, k.key);
+	}
+	nodeTracks.Add(tracks);
+}
+
+void DKAnimation::RebuildNodeTracks(void)
+{
+	nodeTracks.Clear();
+	vectorKeyTimes.Clear();
+	rotationKeyTimes.Clear();
+	for (DKArray<float>& keys : vectorKeys)
+		keys.Clear();
+	for (DKArray<float>& keys : rotationKeys)
+		keys.Clear();
+
+	for (const Node* node : nodes)
+		AppendNodeTracks(node);
 }
 
 size_t DKAnimation::NodeCount(void) const
@@ -343,7 +641,15 @@ size_t DKAnimation::NodeCount(void) const
 
 DKAnimation::NodeIndex DKAnimation::IndexOfNode(const DKFoundation::DKString& name) const
 {
-	const DKMap<DKString, size_t>::Pair* indexPtr = nodeIndexMap.Find(name);
+	DKStringAtom key = DKStringAtom::Find(name);
+	if (key.IsEmpty() && name.Length() > 0)
+		return invalidNodeIndex;	// name not interned, no node has this name.
+	return IndexOfNode(key);
+}
+
+DKAnimation::NodeIndex DKAnimation::IndexOfNode(const DKFoundation::DKStringAtom& name) const
+{
+	const DKHashMap<DKStringAtom, size_t>::Pair* indexPtr = nodeIndexMap.Find(name);
 	if (indexPtr)
 		return indexPtr->value;
 	return invalidNodeIndex;
@@ -358,6 +664,260 @@ const DKAnimation::Node* DKAnimation::NodeAtIndex(NodeIndex index) const
 	return NULL;
 }
 
+size_t DKAnimation::CompressedNode::FrameBits(void) const
+{
+	size_t bits = 0;
+	for (int i = 0; i < 3; ++i)
+		bits += scale.bits[i] + translation.bits[i];
+	if (rotation.bits > 0)
+		bits += 2 + rotation.bits * 3;
+	return bits;
+}
+
+DKTransformUnit DKAnimation::CompressedNode::Frame(size_t index) const
+{
+	DKASSERT_DEBUG(index < frameCount);
+
+	const unsigned int* data = stream;
+	size_t offset = index * FrameBits();
+	DKTransformUnit output;
+	DecodeVector(scale, data, offset, output.scale);
+	DecodeVector(translation, data, offset, output.translation);
+	DecodeRotation(rotation, data, offset, output.rotation);
+	return output;
+}
+
+void DKAnimation::SamplePose(float t, PoseCursor& cursor, DKTransformUnit* output) const
+{
+	const size_t numNodes = nodeTracks.Count();
+	DKASSERT_DEBUG(numNodes == nodes.Count());
+	if (numNodes == 0)
+		return;
+
+	if (cursor.keyIndices.Count() != numNodes * 3)
+	{
+		cursor.keyIndices.Clear();
+		cursor.keyIndices.Resize(numNodes * 3, 0U);
+	}
+
+	// working set in SoA, two keys and weight for each track.
+	// vector tracks are two per node (scale, translation)
+	// if exact[i] is set, rotation is first key without interpolation.
+	const size_t numVectors = numNodes * 2;
+	cursor.buffer.Resize(numVectors * 7 + numNodes * 12);
+	cursor.exact.Resize(numNodes);
+
+	float* buffer = cursor.buffer;
+	float* va[3] = { buffer, buffer + numVectors, buffer + numVectors * 2 };
+	buffer += numVectors * 3;
+	float* vb[3] = { buffer, buffer + numVectors, buffer + numVectors * 2 };
+	buffer += numVectors * 3;
+	float* vw = buffer;
+	buffer += numVectors;
+	float* qa[4] = { buffer, buffer + numNodes, buffer + numNodes * 2, buffer + numNodes * 3 };
+	buffer += numNodes * 4;
+	float* qb[4] = { buffer, buffer + numNodes, buffer + numNodes * 2, buffer + numNodes * 3 };
+	buffer += numNodes * 4;
+	float* qw = buffer;
+	float* qd = buffer + numNodes;
+	float* ratio1 = buffer + numNodes * 2;
+	float* ratio2 = buffer + numNodes * 3;
+	unsigned char* exact = cursor.exact;
+
+	const float* vt = vectorKeyTimes;
+	const float* vk[3] = { vectorKeys[0], vectorKeys[1], vectorKeys[2] };
+	const float* rt = rotationKeyTimes;
+	const float* rk[4] = { rotationKeys[0], rotationKeys[1], rotationKeys[2], rotationKeys[3] };
+
+	auto setVector = [&](size_t lane, const DKVector3& v)
+	{
+		va[0][lane] = vb[0][lane] = v.x;
+		va[1][lane] = vb[1][lane] = v.y;
+		va[2][lane] = vb[2][lane] = v.z;
+		vw[lane] = 0.0f;
+	};
+	auto setVectorKeys = [&](size_t lane, size_t key1, size_t key2, float w)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			va[i][lane] = vk[i][key1];
+			vb[i][lane] = vk[i][key2];
+		}
+		vw[lane] = w;
+	};
+	auto setRotationKeys = [&](size_t lane, size_t key1, size_t key2, float w, bool e)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			qa[i][lane] = rk[i][key1];
+			qb[i][lane] = rk[i][key2];
+		}
+		qw[lane] = w;
+		exact[lane] = e;
+	};
+	auto setFrames = [&](size_t n, const DKTransformUnit& f1, const DKTransformUnit& f2, float w, bool e)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			va[i][n * 2] = f1.scale.val[i];
+			vb[i][n * 2] = f2.scale.val[i];
+			va[i][n * 2 + 1] = f1.translation.val[i];
+			vb[i][n * 2 + 1] = f2.translation.val[i];
+		}
+		vw[n * 2] = vw[n * 2 + 1] = w;
+		for (int i = 0; i < 4; ++i)
+		{
+			qa[i][n] = f1.rotation.val[i];
+			qb[i][n] = f2.rotation.val[i];
+		}
+		qw[n] = w;
+		exact[n] = e;
+	};
+	// keyframe track, same as Interpolate() of two nearest keys.
+	auto gatherVector = [&](size_t lane, const Track& track, unsigned int& key, const DKVector3& defaultValue)
+	{
+		if (track.count == 0)
+			setVector(lane, defaultValue);
+		else if (track.count == 1)
+			setVectorKeys(lane, track.first, track.first, 0.0f);
+		else
+		{
+			size_t index = FindKeyIndex(vt + track.first, track.count, key, t);
+			key = static_cast<unsigned int>(index);
+			size_t k1 = track.first + index;
+			float w = (t - vt[k1]) / (vt[k1 + 1] - vt[k1]);
+			if (w <= 0)
+				setVectorKeys(lane, k1, k1, 0.0f);
+			else if (w >= 1)
+				setVectorKeys(lane, k1 + 1, k1 + 1, 0.0f);
+			else
+				setVectorKeys(lane, k1, k1 + 1, w);
+		}
+	};
+	auto gatherRotation = [&](size_t lane, const Track& track, unsigned int& key)
+	{
+		if (track.count == 0)
+		{
+			for (int i = 0; i < 4; ++i)
+				qa[i][lane] = qb[i][lane] = DKQuaternion::identity.val[i];
+			qw[lane] = 0.0f;
+			exact[lane] = 1;
+		}
+		else if (track.count == 1)
+			setRotationKeys(lane, track.first, track.first, 0.0f, true);
+		else
+		{
+			size_t index = FindKeyIndex(rt + track.first, track.count, key, t);
+			key = static_cast<unsigned int>(index);
+			size_t k1 = track.first + index;
+			float w = (t - rt[k1]) / (rt[k1 + 1] - rt[k1]);
+			if (w <= 0)
+				setRotationKeys(lane, k1, k1, 0.0f, true);
+			else if (w >= 1)
+				setRotationKeys(lane, k1 + 1, k1 + 1, 0.0f, true);
+			else
+				setRotationKeys(lane, k1, k1 + 1, w, false);
+		}
+	};
+
+	// find keys of all tracks.
+	for (size_t n = 0; n < numNodes; ++n)
+	{
+		const NodeTracks& tracks = nodeTracks.Value(n);
+		unsigned int* keys = &cursor.keyIndices.Value(n * 3);
+		if (tracks.compressed)
+		{
+			// decode two frames, same as GetTransform().
+			const CompressedNode* node = tracks.compressed;
+			const size_t count = node->frameCount;
+			if (t <= 0 || count == 1)
+			{
+				DKTransformUnit frame = node->Frame(0);
+				setFrames(n, frame, frame, 0.0f, true);
+			}
+			else if (t >= 1.0f)
+			{
+				DKTransformUnit frame = node->Frame(count - 1);
+				setFrames(n, frame, frame, 0.0f, true);
+			}
+			else
+			{
+				float elapsed = ((float)count - 1) * t;
+				int index = (int)elapsed;
+				float interval = elapsed - index;
+				setFrames(n, node->Frame(index), node->Frame(index + 1), interval, false);
+			}
+		}
+		else if (tracks.uniform)
+		{
+			// sampling node, same as GetTransform().
+			const size_t count = tracks.rotation.count;
+			if (t <= 0 || count == 1)
+			{
+				setVectorKeys(n * 2, tracks.scale.first, tracks.scale.first, 0.0f);
+				setVectorKeys(n * 2 + 1, tracks.translation.first, tracks.translation.first, 0.0f);
+				setRotationKeys(n, tracks.rotation.first, tracks.rotation.first, 0.0f, true);
+			}
+			else if (t >= 1.0f)
+			{
+				setVectorKeys(n * 2, tracks.scale.first + count - 1, tracks.scale.first + count - 1, 0.0f);
+				setVectorKeys(n * 2 + 1, tracks.translation.first + count - 1, tracks.translation.first + count - 1, 0.0f);
+				setRotationKeys(n, tracks.rotation.first + count - 1, tracks.rotation.first + count - 1, 0.0f, true);
+			}
+			else
+			{
+				float elapsed = ((float)count - 1) * t;
+				int index = (int)elapsed;
+				float interval = elapsed - index;
+
+				setVectorKeys(n * 2, tracks.scale.first + index, tracks.scale.first + index + 1, interval);
+				setVectorKeys(n * 2 + 1, tracks.translation.first + index, tracks.translation.first + index + 1, interval);
+				setRotationKeys(n, tracks.rotation.first + index, tracks.rotation.first + index + 1, interval, false);
+			}
+		}
+		else
+		{
+			gatherVector(n * 2, tracks.scale, keys[0], DKVector3(1, 1, 1));
+			gatherVector(n * 2 + 1, tracks.translation, keys[2], DKVector3(0, 0, 0));
+			gatherRotation(n, tracks.rotation, keys[1]);
+		}
+	}
+
+	// interpolate all tracks together.
+	for (int i = 0; i < 3; ++i)
+	{
+		float* a = va[i];
+		const float* b = vb[i];
+		for (size_t lane = 0; lane < numVectors; ++lane)
+			a[lane] = a[lane] + ((b[lane] - a[lane]) * vw[lane]);
+	}
+	for (size_t lane = 0; lane < numNodes; ++lane)
+		qd[lane] = qa[3][lane] * qb[3][lane] + qa[0][lane] * qb[0][lane] + qa[1][lane] * qb[1][lane] + qa[2][lane] * qb[2][lane];
+	for (size_t lane = 0; lane < numNodes; ++lane)
+	{
+		if (exact[lane] || !SlerpRatio(qd[lane], qw[lane], ratio1[lane], ratio2[lane]))
+		{
+			ratio1[lane] = 1.0f;
+			ratio2[lane] = 0.0f;
+		}
+	}
+	for (int i = 0; i < 4; ++i)
+	{
+		float* a = qa[i];
+		const float* b = qb[i];
+		for (size_t lane = 0; lane < numNodes; ++lane)
+			a[lane] = ratio1[lane] * a[lane] + ratio2[lane] * b[lane];
+	}
+
+	for (size_t n = 0; n < numNodes; ++n)
+	{
+		DKTransformUnit& tu = output[n];
+		tu.scale = DKVector3(va[0][n * 2], va[1][n * 2], va[2][n * 2]);
+		tu.translation = DKVector3(va[0][n * 2 + 1], va[1][n * 2 + 1], va[2][n * 2 + 1]);
+		tu.rotation = DKQuaternion(qa[0][n], qa[1][n], qa[2][n], qa[3][n]);
+	}
+}
+
 DKTransformUnit DKAnimation::GetTransform(const Node& node, float time)
 {
 	DKTransformUnit output;
@@ -429,6 +989,31 @@ DKTransformUnit DKAnimation::GetTransform(const Node& node, float time)
 				output.scale = scaleKeys.Value(0).key;
 		}
 	}
+	else if (node.type == Node::NodeTypeCompressed)
+	{
+		// decode frames only needed, same as sampling node.
+		const CompressedNode& compressed = (const CompressedNode&)node;
+		size_t count = compressed.frameCount;
+		if (count > 0)
+		{
+			if (time <= 0 || count == 1)
+			{
+				output = compressed.Frame(0);
+			}
+			else if (time >= 1.0f)
+			{
+				output = compressed.Frame(count - 1);
+			}
+			else
+			{
+				float elapsed = ((float)count - 1) * time;
+				int index = (int)elapsed;
+				float interval = elapsed - index;
+
+				output = compressed.Frame(index).Interpolate(compressed.Frame(index + 1), interval);
+			}
+		}
+	}
 	return output;
 }
 
@@ -544,11 +1129,52 @@ bool DKAnimation::ResampleNode(const Node& source, unsigned int frames, Sampling
 	output.frames.Clear();
 	output.frames.Reserve(frames);
 
+	// first frame:0, last frame:frames-1 (same as GetTransform)
 	for (unsigned int i = 0; i < frames; i++)
 	{
-		output.frames.Add(GetTransform(*samplingTarget, double(i)/double(frames)));
+		output.frames.Add(GetTransform(*samplingTarget, frames > 1 ? double(i)/double(frames-1) : 0.0));
+	}
+
+	return true;
+}
+
+bool DKAnimation::CompressNode(const Node& source, unsigned int frames, CompressedNode& output, float translationError, float rotationError, float scaleError)
+{
+	SamplingNode sampled;
+	if (frames == 0 || !ResampleNode(source, frames, sampled))
+		return false;
+
+	const size_t count = sampled.frames.Count();
+	DKArray<DKVector3> scales;
+	DKArray<DKVector3> translations;
+	DKArray<DKQuaternion> rotations;
+	scales.Reserve(count);
+	translations.Reserve(count);
+	rotations.Reserve(count);
+	for (const DKTransformUnit& t : sampled.frames)
+	{
+		scales.Add(t.scale);
+		translations.Add(t.translation);
+		rotations.Add(t.rotation);
 	}
 
+	output.name = source.name;
+	output.frameCount = static_cast<unsigned int>(count);
+	SetupVectorTrack(scales, Max(scaleError, 0.0f), output.scale);
+	SetupVectorTrack(translations, Max(translationError, 0.0f), output.translation);
+	SetupRotationTrack(rotations, Max(rotationError, 0.0f), output.rotation);
+
+	output.stream.Clear();
+	output.stream.Resize((count * output.FrameBits() + 31) / 32 + 1, 0U);
+	unsigned int* data = output.stream;
+	size_t offset = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		EncodeVector(output.scale, scales.Value(i), data, offset);
+		EncodeVector(output.translation, translations.Value(i), data, offset);
+		EncodeRotation(output.rotation, rotations.Value(i), data, offset);
+	}
+	DKASSERT_DEBUG(offset == count * output.FrameBits());
 	return true;
 }
 
@@ -560,6 +1186,11 @@ DKObject<DKAnimationController> DKAnimation::CreateLoopController(void)
 		float frameTime;
 		bool playing;
 
+		// pose of current frame, sampled on first request.
+		PoseCursor cursor;
+		DKArray<DKTransformUnit> pose;
+		bool poseSampled;
+
 		void UpdateFrame(float frame)
 		{
 			if (animation)
@@ -569,11 +1200,33 @@ DKObject<DKAnimationController> DKAnimation::CreateLoopController(void)
 				if (frameTime > 1.0 || frameTime < 0.0)
 					frameTime -= floor(frameTime);
 			}
+			poseSampled = false;
 		}
 		bool GetTransform(const NodeId& key, DKTransformUnit& out)
 		{
 			if (animation)
-				return animation->GetNodeTransform(key, frameTime, out);
+				return GetTransformAtIndex(animation->IndexOfNode(key), out);
+			return false;
+		}
+		NodeIndex IndexOfNode(const NodeId& key)
+		{
+			if (animation)
+				return animation->IndexOfNode(key);
+			return invalidNodeIndex;
+		}
+		bool GetTransformAtIndex(NodeIndex index, DKTransformUnit& out)
+		{
+			if (animation && index >= 0 && (size_t)index < animation->NodeCount())
+			{
+				if (!poseSampled || pose.Count() != animation->NodeCount())
+				{
+					pose.Resize(animation->NodeCount());
+					animation->SamplePose(frameTime, cursor, pose);
+					poseSampled = true;
+				}
+				out = pose.Value(index);
+				return true;
+			}
 			return false;
 		}
 		bool IsPlaying(void) const
@@ -601,6 +1254,7 @@ DKObject<DKAnimationController> DKAnimation::CreateLoopController(void)
 	con->animation = this;
 	con->frameTime = 0;
 	con->playing = false;
+	con->poseSampled = false;
 
 	return con.SafeCast<DKAnimationController>();
 }
@@ -635,6 +1289,11 @@ DKObject<DKSerializer> DKAnimation::Serializer(void)
 				DKFunction(this, &LocalSerializer::SetKeyframeNode),
 				DKFunction(this, &LocalSerializer::CheckKeyframeNode),
 				NULL);
+			this->Bind(L"compressedNodes",
+				DKFunction(this, &LocalSerializer::GetCompressedNode),
+				DKFunction(this, &LocalSerializer::SetCompressedNode),
+				DKFunction(this, &LocalSerializer::CheckCompressedNode),
+				DKFunction([]{})->Invocation());	// optional, no compressed nodes.
 
 			return this;
 		}
@@ -718,6 +1377,129 @@ DKObject<DKSerializer> DKAnimation::Serializer(void)
 			}
 			return false;
 		}
+		void GetVectorTrackVariant(DKVariant& v, const CompressedNode::VectorTrack& track) const
+		{
+			DKVariant base(DKVariant::TypeArray);
+			DKVariant step(DKVariant::TypeArray);
+			DKVariant bits(DKVariant::TypeArray);
+			for (int i = 0; i < 3; ++i)
+			{
+				base.Array().Add(DKVariant::VFloat(track.base[i]));
+				step.Array().Add(DKVariant::VFloat(track.step[i]));
+				bits.Array().Add(DKVariant::VInteger(track.bits[i]));
+			}
+			v.SetValueType(DKVariant::TypePairs);
+			v.Pairs().Insert(L"base", base);
+			v.Pairs().Insert(L"step", step);
+			v.Pairs().Insert(L"bits", bits);
+		}
+		bool SetVectorTrackVariant(const DKVariant& v, CompressedNode::VectorTrack& track) const
+		{
+			if (v.ValueType() == DKVariant::TypePairs)
+			{
+				const DKVariant::VPairs::Pair* pBase = v.Pairs().Find(L"base");
+				const DKVariant::VPairs::Pair* pStep = v.Pairs().Find(L"step");
+				const DKVariant::VPairs::Pair* pBits = v.Pairs().Find(L"bits");
+
+				if (pBase && CheckArrayValueType(pBase->value, DKVariant::TypeFloat, 3) &&
+					pStep && CheckArrayValueType(pStep->value, DKVariant::TypeFloat, 3) &&
+					pBits && CheckArrayValueType(pBits->value, DKVariant::TypeInteger, 3))
+				{
+					for (int i = 0; i < 3; ++i)
+					{
+						track.base[i] = static_cast<float>(pBase->value.Array().Value(i).Float());
+						track.step[i] = static_cast<float>(pStep->value.Array().Value(i).Float());
+						track.bits[i] = static_cast<unsigned int>(pBits->value.Array().Value(i).Integer());
+					}
+					return true;
+				}
+			}
+			return false;
+		}
+		void GetRotationTrackVariant(DKVariant& v, const CompressedNode::RotationTrack& track) const
+		{
+			v.SetValueType(DKVariant::TypePairs);
+			v.Pairs().Insert(L"constant", (const DKVariant::VQuaternion&)track.constant);
+			v.Pairs().Insert(L"bits", DKVariant::VInteger(track.bits));
+		}
+		bool SetRotationTrackVariant(const DKVariant& v, CompressedNode::RotationTrack& track) const
+		{
+			if (v.ValueType() == DKVariant::TypePairs)
+			{
+				const DKVariant::VPairs::Pair* pConstant = v.Pairs().Find(L"constant");
+				const DKVariant::VPairs::Pair* pBits = v.Pairs().Find(L"bits");
+
+				if (pConstant && pConstant->value.ValueType() == DKVariant::TypeQuaternion &&
+					pBits && pBits->value.ValueType() == DKVariant::TypeInteger)
+				{
+					track.constant = pConstant->value.Quaternion();
+					track.bits = static_cast<unsigned int>(pBits->value.Integer());
+					return true;
+				}
+			}
+			return false;
+		}
+		bool CheckArrayValueType(const DKVariant& v, DKVariant::Type type, size_t count) const
+		{
+			if (v.ValueType() == DKVariant::TypeArray && v.Array().Count() == count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (v.Array().Value(i).ValueType() != type)
+						return false;
+				}
+				return true;
+			}
+			return false;
+		}
+		void GetCompressedNodeVariant(DKVariant& v, const CompressedNode& cn) const
+		{
+			v.SetValueType(DKVariant::TypePairs);
+			v.Pairs().Insert(L"name", (const DKVariant::VString&)cn.name);
+			v.Pairs().Insert(L"frameCount", (DKVariant::VInteger)cn.frameCount);
+
+			DKVariant scale, translation, rotation;
+			DKVariant stream(DKVariant::TypeData);
+
+			GetVectorTrackVariant(scale, cn.scale);
+			GetVectorTrackVariant(translation, cn.translation);
+			GetRotationTrackVariant(rotation, cn.rotation);
+			stream.Data().SetContent((const unsigned int*)cn.stream, cn.stream.Count() * sizeof(unsigned int));
+
+			v.Pairs().Insert(L"scale", scale);
+			v.Pairs().Insert(L"translation", translation);
+			v.Pairs().Insert(L"rotation", rotation);
+			v.Pairs().Insert(L"stream", stream);
+		}
+		bool SetCompressedNodeVariant(const DKVariant& v, CompressedNode& cn) const
+		{
+			if (v.ValueType() == DKVariant::TypePairs)
+			{
+				const DKVariant::VPairs::Pair* pName = v.Pairs().Find(L"name");
+				const DKVariant::VPairs::Pair* pFrameCount = v.Pairs().Find(L"frameCount");
+				const DKVariant::VPairs::Pair* pScale = v.Pairs().Find(L"scale");
+				const DKVariant::VPairs::Pair* pTranslation = v.Pairs().Find(L"translation");
+				const DKVariant::VPairs::Pair* pRotation = v.Pairs().Find(L"rotation");
+				const DKVariant::VPairs::Pair* pStream = v.Pairs().Find(L"stream");
+
+				if (pName && pName->value.ValueType() == DKVariant::TypeString &&
+					pFrameCount && pFrameCount->value.ValueType() == DKVariant::TypeInteger &&
+					pScale && SetVectorTrackVariant(pScale->value, cn.scale) &&
+					pTranslation && SetVectorTrackVariant(pTranslation->value, cn.translation) &&
+					pRotation && SetRotationTrackVariant(pRotation->value, cn.rotation) &&
+					pStream && pStream->value.ValueType() == DKVariant::TypeData)
+				{
+					const DKData& streamData = pStream->value.Data();
+					cn.stream.Add((const unsigned int*)streamData.LockShared(), streamData.Length() / sizeof(unsigned int));
+					streamData.UnlockShared();
+
+					cn.frameCount = static_cast<unsigned int>(pFrameCount->value.Integer());
+					cn.name = pName->value.String();
+					return true;
+				}
+			}
+			return false;
+		}
 		void GetSamplingNode(DKVariant& v) const
 		{
 			v.SetValueType(DKVariant::TypeArray);
@@ -774,6 +1556,34 @@ DKObject<DKSerializer> DKAnimation::Serializer(void)
 		{
 			return v.ValueType() == DKVariant::TypeArray;
 		}
+		void GetCompressedNode(DKVariant& v) const
+		{
+			v.SetValueType(DKVariant::TypeArray);
+			v.Array().Reserve(target->nodes.Count());
+			for (const Node* n : target->nodes)
+			{
+				if (n->type == Node::NodeTypeCompressed)
+				{
+					DKVariant::VArray::Index idx = v.Array().Add(DKVariant(DKVariant::TypeUndefined));
+					GetCompressedNodeVariant(v.Array().Value(idx), *static_cast<const CompressedNode*>(n));
+				}
+			}
+		}
+		void SetCompressedNode(DKVariant& v)
+		{
+			for (size_t i = 0; i < v.Array().Count(); ++i)
+			{
+				CompressedNode cn;
+				if (SetCompressedNodeVariant(v.Array().Value(i), cn))
+				{
+					target->AddNode(&cn);
+				}
+			}
+		}
+		bool CheckCompressedNode(const DKVariant& v)
+		{
+			return v.ValueType() == DKVariant::TypeArray;
+		}
 		void GetDuration(DKVariant& v) const
 		{
 			v = (DKVariant::VFloat)target->Duration();
@@ -21,6 +21,14 @@
 // You need to create controller object (DKAnimationController) to animate
 // any kind of DKModel. (don't have to create controller for calculation only)
 //
+// For sampling all nodes at once, use SamplePose() with PoseCursor.
+// keys are stored as SoA (structure of arrays) also, pose can be sampled
+// with cached key positions (O(1) per track for sequential playback) and
+// interpolated all together.
+//
+// CompressedNode is evenly sampled node with quantized frames, frames are
+// decoded on sampling without expanding. create with CompressNode().
+//
 // Note:
 //   This class can handles affine-transform only.
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +47,7 @@ namespace DKFramework
 			{
 				NodeTypeSampling,
 				NodeTypeKeyframe,
+				NodeTypeCompressed,
 			};
 			DKFoundation::DKString	name;
 			const NodeType	type;
@@ -71,11 +80,49 @@ namespace DKFramework
 			KeyframeNode(void) : Node(NodeTypeKeyframe) {}
 			bool IsEmpty(void) const		{return translationKeys.IsEmpty() && rotationKeys.IsEmpty() && scaleKeys.IsEmpty();}
 		};
+		struct CompressedNode : public Node
+		{
+			// each component quantized in range of track.
+			// component with 0 bits is constant. (base)
+			struct VectorTrack
+			{
+				float			base[3];	// minimum value
+				float			step[3];	// quantization step
+				unsigned int	bits[3];	// bits per frame
+			};
+			// quantized with smallest three components. (index of largest
+			// component in 2 bits, and three components in bits each)
+			// track with 0 bits is constant.
+			struct RotationTrack
+			{
+				DKQuaternion	constant;
+				unsigned int	bits;
+			};
+			unsigned int	frameCount;
+			VectorTrack		scale;
+			VectorTrack		translation;
+			RotationTrack	rotation;
+			DKFoundation::DKArray<unsigned int>	stream;		// packed frames
+
+			CompressedNode(void) : Node(NodeTypeCompressed), frameCount(0) {}
+			bool IsEmpty(void) const		{return frameCount == 0;}
+			size_t FrameBits(void) const;
+			DKTransformUnit Frame(size_t index) const;	// decode frame
+		};
 		struct NodeSnapshot
 		{
 			DKFoundation::DKString	name;
 			DKTransformUnit			transform;
 		};
+		// PoseCursor: key positions of each track from last sampling, and
+		// working buffer for SamplePose(). one object per playback.
+		class PoseCursor
+		{
+			DKFoundation::DKArray<unsigned int>		keyIndices;
+			DKFoundation::DKArray<float>			buffer;
+			DKFoundation::DKArray<unsigned char>	exact;
+			friend class DKAnimation;
+		};
 
 		DKAnimation(void);
 		~DKAnimation(void);
@@ -92,11 +139,17 @@ namespace DKFramework
 		void		RemoveAllNodes(void);
 		size_t		NodeCount(void) const;
 		NodeIndex	IndexOfNode(const DKFoundation::DKString& name) const;
+		NodeIndex	IndexOfNode(const DKFoundation::DKStringAtom& name) const;
 		const Node*	NodeAtIndex(NodeIndex index) const;
 
 		// calculate transform at time ( 0.0 <= t <= 1.0 )
 		bool GetNodeTransform(NodeIndex index, float t, DKTransformUnit& output) const;
 		bool GetNodeTransform(const DKFoundation::DKString& name, float t, DKTransformUnit& output) const;
+		bool GetNodeTransform(const DKFoundation::DKStringAtom& name, float t, DKTransformUnit& output) const;
+
+		// calculate transform of all nodes at time ( 0.0 <= t <= 1.0 )
+		// output should have NodeCount() elements. (indexed by NodeIndex)
+		void SamplePose(float t, PoseCursor& cursor, DKTransformUnit* output) const;
 
 		// generate snap-shot.
 		// snap-shot can be combined with other animation object. (interpolated altogether)
@@ -114,6 +167,11 @@ namespace DKFramework
 		static bool ResampleNode(const Node& source, unsigned int frames, KeyframeNode& output, float threshold = 0.000001f);
 		static bool ResampleNode(const Node& source, unsigned int frames, SamplingNode& output);
 
+		// compress node, resampled with frames. error bounds are maximum
+		// error of each component. (rotation error is of quaternion component)
+		static bool CompressNode(const Node& source, unsigned int frames, CompressedNode& output,
+								 float translationError = 0.0001f, float rotationError = 0.0001f, float scaleError = 0.0001f);
+
 		// set animation duration.
 		void	SetDuration(float d);
 		float	Duration(void) const;
@@ -126,7 +184,31 @@ namespace DKFramework
 	private:
 		float	duration;
 
-		DKFoundation::DKMap<DKFoundation::DKString, size_t> nodeIndexMap; // for fast search
+		DKFoundation::DKHashMap<DKFoundation::DKStringAtom, size_t> nodeIndexMap; // for fast search
 		DKFoundation::DKArray<Node*>	nodes;
+
+		// copy of keys in SoA layout, for SamplePose().
+		// scale, translation keys are in vector arrays.
+		struct Track
+		{
+			size_t first;	// index of first key
+			size_t count;
+		};
+		struct NodeTracks
+		{
+			const CompressedNode* compressed;	// decoded directly, no keys copied.
+			bool uniform;	// sampling node, keys are evenly spaced.
+			Track scale;
+			Track rotation;
+			Track translation;
+		};
+		DKFoundation::DKArray<NodeTracks>	nodeTracks;
+		DKFoundation::DKArray<float>		vectorKeyTimes;
+		DKFoundation::DKArray<float>		vectorKeys[3];		// x, y, z
+		DKFoundation::DKArray<float>		rotationKeyTimes;
+		DKFoundation::DKArray<float>		rotationKeys[4];	// x, y, z, w
+
+		void AppendNodeTracks(const Node* node);
+		void RebuildNodeTracks(void);
 	};
 }
@@ -22,10 +22,19 @@ namespace DKFramework
 	class DKGL_API DKAnimatedTransform
 	{
 	public:
-		typedef DKFoundation::DKString NodeId;
+		typedef DKFoundation::DKStringAtom NodeId;	// interned node name
+		typedef long NodeIndex;
+		static const NodeIndex invalidNodeIndex = -1;
+
 		virtual ~DKAnimatedTransform(void) {}
 		virtual void Update(double timeDelta, DKFoundation::DKTimeTick tick) {}
 		virtual bool GetTransform(const NodeId& key, DKTransformUnit& out) = 0;
+
+		// resolve node to index once (on bind), and get transform with index.
+		// subclass can override for faster lookup. index is valid until
+		// animation of subclass changed.
+		virtual NodeIndex IndexOfNode(const NodeId& key)							{ return invalidNodeIndex; }
+		virtual bool GetTransformAtIndex(NodeIndex index, DKTransformUnit& out)		{ return false; }
 	};
 
 	class DKGL_API DKAnimationController : public DKAnimatedTransform
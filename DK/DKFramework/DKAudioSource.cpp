@@ -120,7 +120,7 @@ bool DKAudioSource::EnqueueBuffer(int frequency, int bits, int channels, const v
 		{
 			DKCriticalSection<DKSpinLock> guard(this->bufferLock);
 
-			DKArray<ALuint> finishedBuffers;
+			DKSmallArray<ALuint, 8> finishedBuffers;
 			ALint numBuffersProcessed = 0;
 			alGetSourcei(sourceId, AL_BUFFERS_PROCESSED, &numBuffersProcessed);
 			finishedBuffers.Reserve(numBuffersProcessed);
@@ -73,14 +73,14 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 			else
 				rp.blendState.Bind();
 
-			auto BindSampler = [&](const DKShaderConstant& sc)->bool
+			auto BindSampler = [&](const DKShaderConstant& sc, int slot)->bool
 			{
 				const TextureArray* texArray = NULL;
 				const DKTextureSampler* texSampler = NULL;
 
 				if (callback)
 				{
-					const Sampler* sampler = callback->GetSamplerProperty(sc, programIndex);
+					const Sampler* sampler = slot < 0 ? callback->GetSamplerProperty(sc, programIndex) : callback->GetSlotSamplerProperty(slot, sc, programIndex);
 					if (sampler)
 					{
 						texArray = &sampler->textures;
@@ -98,7 +98,7 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 				}
 				if (texArray)
 				{
-					DKArray<GLint> boundTexStages; // texture stage id has been bound
+					DKSmallArray<GLint, 16> boundTexStages; // texture stage id has been bound
 					boundTexStages.Reserve(sc.components);
 					for (size_t i = 0; i < texArray->Count(); ++i)
 					{
@@ -131,13 +131,13 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 				}
 				return false;
 			};
-			auto BindIntProperty = [&](const DKShaderConstant& sc)->bool
+			auto BindIntProperty = [&](const DKShaderConstant& sc, int slot)->bool
 			{
 				const GLint* values = NULL;
 				size_t count = 0;
 				if (callback)
 				{
-					auto v = callback->GetIntProperty(sc, programIndex);
+					auto v = slot < 0 ? callback->GetIntProperty(sc, programIndex) : callback->GetSlotIntProperty(slot, sc, programIndex);
 					values = v;
 					count = v.Count();
 				}
@@ -175,13 +175,13 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 				}
 				return false;
 			};
-			auto BindFloatProperty = [&](const DKShaderConstant& sc)->bool
+			auto BindFloatProperty = [&](const DKShaderConstant& sc, int slot)->bool
 			{
 				const GLfloat* values = NULL;
 				size_t count = 0;
 				if (callback)
 				{
-					auto v = callback->GetFloatProperty(sc, programIndex);
+					auto v = slot < 0 ? callback->GetFloatProperty(sc, programIndex) : callback->GetSlotFloatProperty(slot, sc, programIndex);
 					values = v;
 					count = v.Count();
 				}
@@ -225,25 +225,20 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 				return false;
 			};
 
-			// bind Uinform, Sampler into shader program.
-			for (const DKShaderConstant& sc : rp.program->uniforms)
+			auto BindUniform = [&](const DKShaderConstant& sc, DKShaderConstant::BaseType baseType, int slot)
 			{
-				if (sc.components == 0 || sc.location < 0)
-					continue;
-
 				bool result = false;
-				DKShaderConstant::BaseType baseType = DKShaderConstant::GetBaseType(sc.type);
 				switch (baseType)
 				{
 				case DKShaderConstant::BaseTypeSampler:
-					result = BindSampler(sc);
+					result = BindSampler(sc, slot);
 					break;
 				case DKShaderConstant::BaseTypeBoolean:
 				case DKShaderConstant::BaseTypeInteger:
-					result = BindIntProperty(sc);
+					result = BindIntProperty(sc, slot);
 					break;
 				case DKShaderConstant::BaseTypeFloating:
-					result = BindFloatProperty(sc);
+					result = BindFloatProperty(sc, slot);
 					break;
 				default:
 					DKLog("Warning: uniform:(%ls) is unknown type.\n", (const wchar_t*)sc.name);
@@ -254,6 +249,30 @@ bool DKMaterial::Bind(int programIndex, PropertyCallback* callback, const DKBlen
 				{
 					DKLog("Warning: uniform:(%ls) bind failed.\n", (const wchar_t*)sc.name);
 				}
+			};
+
+			// bind Uinform, Sampler into shader program.
+			if ((size_t)programIndex < this->bindingTables.Count() &&
+				this->bindingTables.Value(programIndex).program == rp.program)
+			{
+				// walk pre-resolved binding table.
+				const BindingTable& table = this->bindingTables.Value(programIndex);
+				const DKShaderConstant* uniforms = rp.program->uniforms;
+				for (const UniformBinding& ub : table.uniforms)
+				{
+					BindUniform(uniforms[ub.uniformIndex], ub.baseType, ub.slot);
+				}
+			}
+			else
+			{
+				// program has been replaced after build.
+				for (const DKShaderConstant& sc : rp.program->uniforms)
+				{
+					if (sc.components == 0 || sc.location < 0)
+						continue;
+
+					BindUniform(sc, DKShaderConstant::GetBaseType(sc.type), this->PropertySlot(sc.name));
+				}
 			}
 			return true;
 		}
@@ -394,11 +413,60 @@ bool DKMaterial::BuildProgram(int index, BuildLog* log)
 					DKLog("Warning: uniform \"%ls\" not found!\n", (const wchar_t*)s.name);
 			}
 		}
+		BuildBindingTable(index);
 		return true;
 	}
 	return false;
 }
 
+void DKMaterial::BuildBindingTable(int index)
+{
+	DKASSERT_DEBUG(index < renderingProperties.Count());
+
+	const RenderingProperty& rp = renderingProperties.Value(index);
+
+	if (bindingTables.Count() < renderingProperties.Count())
+		bindingTables.Resize(renderingProperties.Count());
+
+	BindingTable& table = bindingTables.Value(index);
+	table.program = rp.program;
+	table.uniforms.Clear();
+	if (rp.program == NULL)
+		return;
+
+	table.uniforms.Reserve(rp.program->uniforms.Count());
+	for (size_t i = 0; i < rp.program->uniforms.Count(); i++)
+	{
+		const DKShaderConstant& sc = rp.program->uniforms.Value(i);
+		if (sc.components == 0 || sc.location < 0)
+			continue;
+
+		// assign new slot for name, existing slots are never changed.
+		int slot = static_cast<int>(propertySlots.Count());
+		auto p = propertySlots.Find(sc.name);
+		if (p)
+			slot = p->value;
+		else
+			propertySlots.Insert(sc.name, slot);
+
+		UniformBinding ub = { static_cast<int>(i), slot, DKShaderConstant::GetBaseType(sc.type) };
+		table.uniforms.Add(ub);
+	}
+}
+
+int DKMaterial::PropertySlot(const DKString& name) const
+{
+	auto p = propertySlots.Find(name);
+	if (p)
+		return p->value;
+	return -1;
+}
+
+size_t DKMaterial::NumberOfPropertySlots(void) const
+{
+	return propertySlots.Count();
+}
+
 bool DKMaterial::Build(BuildLog* log)
 {
 	for (int i = 0; i < renderingProperties.Count(); i++)
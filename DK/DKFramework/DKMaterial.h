@@ -142,6 +142,13 @@ namespace DKFramework
 			virtual IntArray GetIntProperty(const DKShaderConstant&, int) = 0;
 			virtual FloatArray GetFloatProperty(const DKShaderConstant&, int) = 0;
 			virtual const Sampler* GetSamplerProperty(const DKShaderConstant&, int) = 0;
+
+			// called with property slot of material. (see PropertySlot)
+			// default implementation ignores slot.
+			virtual IntArray GetSlotIntProperty(int slot, const DKShaderConstant& sc, int programIndex)				{ return GetIntProperty(sc, programIndex); }
+			virtual FloatArray GetSlotFloatProperty(int slot, const DKShaderConstant& sc, int programIndex)			{ return GetFloatProperty(sc, programIndex); }
+			virtual const Sampler* GetSlotSamplerProperty(int slot, const DKShaderConstant& sc, int programIndex)	{ return GetSamplerProperty(sc, programIndex); }
+
 			virtual ~PropertyCallback(void) {}
 		};
 
@@ -155,6 +162,15 @@ namespace DKFramework
 
 		const DKFoundation::DKArray<DKVertexStream>& StreamArray(int state) const;
 
+		// Property slot
+		// Integer handle of uniform (or sampler) name, assigned when program
+		// has been built. slot is shared by all rendering properties of material
+		// and remains valid for the material object, even if it rebuilt.
+		// Mesh object can set properties with slot to avoid name lookup.
+		// returns -1 if name is not used by any programs.
+		int PropertySlot(const DKFoundation::DKString& name) const;
+		size_t NumberOfPropertySlots(void) const;
+
 		struct BuildLog
 		{
 			DKFoundation::DKString errorLog;
@@ -186,5 +202,24 @@ namespace DKFramework
 
 		bool Validate(void) override;
 		bool IsValid(void) const;
+
+	private:
+		// binding table: flat list of active uniforms with resolved slot,
+		// built for each rendering property when program linked.
+		struct UniformBinding
+		{
+			int uniformIndex;		// index of program's uniforms
+			int slot;
+			DKShaderConstant::BaseType baseType;
+		};
+		struct BindingTable
+		{
+			DKFoundation::DKObject<DKShaderProgram> program;
+			DKFoundation::DKArray<UniformBinding> uniforms;
+		};
+		DKFoundation::DKArray<BindingTable> bindingTables;
+		DKFoundation::DKMap<DKFoundation::DKString, int> propertySlots;
+
+		void BuildBindingTable(int index);
 	};
 }
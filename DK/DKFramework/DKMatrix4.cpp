@@ -10,9 +10,11 @@
 #include "DKVector3.h"
 #include "DKVector4.h"
 #include "DKQuaternion.h"
+#include "Private/SIMDUtils.h"
 
 using namespace DKFoundation;
 using namespace DKFramework;
+using namespace DKFramework::Private;
 
 const DKMatrix4 DKMatrix4::identity = DKMatrix4().Identity();
 
@@ -82,6 +84,9 @@ bool DKMatrix4::IsDiagonal(void) const
 DKMatrix4 DKMatrix4::operator * (const DKMatrix4& m) const
 {
 	DKMatrix4 mat;
+#ifdef DKGL_SIMD_ENABLED
+	SIMD::Matrix4Multiply(this->val, m.val, mat.val);
+#else
 	mat.m[0][0] = (this->m[0][0] * m.m[0][0]) + (this->m[0][1] * m.m[1][0]) + (this->m[0][2] * m.m[2][0]) + (this->m[0][3] * m.m[3][0]);
 	mat.m[0][1] = (this->m[0][0] * m.m[0][1]) + (this->m[0][1] * m.m[1][1]) + (this->m[0][2] * m.m[2][1]) + (this->m[0][3] * m.m[3][1]);
 	mat.m[0][2] = (this->m[0][0] * m.m[0][2]) + (this->m[0][1] * m.m[1][2]) + (this->m[0][2] * m.m[2][2]) + (this->m[0][3] * m.m[3][2]);
@@ -98,6 +103,7 @@ DKMatrix4 DKMatrix4::operator * (const DKMatrix4& m) const
 	mat.m[3][1] = (this->m[3][0] * m.m[0][1]) + (this->m[3][1] * m.m[1][1]) + (this->m[3][2] * m.m[2][1]) + (this->m[3][3] * m.m[3][1]);
 	mat.m[3][2] = (this->m[3][0] * m.m[0][2]) + (this->m[3][1] * m.m[1][2]) + (this->m[3][2] * m.m[2][2]) + (this->m[3][3] * m.m[3][2]);
 	mat.m[3][3] = (this->m[3][0] * m.m[0][3]) + (this->m[3][1] * m.m[1][3]) + (this->m[3][2] * m.m[2][3]) + (this->m[3][3] * m.m[3][3]);
+#endif
 	return mat;
 }
 
@@ -192,6 +198,9 @@ DKMatrix4 DKMatrix4::operator / (float f) const
 
 DKMatrix4& DKMatrix4::operator *= (const DKMatrix4& m)
 {
+#ifdef DKGL_SIMD_ENABLED
+	SIMD::Matrix4Multiply(this->val, m.val, this->val);
+#else
 	DKMatrix4 mat(*this);
 	this->m[0][0] = (mat.m[0][0] * m.m[0][0]) + (mat.m[0][1] * m.m[1][0]) + (mat.m[0][2] * m.m[2][0]) + (mat.m[0][3] * m.m[3][0]);
 	this->m[0][1] = (mat.m[0][0] * m.m[0][1]) + (mat.m[0][1] * m.m[1][1]) + (mat.m[0][2] * m.m[2][1]) + (mat.m[0][3] * m.m[3][1]);
@@ -209,6 +218,7 @@ DKMatrix4& DKMatrix4::operator *= (const DKMatrix4& m)
 	this->m[3][1] = (mat.m[3][0] * m.m[0][1]) + (mat.m[3][1] * m.m[1][1]) + (mat.m[3][2] * m.m[2][1]) + (mat.m[3][3] * m.m[3][1]);
 	this->m[3][2] = (mat.m[3][0] * m.m[0][2]) + (mat.m[3][1] * m.m[1][2]) + (mat.m[3][2] * m.m[2][2]) + (mat.m[3][3] * m.m[3][2]);
 	this->m[3][3] = (mat.m[3][0] * m.m[0][3]) + (mat.m[3][1] * m.m[1][3]) + (mat.m[3][2] * m.m[2][3]) + (mat.m[3][3] * m.m[3][3]);
+#endif
 	return *this;
 }
 
@@ -352,6 +362,9 @@ float DKMatrix4::Determinant(void) const
 
 bool DKMatrix4::GetInverseMatrix(DKMatrix4& matOut, float *pDeterminant) const
 {
+#ifdef DKGL_SIMD_SSE
+	return SIMD::Matrix4Inverse(this->val, matOut.val, pDeterminant);
+#else
 	float det = Determinant();
 
 	if (det != 0.0f)
@@ -379,6 +392,7 @@ bool DKMatrix4::GetInverseMatrix(DKMatrix4& matOut, float *pDeterminant) const
 		return true;
 	}
 	return false;
+#endif
 }
 
 DKMatrix4& DKMatrix4::Inverse(void)
@@ -415,6 +429,9 @@ DKMatrix4& DKMatrix4::Transpose(void)
 
 DKMatrix4& DKMatrix4::Multiply(const DKMatrix4& m)
 {
+#ifdef DKGL_SIMD_ENABLED
+	SIMD::Matrix4Multiply(this->val, m.val, this->val);
+#else
 	DKMatrix4 mat(*this);
 	this->m[0][0] = (mat.m[0][0] * m.m[0][0]) + (mat.m[0][1] * m.m[1][0]) + (mat.m[0][2] * m.m[2][0]) + (mat.m[0][3] * m.m[3][0]);
 	this->m[0][1] = (mat.m[0][0] * m.m[0][1]) + (mat.m[0][1] * m.m[1][1]) + (mat.m[0][2] * m.m[2][1]) + (mat.m[0][3] * m.m[3][1]);
@@ -432,9 +449,48 @@ DKMatrix4& DKMatrix4::Multiply(const DKMatrix4& m)
 	this->m[3][1] = (mat.m[3][0] * m.m[0][1]) + (mat.m[3][1] * m.m[1][1]) + (mat.m[3][2] * m.m[2][1]) + (mat.m[3][3] * m.m[3][1]);
 	this->m[3][2] = (mat.m[3][0] * m.m[0][2]) + (mat.m[3][1] * m.m[1][2]) + (mat.m[3][2] * m.m[2][2]) + (mat.m[3][3] * m.m[3][2]);
 	this->m[3][3] = (mat.m[3][0] * m.m[0][3]) + (mat.m[3][1] * m.m[1][3]) + (mat.m[3][2] * m.m[2][3]) + (mat.m[3][3] * m.m[3][3]);
+#endif
 	return *this;
 }
 
+void DKMatrix4::MultiplyArray(const DKMatrix4* m1, const DKMatrix4* m2, DKMatrix4* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+#ifdef DKGL_SIMD_ENABLED
+		SIMD::Matrix4Multiply(m1[i].val, m2[i].val, out[i].val);
+#else
+		out[i] = m1[i] * m2[i];
+#endif
+	}
+}
+
+void DKMatrix4::MultiplyArray(const DKMatrix4* m1, const DKMatrix4& m2, DKMatrix4* out, size_t count)
+{
+#ifdef DKGL_SIMD_ENABLED
+	const DKMatrix4 mat(m2);	// m2 can be one of output.
+	for (size_t i = 0; i < count; ++i)
+		SIMD::Matrix4Multiply(m1[i].val, mat.val, out[i].val);
+#else
+	const DKMatrix4 mat(m2);
+	for (size_t i = 0; i < count; ++i)
+		out[i] = m1[i] * mat;
+#endif
+}
+
+void DKMatrix4::MultiplyArray(const DKMatrix4& m1, const DKMatrix4* m2, DKMatrix4* out, size_t count)
+{
+#ifdef DKGL_SIMD_ENABLED
+	const DKMatrix4 mat(m1);	// m1 can be one of output.
+	for (size_t i = 0; i < count; ++i)
+		SIMD::Matrix4Multiply(mat.val, m2[i].val, out[i].val);
+#else
+	const DKMatrix4 mat(m1);
+	for (size_t i = 0; i < count; ++i)
+		out[i] = mat * m2[i];
+#endif
+}
+
 DKVector4 DKMatrix4::Row1(void) const
 {
 	return DKVector4(m[0][0], m[0][1], m[0][2], m[0][3]);
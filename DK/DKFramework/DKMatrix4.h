@@ -42,6 +42,14 @@ namespace DKFramework
 		float Determinant(void) const;
 		bool GetInverseMatrix(DKMatrix4& matOut, float *pDeterminant) const;
 
+		// batch multiplication, out[i] = m1[i] * m2[i]
+		// output array can be one of input arrays.
+		static void MultiplyArray(const DKMatrix4* m1, const DKMatrix4* m2, DKMatrix4* out, size_t count);
+		// out[i] = m1[i] * m2
+		static void MultiplyArray(const DKMatrix4* m1, const DKMatrix4& m2, DKMatrix4* out, size_t count);
+		// out[i] = m1 * m2[i]
+		static void MultiplyArray(const DKMatrix4& m1, const DKMatrix4* m2, DKMatrix4* out, size_t count);
+
 		DKMatrix4 operator * (const DKMatrix4& m) const;
 		DKMatrix4 operator + (const DKMatrix4& m) const;
 		DKMatrix4 operator - (const DKMatrix4& m) const;
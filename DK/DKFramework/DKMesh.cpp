@@ -12,6 +12,7 @@
 #include "DKTextureCube.h"
 #include "DKOpenGLContext.h"
 #include "DKRenderTarget.h"
+#include "DKAabbTree.h"
 
 using namespace DKFoundation;
 using namespace DKFramework;
@@ -23,6 +24,7 @@ DKMesh::DKMesh(void)
 , scale(1, 1, 1)
 , hidden(false)
 , drawingGroupFlags(1)
+, cullingProxy(DKAabbTree::NullProxy)
 {
 }
 
@@ -32,10 +34,16 @@ DKMesh::~DKMesh(void)
 
 void DKMesh::SetMaterial(DKMaterial* m)
 {
+	if (material != m)
+	{
+		// slots are valid for the material only.
+		slotProperties.Clear();
+		slotSamplers.Clear();
+	}
 	material = m;
 }
 
-void DKMesh::AppendSampler(const DKString& name, DKTexture* texture)
+void DKMesh::AppendSampler(const DKStringAtom& name, DKTexture* texture)
 {
 	if (texture)
 	{
@@ -43,7 +51,7 @@ void DKMesh::AppendSampler(const DKString& name, DKTexture* texture)
 	}
 }
 
-void DKMesh::SetSampler(const DKFoundation::DKString& name, DKTexture* texture, DKTextureSampler* sampler)
+void DKMesh::SetSampler(const DKStringAtom& name, DKTexture* texture, DKTextureSampler* sampler)
 {
 	if (texture)
 	{
@@ -56,7 +64,7 @@ void DKMesh::SetSampler(const DKFoundation::DKString& name, DKTexture* texture,
 		samplers.Remove(name);
 }
 
-void DKMesh::SetSampler(const DKString& name, const TextureArray& textures, DKTextureSampler* sampler)
+void DKMesh::SetSampler(const DKStringAtom& name, const TextureArray& textures, DKTextureSampler* sampler)
 {
 	if (textures.IsEmpty())
 	{
@@ -83,14 +91,14 @@ void DKMesh::SetSampler(const DKString& name, const TextureArray& textures, DKTe
 	}
 }
 
-const DKMesh::TextureSampler* DKMesh::Sampler(const DKString& name) const
+const DKMesh::TextureSampler* DKMesh::Sampler(const DKStringAtom& name) const
 {
 	auto p = samplers.Find(name);
 	if (p)		return &p->value;
 	return NULL;
 }
 
-DKMesh::TextureSampler* DKMesh::Sampler(const DKString& name)
+DKMesh::TextureSampler* DKMesh::Sampler(const DKStringAtom& name)
 {
 	auto p = samplers.Find(name);
 	if (p)		return &p->value;
@@ -102,7 +110,7 @@ size_t DKMesh::SamplerCount(void) const
 	return samplers.Count();
 }
 
-void DKMesh::RemoveSampler(const DKFoundation::DKString& name)
+void DKMesh::RemoveSampler(const DKStringAtom& name)
 {
 	samplers.Remove(name);
 }
@@ -110,33 +118,74 @@ void DKMesh::RemoveSampler(const DKFoundation::DKString& name)
 void DKMesh::RemoveAllSamplers(void)
 {
 	samplers.Clear();
+	slotSamplers.Clear();
 }
 
-void DKMesh::SetMaterialProperty(const DKString& name, const PropertyArray& value)
+void DKMesh::SetSampler(int slot, DKTexture* texture, DKTextureSampler* sampler)
+{
+	if (slot < 0)
+		return;
+
+	if (texture)
+	{
+		if (slotSamplers.Count() <= (size_t)slot)
+			slotSamplers.Resize(slot + 1);
+
+		DKMaterial::Sampler& s = slotSamplers.Value(slot);
+		s.textures.Clear();
+		s.textures.Add(texture);
+		s.sampler = sampler;
+	}
+	else
+		RemoveSampler(slot);
+}
+
+const DKMesh::TextureSampler* DKMesh::Sampler(int slot) const
+{
+	if (slot >= 0 && (size_t)slot < slotSamplers.Count())
+	{
+		const TextureSampler& s = slotSamplers.Value(slot);
+		if (s.textures.Count() > 0)
+			return &s;
+	}
+	return NULL;
+}
+
+void DKMesh::RemoveSampler(int slot)
+{
+	if (slot >= 0 && (size_t)slot < slotSamplers.Count())
+	{
+		DKMaterial::Sampler& s = slotSamplers.Value(slot);
+		s.textures.Clear();
+		s.sampler = NULL;
+	}
+}
+
+void DKMesh::SetMaterialProperty(const DKStringAtom& name, const PropertyArray& value)
 {
 	materialProperties.Update(name, value);
 }
 
-size_t DKMesh::MaterialPropertyCount(const DKString& name) const
+size_t DKMesh::MaterialPropertyCount(const DKStringAtom& name) const
 {
 	return materialProperties.Count();
 }
 
-const DKMesh::PropertyArray* DKMesh::MaterialProperty(const DKString& name) const
+const DKMesh::PropertyArray* DKMesh::MaterialProperty(const DKStringAtom& name) const
 {
 	const PropertyMap::Pair* p = materialProperties.Find(name);
 	if (p)		return &p->value;
 	return NULL;
 }
 
-DKMesh::PropertyArray* DKMesh::MaterialProperty(const DKString& name)
+DKMesh::PropertyArray* DKMesh::MaterialProperty(const DKStringAtom& name)
 {
 	PropertyMap::Pair* p = materialProperties.Find(name);
 	if (p)		return &p->value;
 	return NULL;
 }
 
-void DKMesh::RemoveMaterialProperty(const DKString& name)
+void DKMesh::RemoveMaterialProperty(const DKStringAtom& name)
 {
 	materialProperties.Remove(name);
 }
@@ -144,6 +193,44 @@ void DKMesh::RemoveMaterialProperty(const DKString& name)
 void DKMesh::RemoveAllMaterialProperties(void)
 {
 	materialProperties.Clear();
+	slotProperties.Clear();
+}
+
+void DKMesh::SetMaterialProperty(int slot, const PropertyArray& value)
+{
+	if (slot < 0)
+		return;
+
+	if (slotProperties.Count() <= (size_t)slot)
+		slotProperties.Resize(slot + 1);
+
+	PropertyArray& p = slotProperties.Value(slot);
+	// reuse storage, property can be updated every frame.
+	p.integers.Clear();
+	p.floatings.Clear();
+	p.integers.Add(value.integers);
+	p.floatings.Add(value.floatings);
+}
+
+const DKMesh::PropertyArray* DKMesh::MaterialProperty(int slot) const
+{
+	if (slot >= 0 && (size_t)slot < slotProperties.Count())
+	{
+		const PropertyArray& p = slotProperties.Value(slot);
+		if (p.integers.Count() > 0 || p.floatings.Count() > 0)
+			return &p;
+	}
+	return NULL;
+}
+
+void DKMesh::RemoveMaterialProperty(int slot)
+{
+	if (slot >= 0 && (size_t)slot < slotProperties.Count())
+	{
+		PropertyArray& p = slotProperties.Value(slot);
+		p.integers.Clear();
+		p.floatings.Clear();
+	}
 }
 
 DKAabb DKMesh::ScaledAabb(void) const
@@ -168,13 +255,9 @@ const DKMatrix4& DKMesh::ScaledWorldTransformMatrix(void) const
 
 bool DKMesh::BindTransform(DKSceneState& st) const
 {
-	st.modelMatrix = this->ScaledWorldTransformMatrix();
-	st.modelMatrixInverse = DKMatrix4(st.modelMatrix).Inverse();
-	st.modelViewMatrix = st.modelMatrix * st.viewMatrix;
-	st.modelViewMatrixInverse = DKMatrix4(st.modelViewMatrix).Inverse();
-	st.modelViewProjectionMatrix = st.modelMatrix * st.viewProjectionMatrix;
-	st.modelViewProjectionMatrixInverse = DKMatrix4(st.modelViewProjectionMatrix).Inverse();
-
+	// other matrices (inverse, model-view, etc.) will be calculated by
+	// scene-state only if shader program requests it.
+	st.SetModelMatrix(this->ScaledWorldTransformMatrix());
 	return true;
 }
 
@@ -225,6 +308,8 @@ bool DKMesh::Bind(DKSceneState& ss, RenderInfo* info, const DKBlendState* blendi
 			{
 				ss.materialProperties = &this->materialProperties;
 				ss.materialSamplers = &this->samplers;
+				ss.materialSlotProperties = &this->slotProperties;
+				ss.materialSlotSamplers = &this->slotSamplers;
 
 				int minElements = 0x7fffffff;
 				const DKArray<DKVertexStream>& streams = material->StreamArray(ss.sceneIndex);
@@ -286,6 +371,8 @@ DKMesh* DKMesh::Copy(UUIDObjectMap& uuids, const DKMesh* mesh)
 		this->boundingSphere = mesh->boundingSphere;
 		this->materialProperties = mesh->materialProperties;
 		this->samplers = mesh->samplers;
+		this->slotProperties = mesh->slotProperties;
+		this->slotSamplers = mesh->slotSamplers;
 		this->material = mesh->material;
 		this->scale = mesh->scale;
 		this->hidden = mesh->hidden;
@@ -553,7 +640,7 @@ DKObject<DKSerializer> DKMesh::Serializer(void)
 					const DKResource* res = pair.value.textures.Value(i).SafeCast<DKResource>();
 					if (res)
 					{
-						DKString texKey = DKString::Format("Sampler:%ls:%u", (const wchar_t*)pair.key, i);
+						DKString texKey = DKString::Format("Sampler:%ls:%u", (const wchar_t*)pair.key.String(), i);
 						texArray.Array().Add((const DKVariant::VString&)texKey);
 					}
 				}
@@ -595,7 +682,7 @@ DKObject<DKSerializer> DKMesh::Serializer(void)
 					DKResource* res = pair.value.textures.Value(i).SafeCast<DKResource>();
 					if (res)
 					{
-						DKString texKey = DKString::Format("Sampler:%ls:%u", (const wchar_t*)pair.key, i);
+						DKString texKey = DKString::Format("Sampler:%ls:%u", (const wchar_t*)pair.key.String(), i);
 						v.Insert(texKey, res);
 					}
 				}
@@ -41,9 +41,9 @@ namespace DKFramework
 		};
 		using TextureArray = DKMaterial::TextureArray;
 		using TextureSampler = DKMaterial::Sampler;
-		using TextureSamplerMap = DKFoundation::DKMap<DKFoundation::DKString, TextureSampler>;
+		using TextureSamplerMap = DKFoundation::DKHashMap<DKFoundation::DKStringAtom, TextureSampler>;
 		using PropertyArray = DKMaterial::PropertyArray;
-		using PropertyMap = DKFoundation::DKMap<DKFoundation::DKString, PropertyArray>;
+		using PropertyMap = DKFoundation::DKHashMap<DKFoundation::DKStringAtom, PropertyArray>;
 
 		// material
 		DKMaterial* Material(void)								{return material;}
@@ -52,28 +52,40 @@ namespace DKFramework
 		virtual bool CanAdoptMaterial(const DKMaterial* m) const {return false;}
 		virtual void SetMaterial(DKMaterial* m); // assigning material.
 
+		// samplers and properties are keyed by interned name (DKStringAtom),
+		// passing atom skips string hashing and comparison.
 		// Append texture to sampler for name.
-		void AppendSampler(const DKFoundation::DKString& name, DKTexture* texture);
+		void AppendSampler(const DKFoundation::DKStringAtom& name, DKTexture* texture);
 		// Set multiple textures and one sampler for name.
-		void SetSampler(const DKFoundation::DKString& name, const TextureArray& textures, DKTextureSampler* sampler);
+		void SetSampler(const DKFoundation::DKStringAtom& name, const TextureArray& textures, DKTextureSampler* sampler);
 		// Set one texture and one sampler for name. (Remove sampler if texture is NULL)
-		void SetSampler(const DKFoundation::DKString& name, DKTexture* texture, DKTextureSampler* sampler);
+		void SetSampler(const DKFoundation::DKStringAtom& name, DKTexture* texture, DKTextureSampler* sampler);
 		// get sampler data
-		TextureSampler* Sampler(const DKFoundation::DKString& name);
-		const TextureSampler* Sampler(const DKFoundation::DKString& name) const;
+		TextureSampler* Sampler(const DKFoundation::DKStringAtom& name);
+		const TextureSampler* Sampler(const DKFoundation::DKStringAtom& name) const;
 		size_t SamplerCount(void) const;
 		// remove sampler
-		void RemoveSampler(const DKFoundation::DKString& name);
+		void RemoveSampler(const DKFoundation::DKStringAtom& name);
 		void RemoveAllSamplers(void);
 
 		// Material Properties
-		void SetMaterialProperty(const DKFoundation::DKString& name, const PropertyArray& value);
-		size_t MaterialPropertyCount(const DKFoundation::DKString& name) const;
-		const PropertyArray* MaterialProperty(const DKFoundation::DKString& name) const;
-		PropertyArray* MaterialProperty(const DKFoundation::DKString& name);
-		void RemoveMaterialProperty(const DKFoundation::DKString& name);
+		void SetMaterialProperty(const DKFoundation::DKStringAtom& name, const PropertyArray& value);
+		size_t MaterialPropertyCount(const DKFoundation::DKStringAtom& name) const;
+		const PropertyArray* MaterialProperty(const DKFoundation::DKStringAtom& name) const;
+		PropertyArray* MaterialProperty(const DKFoundation::DKStringAtom& name);
+		void RemoveMaterialProperty(const DKFoundation::DKStringAtom& name);
 		void RemoveAllMaterialProperties(void);
 
+		// Slot properties, slot should be acquired from DKMaterial::PropertySlot().
+		// values set by slot overrides values set by name, and will be
+		// removed when material changed.
+		void SetMaterialProperty(int slot, const PropertyArray& value);
+		const PropertyArray* MaterialProperty(int slot) const;
+		void RemoveMaterialProperty(int slot);
+		void SetSampler(int slot, DKTexture* texture, DKTextureSampler* sampler);
+		const TextureSampler* Sampler(int slot) const;
+		void RemoveSampler(int slot);
+
 		// get property maps to access directly.
 		const PropertyMap& MaterialPropertyMap(void) const		{return materialProperties;}
 		const TextureSamplerMap& SamplerMap(void) const			{ return samplers; }
@@ -89,8 +101,8 @@ namespace DKFramework
 		void SetDrawFace(DrawFaceMode face)		{drawFace = face;}
 		DrawFaceMode DrawFace(void) const		{return drawFace;}
 
-		void SetScale(float s)					{ scale = DKVector3(s, s, s); }
-		void SetScale(const DKVector3& s)		{ scale = s; }
+		void SetScale(float s)					{ scale = DKVector3(s, s, s); MarkTransformDirty(); }
+		void SetScale(const DKVector3& s)		{ scale = s; MarkTransformDirty(); }
 		const DKVector3& Scale(void) const		{ return scale; }
 
 		bool IsHidden(void) const				{ return hidden; }
@@ -98,7 +110,7 @@ namespace DKFramework
 
 		// Bounding information for collision (optional)
 		void SetAabb(const DKAabb& aabb)				{ this->aabb = aabb; }
-		void SetBoundingSphere(const DKSphere& sphere)	{ this->boundingSphere = sphere; }
+		void SetBoundingSphere(const DKSphere& sphere)	{ this->boundingSphere = sphere; MarkTransformDirty(); }
 		const DKAabb& Aabb(void) const					{ return this->aabb; }
 		const DKSphere& BoundingSphere(void) const		{ return this->boundingSphere; }
 
@@ -147,6 +159,14 @@ namespace DKFramework
 		// samplers will overrides material's
 		TextureSamplerMap	samplers;
 
+		// properties, samplers indexed by material's property slot.
+		DKFoundation::DKArray<PropertyArray>	slotProperties;
+		DKFoundation::DKArray<TextureSampler>	slotSamplers;
+
 		DKFoundation::DKObject<DKMaterial>	material;
+
+	private:
+		int cullingProxy;	// proxy ID of scene's DKAabbTree, managed by DKScene.
+		friend class DKScene;
 	};
 }
@@ -12,7 +12,9 @@ using namespace DKFoundation;
 using namespace DKFramework;
 
 DKModel::DKModel(Type t)
-: type(t), parent(NULL), scene(NULL), hideDescendants(false), needResolveTree(true)
+: type(t), parent(NULL), scene(NULL), animationNodeIndex(DKAnimatedTransform::invalidNodeIndex)
+, hideDescendants(false), needResolveTree(true)
+, transformDirty(true), descendantTransformDirty(false), needFlattenTree(true)
 {
 }
 
@@ -31,6 +33,7 @@ DKModel::~DKModel(void)
 		c->parent = NULL;
 		c->OnRemovedFromParent();
 		c->needResolveTree = true;
+		c->needFlattenTree = true;
 	}
 	children.Clear();
 }
@@ -60,6 +63,8 @@ bool DKModel::AddChild(DKModel* obj)
 			obj->parent = this;
 			this->children.Add(obj);
 			obj->OnAddedToParent();
+			obj->flattenedTree.Clear();
+			obj->MarkTransformDirty();
 
 			if (this->scene != obj->scene)
 			{
@@ -68,7 +73,9 @@ bool DKModel::AddChild(DKModel* obj)
 					this->scene->AddObject(obj);
 			}
 
-			this->RootObject()->needResolveTree = true;
+			DKModel* root = this->RootObject();
+			root->needResolveTree = true;
+			root->needFlattenTree = true;
 			return true;
 		}
 	}
@@ -95,7 +102,12 @@ void DKModel::RemoveFromParent(void)
 		this->parent = NULL;
 		this->OnRemovedFromParent();
 		this->needResolveTree = true;
-		p->RootObject()->needResolveTree = true;
+		this->needFlattenTree = true;
+		this->MarkTransformDirty();
+
+		DKModel* root = p->RootObject();
+		root->needResolveTree = true;
+		root->needFlattenTree = true;
 	}
 }
 
@@ -132,7 +144,20 @@ size_t DKModel::NumberOfDescendants(void) const
 
 DKModel* DKModel::FindDescendant(const DKFoundation::DKString& name)
 {
-	if (Name() == name)
+	DKStringAtom key = DKStringAtom::Find(name);
+	if (key.IsEmpty() && name.Length() > 0)
+		return NULL;	// name not interned, no object has this name.
+	return FindDescendant(key);
+}
+
+const DKModel* DKModel::FindDescendant(const DKFoundation::DKString& name) const
+{
+	return const_cast<DKModel&>(*this).FindDescendant(name);
+}
+
+DKModel* DKModel::FindDescendant(const DKFoundation::DKStringAtom& name)
+{
+	if (NameAtom() == name)
 		return this;
 	for (DKModel* obj : children)
 	{
@@ -143,7 +168,7 @@ DKModel* DKModel::FindDescendant(const DKFoundation::DKString& name)
 	return NULL;
 }
 
-const DKModel* DKModel::FindDescendant(const DKFoundation::DKString& name) const
+const DKModel* DKModel::FindDescendant(const DKFoundation::DKStringAtom& name) const
 {
 	return const_cast<DKModel&>(*this).FindDescendant(name);
 }
@@ -258,6 +283,9 @@ void DKModel::SetAnimation(DKAnimatedTransform* anim, bool recursive)
 	if (this->animation != anim)
 	{
 		this->animation = anim;
+		// node index will be resolved on next update.
+		this->animationNodeIndex = DKAnimatedTransform::invalidNodeIndex;
+		this->animationNodeName = DKStringAtom();
 		this->OnSetAnimation(anim);
 	}
 
@@ -275,6 +303,7 @@ void DKModel::SetWorldTransform(const DKNSTransform& t)
 		localTransform = t * DKNSTransform(parent->WorldTransform()).Inverse();
 	else
 		localTransform = t;
+	MarkTransformDirty();
 }
 
 void DKModel::SetLocalTransform(const DKNSTransform& t)
@@ -284,6 +313,14 @@ void DKModel::SetLocalTransform(const DKNSTransform& t)
 		worldTransform = t * parent->WorldTransform();
 	else
 		worldTransform = t;
+	MarkTransformDirty();
+}
+
+void DKModel::MarkTransformDirty(void)
+{
+	transformDirty = true;
+	for (DKModel* p = parent; p && !p->descendantTransformDirty; p = p->parent)
+		p->descendantTransformDirty = true;
 }
 
 void DKModel::CreateNamedObjectMap(NamedObjectMap& map)
@@ -352,8 +389,22 @@ void DKModel::OnUpdateKinematic(double timeDelta, DKTimeTick tick)
 	if (this->animation)
 	{
 		this->animation->Update(timeDelta, tick);
+
+		// resolve node index once, or again if name has changed.
+		const DKStringAtom& name = this->NameAtom();
+		if (name != this->animationNodeName)
+		{
+			this->animationNodeName = name;
+			this->animationNodeIndex = name.IsEmpty() ? DKAnimatedTransform::invalidNodeIndex : this->animation->IndexOfNode(name);
+		}
+
 		DKTransformUnit tu;
-		if (this->animation->GetTransform(this->Name(), tu))
+		bool found;
+		if (this->animationNodeIndex != DKAnimatedTransform::invalidNodeIndex)
+			found = this->animation->GetTransformAtIndex(this->animationNodeIndex, tu);
+		else
+			found = this->animation->GetTransform(name, tu);
+		if (found)
 		{
 			DKNSTransform trans = DKNSTransform(tu.rotation, tu.translation);
 			this->SetLocalTransform(trans);
@@ -383,9 +434,102 @@ void DKModel::OnUpdateSceneState(const DKNSTransform& t)
 void DKModel::UpdateSceneState(const DKNSTransform& t)
 {
 	this->OnUpdateSceneState(t);
+	this->transformDirty = false;
+	this->descendantTransformDirty = false;
 
 	for (DKModel* c : children)
 		c->UpdateSceneState(this->worldTransform);
+
+	this->OnUpdateDependentSceneState();
+}
+
+void DKModel::FlattenTree(void)
+{
+	DKASSERT_DEBUG(parent == NULL);
+
+	struct _Flatten
+	{
+		DKArray<FlattenedNode>& nodes;
+		// returns true if any node of subtree should be updated always.
+		bool operator () (DKModel* model, size_t parentIndex)
+		{
+			bool dependent = model->DependsOnOtherNodes();
+			bool always = dependent || model->NeedsUpdateSceneStateAlways();
+			size_t index = nodes.Add(FlattenedNode{ model, parentIndex, 0, always, always, true, dependent });
+			bool subtreeAlways = always;
+			for (DKModel* c : model->children)
+			{
+				if (this->operator()(c, index))
+					subtreeAlways = true;
+			}
+			FlattenedNode& node = nodes.Value(index);
+			node.subtreeEnd = nodes.Count();
+			node.subtreeUpdateAlways = subtreeAlways;
+			return subtreeAlways;
+		}
+	};
+
+	flattenedTree.Clear();
+	flattenedTree.Reserve(NumberOfDescendants() + 1);
+	_Flatten{ flattenedTree }(this, (size_t)-1);
+	needFlattenTree = false;
+}
+
+void DKModel::UpdateDirtySceneState(DKArray<DKModel*>& updatedMeshes, DKArray<DKModel*>& dependentNodes)
+{
+	DKASSERT_DEBUG(parent == NULL);
+
+	// update all nodes when tree has changed.
+	bool updateAll = needFlattenTree;
+	if (needFlattenTree)
+		FlattenTree();
+
+	// parent precedes children, parent's changed flag is valid when
+	// visiting children. unchanged subtree can be skipped at once.
+	const size_t count = flattenedTree.Count();
+	size_t index = 0;
+	while (index < count)
+	{
+		FlattenedNode& node = flattenedTree.Value(index);
+		DKModel* model = node.model;
+		DKASSERT_DEBUG(node.parentIndex == (size_t)-1 || flattenedTree.Value(node.parentIndex).model == model->parent);
+
+		bool parentChanged = updateAll;
+		if (node.parentIndex < index)
+			parentChanged = flattenedTree.Value(node.parentIndex).changed;
+
+		const DKNSTransform& parentTransform = model->parent ? model->parent->worldTransform : DKNSTransform::identity;
+		if (parentChanged || model->transformDirty)
+		{
+			model->OnUpdateSceneState(parentTransform);
+			node.changed = true;
+		}
+		else if (model->descendantTransformDirty || node.subtreeUpdateAlways)
+		{
+			if (node.updateAlways)
+			{
+				DKNSTransform prev = model->worldTransform;
+				model->OnUpdateSceneState(parentTransform);
+				node.changed = prev != model->worldTransform;
+			}
+			else
+				node.changed = false;
+		}
+		else
+		{
+			// nothing changed in this subtree.
+			index = node.subtreeEnd;
+			continue;
+		}
+
+		model->transformDirty = false;
+		model->descendantTransformDirty = false;
+		if (node.changed && model->type == TypeMesh)
+			updatedMeshes.Add(model);
+		if (node.dependent)
+			dependentNodes.Add(model);
+		index++;
+	}
 }
 
 void DKModel::UpdateLocalTransform(bool recursive)
@@ -461,6 +605,7 @@ DKModel* DKModel::Copy(UUIDObjectMap& uuids, const DKModel* obj)
 		this->SetName(obj->Name());
 		this->localTransform = obj->localTransform;
 		this->worldTransform = obj->worldTransform;
+		this->MarkTransformDirty();
 
 		for (const DKModel* m : obj->children)
 		{
@@ -508,6 +653,7 @@ DKObject<DKSerializer> DKModel::Serializer(void)
 			{
 				target->localTransform.Identity();
 			}
+			target->MarkTransformDirty();
 		}
 		bool CheckLocalTransform(const DKVariant& v)
 		{
@@ -516,6 +662,7 @@ DKObject<DKSerializer> DKModel::Serializer(void)
 		void ResetLocalTransform(void)
 		{
 			target->localTransform.Identity();
+			target->MarkTransformDirty();
 		}
 		// children
 		void GetChildren(ExternalArrayType& v)
@@ -26,6 +26,10 @@
 //    In case of constraint (DKConstraint), not all objects can be accepted as
 //    parent which is DKConstraint's reference bodies. You can overrides this
 //    behavior.
+//    Scene-state of unchanged subtrees is not updated by DKScene. transform
+//    setters mark node dirty, if you modify localTransform or worldTransform
+//    directly, call MarkTransformDirty(). Independent root trees are updated
+//    in parallel, OnUpdateSceneState() can be called from worker threads.
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace DKFramework
@@ -72,6 +76,8 @@ namespace DKFramework
 		size_t NumberOfDescendants(void) const;
 		DKModel* FindDescendant(const DKFoundation::DKString&);
 		const DKModel* FindDescendant(const DKFoundation::DKString&) const;
+		DKModel* FindDescendant(const DKFoundation::DKStringAtom&);
+		const DKModel* FindDescendant(const DKFoundation::DKStringAtom&) const;
 		DKModel* FindCommonAncestor(DKModel*, DKModel*, Type t = TypeCustom);
 
 		DKModel* ChildAtIndex(unsigned int i)					{ return children.Value(i); }
@@ -129,6 +135,23 @@ namespace DKFramework
 		// OnUpdateSceneState: called after simulate, before render.
 		virtual void OnUpdateSceneState(const DKNSTransform& parentWorldTransform);
 
+		// NeedsUpdateSceneStateAlways: return true if scene-state depends on
+		// other than transform of self and ancestors. (physics, other nodes)
+		// this value is cached when tree changed, should not be changed.
+		virtual bool NeedsUpdateSceneStateAlways(void) const { return false; }
+
+		// OnUpdateDependentSceneState: called after world-transform of all
+		// nodes in scene updated, on calling thread. scene-state depends on
+		// other nodes (can be in other tree) should be updated here.
+		virtual void OnUpdateDependentSceneState(void) {}
+		// DependsOnOtherNodes: return true to have OnUpdateDependentSceneState
+		// called. this value is cached when tree changed, like above.
+		virtual bool DependsOnOtherNodes(void) const { return false; }
+
+		// MarkTransformDirty: mark scene-state of node and descendants
+		// should be updated. (ancestors will be marked also)
+		void MarkTransformDirty(void);
+
 		// ResolveTree: update descendants.
 		// this calls OnUpdateTreeReferences() if necessary.
 		void ResolveTree(bool force = false);
@@ -167,12 +190,40 @@ namespace DKFramework
 		DKScene* scene;
 		DKFoundation::DKArray<DKFoundation::DKObject<DKModel>> children;
 		DKFoundation::DKObject<DKAnimatedTransform> animation;
+		// index of node in animation, resolved with name once.
+		DKAnimatedTransform::NodeIndex animationNodeIndex;
+		DKFoundation::DKStringAtom animationNodeName;
 
 		bool hideDescendants;
 
 		// set true to call OnUpdateTreeReferences() when next update.
 		bool needResolveTree;
 
+		// dirty flags, cleared on scene-state updated.
+		bool transformDirty;
+		bool descendantTransformDirty;
+
+		// tree flattened with depth-first pre-order (root object only)
+		// parent precedes children, descendants are contiguous.
+		struct FlattenedNode
+		{
+			DKModel* model;
+			size_t parentIndex;
+			size_t subtreeEnd;		// index after last descendant
+			bool updateAlways;
+			bool subtreeUpdateAlways;
+			bool changed;			// world-transform changed on last update
+			bool dependent;			// depends on other nodes
+		};
+		DKFoundation::DKArray<FlattenedNode> flattenedTree;
+		bool needFlattenTree;
+
+		void FlattenTree(void);
+		// update scene-state of dirty nodes, changed meshes are appended.
+		// nodes depend on other nodes are appended to dependentNodes, caller
+		// should call OnUpdateDependentSceneState() after all trees updated.
+		void UpdateDirtySceneState(DKFoundation::DKArray<DKModel*>& updatedMeshes, DKFoundation::DKArray<DKModel*>& dependentNodes);
+
 		bool EnumerateInternal(Enumerator* e);
 		void EnumerateInternal(EnumeratorLoop* e);
 		bool EnumerateInternal(ConstEnumerator* e) const;
@@ -0,0 +1,135 @@
+//
+//  File: DKOpenGLRecorder.cpp
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#include "DKOpenGLRecorder.h"
+
+using namespace DKFoundation;
+using namespace DKFramework;
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		static DKSpinLock						recorderLock;
+		static bool								recordingEnabled = false;
+		static DKOpenGLRecorder::Counters		recorderCounters = {};
+		static DKOpenGLRecorder::CommandArray	recordedCommands;
+	}
+}
+using namespace DKFramework::Private;
+
+
+bool DKOpenGLRecorder::IsAvailable(void)
+{
+#ifdef DKGL_OPENGL_NULL
+	return true;
+#else
+	return false;
+#endif
+}
+
+void DKOpenGLRecorder::SetRecordingEnabled(bool enable)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+	recordingEnabled = enable;
+}
+
+bool DKOpenGLRecorder::IsRecordingEnabled(void)
+{
+	return recordingEnabled;
+}
+
+void DKOpenGLRecorder::Reset(void)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+	memset(&recorderCounters, 0, sizeof(Counters));
+	recordedCommands.Clear();
+}
+
+DKOpenGLRecorder::Counters DKOpenGLRecorder::GetCounters(void)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+	return recorderCounters;
+}
+
+DKOpenGLRecorder::CommandArray DKOpenGLRecorder::Commands(void)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+	return recordedCommands;
+}
+
+size_t DKOpenGLRecorder::NumberOfCommands(void)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+	return recordedCommands.Count();
+}
+
+const char* DKOpenGLRecorder::CommandTypeToString(CommandType t)
+{
+	switch (t)
+	{
+	case CommandState:			return "State";
+	case CommandBind:			return "Bind";
+	case CommandUniform:		return "Uniform";
+	case CommandBufferUpload:	return "BufferUpload";
+	case CommandTextureUpload:	return "TextureUpload";
+	case CommandClear:			return "Clear";
+	case CommandDraw:			return "Draw";
+	case CommandResource:		return "Resource";
+	case CommandQuery:			return "Query";
+	case CommandSync:			return "Sync";
+	}
+	return "Unknown";
+}
+
+void DKOpenGLRecorder::Record(const Command& cmd)
+{
+	DKCriticalSection<DKSpinLock> guard(recorderLock);
+
+	recorderCounters.commands++;
+	switch (cmd.type)
+	{
+	case CommandState:
+		recorderCounters.stateChanges++;
+		break;
+	case CommandBind:
+		recorderCounters.bindings++;
+		break;
+	case CommandUniform:
+		recorderCounters.uniformUpdates++;
+		recorderCounters.uploadBytes += cmd.bytes;
+		break;
+	case CommandBufferUpload:
+		recorderCounters.bufferUploads++;
+		recorderCounters.uploadBytes += cmd.bytes;
+		break;
+	case CommandTextureUpload:
+		recorderCounters.textureUploads++;
+		recorderCounters.uploadBytes += cmd.bytes;
+		break;
+	case CommandClear:
+		recorderCounters.clears++;
+		break;
+	case CommandDraw:
+		// args: mode, count, instances
+		recorderCounters.drawCalls++;
+		recorderCounters.vertices += cmd.args[1];
+		recorderCounters.instances += cmd.args[2];
+		break;
+	case CommandResource:
+		recorderCounters.resourceCommands++;
+		break;
+	case CommandQuery:
+		recorderCounters.queries++;
+		break;
+	case CommandSync:
+		recorderCounters.syncs++;
+		break;
+	}
+	if (recordingEnabled)
+		recordedCommands.Add(cmd);
+}
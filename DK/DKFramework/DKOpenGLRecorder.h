@@ -0,0 +1,94 @@
+//
+//  File: DKOpenGLRecorder.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../DKInclude.h"
+#include "../DKFoundation.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKOpenGLRecorder
+// command recorder of headless (null) OpenGL backend.
+//
+// If library built with DKGL_OPENGL_NULL, there is no OpenGL implementation
+// and every OpenGL functions are emulated (objects, buffer contents, shader
+// reflection) without GPU or window, and every calls are recorded here.
+// DKOpenGLContext can be bound without window, DKRenderer, DKScene and other
+// rendering paths can run on headless machine to measure CPU cost.
+//
+// Counters are always accumulated, command list is recorded only when
+// recording enabled (disabled by default, list grows until Reset).
+//
+// Note:
+//    IsAvailable() returns false if library built with real OpenGL,
+//    nothing will be recorded in that case.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFramework
+{
+	class DKGL_API DKOpenGLRecorder
+	{
+	public:
+		enum CommandType
+		{
+			CommandState = 0,		// render state (enable, blend, depth, viewport, ...)
+			CommandBind,			// object binding (buffer, texture, program, framebuffer, ...)
+			CommandUniform,			// uniform update
+			CommandBufferUpload,	// buffer data upload, map, unmap
+			CommandTextureUpload,	// texture image upload, copy
+			CommandClear,			// clear framebuffer
+			CommandDraw,			// draw call
+			CommandResource,		// object creation, deletion, shader compile, link
+			CommandQuery,			// query (get, is, error)
+			CommandSync,			// flush, finish, read pixels
+		};
+		struct Command
+		{
+			CommandType type;
+			const char* function;	// OpenGL function name
+			unsigned int args[4];	// leading arguments (enum, object id, count)
+			size_t bytes;			// data size transferred (upload, uniform, read)
+		};
+		struct Counters
+		{
+			size_t commands;
+			size_t stateChanges;
+			size_t bindings;
+			size_t uniformUpdates;
+			size_t bufferUploads;
+			size_t textureUploads;
+			size_t uploadBytes;		// buffer, texture, uniform
+			size_t clears;
+			size_t drawCalls;
+			size_t vertices;		// vertices (or indices) of draw calls
+			size_t instances;		// instances of draw calls
+			size_t resourceCommands;
+			size_t queries;
+			size_t syncs;
+		};
+		typedef DKFoundation::DKArray<Command> CommandArray;
+
+		static bool IsAvailable(void);
+
+		static void SetRecordingEnabled(bool enable);
+		static bool IsRecordingEnabled(void);
+
+		// clear recorded commands and counters.
+		static void Reset(void);
+
+		static Counters GetCounters(void);
+		static CommandArray Commands(void);
+		static size_t NumberOfCommands(void);
+
+		static const char* CommandTypeToString(CommandType t);
+
+		// record command, called by null backend.
+		static void Record(const Command&);
+
+	private:
+		DKOpenGLRecorder(void);
+	};
+}
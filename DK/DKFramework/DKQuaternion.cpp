@@ -11,11 +11,15 @@
 #include "DKMatrix4.h"
 #include "DKVector3.h"
 #include "DKVector4.h"
+#include "Private/SIMDUtils.h"
+#include "Private/QuaternionUtils.h"
 
 
 using namespace DKFoundation;
 using namespace DKFramework;
 
+using namespace DKFramework::Private;
+
 const DKQuaternion DKQuaternion::identity = DKQuaternion().Identity();
 
 DKQuaternion::DKQuaternion(void)
@@ -97,32 +101,38 @@ DKQuaternion::~DKQuaternion(void)
 
 DKQuaternion DKQuaternion::Slerp(const DKQuaternion& q1, const DKQuaternion& q2, float t)
 {
-	// dot-product of two quaternions (angle of two quats)
-	double cosHalfTheta = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
-	bool flip = cosHalfTheta < 0.0;
-	if (flip)
-		cosHalfTheta = -cosHalfTheta;
-
-	if (cosHalfTheta >= 1.0) // q1 = q2 or q1 = -q2
+	float ratio1, ratio2;
+	if (!SlerpRatio(q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z, t, ratio1, ratio2))
 		return q1;
 
-	float halfTheta = acos(cosHalfTheta);
-	float oneOverSinHalfTheta = 1.0 / sin(halfTheta);
-
-	float t2 = 1.0 - t;
-
-	float ratio1 = sin(halfTheta * t2) * oneOverSinHalfTheta;
-	float ratio2 = sin(halfTheta * t) * oneOverSinHalfTheta;
-
-	if (flip)
-		ratio2 = -ratio2;
-
 	return DKQuaternion(ratio1 * q1.x + ratio2 * q2.x,
 		ratio1 * q1.y + ratio2 * q2.y,
 		ratio1 * q1.z + ratio2 * q2.z,
 		ratio1 * q1.w + ratio2 * q2.w);
 }
 
+void DKQuaternion::SlerpArray(const DKQuaternion* q1, const DKQuaternion* q2, float t, DKQuaternion* out, size_t count)
+{
+	size_t i = 0;
+#ifdef DKGL_SIMD_ENABLED
+	for (; i + 4 <= count; i += 4)
+	{
+		float dot[4];
+		SIMD::QuaternionDot4(q1[i].val, q2[i].val, dot);
+		for (int k = 0; k < 4; ++k)
+		{
+			float ratio1, ratio2;
+			if (SlerpRatio(dot[k], t, ratio1, ratio2))
+				SIMD::Vector4Blend(q1[i + k].val, ratio1, q2[i + k].val, ratio2, out[i + k].val);
+			else
+				out[i + k] = q1[i + k];
+		}
+	}
+#endif
+	for (; i < count; ++i)
+		out[i] = Slerp(q1[i], q2[i], t);
+}
+
 float DKQuaternion::Dot(const DKQuaternion& q1, const DKQuaternion& q2)
 {
 	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
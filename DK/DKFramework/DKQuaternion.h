@@ -35,6 +35,9 @@ namespace DKFramework
 
 		// spherical linear interpolation
 		static DKQuaternion Slerp(const DKQuaternion& q1, const DKQuaternion& q2, float t);
+		// batch slerp of arrays, out[i] = Slerp(q1[i], q2[i], t)
+		// output array can be one of input arrays.
+		static void SlerpArray(const DKQuaternion* q1, const DKQuaternion* q2, float t, DKQuaternion* out, size_t count);
 		static float Dot(const DKQuaternion& q1, const DKQuaternion& q2);
 
 		DKQuaternion& Zero(void);
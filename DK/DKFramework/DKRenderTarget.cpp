@@ -504,7 +504,7 @@ bool DKRenderTarget::Validate(void)
 			}
 		}
 		
-		DKArray<GLenum> drawTargets;
+		DKSmallArray<GLenum, 8> drawTargets;
 		drawTargets.Reserve(this->colorTextures.Count());
 
 		for (size_t i = 0; i < this->colorTextures.Count(); ++i)
@@ -89,6 +89,23 @@ namespace DKFramework
 			DKShader::TypeVertexShader,
 			0
 		};
+		static DKMaterial::ShaderSource vertexShader2TC =
+		{
+			L"vertexShader2TC",
+			DKGL_GLSL_ES_VERSION
+			"attribute mediump vec2 position;\n"
+			"attribute mediump vec2 texCoord;\n"
+			"attribute lowp    vec4 vertColor;\n"
+			"varying   mediump vec2 textureCoord;\n"
+			"varying   lowp    vec4 color;\n"
+			"void main(void) {\n"
+			"    textureCoord = texCoord;\n"
+			"    color = vertColor;\n"
+			"    gl_Position = vec4(position, 0, 1);\n"
+			"}\n",
+			DKShader::TypeVertexShader,
+			0
+		};
 		static DKMaterial::ShaderSource vertexShader3TC =
 		{
 			L"vertexShader3TC",
@@ -219,6 +236,19 @@ namespace DKFramework
 			DKShader::TypeFragmentShader,
 			0
 		};
+		static DKMaterial::ShaderSource varyingColorAlphaTextureFragmentShader =
+		{
+			L"varyingColorAlphaTextureFragmentShader",
+			DKGL_GLSL_ES_VERSION
+			"uniform sampler2D    tex;\n"
+			"varying mediump vec2 textureCoord;\n"
+			"varying lowp    vec4 color;\n"
+			"void main(void) {\n"
+			"    gl_FragColor = vec4(color.rgb, texture2D(tex, textureCoord).r * color.a);\n"
+			"}\n",
+			DKShader::TypeFragmentShader,
+			0
+		};
 
 		enum RendererProgram2D
 		{
@@ -228,12 +258,73 @@ namespace DKFramework
 			RP2TexturedEllipse,
 			RP2AlphaTextured,
 		};
+		enum RendererProgram2DBatch
+		{
+			RP2BatchColored = 0,
+			RP2BatchTextured,
+			RP2BatchAlphaTextured,
+		};
 		enum RenderProgram3D
 		{
 			RP3Colored = 0,
 			RP3Textured,
 		};
 
+		// maximum vertices of pending batch, flushed when exceeded.
+		enum { MaxBatchVertices = 0x10000 };
+
+		inline bool IsBlendStateEqual(const DKBlendState& lhs, const DKBlendState& rhs)
+		{
+			return lhs.srcBlendRGB == rhs.srcBlendRGB &&
+				lhs.srcBlendAlpha == rhs.srcBlendAlpha &&
+				lhs.dstBlendRGB == rhs.dstBlendRGB &&
+				lhs.dstBlendAlpha == rhs.dstBlendAlpha &&
+				lhs.blendFuncRGB == rhs.blendFuncRGB &&
+				lhs.blendFuncAlpha == rhs.blendFuncAlpha &&
+				lhs.colorWriteR == rhs.colorWriteR &&
+				lhs.colorWriteG == rhs.colorWriteG &&
+				lhs.colorWriteB == rhs.colorWriteB &&
+				lhs.colorWriteA == rhs.colorWriteA &&
+				lhs.constantColor.value == rhs.constantColor.value;
+		}
+		// primitive type of batch, strip, fan and loop are converted to list.
+		inline DKPrimitive::Type BatchPrimitiveType(DKPrimitive::Type p)
+		{
+			switch (p)
+			{
+			case DKPrimitive::TypePoints:
+				return DKPrimitive::TypePoints;
+			case DKPrimitive::TypeLines:
+			case DKPrimitive::TypeLineStrip:
+			case DKPrimitive::TypeLineLoop:
+				return DKPrimitive::TypeLines;
+			case DKPrimitive::TypeTriangles:
+			case DKPrimitive::TypeTriangleStrip:
+			case DKPrimitive::TypeTriangleFan:
+				return DKPrimitive::TypeTriangles;
+			default:
+				break;
+			}
+			return DKPrimitive::TypeUnknown;
+		}
+		// number of vertices after converted to list.
+		inline size_t BatchVertexCount(DKPrimitive::Type p, size_t count)
+		{
+			switch (p)
+			{
+			case DKPrimitive::TypePoints:			return count;
+			case DKPrimitive::TypeLines:			return count - (count % 2);
+			case DKPrimitive::TypeLineStrip:		return count > 1 ? (count - 1) * 2 : 0;
+			case DKPrimitive::TypeLineLoop:			return count > 1 ? count * 2 : 0;
+			case DKPrimitive::TypeTriangles:		return count - (count % 3);
+			case DKPrimitive::TypeTriangleStrip:
+			case DKPrimitive::TypeTriangleFan:		return count > 2 ? (count - 2) * 3 : 0;
+			default:
+				break;
+			}
+			return 0;
+		}
+
 		static DKObject<DKStaticMesh> Build2DMesh(DKVertexBuffer::MemoryLocation loc, DKVertexBuffer::BufferUsage usage, DKTexture* fallbackTexture)
 		{
 			auto GetRenderProperty2D = [](const DKFoundation::DKString& name,
@@ -382,6 +473,72 @@ namespace DKFramework
 			return mesh;
 		}
 
+		static DKObject<DKStaticMesh> Build2DBatchMesh(DKVertexBuffer::MemoryLocation loc, DKVertexBuffer::BufferUsage usage, DKTexture* fallbackTexture)
+		{
+			auto GetRenderProperty2D = [](const DKFoundation::DKString& name,
+				std::initializer_list<const DKMaterial::ShaderSource*> shaders) -> DKMaterial::RenderingProperty
+			{
+				DKMaterial::RenderingProperty rp =
+				{
+					name, DKMaterial::RenderingProperty::DepthFuncAlways, false,
+					DKBlendState::defaultAlpha, DKArray<DKMaterial::ShaderSource>(), NULL
+				};
+				for (const DKMaterial::ShaderSource* s : shaders)
+				{
+					if (s)	rp.shaders.Add(*s);
+				}
+				return rp;
+			};
+
+			// build material
+			DKObject<DKMaterial>	material = DKObject<DKMaterial>::New();
+			DKMaterial::StreamProperty position = { DKVertexStream::StreamPosition, DKVertexStream::TypeFloat2, 1 };
+			DKMaterial::StreamProperty texCoord = { DKVertexStream::StreamTexCoord, DKVertexStream::TypeFloat2, 1 };
+			DKMaterial::StreamProperty vertColor = { DKVertexStream::StreamColor, DKVertexStream::TypeFloat4, 1 };
+			// sampler2D tex
+			DKMaterial::SamplerProperty	tex = { DKShaderConstant::UniformUserDefine, DKShaderConstant::TypeSampler2D,
+				fallbackTexture ? DKMaterial::TextureArray(fallbackTexture, 1) : DKMaterial::TextureArray(), NULL };
+
+			material->renderingProperties.Add(GetRenderProperty2D(L"vertexColor", { &vertexShader2TC, 0, &varyingColorFragmentShader }));
+			material->renderingProperties.Add(GetRenderProperty2D(L"textureColor", { &vertexShader2TC, 0, &varyingColorTextureFragmentShader }));
+			material->renderingProperties.Add(GetRenderProperty2D(L"alphaTexture", { &vertexShader2TC, 0, &varyingColorAlphaTextureFragmentShader }));
+
+			material->streamProperties.Insert(L"position", position);
+			material->streamProperties.Insert(L"texCoord", texCoord);
+			material->streamProperties.Insert(L"vertColor", vertColor);
+
+			material->samplerProperties.Insert(L"tex", tex);
+
+			DKMaterial::BuildLog log;
+			if (!material->Build(&log))
+			{
+				DKLog("Building screen utils error: %ls\n", (const wchar_t*)log.errorLog);
+				DKLog("While trying to build shader: %ls, in program: %ls.\n", (const wchar_t*)log.failedShader, (const wchar_t*)log.failedProgram);
+				return NULL;
+			}
+			// cleanup source (for memory)
+			material->shaderProperties.Clear();
+			for (DKMaterial::RenderingProperty& rp : material->renderingProperties)
+				rp.shaders.Clear();
+
+			// build mesh
+			const DKVertexBuffer::Decl decl[] = {
+					{ DKVertexStream::StreamPosition, L"", DKVertexStream::TypeFloat2, false, 0 },
+					{ DKVertexStream::StreamTexCoord, L"", DKVertexStream::TypeFloat2, false, sizeof(float) * 2 },
+					{ DKVertexStream::StreamColor, L"", DKVertexStream::TypeFloat4, false, sizeof(float) * 4 }
+			};
+
+			DKObject<DKVertexBuffer> vb = DKVertexBuffer::Create(decl, 3, NULL, sizeof(float) * 8, 0, loc, usage);
+
+			DKObject<DKStaticMesh> mesh = DKObject<DKStaticMesh>::New();
+			mesh->SetDrawFace(DKMesh::DrawFaceBoth);
+			mesh->SetDefaultPrimitiveType(DKPrimitive::TypeTriangles);
+			mesh->AddVertexBuffer(vb);
+			mesh->SetMaterial(material);
+
+			return mesh;
+		}
+
 		static DKSpinLock						reusableBufferSpinLock;
 		static DKArray<DKRenderer::Vertex2D>	reusableVert2DBuffer;   // vertex buffer for 2d
 		static DKArray<DKRenderer::Vertex3D>	reusableVert3DBuffer;   // vertex buffer for 3d
@@ -402,6 +559,7 @@ public:
 		, vbUsage(DKVertexBuffer::BufferUsageDraw)
 		, mesh2D(NULL)
 		, mesh3D(NULL)
+		, mesh2DBatch(NULL)
 	{
 		unsigned char d[] = { 1, 0, 1 };
 		DKObject<DKTexture> dummyTexture = DKTexture2D::Create(1, 1, DKTexture::FormatRGB8, DKTexture::TypeUnsignedByte, d).SafeCast<DKTexture>();
@@ -411,11 +569,36 @@ public:
 		}
 		mesh2D = Build2DMesh(vbLoc, vbUsage, dummyTexture);
 		mesh3D = Build3DMesh(vbLoc, vbUsage, dummyTexture);
+		mesh2DBatch = Build2DBatchMesh(vbLoc, vbUsage, dummyTexture);
+
+		// resolve property slots once.
+		slot2D.color = slot2D.radiusSq = slot2D.center = slot2D.tex = -1;
+		slot3D.transform = slot3D.tex = -1;
+		slot2DBatch.tex = -1;
+		if (mesh2D && mesh2D->Material())
+		{
+			const DKMaterial* m = mesh2D->Material();
+			slot2D.color = m->PropertySlot(L"color");
+			slot2D.radiusSq = m->PropertySlot(L"radiusSq");
+			slot2D.center = m->PropertySlot(L"center");
+			slot2D.tex = m->PropertySlot(L"tex");
+		}
+		if (mesh3D && mesh3D->Material())
+		{
+			const DKMaterial* m = mesh3D->Material();
+			slot3D.transform = m->PropertySlot(L"transform");
+			slot3D.tex = m->PropertySlot(L"tex");
+		}
+		if (mesh2DBatch && mesh2DBatch->Material())
+		{
+			slot2DBatch.tex = mesh2DBatch->Material()->PropertySlot(L"tex");
+		}
 	}
 	~RendererContext(void)
 	{
 		mesh2D = NULL;
 		mesh3D = NULL;
+		mesh2DBatch = NULL;
 	}
 	void Update2DMeshStream(DKPrimitive::Type p, const DKRenderer::Vertex2D* vertices, size_t count) const
 	{
@@ -429,6 +612,10 @@ public:
 	}
 	mutable DKObject<DKStaticMesh>			mesh2D;
 	mutable DKObject<DKStaticMesh>			mesh3D;
+	mutable DKObject<DKStaticMesh>			mesh2DBatch;	// 2D mesh with vertex color
+	struct { int color, radiusSq, center, tex; } slot2D;	// property slots of mesh2D
+	struct { int transform, tex; } slot3D;					// property slots of mesh3D
+	struct { int tex; } slot2DBatch;						// property slots of mesh2DBatch
 	DKVertexBuffer::MemoryLocation			vbLoc;
 	DKVertexBuffer::BufferUsage				vbUsage;
 	const DKAffineTransform2				screenOrient;	// 2D screen-orient transform
@@ -456,10 +643,17 @@ DKRenderer::DKRenderer(DKRenderTarget* rt)
 		DKSize size = renderTarget->Resolution();
 		this->viewport = DKRect(DKPoint(0, 0), size);
 	}
+
+	batch.enabled = false;
+	batch.program = 0;
+	batch.primitive = DKPrimitive::TypeUnknown;
+	memset(&batch.stats, 0, sizeof(BatchStatistics));
 }
 
 DKRenderer::~DKRenderer(void)
 {
+	if (batch.vertices.Count() > 0)
+		DKLog("Warning: DKRenderer destroyed with %lu pending vertices.\n", (unsigned long)batch.vertices.Count());
 }
 
 DKRenderer::RendererContext* DKRenderer::GetContext(void) const
@@ -476,6 +670,7 @@ const DKRect& DKRenderer::Viewport(void) const
 
 void DKRenderer::SetViewport(const DKRect& rc)
 {
+	this->Flush();
 	viewport = rc;
 	this->UpdateTransform();
 }
@@ -509,6 +704,7 @@ const DKMatrix3& DKRenderer::ContentTransform(void) const
 
 void DKRenderer::SetPolygonOffset(float factor, float units)
 {
+	this->Flush();
 	this->polygonOffset.factor = factor;
 	this->polygonOffset.units = units;
 }
@@ -547,6 +743,152 @@ const DKRenderTarget* DKRenderer::RenderTarget(void) const
 	return renderTarget;
 }
 
+void DKRenderer::SetBatchingEnabled(bool enable)
+{
+	if (!enable)
+		this->Flush();
+	batch.enabled = enable;
+}
+
+bool DKRenderer::IsBatchingEnabled(void) const
+{
+	return batch.enabled;
+}
+
+const DKRenderer::BatchStatistics& DKRenderer::BatchingStatistics(void) const
+{
+	return batch.stats;
+}
+
+void DKRenderer::ResetBatchingStatistics(void)
+{
+	memset(&batch.stats, 0, sizeof(BatchStatistics));
+}
+
+void DKRenderer::Flush(void) const
+{
+	if (batch.vertices.IsEmpty())
+		return;
+
+	if (IsDrawable() && this->Bind())
+	{
+		RendererContext* ctxt = GetContext();
+		RendererContext::CriticalSection section(ctxt->lock);
+
+		if (ctxt->mesh2DBatch)
+		{
+			ctxt->mesh2DBatch->VertexBufferAtIndex(0)->UpdateContent(batch.vertices, batch.vertices.Count(), ctxt->vbLoc, ctxt->vbUsage);
+			ctxt->mesh2DBatch->SetDefaultPrimitiveType(batch.primitive);
+			if (batch.texture)
+				ctxt->mesh2DBatch->SetSampler(ctxt->slot2DBatch.tex, batch.texture, batch.sampler);
+			ctxt->sceneState.sceneIndex = batch.program;
+			this->DrawMesh(ctxt->mesh2DBatch, ctxt->sceneState, &batch.blend);
+			ctxt->mesh2DBatch->RemoveSampler(ctxt->slot2DBatch.tex);
+
+			batch.stats.drawCalls++;
+			batch.stats.vertices += batch.vertices.Count();
+		}
+	}
+	batch.vertices.Clear();
+	batch.texture = NULL;
+	batch.sampler = NULL;
+}
+
+void DKRenderer::AppendBatch(int program, DKPrimitive::Type p, const Vertex2D* vertices, size_t count, const DKMatrix3* tm, const DKTexture* texture, const DKTextureSampler* sampler, const DKColor& color, const DKBlendState& blend) const
+{
+	static_assert(sizeof(BatchVertex2D) == sizeof(float) * 8, "size mismatch");
+
+	const DKPrimitive::Type primitive = BatchPrimitiveType(p);
+	const size_t numVerts = BatchVertexCount(p, count);
+	if (primitive == DKPrimitive::TypeUnknown || numVerts == 0)
+		return;
+
+	batch.stats.primitives++;
+
+	if (batch.vertices.Count() > 0)
+	{
+		if (batch.program == program &&
+			batch.primitive == primitive &&
+			(const DKTexture*)batch.texture == texture &&
+			(const DKTextureSampler*)batch.sampler == sampler &&
+			IsBlendStateEqual(batch.blend, blend))
+		{
+			if (batch.vertices.Count() + numVerts > MaxBatchVertices)
+			{
+				batch.stats.capacityFlushes++;
+				this->Flush();
+			}
+			else
+			{
+				batch.stats.mergedPrimitives++;
+			}
+		}
+		else
+		{
+			batch.stats.stateChangeFlushes++;
+			this->Flush();
+		}
+	}
+	if (batch.vertices.IsEmpty())
+	{
+		batch.program = program;
+		batch.primitive = primitive;
+		batch.texture = const_cast<DKTexture*>(texture);
+		batch.sampler = const_cast<DKTextureSampler*>(sampler);
+		batch.blend = blend;
+	}
+
+	auto AddVertex = [&](size_t i)
+	{
+		const Vertex2D& v = vertices[i];
+		BatchVertex2D bv = { v.position, v.texcoord, color };
+		if (tm)
+			bv.position = DKVector2(v.position.x, v.position.y).Transform(*tm);
+		batch.vertices.Add(bv);
+	};
+
+	batch.vertices.Reserve(batch.vertices.Count() + numVerts);
+	switch (p)
+	{
+	case DKPrimitive::TypeLineStrip:
+		for (size_t i = 1; i < count; i++)
+		{
+			AddVertex(i - 1);
+			AddVertex(i);
+		}
+		break;
+	case DKPrimitive::TypeLineLoop:
+		for (size_t i = 1; i < count; i++)
+		{
+			AddVertex(i - 1);
+			AddVertex(i);
+		}
+		AddVertex(count - 1);
+		AddVertex(0);
+		break;
+	case DKPrimitive::TypeTriangleStrip:
+		for (size_t i = 2; i < count; i++)
+		{
+			AddVertex(i - 2);
+			AddVertex(i - 1);
+			AddVertex(i);
+		}
+		break;
+	case DKPrimitive::TypeTriangleFan:
+		for (size_t i = 2; i < count; i++)
+		{
+			AddVertex(0);
+			AddVertex(i - 1);
+			AddVertex(i);
+		}
+		break;
+	default:	// list types
+		for (size_t i = 0; i < numVerts; i++)
+			AddVertex(i);
+		break;
+	}
+}
+
 bool DKRenderer::IsDrawable(void) const
 {
 	DKASSERT_DEBUG(renderTarget != NULL);
@@ -589,6 +931,7 @@ DKRenderState* DKRenderer::Bind(void) const
 
 void DKRenderer::Clear(const DKColor& color) const
 {
+	this->Flush();
 	DKRenderState* state = this->Bind();
 	if (state)
 	{
@@ -601,6 +944,7 @@ void DKRenderer::Clear(const DKColor& color) const
 
 void DKRenderer::ClearColorBuffer(const DKColor& color) const
 {
+	this->Flush();
 	DKRenderState* state = this->Bind();
 	if (state)
 	{
@@ -612,6 +956,7 @@ void DKRenderer::ClearColorBuffer(const DKColor& color) const
 
 void DKRenderer::ClearDepthBuffer(void) const
 {
+	this->Flush();
 	DKRenderState* state = this->Bind();
 	if (state)
 	{
@@ -625,6 +970,19 @@ void DKRenderer::RenderPrimitive(DKPrimitive::Type p, const Vertex2D* vertices,
 	if (vertices == NULL || count == 0)
 		return;
 
+	if (batch.enabled && BatchPrimitiveType(p) != DKPrimitive::TypeUnknown)
+	{
+		if (IsDrawable())
+		{
+			if (texture && texture->IsValid())
+				AppendBatch(Private::RP2BatchTextured, p, vertices, count, &screenTM, texture, sampler, color, blend);
+			else
+				AppendBatch(Private::RP2BatchColored, p, vertices, count, &screenTM, NULL, NULL, color, blend);
+		}
+		return;
+	}
+
+	this->Flush();
 	if (IsDrawable() && this->Bind())
 	{
 		RendererContext* ctxt = GetContext();
@@ -638,19 +996,19 @@ void DKRenderer::RenderPrimitive(DKPrimitive::Type p, const Vertex2D* vertices,
 			ctxt->buffer.Add(Vertex2D(DKVector2(vertices[i].position.x, vertices[i].position.y).Transform(screenTM), vertices[i].texcoord));
 		}
 		ctxt->Update2DMeshStream(p, ctxt->buffer, ctxt->buffer.Count());
-		ctxt->mesh2D->SetMaterialProperty(L"color", DKMaterial::PropertyArray(color.val, 4));
+		ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.color, DKMaterial::PropertyArray(color.val, 4));
 
 		if (texture && texture->IsValid())
 		{
-			ctxt->mesh2D->SetSampler(L"tex", const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
+			ctxt->mesh2D->SetSampler(ctxt->slot2D.tex, const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
 			ctxt->sceneState.sceneIndex = Private::RP2Textured;
 		}
 		else
 		{
 			ctxt->sceneState.sceneIndex = Private::RP2Colored;
 		}
-		this->RenderMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
-		ctxt->mesh2D->RemoveSampler(L"tex");
+		this->DrawMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
+		ctxt->mesh2D->RemoveSampler(ctxt->slot2D.tex);
 		ctxt->buffer.Clear();
 	}
 }
@@ -660,24 +1018,25 @@ void DKRenderer::RenderPrimitive(DKPrimitive::Type p, const Vertex3D* vertices,
 	if (vertices == NULL || count == 0)
 		return;
 
+	this->Flush();
 	if (IsDrawable() && this->Bind())
 	{
 		RendererContext* ctxt = GetContext();
 		RendererContext::CriticalSection section(ctxt->lock);
 		ctxt->Update3DMeshStream(p, vertices, count);
-		ctxt->mesh3D->SetMaterialProperty(L"transform", DKMaterial::PropertyArray(tm.val, 16));
+		ctxt->mesh3D->SetMaterialProperty(ctxt->slot3D.transform, DKMaterial::PropertyArray(tm.val, 16));
 
 		if (texture && texture->IsValid())
 		{
-			ctxt->mesh3D->SetSampler(L"tex", const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
+			ctxt->mesh3D->SetSampler(ctxt->slot3D.tex, const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
 			ctxt->sceneState.sceneIndex = Private::RP3Textured;
 		}
 		else
 		{
 			ctxt->sceneState.sceneIndex = Private::RP3Colored;
 		}
-		this->RenderMesh(ctxt->mesh3D, ctxt->sceneState, &blend);
-		ctxt->mesh3D->RemoveSampler(L"tex");
+		this->DrawMesh(ctxt->mesh3D, ctxt->sceneState, &blend);
+		ctxt->mesh3D->RemoveSampler(ctxt->slot3D.tex);
 	}
 }
 
@@ -1038,16 +1397,17 @@ void DKRenderer::RenderSolidEllipse(const DKRect& bounds, const DKColor& color,
 			const DKVector2 radius((prb - plb).Length() / 2, (plt - plb).Length() / 2);
 			const float radiusSq[2] = { radius.x * radius.x, radius.y * radius.y };
 
+			this->Flush();
 			if (this->Bind())
 			{
 				RendererContext* ctxt = GetContext();
 				RendererContext::CriticalSection section(ctxt->lock);
 				ctxt->Update2DMeshStream(DKPrimitive::TypeTriangleStrip, vf, 4);
-				ctxt->mesh2D->SetMaterialProperty(L"color", DKMaterial::PropertyArray(color.val, 4));
-				ctxt->mesh2D->SetMaterialProperty(L"radiusSq", DKMaterial::PropertyArray(radiusSq, 2));
-				ctxt->mesh2D->SetMaterialProperty(L"center", DKMaterial::PropertyArray(center.val, 2));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.color, DKMaterial::PropertyArray(color.val, 4));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.radiusSq, DKMaterial::PropertyArray(radiusSq, 2));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.center, DKMaterial::PropertyArray(center.val, 2));
 				ctxt->sceneState.sceneIndex = Private::RP2SolidEllipse;
-				this->RenderMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
+				this->DrawMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
 			}
 		}
 	}
@@ -1393,20 +1753,21 @@ void DKRenderer::RenderTexturedEllipse(const DKRect& bounds, const DKRect& texBo
 			const DKVector2 radius((prb - plb).Length() / 2, (plt - plb).Length() / 2);
 			const float radiusSq[2] = { radius.x * radius.x, radius.y * radius.y };
 
+			this->Flush();
 			if (this->Bind())
 			{
 				RendererContext* ctxt = GetContext();
 				RendererContext::CriticalSection section(ctxt->lock);
 
 				ctxt->Update2DMeshStream(DKPrimitive::TypeTriangleStrip, vf, 4);
-				ctxt->mesh2D->SetMaterialProperty(L"color", DKMaterial::PropertyArray(color.val, 4));
-				ctxt->mesh2D->SetMaterialProperty(L"radiusSq", DKMaterial::PropertyArray(radiusSq, 2));
-				ctxt->mesh2D->SetMaterialProperty(L"center", DKMaterial::PropertyArray(center.val, 2));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.color, DKMaterial::PropertyArray(color.val, 4));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.radiusSq, DKMaterial::PropertyArray(radiusSq, 2));
+				ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.center, DKMaterial::PropertyArray(center.val, 2));
 
-				ctxt->mesh2D->SetSampler(L"tex", const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
+				ctxt->mesh2D->SetSampler(ctxt->slot2D.tex, const_cast<DKTexture*>(texture), const_cast<DKTextureSampler*>(sampler));
 				ctxt->sceneState.sceneIndex = Private::RP2TexturedEllipse;
-				this->RenderMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
-				ctxt->mesh2D->RemoveSampler(L"tex");
+				this->DrawMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
+				ctxt->mesh2D->RemoveSampler(ctxt->slot2D.tex);
 			}
 		}
 	}
@@ -2022,6 +2383,39 @@ void DKRenderer::RenderText(const DKRect& bounds, const DKMatrix3& transform, co
 	// sort by texture (same texture first)
 	quads.Sort(0, quads.Count(), TextureQuad::OrderByTextureASC);
 
+	if (batch.enabled)
+	{
+		// append glyphs to batch, quads are in screen-space already.
+		DKArray<Vertex2D> verts;
+		verts.Reserve(quads.Count() * 6);
+
+		size_t beginIndex = 0;
+		while (beginIndex < quads.Count())
+		{
+			size_t nextIndex = beginIndex;
+			const DKTexture* currentTexture = quads.Value(beginIndex).texture;
+
+			verts.Clear();
+			while (nextIndex < quads.Count() && quads.Value(nextIndex).texture == currentTexture)
+			{
+				const TextureQuad& q = quads.Value(nextIndex);
+				verts.Add(q.topLeft);
+				verts.Add(q.bottomLeft);
+				verts.Add(q.topRight);
+
+				verts.Add(q.topRight);
+				verts.Add(q.bottomLeft);
+				verts.Add(q.bottomRight);
+
+				nextIndex++;
+			}
+			AppendBatch(Private::RP2BatchAlphaTextured, DKPrimitive::TypeTriangles, verts, verts.Count(), NULL, currentTexture, NULL, color, blend);
+			beginIndex = nextIndex;
+		}
+		return;
+	}
+
+	this->Flush();
 	if (this->Bind())
 	{
 		RendererContext* ctxt = GetContext();
@@ -2030,7 +2424,7 @@ void DKRenderer::RenderText(const DKRect& bounds, const DKMatrix3& transform, co
 		ctxt->buffer.Clear();
 		ctxt->buffer.Reserve(quads.Count() * 6);  // 6 verts, (2 triangles)
 
-		ctxt->mesh2D->SetMaterialProperty(L"color", DKMaterial::PropertyArray(color.val, 4));
+		ctxt->mesh2D->SetMaterialProperty(ctxt->slot2D.color, DKMaterial::PropertyArray(color.val, 4));
 
 		size_t beginIndex = 0;
 		while (beginIndex < quads.Count())
@@ -2058,10 +2452,10 @@ void DKRenderer::RenderText(const DKRect& bounds, const DKMatrix3& transform, co
 			{
 				// use triangle primitive. (each triangles apart)
 				ctxt->Update2DMeshStream(DKPrimitive::TypeTriangles, ctxt->buffer, ctxt->buffer.Count());
-				ctxt->mesh2D->SetSampler(L"tex", const_cast<DKTexture*>(currentTexture), NULL);
+				ctxt->mesh2D->SetSampler(ctxt->slot2D.tex, const_cast<DKTexture*>(currentTexture), NULL);
 				ctxt->sceneState.sceneIndex = Private::RP2AlphaTextured;
-				this->RenderMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
-				ctxt->mesh2D->RemoveSampler(L"tex");
+				this->DrawMesh(ctxt->mesh2D, ctxt->sceneState, &blend);
+				ctxt->mesh2D->RemoveSampler(ctxt->slot2D.tex);
 			}
 			beginIndex = nextIndex;
 		}
@@ -2110,6 +2504,12 @@ void DKRenderer::RenderText(const DKPoint& baselineBegin, const DKPoint& baselin
 }
 
 size_t DKRenderer::RenderMesh(const DKMesh* mesh, DKSceneState& st, const DKBlendState* blend) const
+{
+	this->Flush();
+	return this->DrawMesh(mesh, st, blend);
+}
+
+size_t DKRenderer::DrawMesh(const DKMesh* mesh, DKSceneState& st, const DKBlendState* blend) const
 {
 	size_t numInstancesDrawn = 0;
 
@@ -2190,6 +2590,7 @@ size_t DKRenderer::RenderMesh(const DKMesh* mesh, DKSceneState& st, const DKBlen
 
 void DKRenderer::RenderScene(const DKScene* scene, const DKCamera& camera, int sceneIndex, unsigned int drawModes, unsigned int groupFilter, bool enableCulling, RenderSceneCallback* sc) const
 {
+	this->Flush();
 	if (scene && IsDrawable() && this->Bind())
 	{
 		struct Callback : public DKScene::DrawCallback
@@ -31,6 +31,16 @@
 //   Coordinates space of 2d shapes, lower-left corner is origin.
 //   Coordinates space of 3d shapes, center is origin,
 //   (each axis range is -1.0 ~ 1.0)
+//
+// Batching:
+//   If batching enabled, 2D primitives (shapes, textured shapes, text) are
+//   not drawn immediately. consecutive primitives with same texture, sampler,
+//   blend-state and primitive type are merged into one vertex stream with
+//   per-vertex color, and drawn with single draw call when state changes,
+//   other (non-batched) drawing function called or Flush() called.
+//   You should call Flush() at end of frame. (DKFrame does it for you)
+//   strip, fan and loop primitives are converted into lists to be merged.
+//   Pending primitives are discarded if renderer destroyed without Flush.
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFramework
@@ -77,6 +87,15 @@ namespace DKFramework
 			DKVector3 position;		// 3D scene space
 			DKPoint texcoord;
 		};
+		struct BatchStatistics
+		{
+			size_t primitives;			// number of 2D primitives submitted
+			size_t mergedPrimitives;	// primitives merged into pending batch
+			size_t drawCalls;			// draw calls issued by flush
+			size_t vertices;			// vertices drawn by flush
+			size_t stateChangeFlushes;	// flushes caused by incompatible state
+			size_t capacityFlushes;		// flushes caused by batch capacity
+		};
 
 		const DKRect& Viewport(void) const;
 		void SetViewport(const DKRect& rc);
@@ -93,6 +112,13 @@ namespace DKFramework
 		DKRenderTarget* RenderTarget(void);
 		const DKRenderTarget* RenderTarget(void) const;
 
+		// 2D batching. (disabled by default)
+		void SetBatchingEnabled(bool enable);
+		bool IsBatchingEnabled(void) const;
+		void Flush(void) const;		// draw pending primitives
+		const BatchStatistics& BatchingStatistics(void) const;
+		void ResetBatchingStatistics(void);
+
 		void Clear(const DKColor& color) const;
 		void ClearColorBuffer(const DKColor& color) const;
 		void ClearDepthBuffer(void) const;
@@ -197,9 +223,30 @@ namespace DKFramework
 			float units;
 		} polygonOffset;
 
+		struct BatchVertex2D
+		{
+			DKPoint position;		// screen space
+			DKPoint texcoord;
+			DKColor color;
+		};
+		struct Batch
+		{
+			bool enabled;
+			int program;
+			DKPrimitive::Type primitive;
+			DKFoundation::DKObject<DKTexture> texture;
+			DKFoundation::DKObject<DKTextureSampler> sampler;
+			DKBlendState blend;
+			DKFoundation::DKArray<BatchVertex2D> vertices;
+			BatchStatistics stats;
+		};
+		mutable Batch batch;
+
 		void UpdateTransform(void);
 		bool IsDrawable(void) const;
 		DKRenderState* Bind(void) const;
 		RendererContext* GetContext(void) const;
+		size_t DrawMesh(const DKMesh*, DKSceneState&, const DKBlendState* blend) const;
+		void AppendBatch(int program, DKPrimitive::Type p, const Vertex2D* vertices, size_t count, const DKMatrix3* tm, const DKTexture* texture, const DKTextureSampler* sampler, const DKColor& color, const DKBlendState& blend) const;
 	};
 }
@@ -27,6 +27,7 @@ DKResource::~DKResource(void)
 void DKResource::SetName(const DKString& name)
 {
 	objectName = name;
+	objectNameAtom = name;
 }
 
 const DKString& DKResource::Name(void) const
@@ -34,6 +35,11 @@ const DKString& DKResource::Name(void) const
 	return objectName;
 }
 
+const DKStringAtom& DKResource::NameAtom(void) const
+{
+	return objectNameAtom;
+}
+
 void DKResource::SetUUID(const DKFoundation::DKUuid& uuid)
 {
 	DKASSERT_DEBUG(uuid.IsValid());
@@ -29,6 +29,7 @@ namespace DKFramework
 
 		virtual void SetName(const DKFoundation::DKString& name);
 		const DKFoundation::DKString& Name(void) const;
+		const DKFoundation::DKStringAtom& NameAtom(void) const;	// interned name
 		virtual void SetUUID(const DKFoundation::DKUuid& uuid);
 		const DKFoundation::DKUuid& UUID(void) const;
 
@@ -47,6 +48,7 @@ namespace DKFramework
 
 	private:
 		DKFoundation::DKString objectName;
+		DKFoundation::DKStringAtom objectNameAtom;
 		DKFoundation::DKUuid objectUUID;
 		DKFoundation::DKAllocator* allocator;
 
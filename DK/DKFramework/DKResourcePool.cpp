@@ -340,13 +340,13 @@ DKObject<DKResource> DKResourcePool::LoadResource(const DKString& name)
 	if (ret)
 	{
 		if (ret->Validate() == false)
-			DKLog("Warning: resource \"%ls\" validation failed.\n", (const wchar_t*)name);
+			DKLog(DKLogLevelWarning, "Warning: resource \"%ls\" validation failed.\n", (const wchar_t*)name);
 
 		ret->SetName(name);
 
 		AddResource(name, ret);
 		
-		DKLog("Resource \"%ls\" loaded.\n", (const wchar_t*)name);
+		DKLog(DKLogLevelDebug, "Resource \"%ls\" loaded.\n", (const wchar_t*)name);
 	}
 	return ret;
 }
@@ -391,7 +391,7 @@ DKObject<DKData> DKResourcePool::LoadResourceData(const DKString& name, bool map
 	{
 		AddResourceData(name, ret);
 		
-		DKLog("Resource Data:%ls loaded.\n", (const wchar_t*)name);	
+		DKLog(DKLogLevelDebug, "Resource Data:%ls loaded.\n", (const wchar_t*)name);	
 	}
 	
 	return ret;
@@ -121,6 +121,8 @@ namespace DKFramework
 		void OnAddedToParent(void) override;
 		void OnSetAnimation(DKAnimatedTransform*) override;
 		void OnUpdateSceneState(const DKNSTransform& parentWorldTransform) override;
+		// transform can be moved by simulation.
+		bool NeedsUpdateSceneStateAlways(void) const override { return true; }
 
 	private:
 		class btMotionState* motionState;
@@ -801,6 +801,7 @@ namespace DKFramework
 				, drawShapes(false)
 				, tick(0)
 				, purgeChcheTickCount(10)
+				, numMatricesComputed(0)
 			{
 			}
 			~ShapeDrawer(void)
@@ -838,7 +839,15 @@ namespace DKFramework
 			DKArray<ZSortedMesh> sortedMeshes;  // for sorting
 			DKArray<const DKMesh*> drawMeshes;  // for drawing
 			DKSceneState sceneState;
+			size_t numMatricesComputed;	// scene-state matrices of last rendering.
 		};
+
+		// queue for updating scene-state of root objects in parallel.
+		DKOperationQueue* SceneUpdateQueue(void)
+		{
+			static DKOperationQueue queue;
+			return &queue;
+		}
 	}
 }
 using namespace DKFramework;
@@ -997,10 +1006,95 @@ void DKScene::UpdateObjectKinematics(double tickDelta, DKTimeTick tick)
 
 void DKScene::UpdateObjectSceneStates(void)
 {
-	for (DKModel* m : updatePendingObjects)
+	// transforms of root objects are independent of each other, update in
+	// parallel. each chunk collects meshes moved, to update bounding volumes,
+	// and nodes depend on other nodes (skin meshes), to update after all.
+	const size_t numObjects = updatePendingObjects.Count();
+	if (numObjects == 0)
+		return;
+
+	DKOperationQueue* queue = NULL;
+	size_t grain = numObjects;
+	if (numObjects > 1)
+	{
+		queue = Private::SceneUpdateQueue();
+		grain = Max(numObjects / ((queue->MaxConcurrentOperations() + 1) * 4), (size_t)1);
+	}
+
+	DKArray<DKArray<DKModel*>> updatedMeshes;
+	DKArray<DKArray<DKModel*>> dependentNodes;
+	updatedMeshes.Resize((numObjects + grain - 1) / grain);
+	dependentNodes.Resize(updatedMeshes.Count());
+
+	DKParallelFor(queue, 0, numObjects, grain, [&](size_t begin, size_t end)
+	{
+		DKArray<DKModel*>& updated = updatedMeshes.Value(begin / grain);
+		DKArray<DKModel*>& dependent = dependentNodes.Value(begin / grain);
+		for (size_t i = begin; i < end; ++i)
+			updatePendingObjects.Value(i)->UpdateDirtySceneState(updated, dependent);
+	});
+
+	// nodes can refer nodes in other trees, update after all transforms updated.
+	for (const DKArray<DKModel*>& dependent : dependentNodes)
+	{
+		for (DKModel* m : dependent)
+			m->OnUpdateDependentSceneState();
+	}
+
+	// update bounding volumes of meshes. tree will not be modified
+	// unless mesh moved out of it's enlarged volume.
+	DKCriticalSection<DKSpinLock> guard(this->lock);
+	for (const DKArray<DKModel*>& updated : updatedMeshes)
+	{
+		for (DKModel* m : updated)
+		{
+			DKASSERT_DEBUG(dynamic_cast<DKMesh*>(m) != NULL);
+			DKMesh* mesh = static_cast<DKMesh*>(m);
+			DKASSERT_DEBUG(this->meshes.Contains(mesh));
+			this->UpdateMeshVolume(mesh);
+		}
+	}
+}
+
+void DKScene::UpdateMeshVolume(DKMesh* mesh)
+{
+	DKSphere bs = mesh->ScaledBoundingSphere();
+	if (bs.radius > 0.0f)
+	{
+		bs.center.Transform(mesh->ScaledWorldTransformMatrix());
+		const DKVector3 r(bs.radius, bs.radius, bs.radius);
+		const DKAabb aabb(bs.center - r, bs.center + r);
+
+		if (mesh->cullingProxy == DKAabbTree::NullProxy)
+		{
+			unboundedMeshes.Remove(mesh);
+			mesh->cullingProxy = meshVolumeTree.CreateProxy(aabb, mesh);
+		}
+		else
+		{
+			meshVolumeTree.MoveProxy(mesh->cullingProxy, aabb);
+		}
+	}
+	else
+	{
+		// mesh without bounding volume will not be culled.
+		if (mesh->cullingProxy != DKAabbTree::NullProxy)
+		{
+			meshVolumeTree.DestroyProxy(mesh->cullingProxy);
+			mesh->cullingProxy = DKAabbTree::NullProxy;
+		}
+		unboundedMeshes.Insert(mesh);
+	}
+}
+
+void DKScene::RemoveMeshVolume(DKMesh* mesh)
+{
+	if (mesh->cullingProxy != DKAabbTree::NullProxy)
 	{
-		m->UpdateSceneState(DKNSTransform::identity);
+		meshVolumeTree.DestroyProxy(mesh->cullingProxy);
+		mesh->cullingProxy = DKAabbTree::NullProxy;
 	}
+	unboundedMeshes.Remove(mesh);
 }
 
 void DKScene::Render(const DKCamera& camera, int sceneIndex, unsigned int modes, unsigned int groupFilter, bool enableCulling, DrawCallback& dc) const
@@ -1015,6 +1109,7 @@ void DKScene::Render(const DKCamera& camera, int sceneIndex, unsigned int modes,
 
 	DKCriticalSection<DKSpinLock> guard(this->lock);
 
+	drawer->numMatricesComputed = 0;
 	bool drawCollisionWorld = (modes | DrawMeshes) != DrawMeshes;
 
 	if (drawCollisionWorld)
@@ -1129,7 +1224,7 @@ void DKScene::Render(const DKCamera& camera, int sceneIndex, unsigned int modes,
 				{
 					const DKMatrix4& nodeTM = mesh->ScaledWorldTransformMatrix();
 					bool visible = true;
-					if (enableCulling)
+					if (enableCulling && mesh->cullingProxy != DKAabbTree::NullProxy)
 					{
 						DKSphere bs = mesh->ScaledBoundingSphere();
 						if (bs.radius > 0.0f)
@@ -1174,7 +1269,27 @@ void DKScene::Render(const DKCamera& camera, int sceneIndex, unsigned int modes,
 		drawer->sortedMeshes.Clear();
 		drawer->sortedMeshes.Reserve(this->meshes.Count());
 		this->SetSceneState(camera, drawer->sceneState);
-		this->meshes.EnumerateForward(extractMeshes);
+		if (enableCulling)
+		{
+			// query intersecting volumes with frustum, and test again with sphere.
+			const DKPlane frustum[6] = {
+				camera.NearFrustumPlane(),
+				camera.FarFrustumPlane(),
+				camera.LeftFrustumPlane(),
+				camera.RightFrustumPlane(),
+				camera.TopFrustumPlane(),
+				camera.BottomFrustumPlane()
+			};
+			this->meshVolumeTree.Query(frustum, 6, [&](void* p)
+			{
+				extractMeshes(reinterpret_cast<const DKMesh*>(p));
+			});
+			this->unboundedMeshes.EnumerateForward(extractMeshes);
+		}
+		else
+		{
+			this->meshes.EnumerateForward(extractMeshes);
+		}
 		drawer->sortedMeshes.Sort<decltype(sorter)&>(sorter);
 
 		drawer->sceneState.sceneIndex = sceneIndex;
@@ -1195,6 +1310,7 @@ void DKScene::Render(const DKCamera& camera, int sceneIndex, unsigned int modes,
 		}
 
 		drawer->drawMeshes.Clear();
+		drawer->numMatricesComputed = drawer->sceneState.NumberOfMatricesComputed();
 		drawer->sceneState.Clear();
 	}
 }
@@ -1421,6 +1537,7 @@ bool DKScene::AddSingleObject(DKModel* obj)
 		DKMesh* mesh = static_cast<DKMesh*>(obj);
 		DKASSERT_DEBUG(meshes.Contains(mesh) == false);
 		meshes.Insert(mesh);
+		UpdateMeshVolume(mesh);
 		return true;
 	}
 	else if (obj->type == DKModel::TypeCollision)
@@ -1446,6 +1563,7 @@ void DKScene::RemoveSingleObject(DKModel* obj)
 		DKASSERT_DEBUG(dynamic_cast<DKMesh*>(obj) != NULL);
 		DKMesh* mesh = static_cast<DKMesh*>(obj);
 		meshes.Remove(static_cast<DKMesh*>(mesh));
+		RemoveMeshVolume(mesh);
 	}
 	else if (obj->type == DKModel::TypeCollision)
 	{
@@ -1477,8 +1595,24 @@ void DKScene::RemoveAllObjects(void)
 		model->scene = NULL;
 		model->OnRemovedFromScene();
 	});
+	this->meshes.EnumerateForward([](DKMesh* mesh)
+	{
+		mesh->cullingProxy = DKAabbTree::NullProxy;
+	});
 	this->sceneObjects.Clear();
 	this->meshes.Clear();
+	this->unboundedMeshes.Clear();
+	this->meshVolumeTree.Clear();
+}
+
+size_t DKScene::NumberOfMatricesComputed(void) const
+{
+	DKASSERT_DEBUG(context);
+	DKASSERT_DEBUG(context->world);
+	const ShapeDrawer* drawer = static_cast<const ShapeDrawer*>(context->world->getDebugDrawer());
+
+	DKCriticalSection<DKSpinLock> guard(this->lock);
+	return drawer->numMatricesComputed;
 }
 
 size_t DKScene::NumberOfSceneObjects(void) const
@@ -14,11 +14,16 @@
 #include "DKRenderer.h"
 #include "DKModel.h"
 #include "DKCollisionObject.h"
+#include "DKAabbTree.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // DKScene
 // compose scene with DKModel tree.
 // you can detect collision with DKModel nodes.
+//
+// Note:
+//    bounding volumes of meshes are managed with DKAabbTree, frustum culling
+//    is performed hierarchically. volumes are updated by UpdateObjectSceneStates.
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFramework
@@ -42,6 +47,10 @@ namespace DKFramework
 			virtual bool ObjectColors(const DKCollisionObject*, DKColor&, DKColor&) { return true; }
 		};
 		void Render(const DKCamera& camera, int sceneIndex, unsigned int modes, unsigned int groupFilter, bool enableCulling, DrawCallback& dc) const;
+		// number of derived model matrices (inverse, model-view, etc.) calculated
+		// for meshes in last Render(). matrices are calculated only when shader
+		// program uses it. (see DKSceneState)
+		size_t NumberOfMatricesComputed(void) const;
 
 		virtual void Update(double tickDelta, DKFoundation::DKTimeTick tick);
 
@@ -107,6 +116,12 @@ namespace DKFramework
 
 		DKFoundation::DKArray<DKFoundation::DKObject<DKModel>> updatePendingObjects;
 
+		// spatial index of meshes for culling. (meshes with bounding volume)
+		DKAabbTree meshVolumeTree;
+		DKFoundation::DKSet<DKMesh*> unboundedMeshes;
+		void UpdateMeshVolume(DKMesh*);
+		void RemoveMeshVolume(DKMesh*);
+
 		DKScene(const DKScene&);
 		DKScene& operator = (const DKScene&);
 
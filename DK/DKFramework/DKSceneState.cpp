@@ -6,10 +6,44 @@
 //
 
 #include "DKSceneState.h"
+#include "DKAffineTransform3.h"
 
 using namespace DKFoundation;
 using namespace DKFramework;
 
+namespace DKFramework
+{
+	namespace Private
+	{
+		// shader constants from DKShaderProgram have interned name.
+		inline DKStringAtom ShaderConstantKey(const DKShaderConstant& sc)
+		{
+			if (sc.nameAtom.IsEmpty())
+				return DKStringAtom::Find(sc.name);
+			return sc.nameAtom;
+		}
+
+		enum ModelMatrixBit : unsigned int
+		{
+			ModelMatrixInverseBit = 1,
+			ModelViewMatrixBit = 1 << 1,
+			ModelViewMatrixInverseBit = 1 << 2,
+			ModelViewProjectionMatrixBit = 1 << 3,
+			ModelViewProjectionMatrixInverseBit = 1 << 4,
+		};
+
+		inline bool IsAffineMatrix(const DKMatrix4& m)
+		{
+			return m.m[0][3] == 0.0f && m.m[1][3] == 0.0f && m.m[2][3] == 0.0f && m.m[3][3] == 1.0f;
+		}
+		// inverse of affine matrix, much cheaper than DKMatrix4::Inverse.
+		inline DKMatrix4 AffineMatrixInverse(const DKMatrix4& m)
+		{
+			return DKAffineTransform3(m).Inverse().Matrix4();
+		}
+	}
+}
+using namespace DKFramework::Private;
 
 void DKSceneState::Clear(void)
 {
@@ -19,42 +53,135 @@ void DKSceneState::Clear(void)
 	this->pointLightPositions.Clear();
 	this->pointLightAttenuations.Clear();
 	this->ClearModel();
+	this->numMatricesComputed = 0;
 }
 
 void DKSceneState::ClearModel(void)
 {
-	this->modelMatrix.Identity();
-	this->modelMatrixInverse.Identity();
-	this->modelViewMatrix.Identity();
-	this->modelViewMatrixInverse.Identity();
-	this->modelViewProjectionMatrix.Identity();
-	this->modelViewProjectionMatrixInverse.Identity();
+	this->SetModelMatrix(DKMatrix4::identity);
 
 	this->linearTransformMatrixArray.Clear();
 	this->affineTransformMatrixArray.Clear();
 
 	this->materialProperties = NULL;
 	this->materialSamplers = NULL;
+	this->materialSlotProperties = NULL;
+	this->materialSlotSamplers = NULL;
+}
+
+void DKSceneState::SetModelMatrix(const DKMatrix4& m)
+{
+	this->modelMatrix = m;
+	this->affineModelMatrix = IsAffineMatrix(m);
+	this->validModelMatrices = 0;
+}
+
+const DKMatrix4& DKSceneState::ModelMatrixInverse(void)
+{
+	if ((this->validModelMatrices & ModelMatrixInverseBit) == 0)
+	{
+		if (this->affineModelMatrix)
+			this->modelMatrixInverse = AffineMatrixInverse(this->modelMatrix);
+		else
+			this->modelMatrixInverse = DKMatrix4(this->modelMatrix).Inverse();
+		this->validModelMatrices |= ModelMatrixInverseBit;
+		this->numMatricesComputed++;
+	}
+	return this->modelMatrixInverse;
+}
+
+const DKMatrix4& DKSceneState::ModelViewMatrix(void)
+{
+	if ((this->validModelMatrices & ModelViewMatrixBit) == 0)
+	{
+		this->modelViewMatrix = this->modelMatrix * this->viewMatrix;
+		this->validModelMatrices |= ModelViewMatrixBit;
+		this->numMatricesComputed++;
+	}
+	return this->modelViewMatrix;
+}
+
+const DKMatrix4& DKSceneState::ModelViewMatrixInverse(void)
+{
+	if ((this->validModelMatrices & ModelViewMatrixInverseBit) == 0)
+	{
+		const DKMatrix4& mv = this->ModelViewMatrix();
+		if (IsAffineMatrix(mv))
+			this->modelViewMatrixInverse = AffineMatrixInverse(mv);
+		else
+			this->modelViewMatrixInverse = DKMatrix4(mv).Inverse();
+		this->validModelMatrices |= ModelViewMatrixInverseBit;
+		this->numMatricesComputed++;
+	}
+	return this->modelViewMatrixInverse;
+}
+
+const DKMatrix4& DKSceneState::ModelViewProjectionMatrix(void)
+{
+	if ((this->validModelMatrices & ModelViewProjectionMatrixBit) == 0)
+	{
+		this->modelViewProjectionMatrix = this->modelMatrix * this->viewProjectionMatrix;
+		this->validModelMatrices |= ModelViewProjectionMatrixBit;
+		this->numMatricesComputed++;
+	}
+	return this->modelViewProjectionMatrix;
+}
+
+const DKMatrix4& DKSceneState::ModelViewProjectionMatrixInverse(void)
+{
+	if ((this->validModelMatrices & ModelViewProjectionMatrixInverseBit) == 0)
+	{
+		// (M * VP)^-1 = VP^-1 * M^-1, inverse of view-projection is calculated
+		// once per scene. only model matrix inverse is required for each mesh.
+		if (this->affineModelMatrix)
+			this->modelViewProjectionMatrixInverse = this->viewProjectionMatrixInverse * this->ModelMatrixInverse();
+		else
+			this->modelViewProjectionMatrixInverse = DKMatrix4(this->ModelViewProjectionMatrix()).Inverse();
+		this->validModelMatrices |= ModelViewProjectionMatrixInverseBit;
+		this->numMatricesComputed++;
+	}
+	return this->modelViewProjectionMatrixInverse;
 }
 
 DKSceneState::IntArray DKSceneState::GetIntProperty(const DKShaderConstant& sc, int programIndex)
+{
+	return GetSlotIntProperty(-1, sc, programIndex);
+}
+
+DKSceneState::FloatArray DKSceneState::GetFloatProperty(const DKShaderConstant& sc, int programIndex)
+{
+	return GetSlotFloatProperty(-1, sc, programIndex);
+}
+
+const DKSceneState::Sampler* DKSceneState::GetSamplerProperty(const DKShaderConstant& sc, int programIndex)
+{
+	return GetSlotSamplerProperty(-1, sc, programIndex);
+}
+
+DKSceneState::IntArray DKSceneState::GetSlotIntProperty(int slot, const DKShaderConstant& sc, int programIndex)
 {
 	if (this->userMaterialPropertyCallback)
 	{
-		auto val = this->userMaterialPropertyCallback->GetIntProperty(sc, programIndex);
+		auto val = slot < 0 ? this->userMaterialPropertyCallback->GetIntProperty(sc, programIndex) : this->userMaterialPropertyCallback->GetSlotIntProperty(slot, sc, programIndex);
 		if (val.Count() > 0)
 			return val;
 	}
+	if (this->materialSlotProperties && slot >= 0 && (size_t)slot < this->materialSlotProperties->Count())
+	{
+		const DKMaterial::PropertyArray& p = this->materialSlotProperties->Value(slot);
+		if (p.integers.Count() > 0)
+			return IntArray((int*)(const int*)p.integers, p.integers.Count());
+	}
 	if (this->materialProperties)
 	{
-		auto p = this->materialProperties->Find(sc.name);
+		auto p = this->materialProperties->Find(ShaderConstantKey(sc));
 		if (p && p->value.integers.Count() > 0)
 			return IntArray((int*)(const int*)p->value.integers, p->value.integers.Count());
 	}
 	return IntArray();
 }
 
-DKSceneState::FloatArray DKSceneState::GetFloatProperty(const DKShaderConstant& sc, int programIndex)
+DKSceneState::FloatArray DKSceneState::GetSlotFloatProperty(int slot, const DKShaderConstant& sc, int programIndex)
 {
 	switch (sc.id)
 	{
@@ -64,23 +191,23 @@ DKSceneState::FloatArray DKSceneState::GetFloatProperty(const DKShaderConstant&
 		break;
 	case DKShaderConstant::UniformModelMatrixInverse:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-		return FloatArray(this->modelMatrixInverse.val, 16);
+			return FloatArray((float*)this->ModelMatrixInverse().val, 16);
 		break;
 	case DKShaderConstant::UniformViewMatrix:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-		return FloatArray(this->viewMatrix.val, 16);
+			return FloatArray(this->viewMatrix.val, 16);
 		break;
 	case DKShaderConstant::UniformViewMatrixInverse:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-		return FloatArray(this->viewMatrixInverse.val, 16);
+			return FloatArray(this->viewMatrixInverse.val, 16);
 		break;
 	case DKShaderConstant::UniformProjectionMatrix:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-		return FloatArray(this->projectionMatrix.val, 16);
+			return FloatArray(this->projectionMatrix.val, 16);
 		break;
 	case DKShaderConstant::UniformProjectionMatrixInverse:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-		return FloatArray(this->projectionMatrixInverse.val, 16);
+			return FloatArray(this->projectionMatrixInverse.val, 16);
 		break;
 	case DKShaderConstant::UniformViewProjectionMatrix:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
@@ -92,19 +219,19 @@ DKSceneState::FloatArray DKSceneState::GetFloatProperty(const DKShaderConstant&
 		break;
 	case DKShaderConstant::UniformModelViewMatrix:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-			return FloatArray(this->modelViewMatrix.val, 16);
+			return FloatArray((float*)this->ModelViewMatrix().val, 16);
 		break;
 	case DKShaderConstant::UniformModelViewMatrixInverse:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-			return FloatArray(this->modelViewMatrixInverse.val, 16);
+			return FloatArray((float*)this->ModelViewMatrixInverse().val, 16);
 		break;
 	case DKShaderConstant::UniformModelViewProjectionMatrix:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-			return FloatArray(this->modelViewProjectionMatrix.val, 16);
+			return FloatArray((float*)this->ModelViewProjectionMatrix().val, 16);
 		break;
 	case DKShaderConstant::UniformModelViewProjectionMatrixInverse:
 		if (sc.type == DKShaderConstant::TypeFloat4x4)
-			return FloatArray(this->modelViewProjectionMatrixInverse.val, 16);
+			return FloatArray((float*)this->ModelViewProjectionMatrixInverse().val, 16);
 		break;
 	case DKShaderConstant::UniformLinearTransformArray:
 		if (sc.type == DKShaderConstant::TypeFloat3x3 && this->linearTransformMatrixArray.Count() > 0)
@@ -132,30 +259,42 @@ DKSceneState::FloatArray DKSceneState::GetFloatProperty(const DKShaderConstant&
 
 	if (this->userMaterialPropertyCallback)
 	{
-		FloatArray val = this->userMaterialPropertyCallback->GetFloatProperty(sc, programIndex);
+		FloatArray val = slot < 0 ? this->userMaterialPropertyCallback->GetFloatProperty(sc, programIndex) : this->userMaterialPropertyCallback->GetSlotFloatProperty(slot, sc, programIndex);
 		if (val.Count() > 0)
 			return val;
 	}
+	if (this->materialSlotProperties && slot >= 0 && (size_t)slot < this->materialSlotProperties->Count())
+	{
+		const DKMaterial::PropertyArray& p = this->materialSlotProperties->Value(slot);
+		if (p.floatings.Count() > 0)
+			return FloatArray((float*)(const float*)p.floatings, p.floatings.Count());
+	}
 	if (this->materialProperties)
 	{
-		auto p = this->materialProperties->Find(sc.name);
+		auto p = this->materialProperties->Find(ShaderConstantKey(sc));
 		if (p && p->value.floatings.Count() > 0)
 			return FloatArray((float*)(const float*)p->value.floatings, p->value.floatings.Count());
 	}
 	return FloatArray();
 }
 
-const DKSceneState::Sampler* DKSceneState::GetSamplerProperty(const DKShaderConstant& sc, int programIndex)
+const DKSceneState::Sampler* DKSceneState::GetSlotSamplerProperty(int slot, const DKShaderConstant& sc, int programIndex)
 {
 	if (this->userMaterialPropertyCallback)
 	{
-		auto p = this->userMaterialPropertyCallback->GetSamplerProperty(sc, programIndex);
+		auto p = slot < 0 ? this->userMaterialPropertyCallback->GetSamplerProperty(sc, programIndex) : this->userMaterialPropertyCallback->GetSlotSamplerProperty(slot, sc, programIndex);
 		if (p && p->textures.Count() > 0)
 			return p;
 	}
+	if (this->materialSlotSamplers && slot >= 0 && (size_t)slot < this->materialSlotSamplers->Count())
+	{
+		const Sampler& s = this->materialSlotSamplers->Value(slot);
+		if (s.textures.Count() > 0)
+			return &s;
+	}
 	if (this->materialSamplers)
 	{
-		auto p = this->materialSamplers->Find(sc.name);
+		auto p = this->materialSamplers->Find(ShaderConstantKey(sc));
 		if (p && p->value.textures.Count() > 0)
 			return &p->value;
 	}
@@ -30,7 +30,7 @@ namespace DKFramework
 	class DKGL_API DKSceneState : public DKMaterial::PropertyCallback
 	{
 	public:
-		template <typename T> using StringKeyMap = DKFoundation::DKMap<DKFoundation::DKString, T>;
+		template <typename T> using StringKeyMap = DKFoundation::DKHashMap<DKFoundation::DKStringAtom, T>;
 
 		typedef DKFoundation::DKArray<DKVector2> Vector2Array;
 		typedef DKFoundation::DKArray<DKVector3> Vector3Array;
@@ -62,13 +62,17 @@ namespace DKFramework
 		Vector3Array pointLightPositions;
 		Vector3Array pointLightAttenuations;		// (const, linear, quadratic)
 
-		// model(mesh) transform matrices
-		DKMatrix4 modelMatrix;
-		DKMatrix4 modelMatrixInverse;
-		DKMatrix4 modelViewMatrix;
-		DKMatrix4 modelViewMatrixInverse;
-		DKMatrix4 modelViewProjectionMatrix;
-		DKMatrix4 modelViewProjectionMatrixInverse;
+		// model(mesh) transform matrices.
+		// matrices derived from model matrix are calculated on demand, only
+		// when bound shader program has uniform for it. (see GetFloatProperty)
+		void SetModelMatrix(const DKMatrix4& m);
+		const DKMatrix4& ModelMatrix(void) const	{ return modelMatrix; }
+		const DKMatrix4& ModelMatrixInverse(void);
+		const DKMatrix4& ModelViewMatrix(void);
+		const DKMatrix4& ModelViewMatrixInverse(void);
+		const DKMatrix4& ModelViewProjectionMatrix(void);
+		const DKMatrix4& ModelViewProjectionMatrixInverse(void);
+
 		Matrix3Array linearTransformMatrixArray;
 		Matrix4Array affineTransformMatrixArray;
 		Vector3Array positionArray;
@@ -76,6 +80,9 @@ namespace DKFramework
 		// model(mesh) shading properties
 		const PropertyMap* materialProperties = NULL;
 		const SamplerMap* materialSamplers = NULL;
+		// model(mesh) properties indexed by material's property slot
+		const DKFoundation::DKArray<DKMaterial::PropertyArray>* materialSlotProperties = NULL;
+		const DKFoundation::DKArray<DKMaterial::Sampler>* materialSlotSamplers = NULL;
 
 		// user material callback
 		DKFoundation::DKObject<DKMaterial::PropertyCallback> userMaterialPropertyCallback;
@@ -84,7 +91,25 @@ namespace DKFramework
 		FloatArray GetFloatProperty(const DKShaderConstant& sc, int programIndex) override;
 		const Sampler* GetSamplerProperty(const DKShaderConstant& sc, int programIndex) override;
 
+		IntArray GetSlotIntProperty(int slot, const DKShaderConstant& sc, int programIndex) override;
+		FloatArray GetSlotFloatProperty(int slot, const DKShaderConstant& sc, int programIndex) override;
+		const Sampler* GetSlotSamplerProperty(int slot, const DKShaderConstant& sc, int programIndex) override;
+
 		void Clear(void);
 		void ClearModel(void);
+
+		// number of derived model matrices calculated since last Clear().
+		size_t NumberOfMatricesComputed(void) const	{ return numMatricesComputed; }
+
+	private:
+		DKMatrix4 modelMatrix;
+		DKMatrix4 modelMatrixInverse;
+		DKMatrix4 modelViewMatrix;
+		DKMatrix4 modelViewMatrixInverse;
+		DKMatrix4 modelViewProjectionMatrix;
+		DKMatrix4 modelViewProjectionMatrixInverse;
+		unsigned int validModelMatrices = 0;	// bit-mask of derived matrices calculated.
+		bool affineModelMatrix = true;			// model matrix has no projective part.
+		size_t numMatricesComputed = 0;
 	};
 }
@@ -12,6 +12,22 @@
 using namespace DKFoundation;
 using namespace DKFramework;
 
+namespace DKFramework
+{
+	namespace Private
+	{
+		namespace
+		{
+			// queue for loading chunks of binary data in parallel.
+			DKOperationQueue* DeserializerQueue(void)
+			{
+				static DKOperationQueue queue;
+				return &queue;
+			}
+		}
+	}
+}
+
 
 // generate operations which can restore data from DKVariant
 // 1. picking out operations restorable object from this->entryMap
@@ -1038,13 +1054,15 @@ bool DKSerializer::Deserialize(const DKXMLElement* e, DKResourceLoader* loader)
 //		type(uint32)
 //			'vars'	VariantEntity
 //			'varc'	compressed VariantEntity
+//			'vpak'	VariantEntity (packed, DKVariant::ExportPacked)
+//			'vpkc'	compressed VariantEntity (packed)
 //			'sers'	SerializerEntity
 //			'serc'	compressed SerializerEntity
 //			'extn'	ExternalResource name (filename)
 //			'exts'	regular ExternalResource data
 //			'extc'	compressed ExternalResource data
 //		cType(uint32)
-//			CRC32	hash for vars, varc (uncompressed data CRC32)
+//			CRC32	hash for vars, varc, vpak, vpkc (uncompressed data CRC32)
 //			0		SerializerEntitey, values of ExternalResource(single)
 //			'exta'	ExternalEntityArray
 //			'extm'	ExternalEntityMap
@@ -1056,15 +1074,18 @@ bool DKSerializer::Deserialize(const DKXMLElement* e, DKResourceLoader* loader)
 //		size(uint64) length of data
 //		data(variable-length)
 //
-// In case of types: 'vars','varc','sers','serc',
+// In case of types: 'vars','varc','vpak','vpkc','sers','serc',
 // should be containerType = 'none', containerKeyLen = 0.
-// CRC checking is valid for 'vars', 'varc' only.
+// CRC checking is valid for 'vars', 'varc', 'vpak', 'vpkc' only.
+//
+// VariantEntity is written as packed format since version 13.
+// packed data is read in place, only values of bound keys are restored.
 //
 // if container is array, objectKey='', objectKeyLen = 0.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-#define DKSERIALIZER_VERSION	12
+#define DKSERIALIZER_VERSION	13
 #define DKSERIALIZER_HEADER_STRING_BIG_ENDIAN		"DKSerializeB"
 #define DKSERIALIZER_HEADER_STRING_LITTLE_ENDIAN	"DKSerializeL"
 
@@ -1181,11 +1202,11 @@ size_t DKSerializer::SerializeBinary(SerializeForm sf, DKStream* output) const
 				if (variant.Pairs().Count() > 0)
 				{
 					DKBufferStream stream;
-					if (variant.ExportStream(&stream))
+					if (variant.ExportPacked(&stream))
 					{
 						DKBuffer* buffer = stream.BufferObject();
 						EntityChunk chunk;
-						if (chunk.Create(L"",L"", compress ? 'varc' : 'vars', 'hash', buffer, compress))
+						if (chunk.Create(L"",L"", compress ? 'vpkc' : 'vpak', 'hash', buffer, compress))
 							chunks.Add(chunk);
 						else
 							entityError = true;						
@@ -1566,32 +1587,60 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 
 	DKCriticalSection<DKSpinLock> guard(lock);
 
+	// chunk data and restored objects.
+	// chunks are unpacked in parallel, and committed to entity in order.
+	struct EntityChunk
+	{
+		DKString key;
+		DKString containerKey;
+		unsigned int type;
+		unsigned int ctype;
+		unsigned long long unpackedSize;
+		DKObject<DKData> data;
+
+		DKVariant value;
+		bool valueLoaded;
+		EntityRestore::DeserializerArray includes;
+		bool includesLoaded;
+		DKObject<DKResource> resource;
+	};
+
 	struct EntityLoader
 	{
-		void operator () (
-			const DKString& key,
-			const DKString& cKey,
-			unsigned int type, unsigned int ctype, 
-			unsigned long long unpackedSize,
-			DKData* d,
-			DKResourceLoader* loader,
-			EntityRestore::Entity& entity,
-			const EntityMap& entityMap) const
-		{
-			DKObject<DKData> data = NULL;
-			if (type == 'varc' || type == 'serc' || type == 'extc')
+		bool NeedsLoader(const EntityChunk& chunk) const
+		{
+			switch (chunk.type)
+			{
+			case 'sers': case 'serc': case 'extn': case 'exts': case 'extc':
+				return true;
+			}
+			return false;
+		}
+		void Unpack(EntityChunk& chunk) const
+		{
+			const unsigned int type = chunk.type;
+			if (type == 'varc' || type == 'vpkc' || type == 'serc' || type == 'extc')
 			{
 				// uncompress data
+				DKData* d = chunk.data;
 				const void* p = d->LockShared();
-				data = DKBuffer::Decompress(p, d->Length()).SafeCast<DKData>();
+				DKObject<DKData> data = DKBuffer::Decompress(p, d->Length()).SafeCast<DKData>();
 				d->UnlockShared();
+				chunk.data = data;
 			}
-			else
-			{
-				data = d;
-			}
+			if (chunk.data && chunk.data->Length() != chunk.unpackedSize)
+				chunk.data = NULL;
+		}
+		void Load(EntityChunk& chunk, DKResourceLoader* loader, const EntityMap& entityMap) const
+		{
+			chunk.valueLoaded = false;
+			chunk.includesLoaded = false;
+
+			const unsigned int type = chunk.type;
+			const unsigned int ctype = chunk.ctype;
+			DKData* data = chunk.data;
 
-			if (data && data->Length() == unpackedSize)
+			if (data)
 			{
 				unsigned int crc = 0;
 				if (type == 'varc' || type == 'vars')
@@ -1602,67 +1651,72 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 					if (crc == ctype)
 					{
 						DKDataStream stream(data);
-						if (entity.deserializer->rootValue.ImportStream(&stream) == false)
+						chunk.valueLoaded = chunk.value.ImportStream(&stream);
+					}
+					else	// CRC error.
+					{
+						DKLog("DKSerializer warning: CRC error!\n");
+					}
+				}
+				else if (type == 'vpkc' || type == 'vpak')
+				{
+					// packed data, read in place without restoring whole pairs.
+					const void* ptr = data->LockShared();
+					crc = DKHashCRC32(ptr, data->Length()).digest[0];
+					if (crc == ctype)
+					{
+						DKVariantView root(ptr, data->Length());
+						if (root.ValueType() == DKVariant::TypePairs)
 						{
-							// restoration error!
-							entity.deserializer->rootValue.SetValueType(DKVariant::TypeUndefined);
+							DKVariant::VPairs& pairs = chunk.value.SetValueType(DKVariant::TypePairs).Pairs();
+							entityMap.EnumerateForward([&](const EntityMap::Pair& p)
+							{
+								const VariantEntity* ve = p.value->Variant();
+								if (ve && ve->setter)
+								{
+									DKVariantView value = root.Find(p.key);
+									if (value.IsValid())
+										pairs.Value(p.key) = value.Variant();
+								}
+							});
+							chunk.valueLoaded = true;
 						}
 					}
 					else	// CRC error.
 					{
 						DKLog("DKSerializer warning: CRC error!\n");
-						entity.deserializer->rootValue.SetValueType(DKVariant::TypeUndefined);
 					}
+					data->UnlockShared();
 				}
 				else if (type == 'sers' || type == 'serc')
 				{
-					const EntityMap::Pair* ep = entityMap.Find(key);
+					const EntityMap::Pair* ep = entityMap.Find(chunk.key);
 					if (ep)
 					{
 						const SerializerEntity* se = ep->value->Serializer();
 						if (se && se->serializer)
 						{
 							DKDataStream stream(data);
-							EntityRestore::DeserializerArray de;
-							if (se->serializer->DeserializeBinaryOperations(&stream, de, loader))
-							{
-								entity.includes.Insert(key, de);
-							}
+							chunk.includesLoaded = se->serializer->DeserializeBinaryOperations(&stream, chunk.includes, loader);
 						}
 					}
 				}
 				else if (type == 'extn' || type == 'exts' || type == 'extc')
 				{
-					DKObject<DKResource> resource = NULL;
 					if (type == 'extn')
 					{
-						const char* p = (const char*)d->LockShared();
-						DKString filename(p, d->Length());
-						d->UnlockShared();
+						const char* p = (const char*)data->LockShared();
+						DKString filename(p, data->Length());
+						data->UnlockShared();
 						size_t len = filename.Length();
 						if (len > 0 && loader)
 						{
-							resource = loader->LoadResource(filename);
+							chunk.resource = loader->LoadResource(filename);
 						}
 					}
 					else if (loader)
 					{
-						resource = loader->ResourceFromData(data, key);
-					}
-					if (resource)
-					{
-						switch (ctype)
-						{
-						case 0:
-							entity.deserializer->externals.Insert(key, resource);
-							break;
-						case 'exta':
-							entity.deserializer->externalArrays.Value(cKey).Add(resource);
-							break;
-						case 'extm':
-							entity.deserializer->externalMaps.Value(cKey).Update(key, resource);
-							break;
-						}
+						chunk.resource = loader->ResourceFromData(data, chunk.key);
 					}
 				}
 				else	// unknown type?
@@ -1670,6 +1724,41 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 					DKLog("DKSerializer warning: Unknown type(0x%x) found! (ignored)\n", type);
 				}
 			}
+			// release data, source can be unlocked after all chunks loaded.
+			chunk.data = NULL;
+		}
+		void Commit(EntityChunk& chunk, EntityRestore::Entity& entity) const
+		{
+			switch (chunk.type)
+			{
+			case 'vars': case 'varc': case 'vpak': case 'vpkc':
+				if (chunk.valueLoaded)
+					entity.deserializer->rootValue = static_cast<DKVariant&&>(chunk.value);
+				else	// restoration error!
+					entity.deserializer->rootValue.SetValueType(DKVariant::TypeUndefined);
+				break;
+			case 'sers': case 'serc':
+				if (chunk.includesLoaded)
+					entity.includes.Insert(chunk.key, chunk.includes);
+				break;
+			case 'extn': case 'exts': case 'extc':
+				if (chunk.resource)
+				{
+					switch (chunk.ctype)
+					{
+					case 0:
+						entity.deserializer->externals.Insert(chunk.key, chunk.resource);
+						break;
+					case 'exta':
+						entity.deserializer->externalArrays.Value(chunk.containerKey).Add(chunk.resource);
+						break;
+					case 'extm':
+						entity.deserializer->externalMaps.Value(chunk.containerKey).Update(chunk.key, chunk.resource);
+						break;
+					}
+				}
+				break;
+			}
 		}
 	} entityLoader;
 
@@ -1687,9 +1776,16 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 	numChunks = byteorder(numChunks);
 	//DKLog("DKSerializer(%ls) total chunks:%llu\n", (const wchar_t*)this->resourceClass, numChunks);
 
+	// if stream is seekable data-stream, chunks refer data of source directly.
+	// source is locked until all chunks are loaded.
 	DKDataStream* dataStream = DKObject<DKStream>(s).SafeCast<DKDataStream>();
+	DKData* source = NULL;
+	if (dataStream && s->IsSeekable())
+		source = dataStream->DataSource();
+	const char* sourcePtr = source ? (const char*)source->LockShared() : NULL;
 
-	EntityRestore::Entity restoreEntities;
+	DKArray<EntityChunk> chunks;
+	chunks.Reserve(Min(numChunks, (unsigned long long)s->RemainLength() / 44));	// 44: minimum chunk length
 
 	DKString errorDesc = L"Unknown error";
 	bool error = false;
@@ -1721,16 +1817,10 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 
 		if (keyLen > 0 && keyLen <= s->RemainLength())
 		{
-			DKData* data = NULL;
-			if (dataStream && s->IsSeekable())
-				data = dataStream->DataSource();
-
-			if (data)
+			if (sourcePtr)
 			{
 				DKStream::Position pos = s->GetPos();
-				const char* ptr = (const char*)data->LockShared();
-				objectKey.SetValue(&ptr[pos], keyLen);
-				data->UnlockShared();
+				objectKey.SetValue(&sourcePtr[pos], keyLen);
 				pos += keyLen;
 				s->SetPos(pos);
 			}
@@ -1750,16 +1840,10 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 
 		if (cKeyLen > 0 && cKeyLen <= s->RemainLength())
 		{
-			DKData* data = NULL;
-			if (dataStream && s->IsSeekable())
-				data = dataStream->DataSource();
-
-			if (data)
+			if (sourcePtr)
 			{
 				DKStream::Position pos = s->GetPos();
-				const char* ptr = (const char*)data->LockShared();
-				containerKey.SetValue(&ptr[pos], cKeyLen);
-				data->UnlockShared();
+				containerKey.SetValue(&sourcePtr[pos], cKeyLen);
 				pos += cKeyLen;
 				s->SetPos(pos);
 			}
@@ -1783,19 +1867,17 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 
 		if (dataLength > 0 && dataLength <= s->RemainLength())
 		{
-			DKData* data = NULL;
-			if (dataStream && s->IsSeekable())
-				data = dataStream->DataSource();
-
-			if (data)
+			EntityChunk chunk;
+			chunk.key = static_cast<DKString&&>(objectKey);
+			chunk.containerKey = static_cast<DKString&&>(containerKey);
+			chunk.type = type;
+			chunk.ctype = ctype;
+			chunk.unpackedSize = unpackedSize;
+
+			if (sourcePtr)
 			{
 				DKStream::Position pos = s->GetPos();
-				const char* ptr = (const char*)data->LockShared();
-				const void* p = &ptr[pos];
-
-				entityLoader(objectKey, containerKey, type, ctype, unpackedSize, DKData::StaticData(p, dataLength), loader, restoreEntities, this->entityMap);
-
-				data->UnlockShared();
+				chunk.data = DKData::StaticData(&sourcePtr[pos], dataLength);
 				pos += dataLength;
 				s->SetPos(pos);
 			}
@@ -1805,14 +1887,49 @@ bool DKSerializer::DeserializeBinaryOperations(DKStream* s, DKArray<DKObject<Des
 				void* tmp = buffer->LockExclusive();
 				size_t numRead = s->Read(tmp, dataLength);
 				buffer->UnlockExclusive();
-				if (numRead == dataLength)
-					entityLoader(objectKey, containerKey, type, ctype, unpackedSize, buffer, loader, restoreEntities, this->entityMap);
-				else
+				if (numRead != dataLength)
 				{ERROR_BREAK(L"Stream Error")}
+				chunk.data = buffer.SafeCast<DKData>();
 			}
+			chunks.Add(static_cast<EntityChunk&&>(chunk));
 		}
 	}
 
+	EntityRestore::Entity restoreEntities;
+	if (!error)
+	{
+		// unpack chunks in parallel. (decompress, CRC check, decode variant)
+		// chunks which need loader are restored on calling thread, loader
+		// can create GL objects or call back into script with lock held.
+		DKOperationQueue* queue = Private::DeserializerQueue();
+		size_t numChunksToLoad = chunks.Count();
+		size_t numRunners = Min(queue->MaxConcurrentOperations() + 1, numChunksToLoad);
+		DKAtomicNumber32 nextChunk(0);
+		DKParallelFor(queue, 0, numRunners, 1, [&](size_t, size_t)
+		{
+			for (size_t index = nextChunk.Increment(); index < numChunksToLoad; index = nextChunk.Increment())
+			{
+				EntityChunk& chunk = chunks.Value(index);
+				entityLoader.Unpack(chunk);
+				if (!entityLoader.NeedsLoader(chunk))
+					entityLoader.Load(chunk, loader, this->entityMap);
+			}
+		});
+		for (EntityChunk& chunk : chunks)
+		{
+			if (entityLoader.NeedsLoader(chunk))
+				entityLoader.Load(chunk, loader, this->entityMap);
+		}
+
+		// commit loaded chunks in order.
+		for (EntityChunk& chunk : chunks)
+			entityLoader.Commit(chunk, restoreEntities);
+	}
+	chunks.Clear();
+
+	if (source)
+		source->UnlockShared();
+
 	if (error)
 	{
 		DKLog("DKSerializer::Deserialize failed: %ls", (const wchar_t*)errorDesc);
@@ -84,6 +84,7 @@ namespace DKFramework
 		Type					type;			// value type
 		size_t					components;		// value components
 		int						location;		// binding location of program module
+		DKFoundation::DKStringAtom nameAtom;	// interned name, for searching property maps
 
 		static inline BaseType GetBaseType(Type t)
 		{
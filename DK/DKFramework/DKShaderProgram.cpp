@@ -184,7 +184,7 @@ namespace DKFramework
 							int loc = glGetUniformLocation(id, name);
 							if (loc >= 0)
 							{
-								DKShaderConstant	uni = {name, DKShaderConstant::UniformUnknown, GetShaderConstantType(type), static_cast<size_t>(size), loc};
+								DKShaderConstant	uni = {name, DKShaderConstant::UniformUnknown, GetShaderConstantType(type), static_cast<size_t>(size), loc, name};
 								uniforms.Add(uni);
 							}
 							// DKLog("Shader Program: 0x%x Uniform[%d] = %ls (size:%d, type:%ls, location:%d)\n",
@@ -132,9 +132,8 @@ void DKSkinMesh::OnUpdateTreeReferences(NamedObjectMap& names, UUIDObjectMap& uu
 	ResolveTransformNodes(names);
 }
 
-void DKSkinMesh::OnUpdateSceneState(const DKNSTransform& parentWorldTransform)
+void DKSkinMesh::OnUpdateDependentSceneState(void)
 {
-	DKStaticMesh::OnUpdateSceneState(parentWorldTransform);
 	// bone's world-transform should apply local-transform of baseObject.
 	if (transformNodeResolved)
 	{
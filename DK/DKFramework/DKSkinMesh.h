@@ -53,7 +53,9 @@ namespace DKFramework
 
 	protected:
 		void OnUpdateTreeReferences(NamedObjectMap&, UUIDObjectMap&) override;
-		void OnUpdateSceneState(const DKNSTransform&) override;
+		// bone nodes can be moved without this node, and can be in other tree.
+		void OnUpdateDependentSceneState(void) override;
+		bool DependsOnOtherNodes(void) const override { return true; }
 
 		bool BindTransform(DKSceneState&) const override;
 
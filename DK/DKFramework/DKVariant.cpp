@@ -1444,6 +1444,324 @@ FAILED:
 	return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// DKVariant packed binary format layout
+//   Header, Node, Node, ...
+//
+// Header (24 bytes)
+//   HEADER_STRING(8 bytes), Version(uint-32), Reserved(uint-32),
+//   Offset of root node(uint-64)
+//
+// HEADER_STRING = "DKVPack" + byte_order_char (B/L)
+// big-endian = "DKVPackB"
+// little-endian = "DKVPackL"
+//
+// Node (8 bytes aligned, offset from beginning of header)
+//   Type(uint-32), Reserved(uint-32), Data
+//
+// Data by Type
+//  -TypeUndefined = 0
+//  -TypeInteger = 8 (long long)
+//  -TypeFloat = 8 (double)
+//  -TypeVector2 ~ TypeQuaternion = float x N, padded to 8 bytes
+//  -TypeRational = 16 (numerator(int64), denominator(int64))
+//  -TypeDateTime = 16 (seconds(int64), microseconds(int32), padding)
+//  -TypeString
+//      Data: length(uint64), string(utf8), null-terminator, padding
+//  -TypeData
+//      Data: size(uint64), bytes, padding
+//  -TypeArray
+//      Data: number of items(uint64), offset of item1(uint64), ...
+//  -TypePairs
+//      Data: number of items(uint64),
+//            offset of key1(uint64), offset of item1(uint64),
+//            offset of key2(uint64), offset of item2(uint64), ...
+//      key is TypeString node, sorted by utf8 bytes.
+//
+// Values are stored in system byte order.
+// Child nodes are always stored before parent. (offset of child < parent)
+////////////////////////////////////////////////////////////////////////////////
+
+#define DKVARIANT_PACKED_VERSION	1
+#define DKVARIANT_PACKED_HEADER_STRING_BIG_ENDIAN		"DKVPackB"
+#define DKVARIANT_PACKED_HEADER_STRING_LITTLE_ENDIAN	"DKVPackL"
+#define DKVARIANT_PACKED_HEADER_LENGTH	8
+
+#if __LITTLE_ENDIAN__
+#define DKVARIANT_PACKED_HEADER_STRING		DKVARIANT_PACKED_HEADER_STRING_LITTLE_ENDIAN
+#else
+#define DKVARIANT_PACKED_HEADER_STRING		DKVARIANT_PACKED_HEADER_STRING_BIG_ENDIAN
+#endif
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		namespace
+		{
+			struct VariantPackedHeader
+			{
+				char name[DKVARIANT_PACKED_HEADER_LENGTH];
+				unsigned int version;
+				unsigned int reserved;
+				unsigned long long root;
+			};
+			struct VariantPackedNode
+			{
+				unsigned int type;
+				unsigned int reserved;
+			};
+			struct VariantPackedPair
+			{
+				unsigned long long key;
+				unsigned long long value;
+			};
+			static_assert(sizeof(VariantPackedHeader) == 24, "header size must be 24");
+			static_assert(sizeof(VariantPackedNode) == 8, "node size must be 8");
+
+			template <typename T> inline T ReadPacked(const unsigned char* p)
+			{
+				T value;
+				memcpy(&value, p, sizeof(T));
+				return value;
+			}
+
+			class VariantPacker
+			{
+			public:
+				DKArray<unsigned char> buffer;
+
+				VariantPacker(void)
+				{
+					VariantPackedHeader header;
+					memcpy(header.name, DKVARIANT_PACKED_HEADER_STRING, DKVARIANT_PACKED_HEADER_LENGTH);
+					header.version = DKVARIANT_PACKED_VERSION;
+					header.reserved = 0;
+					header.root = 0;
+					Write(&header, sizeof(header));
+				}
+				bool Pack(const DKVariant& v)
+				{
+					unsigned long long root;
+					if (Pack(v, root))
+					{
+						memcpy(&buffer.Value(offsetof(VariantPackedHeader, root)), &root, sizeof(root));
+						return true;
+					}
+					return false;
+				}
+			private:
+				void Write(const void* p, size_t s)
+				{
+					buffer.Add(reinterpret_cast<const unsigned char*>(p), s);
+				}
+				void Align(void)
+				{
+					const unsigned char zero[8] = {0};
+					size_t pad = (8 - (buffer.Count() % 8)) % 8;
+					if (pad)
+						Write(zero, pad);
+				}
+				unsigned long long BeginNode(DKVariant::Type t)
+				{
+					Align();
+					unsigned long long offset = buffer.Count();
+					VariantPackedNode node = {static_cast<unsigned int>(t), 0};
+					Write(&node, sizeof(node));
+					return offset;
+				}
+				unsigned long long PackString(const DKUniChar8* str, size_t len)
+				{
+					unsigned long long offset = BeginNode(DKVariant::TypeString);
+					unsigned long long len64 = len;
+					Write(&len64, sizeof(len64));
+					Write(str, len);
+					const unsigned char zero = 0;
+					Write(&zero, 1);
+					return offset;
+				}
+				bool Pack(const DKVariant& v, unsigned long long& offset)
+				{
+					switch (v.ValueType())
+					{
+					case DKVariant::TypeUndefined:
+						offset = BeginNode(v.ValueType());
+						break;
+					case DKVariant::TypeInteger:
+						offset = BeginNode(v.ValueType());
+						Write(&v.Integer(), sizeof(DKVariant::VInteger));
+						break;
+					case DKVariant::TypeFloat:
+						offset = BeginNode(v.ValueType());
+						Write(&v.Float(), sizeof(DKVariant::VFloat));
+						break;
+					case DKVariant::TypeVector2:
+						offset = BeginNode(v.ValueType());
+						Write(v.Vector2().val, sizeof(float) * 2);
+						break;
+					case DKVariant::TypeVector3:
+						offset = BeginNode(v.ValueType());
+						Write(v.Vector3().val, sizeof(float) * 3);
+						break;
+					case DKVariant::TypeVector4:
+						offset = BeginNode(v.ValueType());
+						Write(v.Vector4().val, sizeof(float) * 4);
+						break;
+					case DKVariant::TypeMatrix2:
+						offset = BeginNode(v.ValueType());
+						Write(v.Matrix2().val, sizeof(float) * 4);
+						break;
+					case DKVariant::TypeMatrix3:
+						offset = BeginNode(v.ValueType());
+						Write(v.Matrix3().val, sizeof(float) * 9);
+						break;
+					case DKVariant::TypeMatrix4:
+						offset = BeginNode(v.ValueType());
+						Write(v.Matrix4().val, sizeof(float) * 16);
+						break;
+					case DKVariant::TypeQuaternion:
+						offset = BeginNode(v.ValueType());
+						Write(v.Quaternion().val, sizeof(float) * 4);
+						break;
+					case DKVariant::TypeRational:
+						if (true)
+						{
+							long long r[2] = {v.Rational().Numerator(), v.Rational().Denominator()};
+							offset = BeginNode(v.ValueType());
+							Write(r, sizeof(r));
+						}
+						break;
+					case DKVariant::TypeDateTime:
+						if (true)
+						{
+							struct
+							{
+								long long s;
+								int us;
+								int reserved;
+							} dt = {v.DateTime().SecondsSinceEpoch(), v.DateTime().Microsecond(), 0};
+							offset = BeginNode(v.ValueType());
+							Write(&dt, sizeof(dt));
+						}
+						break;
+					case DKVariant::TypeString:
+						if (true)
+						{
+							DKStringU8 str(v.String());
+							offset = PackString(str, str.Bytes());
+						}
+						break;
+					case DKVariant::TypeData:
+						if (true)
+						{
+							const void* ptr = v.Data().LockShared();
+							unsigned long long len = v.Data().Length();
+							offset = BeginNode(v.ValueType());
+							Write(&len, sizeof(len));
+							if (len > 0)
+								Write(ptr, len);
+							v.Data().UnlockShared();
+						}
+						break;
+					case DKVariant::TypeArray:
+						if (true)
+						{
+							const DKVariant::VArray& a = v.Array();
+							DKArray<unsigned long long> items;
+							items.Reserve(a.Count());
+							for (const DKVariant& item : a)
+							{
+								unsigned long long itemOffset;
+								if (!Pack(item, itemOffset))
+									return false;
+								items.Add(itemOffset);
+							}
+							unsigned long long count = items.Count();
+							offset = BeginNode(v.ValueType());
+							Write(&count, sizeof(count));
+							if (count > 0)
+								Write((const unsigned long long*)items, sizeof(unsigned long long) * count);
+						}
+						break;
+					case DKVariant::TypePairs:
+						if (true)
+						{
+							struct KeyValue
+							{
+								DKStringU8 key;
+								const DKVariant* value;
+							};
+							DKArray<KeyValue> keyValues;
+							keyValues.Reserve(v.Pairs().Count());
+							v.Pairs().EnumerateForward([&keyValues](const DKVariant::VPairs::Pair& pair)
+							{
+								KeyValue kv = {DKStringU8(pair.key), &pair.value};
+								keyValues.Add(static_cast<KeyValue&&>(kv));
+							});
+							// sort by utf8 bytes, for binary search.
+							keyValues.Sort([](const KeyValue& lhs, const KeyValue& rhs)
+							{
+								return strcmp((const char*)lhs.key, (const char*)rhs.key) < 0;
+							});
+							DKArray<VariantPackedPair> items;
+							items.Reserve(keyValues.Count());
+							for (const KeyValue& kv : keyValues)
+							{
+								VariantPackedPair pair;
+								pair.key = PackString(kv.key, kv.key.Bytes());
+								if (!Pack(*kv.value, pair.value))
+									return false;
+								items.Add(pair);
+							}
+							unsigned long long count = items.Count();
+							offset = BeginNode(v.ValueType());
+							Write(&count, sizeof(count));
+							if (count > 0)
+								Write((const VariantPackedPair*)items, sizeof(VariantPackedPair) * count);
+						}
+						break;
+					default:
+						DKLog("DKVariant Error: Unknown Type: 0x%x.\n", v.ValueType());
+						return false;
+					}
+					return true;
+				}
+			};
+		}
+	}
+}
+
+bool DKVariant::ExportPacked(DKStream* stream) const
+{
+	if (stream == NULL || stream->IsWritable() == false)
+	{
+		DKLog("DKVariant Error: Invalid stream.\n");
+		return false;
+	}
+
+	Private::VariantPacker packer;
+	if (packer.Pack(*this))
+	{
+		size_t length = packer.buffer.Count();
+		if (stream->Write((const unsigned char*)packer.buffer, length) == length)
+			return true;
+		DKLog("DKVariant Error: Failed to write to stream.\n");
+	}
+	return false;
+}
+
+bool DKVariant::ImportPacked(const void* data, size_t length)
+{
+	DKVariantView view(data, length);
+	if (view.IsValid())
+	{
+		*this = view.Variant();
+		return true;
+	}
+	DKLog("DKVariant Error: Format is not packed DKVariant.\n");
+	return false;
+}
+
 DKVariant& DKVariant::operator = (const DKVariant& v)
 {
 	return this->SetValue(v);
@@ -1904,3 +2222,405 @@ bool DKVariant::IsEqual(const DKVariant& v) const
 	}
 	return result;
 }
+
+DKVariantView::DKVariantView(void)
+	: data(NULL), length(0), offset(0)
+{
+}
+
+DKVariantView::DKVariantView(const void* p, size_t len)
+	: data(NULL), length(0), offset(0)
+{
+	if (p && len >= sizeof(Private::VariantPackedHeader))
+	{
+		Private::VariantPackedHeader header = Private::ReadPacked<Private::VariantPackedHeader>(reinterpret_cast<const unsigned char*>(p));
+		if (memcmp(header.name, DKVARIANT_PACKED_HEADER_STRING, DKVARIANT_PACKED_HEADER_LENGTH) == 0 &&
+			header.version <= DKVARIANT_PACKED_VERSION &&
+			header.root >= sizeof(header) &&
+			header.root <= len - sizeof(Private::VariantPackedNode))
+		{
+			this->data = reinterpret_cast<const unsigned char*>(p);
+			this->length = len;
+			this->offset = header.root;
+		}
+	}
+}
+
+DKVariantView::DKVariantView(const unsigned char* p, size_t len, size_t off)
+	: data(p), length(len), offset(off)
+{
+}
+
+bool DKVariantView::CheckRange(size_t off, size_t size) const
+{
+	return off <= length && size <= length - off;
+}
+
+const unsigned char* DKVariantView::Payload(size_t size) const
+{
+	if (data && CheckRange(offset + sizeof(Private::VariantPackedNode), size))
+		return &data[offset + sizeof(Private::VariantPackedNode)];
+	return NULL;
+}
+
+size_t DKVariantView::ItemOffset(size_t index, size_t stride, size_t field) const
+{
+	if (index < Count())
+	{
+		const unsigned char* p = Payload(sizeof(unsigned long long) + stride * (index + 1));
+		if (p)
+		{
+			unsigned long long off = Private::ReadPacked<unsigned long long>(&p[sizeof(unsigned long long) + stride * index + field]);
+			// child node should be placed before parent.
+			if (off >= sizeof(Private::VariantPackedHeader) && off < offset)
+				return static_cast<size_t>(off);
+		}
+	}
+	return 0;
+}
+
+bool DKVariantView::IsValid(void) const
+{
+	return data != NULL;
+}
+
+DKVariant::Type DKVariantView::ValueType(void) const
+{
+	if (data)
+	{
+		Private::VariantPackedNode node = Private::ReadPacked<Private::VariantPackedNode>(&data[offset]);
+		switch (static_cast<DKVariant::Type>(node.type))
+		{
+		case DKVariant::TypeInteger:
+		case DKVariant::TypeFloat:
+		case DKVariant::TypeVector2:
+		case DKVariant::TypeVector3:
+		case DKVariant::TypeVector4:
+		case DKVariant::TypeMatrix2:
+		case DKVariant::TypeMatrix3:
+		case DKVariant::TypeMatrix4:
+		case DKVariant::TypeQuaternion:
+		case DKVariant::TypeRational:
+		case DKVariant::TypeString:
+		case DKVariant::TypeDateTime:
+		case DKVariant::TypeData:
+		case DKVariant::TypeArray:
+		case DKVariant::TypePairs:
+			return static_cast<DKVariant::Type>(node.type);
+		default:
+			break;
+		}
+	}
+	return DKVariant::TypeUndefined;
+}
+
+DKVariant::VInteger DKVariantView::Integer(void) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeInteger ? Payload(sizeof(DKVariant::VInteger)) : NULL;
+	if (p)
+		return Private::ReadPacked<DKVariant::VInteger>(p);
+	return 0;
+}
+
+DKVariant::VFloat DKVariantView::Float(void) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeFloat ? Payload(sizeof(DKVariant::VFloat)) : NULL;
+	if (p)
+		return Private::ReadPacked<DKVariant::VFloat>(p);
+	return 0.0;
+}
+
+DKVariant::VVector2 DKVariantView::Vector2(void) const
+{
+	DKVariant::VVector2 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeVector2 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VVector3 DKVariantView::Vector3(void) const
+{
+	DKVariant::VVector3 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeVector3 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VVector4 DKVariantView::Vector4(void) const
+{
+	DKVariant::VVector4 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeVector4 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VMatrix2 DKVariantView::Matrix2(void) const
+{
+	DKVariant::VMatrix2 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeMatrix2 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VMatrix3 DKVariantView::Matrix3(void) const
+{
+	DKVariant::VMatrix3 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeMatrix3 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VMatrix4 DKVariantView::Matrix4(void) const
+{
+	DKVariant::VMatrix4 value;
+	const unsigned char* p = ValueType() == DKVariant::TypeMatrix4 ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VQuaternion DKVariantView::Quaternion(void) const
+{
+	DKVariant::VQuaternion value;
+	const unsigned char* p = ValueType() == DKVariant::TypeQuaternion ? Payload(sizeof(value.val)) : NULL;
+	if (p)
+		memcpy(value.val, p, sizeof(value.val));
+	return value;
+}
+
+DKVariant::VRational DKVariantView::Rational(void) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeRational ? Payload(sizeof(long long) * 2) : NULL;
+	if (p)
+		return DKVariant::VRational(Private::ReadPacked<long long>(p), Private::ReadPacked<long long>(&p[sizeof(long long)]));
+	return DKVariant::VRational();
+}
+
+DKVariant::VDateTime DKVariantView::DateTime(void) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeDateTime ? Payload(sizeof(long long) + sizeof(int)) : NULL;
+	if (p)
+		return DKVariant::VDateTime(Private::ReadPacked<long long>(p), Private::ReadPacked<int>(&p[sizeof(long long)]));
+	return DKVariant::VDateTime(0LL, 0);
+}
+
+DKVariant::VString DKVariantView::String(void) const
+{
+	size_t bytes = 0;
+	const DKUniChar8* str = StringUTF8(&bytes);
+	if (str)
+		return DKVariant::VString(str, bytes);
+	return DKVariant::VString(L"");
+}
+
+const DKUniChar8* DKVariantView::StringUTF8(size_t* bytes) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeString ? Payload(sizeof(unsigned long long)) : NULL;
+	if (p)
+	{
+		unsigned long long len = Private::ReadPacked<unsigned long long>(p);
+		size_t begin = offset + sizeof(Private::VariantPackedNode) + sizeof(unsigned long long);
+		if (len < length && CheckRange(begin, len + 1) && data[begin + len] == 0)
+		{
+			if (bytes)
+				*bytes = static_cast<size_t>(len);
+			return reinterpret_cast<const DKUniChar8*>(&data[begin]);
+		}
+	}
+	if (bytes)
+		*bytes = 0;
+	return NULL;
+}
+
+const void* DKVariantView::Data(size_t* bytes) const
+{
+	const unsigned char* p = ValueType() == DKVariant::TypeData ? Payload(sizeof(unsigned long long)) : NULL;
+	if (p)
+	{
+		unsigned long long len = Private::ReadPacked<unsigned long long>(p);
+		size_t begin = offset + sizeof(Private::VariantPackedNode) + sizeof(unsigned long long);
+		if (len <= length && CheckRange(begin, len))
+		{
+			if (bytes)
+				*bytes = static_cast<size_t>(len);
+			return &data[begin];
+		}
+	}
+	if (bytes)
+		*bytes = 0;
+	return NULL;
+}
+
+size_t DKVariantView::Count(void) const
+{
+	size_t stride = 0;
+	switch (ValueType())
+	{
+	case DKVariant::TypeArray:
+		stride = sizeof(unsigned long long);
+		break;
+	case DKVariant::TypePairs:
+		stride = sizeof(Private::VariantPackedPair);
+		break;
+	default:
+		return 0;
+	}
+	const unsigned char* p = Payload(sizeof(unsigned long long));
+	if (p)
+	{
+		unsigned long long count = Private::ReadPacked<unsigned long long>(p);
+		size_t begin = offset + sizeof(Private::VariantPackedNode) + sizeof(unsigned long long);
+		if (count <= (length - begin) / stride)
+			return static_cast<size_t>(count);
+	}
+	return 0;
+}
+
+DKVariantView DKVariantView::Value(size_t index) const
+{
+	size_t off = 0;
+	switch (ValueType())
+	{
+	case DKVariant::TypeArray:
+		off = ItemOffset(index, sizeof(unsigned long long), 0);
+		break;
+	case DKVariant::TypePairs:
+		off = ItemOffset(index, sizeof(Private::VariantPackedPair), offsetof(Private::VariantPackedPair, value));
+		break;
+	default:
+		break;
+	}
+	if (off > 0 && CheckRange(off, sizeof(Private::VariantPackedNode)))
+		return DKVariantView(data, length, off);
+	return DKVariantView();
+}
+
+const DKUniChar8* DKVariantView::Key(size_t index, size_t* bytes) const
+{
+	size_t off = 0;
+	if (ValueType() == DKVariant::TypePairs)
+		off = ItemOffset(index, sizeof(Private::VariantPackedPair), offsetof(Private::VariantPackedPair, key));
+	if (off > 0 && CheckRange(off, sizeof(Private::VariantPackedNode)))
+		return DKVariantView(data, length, off).StringUTF8(bytes);
+	if (bytes)
+		*bytes = 0;
+	return NULL;
+}
+
+DKVariantView DKVariantView::Find(const DKUniChar8* key) const
+{
+	if (key && ValueType() == DKVariant::TypePairs)
+	{
+		size_t begin = 0;
+		size_t end = Count();
+		while (begin < end)
+		{
+			size_t mid = begin + (end - begin) / 2;
+			const DKUniChar8* k = Key(mid);
+			if (k == NULL)
+				break;
+			int cmp = strcmp(k, key);
+			if (cmp == 0)
+				return Value(mid);
+			if (cmp < 0)
+				begin = mid + 1;
+			else
+				end = mid;
+		}
+	}
+	return DKVariantView();
+}
+
+DKVariantView DKVariantView::Find(const DKString& key) const
+{
+	DKStringU8 str(key);
+	return Find((const DKUniChar8*)str);
+}
+
+DKVariant DKVariantView::Variant(void) const
+{
+	DKVariant::Type t = ValueType();
+	switch (t)
+	{
+	case DKVariant::TypeInteger:
+		return DKVariant(Integer());
+	case DKVariant::TypeFloat:
+		return DKVariant(Float());
+	case DKVariant::TypeVector2:
+		return DKVariant(Vector2());
+	case DKVariant::TypeVector3:
+		return DKVariant(Vector3());
+	case DKVariant::TypeVector4:
+		return DKVariant(Vector4());
+	case DKVariant::TypeMatrix2:
+		return DKVariant(Matrix2());
+	case DKVariant::TypeMatrix3:
+		return DKVariant(Matrix3());
+	case DKVariant::TypeMatrix4:
+		return DKVariant(Matrix4());
+	case DKVariant::TypeQuaternion:
+		return DKVariant(Quaternion());
+	case DKVariant::TypeRational:
+		return DKVariant(Rational());
+	case DKVariant::TypeDateTime:
+		return DKVariant(DateTime());
+	case DKVariant::TypeString:
+		if (true)
+		{
+			DKVariant value(t);
+			size_t bytes = 0;
+			const DKUniChar8* str = StringUTF8(&bytes);
+			if (str)
+				value.String().SetValue(str, bytes);
+			return value;
+		}
+		break;
+	case DKVariant::TypeData:
+		if (true)
+		{
+			DKVariant value(t);
+			size_t bytes = 0;
+			const void* p = Data(&bytes);
+			if (p && bytes > 0)
+				value.Data().SetContent(p, bytes);
+			return value;
+		}
+		break;
+	case DKVariant::TypeArray:
+		if (true)
+		{
+			DKVariant value(t);
+			DKVariant::VArray& items = value.Array();
+			size_t count = Count();
+			items.Reserve(count);
+			for (size_t i = 0; i < count; ++i)
+				items.Add(Value(i).Variant());
+			return value;
+		}
+		break;
+	case DKVariant::TypePairs:
+		if (true)
+		{
+			DKVariant value(t);
+			DKVariant::VPairs& pairs = value.Pairs();
+			size_t count = Count();
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t bytes = 0;
+				const DKUniChar8* key = Key(i, &bytes);
+				if (key)
+					pairs.Value(DKString(key, bytes)) = Value(i).Variant();
+			}
+			return value;
+		}
+		break;
+	default:
+		break;
+	}
+	return DKVariant(DKVariant::TypeUndefined);
+}
@@ -38,6 +38,24 @@
 //   - Undefined (no value, initial type)
 //
 // DKVariant object can be serialized with XML or binary.
+//
+// Packed binary format (ExportPacked) stores values with offset-based layout,
+// it can be read in place with DKVariantView, without parsing whole data.
+//
+// DKVariantView
+// read-only view of packed DKVariant data. (created by ExportPacked)
+// view does not copy or own data, data should be alive while using view.
+// (ex: data of DKFileMap, DKBuffer locked with LockShared)
+// Pairs keys are sorted, Find() uses binary search.
+// all offsets are validated, malformed data yields invalid view.
+// packed data can be read on same byte-order system only.
+//
+// Example:
+//   DKObject<DKFileMap> map = DKFileMap::Open(file, 0, false);
+//   const void* p = map->LockShared();
+//   DKVariantView root(p, map->Length());
+//   double d = root.Find(L"scale").Float();
+//   map->UnlockShared();
 ////////////////////////////////////////////////////////////////////////////////
 
 
@@ -117,6 +135,10 @@ namespace DKFramework
 		bool ExportStream(DKFoundation::DKStream* stream) const;
 		bool ImportStream(DKFoundation::DKStream* stream);
 
+		// Packed binary input/output (can be read in place with DKVariantView)
+		bool ExportPacked(DKFoundation::DKStream* stream) const;
+		bool ImportPacked(const void* data, size_t length);
+
 		DKVariant& SetInteger(const VInteger& v);
 		DKVariant& SetFloat(const VFloat& v);
 		DKVariant& SetVector2(const VVector2& v);
@@ -181,4 +203,54 @@ namespace DKFramework
 		unsigned char vblock[VBlock<16>::Size]; // minSize is 16, vblock will be greater or equal to 16.
 		Type valueType;
 	};
+
+	class DKGL_API DKVariantView
+	{
+	public:
+		DKVariantView(void);
+		DKVariantView(const void* data, size_t length);
+
+		bool IsValid(void) const;
+		DKVariant::Type ValueType(void) const;
+
+		DKVariant::VInteger Integer(void) const;
+		DKVariant::VFloat Float(void) const;
+		DKVariant::VVector2 Vector2(void) const;
+		DKVariant::VVector3 Vector3(void) const;
+		DKVariant::VVector4 Vector4(void) const;
+		DKVariant::VMatrix2 Matrix2(void) const;
+		DKVariant::VMatrix3 Matrix3(void) const;
+		DKVariant::VMatrix4 Matrix4(void) const;
+		DKVariant::VQuaternion Quaternion(void) const;
+		DKVariant::VRational Rational(void) const;
+		DKVariant::VDateTime DateTime(void) const;
+		DKVariant::VString String(void) const;
+		// null-terminated UTF-8 string in data. (no copy)
+		const DKFoundation::DKUniChar8* StringUTF8(size_t* bytes = NULL) const;
+		// bytes of TypeData in data. (no copy)
+		const void* Data(size_t* length = NULL) const;
+
+		// number of items of TypeArray, TypePairs.
+		size_t Count(void) const;
+		// item of TypeArray, value of TypePairs.
+		DKVariantView Value(size_t index) const;
+		// key of TypePairs. (null-terminated UTF-8, sorted)
+		const DKFoundation::DKUniChar8* Key(size_t index, size_t* bytes = NULL) const;
+		// find value of TypePairs, returns invalid view if not found.
+		DKVariantView Find(const DKFoundation::DKUniChar8* key) const;
+		DKVariantView Find(const DKFoundation::DKString& key) const;
+
+		// create DKVariant object with all descendant values.
+		DKVariant Variant(void) const;
+
+	private:
+		DKVariantView(const unsigned char* data, size_t length, size_t offset);
+		bool CheckRange(size_t offset, size_t size) const;
+		const unsigned char* Payload(size_t size) const;
+		size_t ItemOffset(size_t index, size_t stride, size_t field) const;
+
+		const unsigned char* data;
+		size_t length;
+		size_t offset;	// offset of node
+	};
 }
@@ -10,9 +10,11 @@
 #include "DKMatrix3.h"
 #include "DKMatrix4.h"
 #include "DKQuaternion.h"
+#include "Private/SIMDUtils.h"
 
 using namespace DKFoundation;
 using namespace DKFramework;
+using namespace DKFramework::Private;
 
 const DKVector3 DKVector3::zero = DKVector3(0,0,0);
 
@@ -276,6 +278,9 @@ DKVector3& DKVector3::Transform(const DKMatrix3& m)
 
 DKVector3& DKVector3::Transform(const DKMatrix4& m)
 {
+#ifdef DKGL_SIMD_ENABLED
+	SIMD::Vector3Transform(this->val, m.val, this->val);
+#else
 	DKVector3 vec(x, y, z);
 	this->x = (vec.x * m.m[0][0]) + (vec.y * m.m[1][0]) + (vec.z * m.m[2][0]) + m.m[3][0];
 	this->y = (vec.x * m.m[0][1]) + (vec.y * m.m[1][1]) + (vec.z * m.m[2][1]) + m.m[3][1];
@@ -285,9 +290,40 @@ DKVector3& DKVector3::Transform(const DKMatrix4& m)
 	this->x *= w;
 	this->y *= w;
 	this->z *= w;
+#endif
 	return *this;
 }
 
+void DKVector3::TransformArray(const DKVector3* in, DKVector3* out, size_t count, const DKMatrix4& m)
+{
+	const DKMatrix4 mat(m);
+	for (size_t i = 0; i < count; ++i)
+	{
+#ifdef DKGL_SIMD_ENABLED
+		SIMD::Vector3Transform(in[i].val, mat.val, out[i].val);
+#else
+		out[i] = DKVector3(in[i]).Transform(mat);
+#endif
+	}
+}
+
+void DKVector3::TransformArray(float* x, float* y, float* z, size_t count, const DKMatrix4& m)
+{
+	const DKMatrix4 mat(m);
+	size_t i = 0;
+#ifdef DKGL_SIMD_ENABLED
+	for (; i + 4 <= count; i += 4)
+		SIMD::Vector3TransformSoA4(&x[i], &y[i], &z[i], mat.val);
+#endif
+	for (; i < count; ++i)
+	{
+		DKVector3 v = DKVector3(x[i], y[i], z[i]).Transform(mat);
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+}
+
 DKVector3& DKVector3::Normalize(void)
 {
 	float lengthSq = x*x + y*y + z*z;
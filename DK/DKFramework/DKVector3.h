@@ -65,6 +65,11 @@ namespace DKFramework
 		DKVector3& Transform(const DKMatrix4& m);	// Homogeneous Transform
 		DKVector3& Normalize(void);
 
+		// batch homogeneous transform of array, (AoS, out can be in)
+		static void TransformArray(const DKVector3* in, DKVector3* out, size_t count, const DKMatrix4& m);
+		// batch homogeneous transform of SoA array, transformed in place.
+		static void TransformArray(float* x, float* y, float* z, size_t count, const DKMatrix4& m);
+
 		operator float* (void)				{return val;}
 		operator const float* (void) const	{return val;}
 
@@ -65,7 +65,7 @@ namespace DKFramework
 	private:
 		void UpdateDeclMap(void);
 		typedef DKFoundation::DKMap<DKVertexStream::Stream, const Decl*> DeclMapById;
-		typedef DKFoundation::DKMap<DKFoundation::DKString, const Decl*> DeclMapByName;
+		typedef DKFoundation::DKHashMap<DKFoundation::DKString, const Decl*> DeclMapByName;
 
 		DeclMapById declMapByStreamId;
 		DeclMapByName declMapByStreamName;
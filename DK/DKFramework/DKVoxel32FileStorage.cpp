@@ -5,34 +5,666 @@
 //  Copyright (c) 2009-2014 Hongtae Kim. All rights reserved.
 //
 
+#define DKGL_EXTDEPS_ZLIB
+#include "../lib/ExtDeps.h"
 #include "DKVoxel32FileStorage.h"
 
 using namespace DKFoundation;
 using namespace DKFramework;
 
-DKVoxel32FileStorage::DKVoxel32FileStorage(void)
-	: maxLoadableUnits(-1)
+namespace DKFramework
 {
+	namespace Private
+	{
+		namespace Voxel32FileStorage
+		{
+			enum : uint32_t
+			{
+				PageSize = 1024,
+				SegmentPages = 0x4000,			// 16MB per segment
+				HeaderPages = 4,
+				MaxUnitPages = DKVoxel32FileStorage::UnitBytes / PageSize,
+				MaxReusableVoxels = 64,
+				MinPendingUnits = 16,
+				FileVersion = 1,
+			};
+			enum : uint32_t
+			{
+				UnitFlagCompressed = 1,
+			};
+			const uint64_t SegmentBytes = static_cast<uint64_t>(SegmentPages) * PageSize;
+			const char fileMagic[8] = { 'D', 'K', 'V', 'O', 'X', '3', '2', 'F' };
+
+			// all values are little-endian.
+			struct FileHeader
+			{
+				char magic[8];
+				uint32_t version;
+				uint32_t pageSize;
+				uint32_t segmentPages;
+				uint32_t clean;				// directory is valid.
+				uint64_t numPages;
+				uint64_t directoryOffset;
+				uint64_t directoryEntries;
+			};
+			struct DirectoryEntry
+			{
+				unsigned char sid[16];
+				uint64_t page;
+				uint32_t pages;
+				uint32_t bytes;
+				uint32_t flags;
+				uint32_t checksum;
+			};
+			static_assert(sizeof(DKUuid) == 16, "DKUuid size must be 16");
+			static_assert(sizeof(FileHeader) <= PageSize * HeaderPages, "Header size is too big");
+
+			inline uint32_t Checksum(const DKVoxel32* voxels)
+			{
+				return (uint32_t)crc32(0L, reinterpret_cast<const Bytef*>(voxels), DKVoxel32FileStorage::UnitBytes);
+			}
+		}
+	}
+}
+using namespace DKFramework::Private::Voxel32FileStorage;
+
+
+DKVoxel32FileStorage::DKVoxel32FileStorage(size_t maxActiveUnits, Compression c)
+	: maxLoadableUnits(Max(maxActiveUnits, (size_t)1))
+	, numPages(0)
+	, clean(false)
+	, maxPendingUnits(Max(maxActiveUnits / 4, (size_t)MinPendingUnits))
+	, numActiveUnits(0)
+	, numPendingUnits(0)
+	, compression(c)
+	, terminate(false)
+{
+	memset(&stats, 0, sizeof(Statistics));
+	writeBackThread = DKThread::Create(DKFunction(this, &DKVoxel32FileStorage::WriteBackThreadProc)->Invocation());
 }
 
 DKVoxel32FileStorage::~DKVoxel32FileStorage(void)
 {
+	Synchronize();
+
+	cond.Lock();
+	terminate = true;
+	cond.Broadcast();
+	cond.Unlock();
+	if (writeBackThread)
+		writeBackThread->WaitTerminate();
+	writeBackThread = NULL;
+
+	DKASSERT_DEBUG(numPendingUnits == 0);
+	if (numActiveUnits > 0)
+		DKLog("Warning: DKVoxel32FileStorage destroyed with %lu active units.\n", (unsigned long)numActiveUnits);
+
+	units.EnumerateForward([](UnitMap::Pair& pair)
+	{
+		if (pair.value.voxels)
+			delete[] pair.value.voxels;
+	});
+	units.Clear();
+	for (DKVoxel32* voxels : reusableVoxels)
+		delete[] voxels;
+	reusableVoxels.Clear();
+
+	for (DKData* data : segments)
+		data->UnlockShared();
+	segments.Clear();
+	file = NULL;
 }
 
-DKVoxel32* DKVoxel32FileStorage::Create(const StorageId& sid)
+DKObject<DKVoxel32FileStorage> DKVoxel32FileStorage::Open(const DKString& path, bool overwrite, size_t maxActiveUnits, Compression c)
 {
+	DKObject<DKFile> file = NULL;
+	bool exists = false;
+	if (!overwrite)
+	{
+		file = DKFile::Create(path, DKFile::ModeOpenExisting, DKFile::ModeShareExclusive);
+		exists = file != NULL;
+	}
+	if (file == NULL)
+		file = DKFile::Create(path, DKFile::ModeOpenNew, DKFile::ModeShareExclusive);
+
+	if (file)
+	{
+		DKObject<DKVoxel32FileStorage> storage = DKObject<DKVoxel32FileStorage>::New(maxActiveUnits, c);
+		DKCriticalSection<DKCondition> guard(storage->cond);
+		if (storage->InitFile(file, exists))
+			return storage;
+	}
+	DKLog("DKVoxel32FileStorage: Cannot open file: %ls\n", (const wchar_t*)path);
 	return NULL;
 }
 
+bool DKVoxel32FileStorage::InitFile(DKFile* f, bool readDirectory)
+{
+	this->file = f;
+	if (readDirectory)
+	{
+		if (ReadDirectory())
+			return true;
+		DKLog("DKVoxel32FileStorage: file (%ls) is not valid or not synchronized, truncated.\n", (const wchar_t*)file->Path());
+		for (DKData* data : segments)
+			data->UnlockShared();
+		segments.Clear();
+		units.Clear();
+		freePages.Clear();
+	}
+	if (file->SetLength(0))
+	{
+		numPages = HeaderPages;
+		if (AllocatePages(0) == HeaderPages)		// map first segment
+		{
+			clean = true;
+			WriteHeader(false);
+			clean = false;
+			return true;
+		}
+	}
+	this->file = NULL;
+	return false;
+}
+
+bool DKVoxel32FileStorage::ReadDirectory(void)
+{
+	FileHeader header;
+	file->SetPos(0);
+	if (file->Read(&header, sizeof(FileHeader)) != sizeof(FileHeader))
+		return false;
+	if (memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+		DKLittleEndianToSystem(header.version) != FileVersion ||
+		DKLittleEndianToSystem(header.pageSize) != PageSize ||
+		DKLittleEndianToSystem(header.segmentPages) != SegmentPages ||
+		DKLittleEndianToSystem(header.clean) == 0)
+		return false;
+
+	uint64_t pages = DKLittleEndianToSystem(header.numPages);
+	uint64_t dirOffset = DKLittleEndianToSystem(header.directoryOffset);
+	uint64_t dirEntries = DKLittleEndianToSystem(header.directoryEntries);
+	uint64_t numSegments = dirOffset / SegmentBytes;
+	if (pages < HeaderPages || numSegments == 0 || dirOffset % SegmentBytes != 0 || pages > numSegments * SegmentPages ||
+		dirOffset + dirEntries * sizeof(DirectoryEntry) > static_cast<uint64_t>(file->TotalLength()))
+		return false;
+
+	DKArray<DirectoryEntry> entries;
+	entries.Resize(dirEntries);
+	file->SetPos(dirOffset);
+	if (file->Read((DirectoryEntry*)entries, sizeof(DirectoryEntry) * dirEntries) != sizeof(DirectoryEntry) * dirEntries)
+		return false;
+
+	// directory is kept in file until header is marked as dirty by first
+	// modification, file is truncated or overwritten when directory rewritten.
+	for (uint64_t i = 0; i < numSegments; ++i)
+	{
+		DKObject<DKData> data = file->MapContentRange(i * SegmentBytes, SegmentBytes);
+		if (data == NULL || !data->IsWritable())
+			return false;
+		data->LockShared();
+		segments.Add(data);
+	}
+	numPages = pages;
+
+	// rebuild units and free pages
+	DKArray<DirectoryEntry*> allocated;
+	allocated.Reserve(entries.Count());
+	for (DirectoryEntry& e : entries)
+	{
+		Unit unit;
+		unit.state = UnitStateStored;
+		unit.voxels = NULL;
+		unit.page = DKLittleEndianToSystem(e.page);
+		unit.pages = DKLittleEndianToSystem(e.pages);
+		unit.bytes = DKLittleEndianToSystem(e.bytes);
+		unit.flags = DKLittleEndianToSystem(e.flags);
+		unit.checksum = DKLittleEndianToSystem(e.checksum);
+		if (unit.page < HeaderPages || unit.page + unit.pages > numPages ||
+			unit.pages == 0 || unit.pages > MaxUnitPages || unit.bytes > unit.pages * PageSize)
+			return false;
+
+		StorageId sid;
+		memcpy(static_cast<void*>(&sid), e.sid, sizeof(e.sid));
+		if (!units.Insert(sid, unit))
+			return false;
+		e.page = unit.page;
+		e.pages = unit.pages;
+		allocated.Add(&e);
+	}
+	allocated.Sort([](DirectoryEntry* const& lhs, DirectoryEntry* const& rhs)
+	{
+		return lhs->page < rhs->page;
+	});
+	uint64_t page = HeaderPages;
+	for (DirectoryEntry* e : allocated)
+	{
+		if (e->page < page)		// overlapped
+			return false;
+		while (page < e->page)
+		{
+			// free-list cannot cross segments
+			uint64_t end = Min(e->page, (page / SegmentPages + 1) * SegmentPages);
+			FreePages(page, static_cast<uint32_t>(end - page));
+			page = end;
+		}
+		page = e->page + e->pages;
+	}
+	DKASSERT_DEBUG(page <= numPages);
+	numPages = page;
+
+	clean = true;
+	stats.units = units.Count();
+	return true;
+}
+
+void DKVoxel32FileStorage::WriteHeader(bool c)
+{
+	if (clean == c || segments.Count() == 0)
+		return;
+
+	FileHeader header;
+	memcpy(header.magic, fileMagic, sizeof(fileMagic));
+	header.version = DKSystemToLittleEndian<uint32_t>(FileVersion);
+	header.pageSize = DKSystemToLittleEndian<uint32_t>(PageSize);
+	header.segmentPages = DKSystemToLittleEndian<uint32_t>(SegmentPages);
+	header.clean = DKSystemToLittleEndian<uint32_t>(c ? 1 : 0);
+	header.numPages = DKSystemToLittleEndian<uint64_t>(numPages);
+	header.directoryOffset = DKSystemToLittleEndian<uint64_t>(segments.Count() * SegmentBytes);
+	header.directoryEntries = 0;
+	if (c)
+	{
+		units.EnumerateForward([&header](UnitMap::Pair& pair)
+		{
+			if (pair.value.pages > 0)
+				header.directoryEntries++;
+		});
+	}
+	header.directoryEntries = DKSystemToLittleEndian<uint64_t>(header.directoryEntries);
+	memcpy(PageAddress(0), &header, sizeof(FileHeader));
+	clean = c;
+}
+
+void DKVoxel32FileStorage::WriteDirectory(void)
+{
+	if (file == NULL || clean)
+		return;
+
+	DKArray<DirectoryEntry> entries;
+	entries.Reserve(units.Count());
+	units.EnumerateForward([&entries](UnitMap::Pair& pair)
+	{
+		const Unit& unit = pair.value;
+		if (unit.pages > 0)
+		{
+			DirectoryEntry e;
+			memcpy(e.sid, &pair.key, sizeof(e.sid));
+			e.page = DKSystemToLittleEndian<uint64_t>(unit.page);
+			e.pages = DKSystemToLittleEndian<uint32_t>(unit.pages);
+			e.bytes = DKSystemToLittleEndian<uint32_t>(unit.bytes);
+			e.flags = DKSystemToLittleEndian<uint32_t>(unit.flags);
+			e.checksum = DKSystemToLittleEndian<uint32_t>(unit.checksum);
+			entries.Add(e);
+		}
+	});
+
+	// directory is placed after last segment.
+	uint64_t offset = segments.Count() * SegmentBytes;
+	size_t bytes = sizeof(DirectoryEntry) * entries.Count();
+	if (file->SetLength(offset + bytes) && static_cast<uint64_t>(file->SetPos(offset)) == offset &&
+		file->Write((const DirectoryEntry*)entries, bytes) == bytes)
+	{
+		WriteHeader(true);
+	}
+	else
+	{
+		DKLog("DKVoxel32FileStorage: Failed to write directory.\n");
+	}
+}
+
+unsigned char* DKVoxel32FileStorage::PageAddress(uint64_t page)
+{
+	size_t seg = static_cast<size_t>(page / SegmentPages);
+	DKASSERT_DEBUG(seg < segments.Count());
+	// segments are locked while mapped, pages are written by owner of unit only.
+	unsigned char* base = reinterpret_cast<unsigned char*>(const_cast<void*>(segments.Value(seg)->LockShared()));
+	segments.Value(seg)->UnlockShared();
+	return &base[(page % SegmentPages) * PageSize];
+}
+
+uint64_t DKVoxel32FileStorage::AllocatePages(uint32_t num)
+{
+	DKASSERT_DEBUG(num <= MaxUnitPages);
+	if (num > 0)
+	{
+		for (uint32_t n = num; n <= MaxUnitPages; ++n)
+		{
+			auto p = freePages.Find(n);
+			if (p && p->value.Count() > 0)
+			{
+				uint64_t page = p->value.Value(p->value.Count() - 1);
+				p->value.Remove(p->value.Count() - 1);
+				FreePages(page + num, n - num);
+				return page;
+			}
+		}
+	}
+
+	if (file == NULL)
+	{
+		DKObject<DKFile> f = DKFile::CreateTemporary();
+		if (f == NULL || !InitFile(f, false))
+		{
+			DKLog("DKVoxel32FileStorage: Cannot create temporary file.\n");
+			return 0;
+		}
+	}
+
+	// pages cannot cross segments.
+	uint64_t page = numPages;
+	uint64_t segmentEnd = (page / SegmentPages + 1) * SegmentPages;
+	if (page + num > segmentEnd)
+	{
+		FreePages(page, static_cast<uint32_t>(segmentEnd - page));
+		page = segmentEnd;
+	}
+	while (segments.Count() * SegmentPages < page + num || segments.Count() == 0)
+	{
+		uint64_t offset = segments.Count() * SegmentBytes;
+		DKObject<DKData> data = NULL;
+		if (file->SetLength(offset + SegmentBytes))
+			data = file->MapContentRange(offset, SegmentBytes);
+		if (data == NULL || !data->IsWritable())
+		{
+			DKLog("DKVoxel32FileStorage: Failed to map file segment.\n");
+			return 0;
+		}
+		data->LockShared();
+		segments.Add(data);
+	}
+	numPages = page + num;
+	return page;
+}
+
+void DKVoxel32FileStorage::FreePages(uint64_t page, uint32_t num)
+{
+	while (num > 0)
+	{
+		uint32_t n = Min(num, (uint32_t)MaxUnitPages);
+		auto p = freePages.Find(n);
+		if (p)
+			p->value.Add(page);
+		else
+			freePages.Insert(n, DKArray<uint64_t>(page, 1));
+		page += n;
+		num -= n;
+	}
+}
+
+DKVoxel32* DKVoxel32FileStorage::AllocateVoxels(void)
+{
+	size_t count = reusableVoxels.Count();
+	if (count > 0)
+	{
+		DKVoxel32* voxels = reusableVoxels.Value(count - 1);
+		reusableVoxels.Remove(count - 1);
+		return voxels;
+	}
+	return new DKVoxel32[UnitVoxels];
+}
+
+void DKVoxel32FileStorage::ReleaseVoxels(DKVoxel32* voxels)
+{
+	if (reusableVoxels.Count() < MaxReusableVoxels)
+		reusableVoxels.Add(voxels);
+	else
+		delete[] voxels;
+}
+
+DKVoxel32* DKVoxel32FileStorage::Create(const StorageId& sid)
+{
+	DKCriticalSection<DKCondition> guard(cond);
+	DKASSERT_DEBUG(units.Find(sid) == NULL);
+
+	Unit unit;
+	unit.state = UnitStateActive;
+	unit.voxels = AllocateVoxels();
+	unit.page = 0;
+	unit.pages = 0;
+	unit.bytes = 0;
+	unit.flags = 0;
+	unit.checksum = 0;
+	bool b = units.Insert(sid, unit);
+	DKASSERT_DEBUG(b);
+	(void)b;
+
+	numActiveUnits++;
+	stats.units++;
+	return unit.voxels;
+}
+
 void DKVoxel32FileStorage::Delete(const StorageId& sid)
 {
+	DKCriticalSection<DKCondition> guard(cond);
+	UnitMap::Pair* p = units.Find(sid);
+	while (p && p->value.state == UnitStateWriting)
+	{
+		cond.Wait();
+		p = units.Find(sid);
+	}
+	DKASSERT_DEBUG(p);
+	if (p)
+	{
+		Unit& unit = p->value;
+		if (unit.state == UnitStateActive)
+			numActiveUnits--;
+		else if (unit.state == UnitStatePending)
+			numPendingUnits--;		// queued sid will be skipped.
+		if (unit.voxels)
+			ReleaseVoxels(unit.voxels);
+		if (unit.pages > 0)
+		{
+			FreePages(unit.page, unit.pages);
+			WriteHeader(false);
+		}
+		units.Remove(sid);
+		stats.units--;
+		cond.Broadcast();
+	}
 }
 
 DKVoxel32* DKVoxel32FileStorage::Load(const StorageId& sid)
 {
-	return NULL;
+	DKCriticalSection<DKCondition> guard(cond);
+	UnitMap::Pair* p = units.Find(sid);
+	while (p && p->value.state == UnitStateWriting)
+	{
+		cond.Wait();
+		p = units.Find(sid);
+	}
+	DKASSERT_DEBUG(p);
+	if (p == NULL)
+		return NULL;
+
+	Unit& unit = p->value;
+	DKASSERT_DEBUG(unit.state != UnitStateActive);
+	if (unit.voxels)
+	{
+		// reclaim unit before written. (queued sid will be skipped)
+		if (unit.state == UnitStatePending)
+			numPendingUnits--;
+		unit.state = UnitStateActive;
+		numActiveUnits++;
+		stats.reclaims++;
+		cond.Broadcast();
+		return unit.voxels;
+	}
+
+	DKASSERT_DEBUG(unit.state == UnitStateStored);
+	DKASSERT_DEBUG(unit.voxels == NULL);
+	DKVoxel32* voxels = AllocateVoxels();
+	const unsigned char* src = PageAddress(unit.page);
+	const uint32_t bytes = unit.bytes;
+	const bool compressed = (unit.flags & UnitFlagCompressed) != 0;
+	unit.state = UnitStateActive;
+	unit.voxels = voxels;
+	numActiveUnits++;
+	stats.loads++;
+	stats.bytesRead += bytes;
+
+	// unit can be touched by caller only, read without lock.
+	cond.Unlock();
+	bool succeeded = false;
+	if (compressed)
+	{
+		uLongf len = UnitBytes;
+		succeeded = uncompress(reinterpret_cast<Bytef*>(voxels), &len, src, bytes) == Z_OK && len == UnitBytes;
+	}
+	else if (bytes == UnitBytes)
+	{
+		memcpy(voxels, src, UnitBytes);
+		succeeded = true;
+	}
+	if (!succeeded)
+	{
+		DKLog("DKVoxel32FileStorage: Failed to read unit (%ls).\n", (const wchar_t*)sid.String());
+		memset(voxels, 0, UnitBytes);
+	}
+	cond.Lock();
+	return voxels;
 }
 
 void DKVoxel32FileStorage::Unload(const StorageId& sid)
 {
-}
\ No newline at end of file
+	DKCriticalSection<DKCondition> guard(cond);
+	UnitMap::Pair* p = units.Find(sid);
+	DKASSERT_DEBUG(p);
+	if (p == NULL)
+		return;
+
+	Unit& unit = p->value;
+	DKASSERT_DEBUG(unit.state == UnitStateActive);
+	DKASSERT_DEBUG(unit.voxels);
+
+	numActiveUnits--;
+	uint32_t checksum = Checksum(unit.voxels);
+	if (unit.pages > 0 && unit.checksum == checksum)
+	{
+		// not modified.
+		unit.state = UnitStateStored;
+		ReleaseVoxels(unit.voxels);
+		unit.voxels = NULL;
+		stats.skippedWrites++;
+		return;
+	}
+	unit.state = UnitStatePending;
+	unit.checksum = checksum;
+	pendingQueue.PushBack(sid);
+	numPendingUnits++;
+	cond.Broadcast();
+
+	// limit memory usage, wait for write-back.
+	while (numPendingUnits > maxPendingUnits && writeBackThread)
+		cond.Wait();
+}
+
+bool DKVoxel32FileStorage::Contains(const StorageId& sid) const
+{
+	DKCriticalSection<DKCondition> guard(cond);
+	return units.Find(sid) != NULL;
+}
+
+void DKVoxel32FileStorage::Synchronize(void)
+{
+	DKCriticalSection<DKCondition> guard(cond);
+	while (numPendingUnits > 0 && writeBackThread)
+		cond.Wait();
+	WriteDirectory();
+}
+
+DKVoxel32FileStorage::Statistics DKVoxel32FileStorage::GetStatistics(void) const
+{
+	DKCriticalSection<DKCondition> guard(cond);
+	Statistics st = stats;
+	st.units = units.Count();
+	st.activeUnits = numActiveUnits;
+	st.pendingUnits = numPendingUnits;
+	st.fileLength = file ? file->TotalLength() : 0;
+	return st;
+}
+
+void DKVoxel32FileStorage::WriteBackThreadProc(void)
+{
+	const int level = compression == CompressionFast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+	DKArray<unsigned char> buffer;
+	buffer.Resize(compressBound(UnitBytes));
+
+	DKCriticalSection<DKCondition> guard(cond);
+	while (true)
+	{
+		StorageId sid;
+		if (!pendingQueue.PopFront(sid))
+		{
+			if (terminate)
+				break;
+			cond.Wait();
+			continue;
+		}
+		UnitMap::Pair* p = units.Find(sid);
+		if (p == NULL || p->value.state != UnitStatePending)
+			continue;		// deleted or reclaimed.
+
+		Unit& unit = p->value;		// unit cannot be removed while writing.
+		unit.state = UnitStateWriting;
+		const DKVoxel32* voxels = unit.voxels;
+
+		cond.Unlock();
+		const unsigned char* data = reinterpret_cast<const unsigned char*>(voxels);
+		uLongf bytes = UnitBytes;
+		uint32_t flags = 0;
+		if (compression != CompressionNone)
+		{
+			uLongf len = buffer.Count();
+			// store uncompressed if it does not save any page.
+			if (compress2((Bytef*)buffer, &len, data, UnitBytes, level) == Z_OK && len <= UnitBytes - PageSize)
+			{
+				data = buffer;
+				bytes = len;
+				flags |= UnitFlagCompressed;
+			}
+		}
+		cond.Lock();
+
+		WriteHeader(false);
+		uint32_t pages = static_cast<uint32_t>((bytes + PageSize - 1) / PageSize);
+		if (unit.pages != pages)
+		{
+			if (unit.pages > 0)
+				FreePages(unit.page, unit.pages);
+			unit.page = AllocatePages(pages);
+			unit.pages = unit.page ? pages : 0;
+		}
+		unit.state = UnitStateStored;
+		if (unit.pages > 0)
+		{
+			unsigned char* dst = PageAddress(unit.page);
+
+			cond.Unlock();
+			memcpy(dst, data, bytes);
+			cond.Lock();
+
+			unit.bytes = static_cast<uint32_t>(bytes);
+			unit.flags = flags;
+			stats.writes++;
+			stats.bytesWritten += bytes;
+			unit.voxels = NULL;
+			ReleaseVoxels(const_cast<DKVoxel32*>(voxels));
+		}
+		else
+		{
+			// keep voxels in memory, unit can be loaded again.
+			DKLog("DKVoxel32FileStorage: Failed to write unit (%ls).\n", (const wchar_t*)sid.String());
+		}
+		numPendingUnits--;
+		cond.Broadcast();
+	}
+}
@@ -14,19 +14,59 @@
 // DKVoxel32FileStorage
 // a 32bit voxel storage, it store data into file.
 //
-// THIS CLASS NOT IMPLEMENTED YET.
-// Use DKVoxel32SparseVolume instead.
+// Every unit (16x16x16 voxels) is stored in one paged file, file is grown by
+// segments and each segment is mapped into memory. (see DKFile::MapContentRange)
+// Units can be compressed individually with zlib.
+//
+// Only MaxActiveUnits() units are kept in memory. Unloaded units are queued
+// and written back by worker thread asynchronously, unit which has not been
+// modified since loaded will not be written again.
+// Unit being written back can be loaded again without reading file.
+//
+// Storage created with file path can be opened again, units are stored with
+// StorageId. Storage created without path uses temporary file.
+//
+// Note:
+//   This class is thread-safe. Load, Unload for same StorageId should be
+//   serialized by caller. (DKVoxel32SparseVolume does)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFramework
 {
-	// NOT IMPLEMENTED. (Use DKVoxel32SparseVolume)
 	class DKGL_API DKVoxel32FileStorage : public DKVoxel32Storage
 	{
 	public:
-		DKVoxel32FileStorage(void);
+		enum Compression
+		{
+			CompressionNone = 0,
+			CompressionFast,		// zlib best speed
+			CompressionDefault,		// zlib default level
+		};
+		enum {UnitVoxels = 16 * 16 * 16};
+		enum {UnitBytes = UnitVoxels * sizeof(DKVoxel32)};
+		enum {DefaultMaxActiveUnits = 4096};		// 64MB
+
+		struct Statistics
+		{
+			size_t units;				// number of units in storage
+			size_t activeUnits;			// loaded units
+			size_t pendingUnits;		// units waiting for write-back
+			size_t loads;				// units read from file
+			size_t reclaims;			// units reloaded before write-back
+			size_t writes;				// units written to file
+			size_t skippedWrites;		// unloaded units which is not modified
+			unsigned long long bytesRead;
+			unsigned long long bytesWritten;
+			unsigned long long fileLength;
+		};
+
+		// create storage with temporary file.
+		DKVoxel32FileStorage(size_t maxActiveUnits = DefaultMaxActiveUnits, Compression c = CompressionFast);
 		~DKVoxel32FileStorage(void);
 
+		// open storage file. create new file if file not exists or overwrite is true.
+		static DKFoundation::DKObject<DKVoxel32FileStorage> Open(const DKFoundation::DKString& file, bool overwrite, size_t maxActiveUnits = DefaultMaxActiveUnits, Compression c = CompressionFast);
+
 		DKVoxel32* Create(const StorageId&);
 		void Delete(const StorageId&);
 		DKVoxel32* Load(const StorageId&);
@@ -34,7 +74,69 @@ namespace DKFramework
 
 		size_t MaxActiveUnits(void) const {return maxLoadableUnits;}
 
+		bool Contains(const StorageId&) const;
+		Compression CompressionType(void) const	{return compression;}
+
+		// wait for write-back, and write directory to file.
+		// storage file can be opened again after synchronized.
+		void Synchronize(void);
+
+		Statistics GetStatistics(void) const;
+
 	protected:
 		size_t maxLoadableUnits;
+
+	private:
+		enum UnitState
+		{
+			UnitStateStored = 0,	// stored in file
+			UnitStateActive,		// loaded
+			UnitStatePending,		// unloaded, waiting for write-back
+			UnitStateWriting,		// writing by worker thread
+		};
+		struct Unit
+		{
+			UnitState state;
+			DKVoxel32* voxels;		// loaded or pending voxels
+			uint64_t page;			// first page of stored data
+			uint32_t pages;			// number of pages allocated
+			uint32_t bytes;			// stored bytes (compressed)
+			uint32_t flags;
+			uint32_t checksum;		// checksum of voxels when loaded or stored
+		};
+		typedef DKFoundation::DKMap<StorageId, Unit> UnitMap;
+
+		bool InitFile(DKFoundation::DKFile* file, bool readDirectory);
+		bool ReadDirectory(void);
+		void WriteDirectory(void);
+		void WriteHeader(bool clean);
+		unsigned char* PageAddress(uint64_t page);
+		uint64_t AllocatePages(uint32_t num);
+		void FreePages(uint64_t page, uint32_t num);
+		DKVoxel32* AllocateVoxels(void);
+		void ReleaseVoxels(DKVoxel32*);
+		void WriteBackThreadProc(void);
+
+		DKFoundation::DKObject<DKFoundation::DKFile> file;
+		DKFoundation::DKArray<DKFoundation::DKObject<DKFoundation::DKData>> segments;	// mapped segments
+		DKFoundation::DKMap<uint32_t, DKFoundation::DKArray<uint64_t>> freePages;		// pages, first-page
+		uint64_t numPages;				// used pages
+		bool clean;						// file is synchronized.
+
+		UnitMap units;
+		DKFoundation::DKQueue<StorageId> pendingQueue;
+		DKFoundation::DKArray<DKVoxel32*> reusableVoxels;
+		size_t maxPendingUnits;
+		size_t numActiveUnits;
+		size_t numPendingUnits;
+		Compression compression;
+		Statistics stats;
+
+		DKFoundation::DKCondition cond;	// lock for storage
+		DKFoundation::DKObject<DKFoundation::DKThread> writeBackThread;
+		bool terminate;
+
+		DKVoxel32FileStorage(const DKVoxel32FileStorage&);
+		DKVoxel32FileStorage& operator = (const DKVoxel32FileStorage&);
 	};
 }
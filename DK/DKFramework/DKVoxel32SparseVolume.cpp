@@ -145,7 +145,7 @@ DKVoxel32SparseVolume::~DKVoxel32SparseVolume(void)
 			if (b.voxels)
 			{
 				storage->Unload(b.storageId);
-				blocksLoaded--;
+				blocksLoaded.Decrement();
 			}
 		}
 	}
@@ -191,6 +191,58 @@ const DKVoxel32SparseVolume::Storage* DKVoxel32SparseVolume::VolumeStorage(void)
 	return storage;
 }
 
+DKVoxel32* DKVoxel32SparseVolume::LoadBlockVoxels(VolumetricBlock& block)
+{
+	DKASSERT_DEBUG(!block.storageId.IsZero());
+	if (block.voxels == NULL)
+	{
+		size_t maxLoadable = Max<size_t>(storage->MaxActiveUnits(), 1);
+		size_t loaded = static_cast<size_t>(blocksLoaded);
+		if (loaded >= maxLoadable)
+			UnloadOldBlocks(loaded - maxLoadable + 1);
+
+		block.voxels = storage->Load(block.storageId);
+		blocksLoaded.Increment();
+	}
+	DKASSERT_DEBUG(block.voxels);
+	block.ts = DKTimer::SystemTick();
+	return block.voxels;
+}
+
+DKVoxel32* DKVoxel32SparseVolume::ExpandSolidBlock(VolumetricBlock& block)
+{
+	DKASSERT_DEBUG(block.storageId.IsZero());
+	size_t maxLoadable = Max<size_t>(storage->MaxActiveUnits(), 1);
+	size_t loaded = static_cast<size_t>(blocksLoaded);
+	if (loaded >= maxLoadable)
+		UnloadOldBlocks(loaded - maxLoadable + 1);
+
+	DKVoxel32 solid = block.solid;
+	block.storageId = DKUuid::Create();
+	block.voxels = storage->Create(block.storageId);
+	DKASSERT_DEBUG(block.voxels);
+	for (size_t i = 0; i < UnitDimensions; ++i)
+	{
+		block.voxels[i] = solid;
+	}
+	block.ts = DKTimer::SystemTick();
+	blocksLoaded.Increment();
+	return block.voxels;
+}
+
+void DKVoxel32SparseVolume::SetSolidBlock(VolumetricBlock& block, const DKVoxel32& v)
+{
+	if (!block.storageId.IsZero())
+	{
+		if (block.voxels)
+			blocksLoaded.Decrement();
+		storage->Delete(block.storageId);
+		block.storageId.SetZero();
+		block.ts = 0;
+	}
+	block.solid = v;
+}
+
 bool DKVoxel32SparseVolume::GetVoxelAtLocation(unsigned int x, unsigned int y, unsigned int z, DKVoxel32& v)
 {
 	DKSharedLockReadOnlySection guard(volumeLock);
@@ -214,19 +266,8 @@ bool DKVoxel32SparseVolume::GetVoxelAtLocation(unsigned int x, unsigned int y, u
 		}
 		else
 		{
-			if (block.voxels == NULL)
-			{
-				size_t maxLoadable = Max<size_t>(storage->MaxActiveUnits(), 1);
-
-				if (blocksLoaded >= maxLoadable)
-					UnloadOldBlocks(maxLoadable - blocksLoaded + 1);
-
-				block.voxels = storage->Load(block.storageId);
-				blocksLoaded++;
-			}
 			size_t idx2 = LocationIndex<size_t>(x % UnitSize, y % UnitSize, z % UnitSize, UnitSize, UnitSize, UnitSize);
-			v = block.voxels[idx2];
-			block.ts = DKTimer::SystemTick();
+			v = LoadBlockVoxels(block)[idx2];
 		}
 		return true;
 	}
@@ -248,9 +289,6 @@ bool DKVoxel32SparseVolume::SetVoxelAtLocation(unsigned int x, unsigned int y, u
 
 		size_t idx = LocationIndex<size_t>(bx, by, bz, w, h, d);
 		size_t idx2 = LocationIndex<size_t>(x % UnitSize, y % UnitSize, z % UnitSize, UnitSize, UnitSize, UnitSize);
-		const size_t numVoxels = UnitSize * UnitSize * UnitSize;
-
-		size_t maxLoadable = Max<size_t>(storage->MaxActiveUnits(), 1);
 
 		VolumetricBlock& block = volumeBlocks[idx];
 
@@ -258,41 +296,205 @@ bool DKVoxel32SparseVolume::SetVoxelAtLocation(unsigned int x, unsigned int y, u
 		if (block.storageId.IsZero())
 		{
 			if (block.solid.uintValue != v.uintValue)
+				ExpandSolidBlock(block)[idx2] = v;
+		}
+		else
+		{
+			LoadBlockVoxels(block)[idx2] = v;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool DKVoxel32SparseVolume::IsRegionValid(unsigned int x, unsigned int y, unsigned int z, size_t w, size_t h, size_t d) const
+{
+	return x <= width && w <= width - x &&
+		y <= height && h <= height - y &&
+		z <= depth && d <= depth - z;
+}
+
+bool DKVoxel32SparseVolume::ReadRegion(unsigned int x, unsigned int y, unsigned int z,
+									   size_t rw, size_t rh, size_t rd,
+									   DKVoxel32* voxels, size_t rowStride, size_t sliceStride)
+{
+	if (rowStride == 0)
+		rowStride = rw;
+	if (sliceStride == 0)
+		sliceStride = rowStride * rh;
+
+	DKASSERT_DEBUG(voxels || rw * rh * rd == 0);
+	DKASSERT_DEBUG(rowStride >= rw && sliceStride >= rowStride * rh);
+
+	auto read = [=](Block& b)->bool
+	{
+		// intersection in volume coordinates
+		size_t x0 = Max<size_t>(x, b.x), x1 = Min<size_t>(x + rw, b.x + b.width);
+		size_t y0 = Max<size_t>(y, b.y), y1 = Min<size_t>(y + rh, b.y + b.height);
+		size_t z0 = Max<size_t>(z, b.z), z1 = Min<size_t>(z + rd, b.z + b.depth);
+		size_t run = x1 - x0;
+		for (size_t vz = z0; vz < z1; ++vz)
+		{
+			for (size_t vy = y0; vy < y1; ++vy)
 			{
-				if (blocksLoaded >= maxLoadable)
-					UnloadOldBlocks(maxLoadable - blocksLoaded + 1);
-
-				DKVoxel32 solid = block.solid;
-				block.storageId = DKUuid::Create();
-				block.voxels = storage->Create(block.storageId);
-				DKASSERT_DEBUG(block.voxels);
-				for (size_t i = 0; i < numVoxels; ++i)
+				DKVoxel32* dst = &voxels[(vz - z) * sliceStride + (vy - y) * rowStride + (x0 - x)];
+				if (b.voxels)
 				{
-					block.voxels[i] = solid;
+					size_t idx = LocationIndex<size_t>(x0 - b.x, vy - b.y, vz - b.z, UnitSize, UnitSize, UnitSize);
+					memcpy(dst, &b.voxels[idx], sizeof(DKVoxel32) * run);
+				}
+				else
+				{
+					for (size_t i = 0; i < run; ++i)
+						dst[i] = b.solid;
 				}
-				block.voxels[idx2] = v;
-				block.ts = DKTimer::SystemTick();
-				blocksLoaded++;
 			}
 		}
-		else
+		return true;
+	};
+	return ForEachBlock(x, y, z, rw, rh, rd, DKFunction(read), false);
+}
+
+bool DKVoxel32SparseVolume::WriteRegion(unsigned int x, unsigned int y, unsigned int z,
+										size_t rw, size_t rh, size_t rd,
+										const DKVoxel32* voxels, size_t rowStride, size_t sliceStride)
+{
+	if (rowStride == 0)
+		rowStride = rw;
+	if (sliceStride == 0)
+		sliceStride = rowStride * rh;
+
+	DKSharedLockReadOnlySection guard(volumeLock);
+	if (!IsRegionValid(x, y, z, rw, rh, rd))
+		return false;
+	if (rw == 0 || rh == 0 || rd == 0)
+		return true;
+
+	DKASSERT_DEBUG(voxels);
+	DKASSERT_DEBUG(rowStride >= rw && sliceStride >= rowStride * rh);
+
+	size_t w = VolumeSizeDiv<size_t>(width, UnitSize);
+	size_t h = VolumeSizeDiv<size_t>(height, UnitSize);
+	size_t d = VolumeSizeDiv<size_t>(depth, UnitSize);
+
+	for (size_t bz = z / UnitSize; bz <= (z + rd - 1) / UnitSize; ++bz)
+	{
+		for (size_t by = y / UnitSize; by <= (y + rh - 1) / UnitSize; ++by)
 		{
-			if (block.voxels == NULL)
+			for (size_t bx = x / UnitSize; bx <= (x + rw - 1) / UnitSize; ++bx)
 			{
-				if (blocksLoaded >= maxLoadable)
-					UnloadOldBlocks(maxLoadable - blocksLoaded + 1);
+				// block range, intersection in volume coordinates
+				size_t bx0 = bx * UnitSize, bx1 = Min<size_t>(bx0 + UnitSize, width);
+				size_t by0 = by * UnitSize, by1 = Min<size_t>(by0 + UnitSize, height);
+				size_t bz0 = bz * UnitSize, bz1 = Min<size_t>(bz0 + UnitSize, depth);
+				size_t x0 = Max<size_t>(x, bx0), x1 = Min<size_t>(x + rw, bx1);
+				size_t y0 = Max<size_t>(y, by0), y1 = Min<size_t>(y + rh, by1);
+				size_t z0 = Max<size_t>(z, bz0), z1 = Min<size_t>(z + rd, bz1);
+				size_t run = x1 - x0;
+
+				auto source = [&](size_t vx, size_t vy, size_t vz)->const DKVoxel32*
+				{
+					return &voxels[(vz - z) * sliceStride + (vy - y) * rowStride + (vx - x)];
+				};
+				// check source values are uniform.
+				const DKVoxel32 first = *source(x0, y0, z0);
+				bool uniform = true;
+				for (size_t vz = z0; vz < z1 && uniform; ++vz)
+				{
+					for (size_t vy = y0; vy < y1 && uniform; ++vy)
+					{
+						const DKVoxel32* src = source(x0, vy, vz);
+						for (size_t i = 0; i < run; ++i)
+						{
+							if (src[i].uintValue != first.uintValue)
+							{
+								uniform = false;
+								break;
+							}
+						}
+					}
+				}
+				bool entireBlock = x0 == bx0 && x1 == bx1 && y0 == by0 && y1 == by1 && z0 == bz0 && z1 == bz1;
 
-				block.voxels = storage->Load(block.storageId);
-				blocksLoaded++;
-			}
-			DKASSERT_DEBUG(block.voxels);
+				VolumetricBlock& block = volumeBlocks[LocationIndex<size_t>(bx, by, bz, w, h, d)];
+				DKCriticalSection<DKSpinLock> blockGuard(block.lock);
+
+				if (uniform && entireBlock)
+				{
+					SetSolidBlock(block, first);
+					continue;
+				}
+				if (uniform && block.storageId.IsZero() && block.solid.uintValue == first.uintValue)
+					continue;
 
-			block.voxels[idx2] = v;
-			block.ts = DKTimer::SystemTick();
+				DKVoxel32* dst = block.storageId.IsZero() ? ExpandSolidBlock(block) : LoadBlockVoxels(block);
+				for (size_t vz = z0; vz < z1; ++vz)
+				{
+					for (size_t vy = y0; vy < y1; ++vy)
+					{
+						size_t idx = LocationIndex<size_t>(x0 - bx0, vy - by0, vz - bz0, UnitSize, UnitSize, UnitSize);
+						memcpy(&dst[idx], source(x0, vy, vz), sizeof(DKVoxel32) * run);
+					}
+				}
+			}
 		}
+	}
+	return true;
+}
+
+bool DKVoxel32SparseVolume::ForEachBlock(BlockEnumerator* e, bool expandSolid)
+{
+	size_t w, h, d;
+	GetDimensions(&w, &h, &d);
+	return ForEachBlock(0, 0, 0, w, h, d, e, expandSolid);
+}
+
+bool DKVoxel32SparseVolume::ForEachBlock(unsigned int x, unsigned int y, unsigned int z,
+										 size_t rw, size_t rh, size_t rd,
+										 BlockEnumerator* e, bool expandSolid)
+{
+	DKSharedLockReadOnlySection guard(volumeLock);
+	if (!IsRegionValid(x, y, z, rw, rh, rd))
+		return false;
+	if (rw == 0 || rh == 0 || rd == 0 || e == NULL)
 		return true;
+
+	size_t w = VolumeSizeDiv<size_t>(width, UnitSize);
+	size_t h = VolumeSizeDiv<size_t>(height, UnitSize);
+	size_t d = VolumeSizeDiv<size_t>(depth, UnitSize);
+
+	for (size_t bz = z / UnitSize; bz <= (z + rd - 1) / UnitSize; ++bz)
+	{
+		for (size_t by = y / UnitSize; by <= (y + rh - 1) / UnitSize; ++by)
+		{
+			for (size_t bx = x / UnitSize; bx <= (x + rw - 1) / UnitSize; ++bx)
+			{
+				VolumetricBlock& block = volumeBlocks[LocationIndex<size_t>(bx, by, bz, w, h, d)];
+				DKCriticalSection<DKSpinLock> blockGuard(block.lock);
+
+				Block b;
+				b.x = static_cast<unsigned int>(bx * UnitSize);
+				b.y = static_cast<unsigned int>(by * UnitSize);
+				b.z = static_cast<unsigned int>(bz * UnitSize);
+				b.width = Min<size_t>(UnitSize, width - b.x);
+				b.height = Min<size_t>(UnitSize, height - b.y);
+				b.depth = Min<size_t>(UnitSize, depth - b.z);
+				if (block.storageId.IsZero())
+					b.voxels = expandSolid ? ExpandSolidBlock(block) : NULL;
+				else
+					b.voxels = LoadBlockVoxels(block);
+				b.solid = block.solid;
+
+				bool next = e->Invoke(b);
+
+				if (b.voxels == NULL && b.solid.uintValue != block.solid.uintValue)
+					block.solid = b.solid;
+				if (!next)
+					return true;
+			}
+		}
 	}
-	return false;
+	return true;
 }
 
 void DKVoxel32SparseVolume::GetDimensions(size_t* w, size_t* h, size_t* d)
@@ -358,7 +560,7 @@ bool DKVoxel32SparseVolume::SetDimensions(size_t w, size_t h, size_t d)
 				if (b.storageId.IsZero()) continue;
 				if (b.voxels)
 				{
-					blocksLoaded--;
+					blocksLoaded.Decrement();
 				}
 				storage->Delete(b.storageId);
 			}
@@ -373,7 +575,7 @@ bool DKVoxel32SparseVolume::SetDimensions(size_t w, size_t h, size_t d)
 				if (b.storageId.IsZero()) continue;
 				if (b.voxels)
 				{
-					blocksLoaded--;
+					blocksLoaded.Decrement();
 				}
 				storage->Delete(b.storageId);
 			}
@@ -463,33 +665,37 @@ void DKVoxel32SparseVolume::UnloadOldBlocks(size_t num)
 	{
 		if (numBlocks > num)	// sort ascending by timestamp
 		{
-			typedef VolumetricBlock* Value;
-			auto sortByTSDesc = [](VolumetricBlock* const & lhs, VolumetricBlock* const & rhs)->bool
-			{
-				return lhs->ts > rhs->ts;
-			};
-
-			DKOrderedArray<VolumetricBlock*> blocks(sortByTSDesc);
-			blocks.Reserve(numBlocks);
+			// blocks locked by other threads (or caller) are skipped.
+			DKArray<VolumetricBlock*> blocks;
+			blocks.Reserve(Min(numBlocks, static_cast<size_t>(blocksLoaded)));
 			for (size_t i = 0; i < numBlocks; ++i)
 			{
 				VolumetricBlock& b = this->volumeBlocks[i];
-				DKCriticalSection<DKSpinLock> blockGuard(b.lock);
-				if (b.storageId.IsZero())
+				if (!b.lock.TryLock())
 					continue;
-				if (b.voxels)
-					blocks.Insert(&b);
+				if (!b.storageId.IsZero() && b.voxels)
+					blocks.Add(&b);
+				b.lock.Unlock();
 			}
+			// sort ascending by timestamp, unload least recently used blocks.
+			blocks.Sort([](VolumetricBlock* const & lhs, VolumetricBlock* const & rhs)->bool
+			{
+				return lhs->ts < rhs->ts;
+			});
 
 			size_t n = Min(num, blocks.Count());
 			for (size_t i = 0; i < n; ++i)
 			{
 				VolumetricBlock* p = blocks.Value(i);
-				DKCriticalSection<DKSpinLock> blockGuard(p->lock);
-				DKASSERT_DEBUG(p->voxels);
-				storage->Unload(p->storageId);
-				p->voxels = NULL;
-				blocksLoaded--;
+				if (!p->lock.TryLock())
+					continue;
+				if (!p->storageId.IsZero() && p->voxels)
+				{
+					storage->Unload(p->storageId);
+					p->voxels = NULL;
+					blocksLoaded.Decrement();
+				}
+				p->lock.Unlock();
 			}
 		}
 		else		// volumeBlocks is smaller, unload all
@@ -497,15 +703,15 @@ void DKVoxel32SparseVolume::UnloadOldBlocks(size_t num)
 			for (size_t i = 0; i < numBlocks; ++i)
 			{
 				VolumetricBlock& b = this->volumeBlocks[i];
-				DKCriticalSection<DKSpinLock> blockGuard(b.lock);
-				if (b.storageId.IsZero())
+				if (!b.lock.TryLock())
 					continue;
-				if (b.voxels)
+				if (!b.storageId.IsZero() && b.voxels)
 				{
 					storage->Unload(b.storageId);
 					b.voxels = NULL;
-					blocksLoaded--;
+					blocksLoaded.Decrement();
 				}
+				b.lock.Unlock();
 			}
 		}
 	}
@@ -18,8 +18,15 @@
 // You need to provide storage object, which can be file or memory that can
 // store voxel data. (see DKVoel32Storage.h)
 //
+// Region functions (ReadRegion, WriteRegion, ForEachBlock) lock each block
+// once and copy voxels by rows. Solid block (block has single value, without
+// storage) is filled by reading, and it will not be allocated by writing
+// if written values are same. Writing single value to entire block makes
+// block to solid.
+//
 // Note:
 //   If you want to polygonize voxels, see DKVoxelPolygonizer.h
+//   DKVoxelMesher polygonizes entire volume with chunks. (DKVoxelMesher.h)
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace DKFramework
@@ -44,6 +51,34 @@ namespace DKFramework
 		void GetDimensions(size_t* width, size_t* height, size_t* depth);
 		bool SetDimensions(size_t width, size_t height, size_t depth);
 
+		// read, write voxels of region. returns false if region is out of volume.
+		// voxels are packed by x, y, z order. stride unit is voxel,
+		// zero for tightly packed. (rowStride = width, sliceStride = rowStride * height)
+		bool ReadRegion(unsigned int x, unsigned int y, unsigned int z,
+						size_t width, size_t height, size_t depth,
+						DKVoxel32* voxels, size_t rowStride = 0, size_t sliceStride = 0);
+		bool WriteRegion(unsigned int x, unsigned int y, unsigned int z,
+						 size_t width, size_t height, size_t depth,
+						 const DKVoxel32* voxels, size_t rowStride = 0, size_t sliceStride = 0);
+
+		struct Block
+		{
+			unsigned int x, y, z;			// location of first voxel
+			size_t width, height, depth;	// valid size of block (can be smaller at edge of volume)
+			DKVoxel32* voxels;				// UnitSize^3 voxels (x, y, z order), NULL for solid block
+			DKVoxel32 solid;				// value of solid block, can be modified by enumerator.
+		};
+		// enumerator returns false to stop enumeration.
+		using BlockEnumerator = DKFoundation::DKFunctionSignature<bool (Block&)>;
+
+		// enumerate blocks which intersect with region. block is locked while enumerator invoked.
+		// if expandSolid is true, solid block will be allocated and voxels are provided.
+		// returns false if region is out of volume.
+		bool ForEachBlock(unsigned int x, unsigned int y, unsigned int z,
+						  size_t width, size_t height, size_t depth,
+						  BlockEnumerator* e, bool expandSolid = false);
+		bool ForEachBlock(BlockEnumerator* e, bool expandSolid = false);
+
 		bool ResetContents(void);
 
 		Storage* VolumeStorage(void);
@@ -68,7 +103,7 @@ namespace DKFramework
 		size_t height;
 		size_t depth;
 
-		size_t blocksLoaded;				// number of blocks loaded.
+		DKFoundation::DKAtomicNumber32 blocksLoaded;	// number of blocks loaded.
 		VolumetricBlock* volumeBlocks;		// all blocks
 
 		DKFoundation::DKObject<Storage> storage;
@@ -76,5 +111,12 @@ namespace DKFramework
 		TimeStamp lastCompactedTS;
 
 		void UnloadOldBlocks(size_t);
+
+		// following functions should be called with block locked.
+		DKVoxel32* LoadBlockVoxels(VolumetricBlock&);	// load voxels of non-solid block
+		DKVoxel32* ExpandSolidBlock(VolumetricBlock&);	// make solid block to non-solid
+		void SetSolidBlock(VolumetricBlock&, const DKVoxel32&);
+
+		bool IsRegionValid(unsigned int x, unsigned int y, unsigned int z, size_t w, size_t h, size_t d) const;
 	};
 }
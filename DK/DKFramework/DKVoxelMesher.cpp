@@ -0,0 +1,436 @@
+﻿//
+//  File: DKVoxelMesher.cpp
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2009-2014 Hongtae Kim. All rights reserved.
+//
+
+#include "DKMath.h"
+#include "DKVoxelMesher.h"
+#include "DKVoxelIsosurfacePolygonizer.h"
+#include "DKVoxel32SparseVolume.h"
+
+using namespace DKFoundation;
+using namespace DKFramework;
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		namespace VoxelMesher
+		{
+			typedef DKVoxelMesher::Index Index;
+
+			// voxel offset of each cube corners. (DKVoxelPolygonizer::CubeIndex)
+			static const unsigned int cornerOffsets[8][3] =
+			{
+				{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1},
+				{0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1},
+			};
+
+			// voxel levels of chunk, with one voxel padding for gradient.
+			// levels are clamped at edge of volume.
+			struct LevelField
+			{
+				DKArray<float> levels;
+				size_t width, height, depth;	// number of voxels, including padding.
+
+				// i, j, k: -1 ~ (number of cubes + 1)
+				float Level(int i, int j, int k) const
+				{
+					return levels.Value(((k + 1) * height + (j + 1)) * width + (i + 1));
+				}
+				DKVector3 Gradient(int i, int j, int k) const
+				{
+					return DKVector3(Level(i+1, j, k) - Level(i-1, j, k),
+									 Level(i, j+1, k) - Level(i, j-1, k),
+									 Level(i, j, k+1) - Level(i, j, k-1)) * 0.5f;
+				}
+			};
+
+			// polygonize cubes of chunk, triangles are generated by
+			// DKVoxelIsosurfacePolygonizer and vertices are shared with edge cache.
+			class ChunkPolygonizer : public DKVoxelIsosurfacePolygonizer
+			{
+			public:
+				enum : Index {InvalidIndex = ~Index(0)};
+
+				ChunkPolygonizer(const LevelField& f, const DKVoxelMesher::Chunk& c, float iso)
+					: field(f), chunk(c)
+				{
+					this->isoLevel = iso;
+					edgeCache.Add(InvalidIndex, (chunk.width + 1) * (chunk.height + 1) * (chunk.depth + 1) * 3);
+				}
+
+				void Polygonize(void)
+				{
+					Cube cube;
+					const int width = static_cast<int>(chunk.width);
+					const int height = static_cast<int>(chunk.height);
+					const int depth = static_cast<int>(chunk.depth);
+					for (cz = 0; cz < depth; ++cz)
+					{
+						for (cy = 0; cy < height; ++cy)
+						{
+							for (cx = 0; cx < width; ++cx)
+							{
+								int cubeIndex = 0;
+								for (int i = 0; i < 8; ++i)
+								{
+									const unsigned int* o = cornerOffsets[i];
+									cube.levels[i] = field.Level(cx + o[0], cy + o[1], cz + o[2]);
+									if (cube.levels[i] < isoLevel)
+										cubeIndex |= (1 << i);
+								}
+								// cube is empty or full.
+								if (cubeIndex == 0 || cubeIndex == 0xff)
+									continue;
+
+								PolygonizeSurface(cube);
+							}
+						}
+					}
+				}
+
+				DKArray<DKVoxelMesher::Vertex> vertices;
+				DKArray<Index> indices;
+
+			protected:
+				void GenerateTriangle(Vertex& v1, Vertex& v2, Vertex& v3) override
+				{
+					Index i1 = EdgeVertex(v1.idx1, v1.idx2);
+					Index i2 = EdgeVertex(v2.idx1, v2.idx2);
+					Index i3 = EdgeVertex(v3.idx1, v3.idx2);
+					if (i1 == i2 || i2 == i3 || i3 == i1)	// degenerated
+						return;
+					Index tri[3] = {i1, i2, i3};
+					indices.Add(tri, 3);
+				}
+				DKVector3 Interpolate(const DKVector3& p1, const DKVector3&, CubeIndex, CubeIndex) override
+				{
+					// vertex position is calculated by EdgeVertex, with edge cache.
+					return p1;
+				}
+
+			private:
+				// find or create vertex on cube edge (c1-c2)
+				Index EdgeVertex(CubeIndex c1, CubeIndex c2)
+				{
+					const unsigned int* o1 = cornerOffsets[c1];
+					const unsigned int* o2 = cornerOffsets[c2];
+					int axis = (o1[0] != o2[0]) ? 0 : ((o1[1] != o2[1]) ? 1 : 2);
+					// edge is owned by lower corner, interpolated from lower to upper
+					// corner always, to make same position on edge of adjacent chunks.
+					const unsigned int* o = (o1[axis] < o2[axis]) ? o1 : o2;
+					int x = cx + o[0];
+					int y = cy + o[1];
+					int z = cz + o[2];
+
+					size_t key = (((z * (chunk.height + 1)) + y) * (chunk.width + 1) + x) * 3 + axis;
+					Index& index = edgeCache.Value(key);
+					if (index == InvalidIndex)
+					{
+						int x2 = x + (axis == 0);
+						int y2 = y + (axis == 1);
+						int z2 = z + (axis == 2);
+
+						float l1 = field.Level(x, y, z);
+						float l2 = field.Level(x2, y2, z2);
+						float t = (l1 != l2) ? Clamp((isoLevel - l1) / (l2 - l1), 0.0f, 1.0f) : 0.0f;
+
+						DKVoxelMesher::Vertex v;
+						v.position = DKVector3(chunk.x + x, chunk.y + y, chunk.z + z);
+						v.position.val[axis] += t;
+
+						DKVector3 g1 = field.Gradient(x, y, z);
+						DKVector3 g2 = field.Gradient(x2, y2, z2);
+						// normal is facing to the lower level. (empty space)
+						v.normal = -(g1 + (g2 - g1) * t);
+						if (v.normal.LengthSq() > 0.0f)
+							v.normal.Normalize();
+
+						index = (Index)vertices.Add(v);
+					}
+					return index;
+				}
+
+				const LevelField& field;
+				const DKVoxelMesher::Chunk& chunk;
+				DKArray<Index> edgeCache;	// vertex index of cube edges. (3 edges per voxel)
+				int cx, cy, cz;				// current cube
+			};
+		}
+	}
+}
+using namespace DKFramework::Private::VoxelMesher;
+
+
+DKVoxelMesher::DKVoxelMesher(Volume* v, size_t cs)
+	: isoLevel(127.5f)
+	, volume(v)
+	, chunkSize(Max(cs, (size_t)1))
+	, volumeWidth(0)
+	, volumeHeight(0)
+	, volumeDepth(0)
+	, chunksX(0)
+	, chunksY(0)
+	, chunksZ(0)
+	, allDirty(true)
+{
+	DKASSERT_DEBUG(volume != NULL);
+}
+
+DKVoxelMesher::~DKVoxelMesher(void)
+{
+}
+
+void DKVoxelMesher::Invalidate(unsigned int x, unsigned int y, unsigned int z, size_t width, size_t height, size_t depth)
+{
+	if (width == 0 || height == 0 || depth == 0)
+		return;
+
+	DKCriticalSection<DKSpinLock> guard(lock);
+	if (allDirty || chunks.IsEmpty())
+		return;
+
+	// voxel is shared by cubes of (x-1, x), and used for gradient of
+	// adjacent voxels. cubes of (x-2 ~ x+width) are affected.
+	auto chunkRange = [this](unsigned int p, size_t len, size_t numChunks, size_t& begin, size_t& end)
+	{
+		size_t first = p > 2 ? p - 2 : 0;
+		size_t last = p + len;
+		begin = Min(first / chunkSize, numChunks);
+		end = Min(last / chunkSize + 1, numChunks);
+	};
+	size_t x0, x1, y0, y1, z0, z1;
+	chunkRange(x, width, chunksX, x0, x1);
+	chunkRange(y, height, chunksY, y0, y1);
+	chunkRange(z, depth, chunksZ, z0, z1);
+
+	for (size_t cz = z0; cz < z1; ++cz)
+		for (size_t cy = y0; cy < y1; ++cy)
+			for (size_t cx = x0; cx < x1; ++cx)
+				dirtyChunks.Insert((unsigned int)((cz * chunksY + cy) * chunksX + cx));
+}
+
+void DKVoxelMesher::InvalidateAll(void)
+{
+	DKCriticalSection<DKSpinLock> guard(lock);
+	allDirty = true;
+	dirtyChunks.Clear();
+}
+
+size_t DKVoxelMesher::Update(DKOperationQueue* queue)
+{
+	size_t width, height, depth;
+	volume->GetDimensions(&width, &height, &depth);
+
+	DKArray<unsigned int> targets;
+	lock.Lock();
+	if (width != volumeWidth || height != volumeHeight || depth != volumeDepth)
+	{
+		ResetChunks(width, height, depth);
+		allDirty = true;
+	}
+	if (allDirty)
+	{
+		targets.Reserve(chunks.Count());
+		for (unsigned int i = 0; i < chunks.Count(); ++i)
+			targets.Add(i);
+	}
+	else
+	{
+		targets.Reserve(dirtyChunks.Count());
+		dirtyChunks.EnumerateForward([&targets](unsigned int i) {targets.Add(i);});
+	}
+	allDirty = false;
+	dirtyChunks.Clear();
+	lock.Unlock();
+
+	if (targets.Count() == 1)
+	{
+		PolygonizeChunk(&chunks.Value(targets.Value(0)));
+	}
+	else if (targets.Count() > 1)
+	{
+		if (queue == NULL)
+			queue = &this->operationQueue;
+
+		DKArray<DKObject<DKOperationQueue::OperationSync>> syncs;
+		syncs.Reserve(targets.Count());
+		for (unsigned int i : targets)
+		{
+			Chunk* chunk = &chunks.Value(i);
+			syncs.Add(queue->ProcessAsync(DKFunction(this, &DKVoxelMesher::PolygonizeChunk)->Invocation(chunk)));
+		}
+		for (DKOperationQueue::OperationSync* s : syncs)
+			s->Sync();
+	}
+	return targets.Count();
+}
+
+void DKVoxelMesher::ResetChunks(size_t width, size_t height, size_t depth)
+{
+	volumeWidth = width;
+	volumeHeight = height;
+	volumeDepth = depth;
+
+	chunks.Clear();
+	chunksX = chunksY = chunksZ = 0;
+	if (width < 2 || height < 2 || depth < 2)
+		return;
+
+	// number of cubes is (number of voxels - 1)
+	size_t cubesX = width - 1;
+	size_t cubesY = height - 1;
+	size_t cubesZ = depth - 1;
+	chunksX = (cubesX + chunkSize - 1) / chunkSize;
+	chunksY = (cubesY + chunkSize - 1) / chunkSize;
+	chunksZ = (cubesZ + chunkSize - 1) / chunkSize;
+
+	chunks.Reserve(chunksX * chunksY * chunksZ);
+	for (size_t cz = 0; cz < chunksZ; ++cz)
+	{
+		for (size_t cy = 0; cy < chunksY; ++cy)
+		{
+			for (size_t cx = 0; cx < chunksX; ++cx)
+			{
+				Chunk c;
+				c.x = (unsigned int)(cx * chunkSize);
+				c.y = (unsigned int)(cy * chunkSize);
+				c.z = (unsigned int)(cz * chunkSize);
+				c.width = Min(chunkSize, cubesX - c.x);
+				c.height = Min(chunkSize, cubesY - c.y);
+				c.depth = Min(chunkSize, cubesZ - c.z);
+				c.revision = 0;
+				chunks.Add(c);
+			}
+		}
+	}
+}
+
+void DKVoxelMesher::PolygonizeChunk(Chunk* chunk)
+{
+	// read voxel levels of chunk with padding. (clamped at edge of volume)
+	LevelField field;
+	field.width = chunk->width + 3;
+	field.height = chunk->height + 3;
+	field.depth = chunk->depth + 3;
+	field.levels.Reserve(field.width * field.height * field.depth);
+
+	size_t x0 = chunk->x > 0 ? chunk->x - 1 : 0;
+	size_t y0 = chunk->y > 0 ? chunk->y - 1 : 0;
+	size_t z0 = chunk->z > 0 ? chunk->z - 1 : 0;
+	size_t x1 = Min(chunk->x + chunk->width + 2, volumeWidth);
+	size_t y1 = Min(chunk->y + chunk->height + 2, volumeHeight);
+	size_t z1 = Min(chunk->z + chunk->depth + 2, volumeDepth);
+	size_t rw = x1 - x0;
+	size_t rh = y1 - y0;
+	size_t rd = z1 - z0;
+
+	DKArray<DKVoxel32> voxels;
+	voxels.Resize(rw * rh * rd);
+	DKVoxel32SparseVolume* sparseVolume = dynamic_cast<DKVoxel32SparseVolume*>(volume.Ptr());
+	if (sparseVolume)
+	{
+		if (!sparseVolume->ReadRegion(x0, y0, z0, rw, rh, rd, voxels))
+			return;
+	}
+	else
+	{
+		DKVoxel32* p = voxels;
+		for (size_t z = z0; z < z1; ++z)
+			for (size_t y = y0; y < y1; ++y)
+				for (size_t x = x0; x < x1; ++x)
+				{
+					if (!volume->GetVoxelAtLocation(x, y, z, *p))
+						p->uintValue = 0;
+					p++;
+				}
+	}
+
+	for (size_t k = 0; k < field.depth; ++k)
+	{
+		size_t vz = (size_t)Clamp((long long)chunk->z + (long long)k - 1, (long long)z0, (long long)z1 - 1) - z0;
+		for (size_t j = 0; j < field.height; ++j)
+		{
+			size_t vy = (size_t)Clamp((long long)chunk->y + (long long)j - 1, (long long)y0, (long long)y1 - 1) - y0;
+			const DKVoxel32* row = &voxels.Value((vz * rh + vy) * rw);
+			for (size_t i = 0; i < field.width; ++i)
+			{
+				size_t vx = (size_t)Clamp((long long)chunk->x + (long long)i - 1, (long long)x0, (long long)x1 - 1) - x0;
+				field.levels.Add(row[vx].level);
+			}
+		}
+	}
+
+	ChunkPolygonizer polygonizer(field, *chunk, isoLevel);
+	polygonizer.Polygonize();
+
+	chunk->vertices = static_cast<DKArray<Vertex>&&>(polygonizer.vertices);
+	chunk->indices = static_cast<DKArray<Index>&&>(polygonizer.indices);
+	chunk->revision++;
+}
+
+size_t DKVoxelMesher::NumberOfChunks(void) const
+{
+	return chunks.Count();
+}
+
+const DKVoxelMesher::Chunk* DKVoxelMesher::ChunkAtIndex(unsigned int index) const
+{
+	if (index < chunks.Count())
+		return &chunks.Value(index);
+	return NULL;
+}
+
+void DKVoxelMesher::GetChunkDimensions(size_t* x, size_t* y, size_t* z) const
+{
+	if (x)	*x = chunksX;
+	if (y)	*y = chunksY;
+	if (z)	*z = chunksZ;
+}
+
+void DKVoxelMesher::GetMeshData(DKArray<Vertex>& vertices, DKArray<Index>& indices) const
+{
+	size_t numVerts = 0;
+	size_t numIndices = 0;
+	for (const Chunk& c : chunks)
+	{
+		numVerts += c.vertices.Count();
+		numIndices += c.indices.Count();
+	}
+	vertices.Clear();
+	indices.Clear();
+	vertices.Reserve(numVerts);
+	indices.Reserve(numIndices);
+
+	for (const Chunk& c : chunks)
+	{
+		Index base = (Index)vertices.Count();
+		vertices.Add(c.vertices);
+		for (Index i : c.indices)
+			indices.Add(base + i);
+	}
+}
+
+DKObject<DKStaticMesh> DKVoxelMesher::CreateMesh(const DKArray<Vertex>& vertices, const DKArray<Index>& indices, DKVertexBuffer::MemoryLocation location, DKVertexBuffer::BufferUsage usage)
+{
+	if (vertices.IsEmpty() || indices.IsEmpty())
+		return NULL;
+
+	const DKVertexBuffer::Decl decl[] = {
+		{ DKVertexStream::StreamPosition, L"", DKVertexStream::TypeFloat3, false, offsetof(Vertex, position) },
+		{ DKVertexStream::StreamNormal, L"", DKVertexStream::TypeFloat3, false, offsetof(Vertex, normal) },
+	};
+	DKObject<DKVertexBuffer> vb = DKVertexBuffer::Create(decl, 2, vertices, location, usage);
+	DKObject<DKIndexBuffer> ib = DKIndexBuffer::Create((const Index*)indices, indices.Count(), DKPrimitive::TypeTriangles, location, usage);
+	if (vb == NULL || ib == NULL)
+		return NULL;
+
+	DKObject<DKStaticMesh> mesh = DKObject<DKStaticMesh>::New();
+	mesh->SetDefaultPrimitiveType(DKPrimitive::TypeTriangles);
+	mesh->AddVertexBuffer(vb);
+	mesh->SetIndexBuffer(ib);
+	return mesh;
+}
@@ -0,0 +1,110 @@
+﻿//
+//  File: DKVoxelMesher.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2009-2014 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../DKInclude.h"
+#include "../DKFoundation.h"
+#include "DKVector3.h"
+#include "DKVoxelVolume.h"
+#include "DKVoxel32Storage.h"
+#include "DKStaticMesh.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// DKVoxelMesher
+// volume-level mesher, polygonize voxel volume with chunks.
+// volume is divided into chunks of cubes, and each chunk is polygonized by
+// DKVoxelIsosurfacePolygonizer in parallel with DKOperationQueue.
+// vertices on shared cube edges are welded with edge cache of each chunk,
+// result of chunk is indexed triangle list, can be used with DKStaticMesh.
+//
+// Only dirty chunks are polygonized by Update(). call Invalidate() with
+// modified region of volume to re-mesh chunks affected by region.
+//
+// Note:
+//   vertex position is in voxel coordinates, (voxel x,y,z is at x,y,z)
+//   voxel which has level greater than isoLevel is solid, normal is facing
+//   to the empty space.
+//   vertices on chunk boundary are not shared between chunks.
+//   chunk should not be accessed while Update() is running.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFramework
+{
+	class DKGL_API DKVoxelMesher
+	{
+	public:
+		typedef DKVoxelVolume<DKVoxel32> Volume;
+		typedef unsigned int Index;
+
+		enum {DefaultChunkSize = 32};	// cubes per axis
+
+		struct Vertex
+		{
+			DKVector3 position;
+			DKVector3 normal;
+		};
+		struct Chunk
+		{
+			unsigned int x, y, z;			// location of first cube
+			size_t width, height, depth;	// number of cubes
+			DKFoundation::DKArray<Vertex> vertices;
+			DKFoundation::DKArray<Index> indices;	// triangle list
+			unsigned int revision;			// increased when polygonized
+		};
+
+		DKVoxelMesher(Volume* volume, size_t chunkSize = DefaultChunkSize);
+		~DKVoxelMesher(void);
+
+		float isoLevel;		// iso-surface level, compared with DKVoxel32::level
+
+		// mark chunks affected by modified voxels as dirty.
+		void Invalidate(unsigned int x, unsigned int y, unsigned int z, size_t width, size_t height, size_t depth);
+		void InvalidateAll(void);
+
+		// polygonize dirty chunks, returns number of chunks polygonized.
+		// if queue is NULL, internal queue will be used.
+		size_t Update(DKFoundation::DKOperationQueue* queue = NULL);
+
+		size_t NumberOfChunks(void) const;
+		const Chunk* ChunkAtIndex(unsigned int index) const;
+		void GetChunkDimensions(size_t* x, size_t* y, size_t* z) const;
+		size_t ChunkSize(void) const		{ return chunkSize; }
+
+		// merge all chunks into single vertex, index array.
+		void GetMeshData(DKFoundation::DKArray<Vertex>& vertices, DKFoundation::DKArray<Index>& indices) const;
+
+		// create mesh with position, normal stream. returns NULL if indices is empty.
+		static DKFoundation::DKObject<DKStaticMesh> CreateMesh(const DKFoundation::DKArray<Vertex>& vertices,
+															   const DKFoundation::DKArray<Index>& indices,
+															   DKVertexBuffer::MemoryLocation location = DKVertexBuffer::MemoryLocationStatic,
+															   DKVertexBuffer::BufferUsage usage = DKVertexBuffer::BufferUsageDraw);
+
+		Volume* VoxelVolume(void)				{ return volume; }
+		const Volume* VoxelVolume(void) const	{ return volume; }
+
+	private:
+		void ResetChunks(size_t width, size_t height, size_t depth);
+		void PolygonizeChunk(Chunk* chunk);
+
+		DKFoundation::DKObject<Volume> volume;
+		size_t chunkSize;
+		size_t volumeWidth;
+		size_t volumeHeight;
+		size_t volumeDepth;
+		size_t chunksX;
+		size_t chunksY;
+		size_t chunksZ;
+		DKFoundation::DKArray<Chunk> chunks;
+		DKFoundation::DKSet<unsigned int> dirtyChunks;
+		bool allDirty;
+		DKFoundation::DKSpinLock lock;
+		DKFoundation::DKOperationQueue operationQueue;
+
+		DKVoxelMesher(const DKVoxelMesher&);
+		DKVoxelMesher& operator = (const DKVoxelMesher&);
+	};
+}
@@ -10,7 +10,7 @@
 #if defined(__APPLE__) && defined(__MACH__)
 
 #import <TargetConditionals.h>
-#if !TARGET_OS_IPHONE
+#if !TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 
 #ifdef __OBJC__
 #import <AppKit/AppKit.h> 
@@ -64,5 +64,5 @@ namespace DKFramework
 	}
 }
 
-#endif	//if !TARGET_OS_IPHONE
+#endif	//if !TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #endif	//if defined(__APPLE__) && defined(__MACH__)
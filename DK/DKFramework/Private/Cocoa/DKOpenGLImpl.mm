@@ -9,7 +9,7 @@
 #if defined(__APPLE__) && defined(__MACH__)
 
 #import <TargetConditionals.h>
-#if !TARGET_OS_IPHONE
+#if !TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #warning Compiling DKOpenGLImpl for Mac OS X
 
 #include <pthread.h>
@@ -236,5 +236,5 @@ void DKOpenGLImpl::SetSwapInterval(bool interval) const
 	}
 }
 
-#endif	//if !TARGET_OS_IPHONE
+#endif	//if !TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #endif	//if defined(__APPLE__) && defined(__MACH__)
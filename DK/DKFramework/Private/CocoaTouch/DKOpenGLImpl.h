@@ -11,7 +11,7 @@
 #if defined(__APPLE__) && defined(__MACH__)
 
 #import <TargetConditionals.h>
-#if TARGET_OS_IPHONE
+#if TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 
 #ifdef __OBJC__
 #import <UIKit/UIKit.h>
@@ -69,5 +69,5 @@ namespace DKFramework
 	}
 }
 
-#endif //if TARGET_OS_IPHONE
+#endif //if TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #endif //if defined(__APPLE__) && defined(__MACH__)
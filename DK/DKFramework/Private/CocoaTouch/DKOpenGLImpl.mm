@@ -9,7 +9,7 @@
 #if defined(__APPLE__) && defined(__MACH__)
 
 #import <TargetConditionals.h>
-#if TARGET_OS_IPHONE
+#if TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #warning Compiling DKOpenGLImpl for iOS
 
 #include <pthread.h>
@@ -303,6 +303,6 @@ unsigned int DKOpenGLImpl::FramebufferId(void) const
 	return 0;
 }
 
-#endif //if TARGET_OS_IPHONE
+#endif //if TARGET_OS_IPHONE && !defined(DKGL_OPENGL_NULL)
 #endif //if defined(__APPLE__) && defined(__MACH__)
 
@@ -0,0 +1,1195 @@
+//
+//  File: DKOpenGLFunctions.cpp
+//  Platform: Null (headless)
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#ifdef DKGL_OPENGL_NULL
+#include <ctype.h>
+#include "../../../../lib/OpenGL.h"
+#include "../../../DKFoundation.h"
+#include "../../DKOpenGLRecorder.h"
+
+using namespace DKFoundation;
+using namespace DKFramework;
+
+////////////////////////////////////////////////////////////////////////////////
+// OpenGL functions for headless build.
+// objects (buffer, texture, shader, program, framebuffer) are emulated,
+// buffer contents are kept in memory to support map and read-back.
+// shader program reflects uniforms and attributes declared in source, so
+// DKShaderProgram and DKMaterial work as same as real OpenGL.
+// every calls are recorded to DKOpenGLRecorder.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		namespace NullGL
+		{
+			struct BufferObject
+			{
+				DKArray<unsigned char> data;
+				GLenum usage;
+				GLbitfield access;
+				bool mapped;
+				GLintptr mapOffset;
+			};
+			struct TextureObject
+			{
+				GLenum target;
+				GLsizei width;
+				GLsizei height;
+				GLint internalFormat;
+			};
+			struct ShaderObject
+			{
+				GLenum type;
+				DKStringU8 source;
+				bool compiled;
+			};
+			struct Variable
+			{
+				DKStringU8 name;	// array name has '[0]' suffix.
+				GLenum type;
+				GLint size;
+			};
+			struct ProgramObject
+			{
+				DKArray<GLuint> shaders;
+				DKArray<Variable> attributes;
+				DKArray<Variable> uniforms;
+				bool linked;
+			};
+
+			struct Context
+			{
+				Context(void)
+					: nextName(1)
+					, program(0), framebuffer(0), renderbuffer(0), vertexArray(0)
+					, activeTexture(GL_TEXTURE0)
+					, packAlignment(4), unpackAlignment(4)
+				{
+					viewport[0] = viewport[1] = viewport[2] = viewport[3] = 0;
+				}
+				DKSpinLock lock;
+				GLuint nextName;		// object names are unique for all types.
+
+				DKMap<GLuint, BufferObject> buffers;
+				DKMap<GLuint, TextureObject> textures;
+				DKMap<GLuint, ShaderObject> shaders;
+				DKMap<GLuint, ProgramObject> programs;
+				DKSet<GLuint> framebuffers;
+				DKSet<GLuint> renderbuffers;
+				DKSet<GLuint> vertexArrays;
+
+				DKMap<GLenum, GLuint> bufferBindings;		// target, buffer
+				DKMap<uint64_t, GLuint> textureBindings;	// (unit, target), texture
+				GLuint program;
+				GLuint framebuffer;
+				GLuint renderbuffer;
+				GLuint vertexArray;
+				GLenum activeTexture;
+				GLint packAlignment;
+				GLint unpackAlignment;
+				GLint viewport[4];
+			};
+			static Context& GetContext(void)
+			{
+				static Context context;
+				return context;
+			}
+			typedef DKCriticalSection<DKSpinLock> CriticalSection;
+
+			inline void Record(DKOpenGLRecorder::CommandType type, const char* func, size_t bytes = 0,
+				unsigned int a0 = 0, unsigned int a1 = 0, unsigned int a2 = 0, unsigned int a3 = 0)
+			{
+				const DKOpenGLRecorder::Command cmd = { type, func, { a0, a1, a2, a3 }, bytes };
+				DKOpenGLRecorder::Record(cmd);
+			}
+
+			static void GenNames(Context& ctxt, GLsizei n, GLuint* names)
+			{
+				for (GLsizei i = 0; i < n; ++i)
+					names[i] = ctxt.nextName++;
+			}
+
+			static BufferObject* BoundBuffer(Context& ctxt, GLenum target)
+			{
+				auto p = ctxt.bufferBindings.Find(target);
+				if (p && p->value)
+				{
+					auto p2 = ctxt.buffers.Find(p->value);
+					if (p2)
+						return &p2->value;
+				}
+				return NULL;
+			}
+
+			static TextureObject* BoundTexture(Context& ctxt, GLenum target)
+			{
+				if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)
+					target = GL_TEXTURE_CUBE_MAP;
+				uint64_t key = (static_cast<uint64_t>(ctxt.activeTexture) << 32) | target;
+				auto p = ctxt.textureBindings.Find(key);
+				if (p && p->value)
+				{
+					auto p2 = ctxt.textures.Find(p->value);
+					if (p2)
+						return &p2->value;
+				}
+				return NULL;
+			}
+
+			static size_t PixelSize(GLenum format, GLenum type)
+			{
+				switch (type)
+				{
+				case GL_UNSIGNED_SHORT_5_6_5:
+				case GL_UNSIGNED_SHORT_4_4_4_4:
+				case GL_UNSIGNED_SHORT_5_5_5_1:
+					return 2;
+				case GL_UNSIGNED_INT_8_8_8_8:
+				case GL_UNSIGNED_INT_10_10_10_2:
+				case GL_UNSIGNED_INT_2_10_10_10_REV:
+				case GL_UNSIGNED_INT_24_8:
+				case GL_UNSIGNED_INT_10F_11F_11F_REV:
+				case GL_UNSIGNED_INT_5_9_9_9_REV:
+					return 4;
+				case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+					return 8;
+				}
+				size_t components = 4;
+				switch (format)
+				{
+				case GL_RED:
+				case GL_RED_INTEGER:
+				case GL_DEPTH_COMPONENT:
+				case GL_STENCIL_INDEX:
+					components = 1;		break;
+				case GL_RG:
+				case GL_RG_INTEGER:
+				case GL_DEPTH_STENCIL:
+					components = 2;		break;
+				case GL_RGB:
+				case GL_BGR:
+				case GL_RGB_INTEGER:
+				case GL_BGR_INTEGER:
+					components = 3;		break;
+				}
+				switch (type)
+				{
+				case GL_BYTE:
+				case GL_UNSIGNED_BYTE:
+					return components;
+				case GL_SHORT:
+				case GL_UNSIGNED_SHORT:
+				case GL_HALF_FLOAT:
+					return components * 2;
+				}
+				return components * 4;
+			}
+			// image bytes, last row is not padded.
+			static size_t ImageSize(GLsizei width, GLsizei height, GLenum format, GLenum type, GLint alignment)
+			{
+				if (width <= 0 || height <= 0)
+					return 0;
+				size_t rowBytes = width * PixelSize(format, type);
+				size_t pitch = rowBytes;
+				if (alignment > 1)
+					pitch = (rowBytes + alignment - 1) / alignment * alignment;
+				return pitch * (height - 1) + rowBytes;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////
+			// GLSL reflection. parse global declarations of uniform, attribute.
+			// (struct, interface block are not supported)
+			static GLenum ShaderVariableType(const DKStringU8& type)
+			{
+				static const struct { const char* name; GLenum type; } types[] =
+				{
+					{ "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+					{ "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+					{ "uint", GL_UNSIGNED_INT }, { "uvec2", GL_UNSIGNED_INT_VEC2 }, { "uvec3", GL_UNSIGNED_INT_VEC3 }, { "uvec4", GL_UNSIGNED_INT_VEC4 },
+					{ "bool", GL_BOOL }, { "bvec2", GL_BOOL_VEC2 }, { "bvec3", GL_BOOL_VEC3 }, { "bvec4", GL_BOOL_VEC4 },
+					{ "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+					{ "mat2x2", GL_FLOAT_MAT2 }, { "mat3x3", GL_FLOAT_MAT3 }, { "mat4x4", GL_FLOAT_MAT4 },
+					{ "mat2x3", GL_FLOAT_MAT2x3 }, { "mat2x4", GL_FLOAT_MAT2x4 }, { "mat3x2", GL_FLOAT_MAT3x2 },
+					{ "mat3x4", GL_FLOAT_MAT3x4 }, { "mat4x2", GL_FLOAT_MAT4x2 }, { "mat4x3", GL_FLOAT_MAT4x3 },
+					{ "sampler1D", GL_SAMPLER_1D }, { "sampler2D", GL_SAMPLER_2D }, { "sampler3D", GL_SAMPLER_3D },
+					{ "samplerCube", GL_SAMPLER_CUBE }, { "sampler2DRect", GL_SAMPLER_2D_RECT },
+					{ "sampler1DShadow", GL_SAMPLER_1D_SHADOW }, { "sampler2DShadow", GL_SAMPLER_2D_SHADOW },
+					{ "samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW }, { "sampler2DRectShadow", GL_SAMPLER_2D_RECT_SHADOW },
+					{ "sampler1DArray", GL_SAMPLER_1D_ARRAY }, { "sampler2DArray", GL_SAMPLER_2D_ARRAY },
+					{ "sampler1DArrayShadow", GL_SAMPLER_1D_ARRAY_SHADOW }, { "sampler2DArrayShadow", GL_SAMPLER_2D_ARRAY_SHADOW },
+					{ "samplerBuffer", GL_SAMPLER_BUFFER },
+					{ "isampler1D", GL_INT_SAMPLER_1D }, { "isampler2D", GL_INT_SAMPLER_2D }, { "isampler3D", GL_INT_SAMPLER_3D },
+					{ "isamplerCube", GL_INT_SAMPLER_CUBE }, { "isampler2DArray", GL_INT_SAMPLER_2D_ARRAY },
+					{ "usampler1D", GL_UNSIGNED_INT_SAMPLER_1D }, { "usampler2D", GL_UNSIGNED_INT_SAMPLER_2D },
+					{ "usampler3D", GL_UNSIGNED_INT_SAMPLER_3D }, { "usamplerCube", GL_UNSIGNED_INT_SAMPLER_CUBE },
+					{ "usampler2DArray", GL_UNSIGNED_INT_SAMPLER_2D_ARRAY },
+				};
+				for (auto& t : types)
+				{
+					if (type.Compare((const DKUniChar8*)t.name) == 0)
+						return t.type;
+				}
+				return 0;
+			}
+
+			static bool IsQualifier(const DKStringU8& token)
+			{
+				static const char* qualifiers[] =
+				{
+					"lowp", "mediump", "highp", "invariant", "centroid", "flat", "smooth", "noperspective", "const",
+				};
+				for (const char* q : qualifiers)
+				{
+					if (token.Compare((const DKUniChar8*)q) == 0)
+						return true;
+				}
+				return false;
+			}
+
+			static void AddVariable(DKArray<Variable>& vars, const DKStringU8& name, GLenum type, GLint size, bool isArray)
+			{
+				DKStringU8 activeName = isArray ? name + (const DKUniChar8*)"[0]" : name;
+				for (const Variable& v : vars)
+				{
+					if (v.name == activeName)
+						return;		// declared in other stage.
+				}
+				Variable v = { activeName, type, size };
+				vars.Add(v);
+			}
+
+			// parse tokens of a global statement. (without ';')
+			static void ParseDeclaration(const DKArray<DKStringU8>& tokens, bool vertexShader, DKArray<Variable>& attributes, DKArray<Variable>& uniforms)
+			{
+				size_t i = 0;
+				size_t count = tokens.Count();
+				DKArray<Variable>* target = NULL;
+
+				while (i < count && target == NULL)
+				{
+					const DKStringU8& t = tokens.Value(i);
+					if (t.Compare((const DKUniChar8*)"layout") == 0)
+					{
+						// skip layout(...)
+						int depth = 0;
+						for (++i; i < count; ++i)
+						{
+							if (tokens.Value(i).Compare((const DKUniChar8*)"(") == 0)
+								depth++;
+							else if (tokens.Value(i).Compare((const DKUniChar8*)")") == 0 && --depth <= 0)
+								break;
+						}
+					}
+					else if (t.Compare((const DKUniChar8*)"uniform") == 0)
+						target = &uniforms;
+					else if (vertexShader && (t.Compare((const DKUniChar8*)"attribute") == 0 || t.Compare((const DKUniChar8*)"in") == 0))
+						target = &attributes;
+					else if (!IsQualifier(t))
+						return;
+					++i;
+				}
+				while (i < count && IsQualifier(tokens.Value(i)))
+					++i;
+				if (target == NULL || i >= count)
+					return;
+
+				GLenum type = ShaderVariableType(tokens.Value(i++));
+				if (type == 0)
+					return;
+
+				while (i < count)
+				{
+					const DKStringU8& name = tokens.Value(i++);
+					GLint size = 1;
+					bool isArray = false;
+					if (i < count && tokens.Value(i).Compare((const DKUniChar8*)"[") == 0)
+					{
+						isArray = true;
+						if (i + 1 < count)
+						{
+							long long n = tokens.Value(i + 1).ToInteger();
+							if (n > 0)
+								size = static_cast<GLint>(n);
+						}
+						while (i < count && tokens.Value(i).Compare((const DKUniChar8*)"]") != 0)
+							++i;
+						++i;
+					}
+					AddVariable(*target, name, type, size, isArray);
+
+					// skip initializer, find next declarator.
+					int depth = 0;
+					while (i < count)
+					{
+						const DKStringU8& t = tokens.Value(i++);
+						if (t.Compare((const DKUniChar8*)"(") == 0)
+							depth++;
+						else if (t.Compare((const DKUniChar8*)")") == 0)
+							depth--;
+						else if (depth == 0 && t.Compare((const DKUniChar8*)",") == 0)
+							break;
+					}
+				}
+			}
+
+			static void ParseShaderVariables(const char* p, bool vertexShader, DKArray<Variable>& attributes, DKArray<Variable>& uniforms)
+			{
+				DKArray<DKStringU8> tokens;
+				int depth = 0;
+				while (p && *p)
+				{
+					const char c = *p;
+					if (c == '/' && p[1] == '/')
+					{
+						while (*p && *p != '\n') p++;
+					}
+					else if (c == '/' && p[1] == '*')
+					{
+						p += 2;
+						while (*p && !(p[0] == '*' && p[1] == '/')) p++;
+						if (*p) p += 2;
+					}
+					else if (c == '#')
+					{
+						// preprocessor directive
+						while (*p && *p != '\n')
+						{
+							if (p[0] == '\\' && p[1] == '\n') p++;
+							p++;
+						}
+					}
+					else if (isalnum((unsigned char)c) || c == '_')
+					{
+						const char* begin = p;
+						while (isalnum((unsigned char)*p) || *p == '_' || *p == '.')
+							p++;
+						if (depth == 0)
+							tokens.Add(DKStringU8((const DKUniChar8*)begin, p - begin));
+					}
+					else
+					{
+						switch (c)
+						{
+						case '{':
+							depth++;
+							tokens.Clear();
+							break;
+						case '}':
+							if (depth > 0) depth--;
+							tokens.Clear();
+							break;
+						case ';':
+							if (depth == 0)
+								ParseDeclaration(tokens, vertexShader, attributes, uniforms);
+							tokens.Clear();
+							break;
+						case '[': case ']': case '(': case ')': case ',': case '=':
+							if (depth == 0)
+								tokens.Add(DKStringU8((const DKUniChar8*)p, 1));
+							break;
+						}
+						p++;
+					}
+				}
+			}
+
+			static void CopyName(const DKStringU8& str, GLsizei bufSize, GLsizei* length, GLchar* name)
+			{
+				GLsizei len = 0;
+				if (name && bufSize > 0)
+				{
+					len = Min(static_cast<GLsizei>(str.Bytes()), bufSize - 1);
+					memcpy(name, (const DKUniChar8*)str, len);
+					name[len] = 0;
+				}
+				if (length)
+					*length = len;
+			}
+
+			static GLint VariableLocation(const DKArray<Variable>& vars, const GLchar* name)
+			{
+				DKStringU8 str((const DKUniChar8*)name);
+				DKStringU8 arrayName = str + (const DKUniChar8*)"[0]";
+				for (size_t i = 0; i < vars.Count(); ++i)
+				{
+					if (vars.Value(i).name == str || vars.Value(i).name == arrayName)
+						return static_cast<GLint>(i);
+				}
+				return -1;
+			}
+		}
+	}
+}
+
+using namespace DKFramework::Private::NullGL;
+
+#define DKGL_RECORD(type, ...)		Record(DKOpenGLRecorder::type, __func__, __VA_ARGS__)
+
+extern "C"
+{
+	////////////////////////////////////////////////////////////////////////////////
+	// state
+	GLAPI void APIENTRY glEnable(GLenum cap)												{ DKGL_RECORD(CommandState, 0, cap); }
+	GLAPI void APIENTRY glDisable(GLenum cap)												{ DKGL_RECORD(CommandState, 0, cap); }
+	GLAPI void APIENTRY glBlendColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)			{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glBlendEquation(GLenum mode)										{ DKGL_RECORD(CommandState, 0, mode); }
+	GLAPI void APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)			{ DKGL_RECORD(CommandState, 0, modeRGB, modeAlpha); }
+	GLAPI void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)						{ DKGL_RECORD(CommandState, 0, sfactor, dfactor); }
+	GLAPI void APIENTRY glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+	{
+		DKGL_RECORD(CommandState, 0, srcRGB, dstRGB, srcAlpha, dstAlpha);
+	}
+	GLAPI void APIENTRY glColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)	{ DKGL_RECORD(CommandState, 0, r, g, b, a); }
+	GLAPI void APIENTRY glDepthMask(GLboolean flag)										{ DKGL_RECORD(CommandState, 0, flag); }
+	GLAPI void APIENTRY glDepthFunc(GLenum func)											{ DKGL_RECORD(CommandState, 0, func); }
+	GLAPI void APIENTRY glDepthRange(GLdouble n, GLdouble f)								{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glDepthRangef(GLfloat n, GLfloat f)								{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)			{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glClearDepth(GLdouble depth)										{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glClearDepthf(GLfloat depth)										{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glCullFace(GLenum mode)											{ DKGL_RECORD(CommandState, 0, mode); }
+	GLAPI void APIENTRY glFrontFace(GLenum mode)											{ DKGL_RECORD(CommandState, 0, mode); }
+	GLAPI void APIENTRY glLineWidth(GLfloat width)											{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glPolygonOffset(GLfloat factor, GLfloat units)						{ DKGL_RECORD(CommandState, 0); }
+	GLAPI void APIENTRY glReadBuffer(GLenum src)											{ DKGL_RECORD(CommandState, 0, src); }
+	GLAPI void APIENTRY glDrawBuffers(GLsizei n, const GLenum* bufs)						{ DKGL_RECORD(CommandState, 0, n); }
+	GLAPI void APIENTRY glEnableVertexAttribArray(GLuint index)							{ DKGL_RECORD(CommandState, 0, index); }
+	GLAPI void APIENTRY glDisableVertexAttribArray(GLuint index)							{ DKGL_RECORD(CommandState, 0, index); }
+	GLAPI void APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)		{ DKGL_RECORD(CommandState, 0, target, pname); }
+	GLAPI void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)			{ DKGL_RECORD(CommandState, 0, target, pname, param); }
+	GLAPI void APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.viewport[0] = x;
+		ctxt.viewport[1] = y;
+		ctxt.viewport[2] = width;
+		ctxt.viewport[3] = height;
+		DKGL_RECORD(CommandState, 0, x, y, width, height);
+	}
+	GLAPI void APIENTRY glPixelStorei(GLenum pname, GLint param)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		if (pname == GL_PACK_ALIGNMENT)
+			ctxt.packAlignment = param;
+		else if (pname == GL_UNPACK_ALIGNMENT)
+			ctxt.unpackAlignment = param;
+		DKGL_RECORD(CommandState, 0, pname, param);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// binding
+	GLAPI void APIENTRY glBindBuffer(GLenum target, GLuint buffer)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.bufferBindings.Update(target, buffer);
+		if (buffer && ctxt.buffers.Find(buffer) == NULL)
+		{
+			BufferObject obj = { DKArray<unsigned char>(), GL_STATIC_DRAW, 0, false, 0 };
+			ctxt.buffers.Update(buffer, obj);
+		}
+		DKGL_RECORD(CommandBind, 0, target, buffer);
+	}
+	GLAPI void APIENTRY glActiveTexture(GLenum texture)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.activeTexture = texture;
+		DKGL_RECORD(CommandBind, 0, texture);
+	}
+	GLAPI void APIENTRY glBindTexture(GLenum target, GLuint texture)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.textureBindings.Update((static_cast<uint64_t>(ctxt.activeTexture) << 32) | target, texture);
+		if (texture && ctxt.textures.Find(texture) == NULL)
+		{
+			TextureObject obj = { target, 0, 0, 0 };
+			ctxt.textures.Update(texture, obj);
+		}
+		DKGL_RECORD(CommandBind, 0, target, texture);
+	}
+	GLAPI void APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.framebuffer = framebuffer;
+		DKGL_RECORD(CommandBind, 0, target, framebuffer);
+	}
+	GLAPI void APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.renderbuffer = renderbuffer;
+		DKGL_RECORD(CommandBind, 0, target, renderbuffer);
+	}
+	GLAPI void APIENTRY glBindVertexArray(GLuint array)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.vertexArray = array;
+		DKGL_RECORD(CommandBind, 0, array);
+	}
+	GLAPI void APIENTRY glUseProgram(GLuint program)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.program = program;
+		DKGL_RECORD(CommandBind, 0, program);
+	}
+	GLAPI void APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+	{
+		DKGL_RECORD(CommandBind, 0, index, size, type, stride);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// uniforms
+	GLAPI void APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLfloat) * count, location, count); }
+	GLAPI void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 2 * count, location, count); }
+	GLAPI void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 3 * count, location, count); }
+	GLAPI void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 4 * count, location, count); }
+	GLAPI void APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLint) * count, location, count); }
+	GLAPI void APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLint) * 2 * count, location, count); }
+	GLAPI void APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLint) * 3 * count, location, count); }
+	GLAPI void APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint* value)	{ DKGL_RECORD(CommandUniform, sizeof(GLint) * 4 * count, location, count); }
+	GLAPI void APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 4 * count, location, count);
+	}
+	GLAPI void APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 9 * count, location, count);
+	}
+	GLAPI void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		DKGL_RECORD(CommandUniform, sizeof(GLfloat) * 16 * count, location, count);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// draw
+	GLAPI void APIENTRY glClear(GLbitfield mask)											{ DKGL_RECORD(CommandClear, 0, mask); }
+	GLAPI void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)				{ DKGL_RECORD(CommandDraw, 0, mode, count, 1); }
+	GLAPI void APIENTRY glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+	{
+		DKGL_RECORD(CommandDraw, 0, mode, count, instancecount);
+	}
+	GLAPI void APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+	{
+		DKGL_RECORD(CommandDraw, 0, mode, count, 1, type);
+	}
+	GLAPI void APIENTRY glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+	{
+		DKGL_RECORD(CommandDraw, 0, mode, count, instancecount, type);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// buffer objects
+	GLAPI void APIENTRY glGenBuffers(GLsizei n, GLuint* buffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GenNames(ctxt, n, buffers);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			BufferObject obj = { DKArray<unsigned char>(), GL_STATIC_DRAW, 0, false, 0 };
+			ctxt.buffers.Update(buffers[i], obj);
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			ctxt.buffers.Remove(buffers[i]);
+			ctxt.bufferBindings.EnumerateForward([&](DKMap<GLenum, GLuint>::Pair& pair)
+			{
+				if (pair.value == buffers[i])
+					pair.value = 0;
+			});
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI GLboolean APIENTRY glIsBuffer(GLuint buffer)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		DKGL_RECORD(CommandQuery, 0, buffer);
+		return ctxt.buffers.Find(buffer) ? GL_TRUE : GL_FALSE;
+	}
+	GLAPI void APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (buffer)
+		{
+			buffer->data.Clear();
+			if (data)
+				buffer->data.Add(reinterpret_cast<const unsigned char*>(data), size);
+			else
+				buffer->data.Add((unsigned char)0, size);
+			buffer->usage = usage;
+			buffer->mapped = false;
+		}
+		DKGL_RECORD(CommandBufferUpload, data ? size : 0, target, static_cast<unsigned int>(size), usage);
+	}
+	GLAPI void APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (buffer && data && offset >= 0 && offset + size <= (GLsizeiptr)buffer->data.Count())
+			memcpy((unsigned char*)buffer->data + offset, data, size);
+		DKGL_RECORD(CommandBufferUpload, size, target, static_cast<unsigned int>(offset), static_cast<unsigned int>(size));
+	}
+	GLAPI void APIENTRY glGetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void* data)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (buffer && data && offset >= 0 && offset + size <= (GLsizeiptr)buffer->data.Count())
+			memcpy(data, (const unsigned char*)buffer->data + offset, size);
+		DKGL_RECORD(CommandQuery, size, target, static_cast<unsigned int>(offset), static_cast<unsigned int>(size));
+	}
+	GLAPI void* APIENTRY glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		void* ptr = NULL;
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (buffer && !buffer->mapped && offset >= 0 && offset + length <= (GLsizeiptr)buffer->data.Count())
+		{
+			buffer->mapped = true;
+			buffer->access = access;
+			buffer->mapOffset = offset;
+			ptr = (unsigned char*)buffer->data + offset;
+		}
+		// access can be GL_*_ONLY enum or GL_MAP_*_BIT flags.
+		bool write = (access == GL_WRITE_ONLY || access == GL_READ_WRITE || (access < GL_READ_ONLY && (access & GL_MAP_WRITE_BIT)));
+		DKGL_RECORD(CommandBufferUpload, write ? length : 0, target, static_cast<unsigned int>(offset), static_cast<unsigned int>(length), access);
+		return ptr;
+	}
+	GLAPI GLboolean APIENTRY glUnmapBuffer(GLenum target)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		GLboolean ret = GL_FALSE;
+		if (buffer && buffer->mapped)
+		{
+			buffer->mapped = false;
+			buffer->access = 0;
+			ret = GL_TRUE;
+		}
+		DKGL_RECORD(CommandBufferUpload, 0, target);
+		return ret;
+	}
+	GLAPI void APIENTRY glGetBufferParameteriv(GLenum target, GLenum pname, GLint* params)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (buffer && params)
+		{
+			switch (pname)
+			{
+			case GL_BUFFER_SIZE:			*params = static_cast<GLint>(buffer->data.Count());		break;
+			case GL_BUFFER_USAGE:			*params = buffer->usage;								break;
+			case GL_BUFFER_MAPPED:			*params = buffer->mapped ? GL_TRUE : GL_FALSE;			break;
+			case GL_BUFFER_ACCESS:
+			case GL_BUFFER_ACCESS_FLAGS:	*params = buffer->access;								break;
+			default:						*params = 0;											break;
+			}
+		}
+		DKGL_RECORD(CommandQuery, 0, target, pname);
+	}
+	GLAPI void APIENTRY glGetBufferPointerv(GLenum target, GLenum pname, void** params)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		BufferObject* buffer = BoundBuffer(ctxt, target);
+		if (params)
+		{
+			*params = NULL;
+			if (buffer && buffer->mapped && pname == GL_BUFFER_MAP_POINTER)
+				*params = (unsigned char*)buffer->data + buffer->mapOffset;
+		}
+		DKGL_RECORD(CommandQuery, 0, target, pname);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// vertex array objects
+	GLAPI void APIENTRY glGenVertexArrays(GLsizei n, GLuint* arrays)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GenNames(ctxt, n, arrays);
+		for (GLsizei i = 0; i < n; ++i)
+			ctxt.vertexArrays.Insert(arrays[i]);
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			ctxt.vertexArrays.Remove(arrays[i]);
+			if (ctxt.vertexArray == arrays[i])
+				ctxt.vertexArray = 0;
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI GLboolean APIENTRY glIsVertexArray(GLuint array)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		DKGL_RECORD(CommandQuery, 0, array);
+		return ctxt.vertexArrays.Contains(array) ? GL_TRUE : GL_FALSE;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// textures
+	GLAPI void APIENTRY glGenTextures(GLsizei n, GLuint* textures)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GenNames(ctxt, n, textures);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			TextureObject obj = { 0, 0, 0, 0 };
+			ctxt.textures.Update(textures[i], obj);
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			ctxt.textures.Remove(textures[i]);
+			ctxt.textureBindings.EnumerateForward([&](DKMap<uint64_t, GLuint>::Pair& pair)
+			{
+				if (pair.value == textures[i])
+					pair.value = 0;
+			});
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		TextureObject* texture = BoundTexture(ctxt, target);
+		if (texture && level == 0)
+		{
+			texture->target = target;
+			texture->width = width;
+			texture->height = height;
+			texture->internalFormat = internalformat;
+		}
+		size_t bytes = pixels ? ImageSize(width, height, format, type, ctxt.unpackAlignment) : 0;
+		DKGL_RECORD(CommandTextureUpload, bytes, target, level, width, height);
+	}
+	GLAPI void APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		size_t bytes = pixels ? ImageSize(width, height, format, type, ctxt.unpackAlignment) : 0;
+		DKGL_RECORD(CommandTextureUpload, bytes, target, level, width, height);
+	}
+	GLAPI void APIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		// copied on GPU, no data transferred.
+		DKGL_RECORD(CommandTextureUpload, 0, target, level, width, height);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// framebuffer, renderbuffer
+	GLAPI void APIENTRY glGenFramebuffers(GLsizei n, GLuint* framebuffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GenNames(ctxt, n, framebuffers);
+		for (GLsizei i = 0; i < n; ++i)
+			ctxt.framebuffers.Insert(framebuffers[i]);
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			ctxt.framebuffers.Remove(framebuffers[i]);
+			if (ctxt.framebuffer == framebuffers[i])
+				ctxt.framebuffer = 0;
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GenNames(ctxt, n, renderbuffers);
+		for (GLsizei i = 0; i < n; ++i)
+			ctxt.renderbuffers.Insert(renderbuffers[i]);
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			ctxt.renderbuffers.Remove(renderbuffers[i]);
+			if (ctxt.renderbuffer == renderbuffers[i])
+				ctxt.renderbuffer = 0;
+		}
+		DKGL_RECORD(CommandResource, 0, n);
+	}
+	GLAPI void APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+	{
+		DKGL_RECORD(CommandResource, 0, target, internalformat, width, height);
+	}
+	GLAPI void APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+	{
+		DKGL_RECORD(CommandResource, 0, target, attachment, renderbuffertarget, renderbuffer);
+	}
+	GLAPI void APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+	{
+		DKGL_RECORD(CommandResource, 0, target, attachment, textarget, texture);
+	}
+	GLAPI GLenum APIENTRY glCheckFramebufferStatus(GLenum target)
+	{
+		DKGL_RECORD(CommandQuery, 0, target);
+		return GL_FRAMEBUFFER_COMPLETE;
+	}
+	GLAPI void APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		size_t bytes = ImageSize(width, height, format, type, ctxt.packAlignment);
+		if (pixels && bytes > 0)
+			memset(pixels, 0, bytes);
+		DKGL_RECORD(CommandSync, bytes, x, y, width, height);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// shaders
+	GLAPI GLuint APIENTRY glCreateShader(GLenum type)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GLuint name = 0;
+		GenNames(ctxt, 1, &name);
+		ShaderObject obj = { type, DKStringU8(), false };
+		ctxt.shaders.Update(name, obj);
+		DKGL_RECORD(CommandResource, 0, type, name);
+		return name;
+	}
+	GLAPI void APIENTRY glDeleteShader(GLuint shader)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.shaders.Remove(shader);
+		DKGL_RECORD(CommandResource, 0, shader);
+	}
+	GLAPI GLboolean APIENTRY glIsShader(GLuint shader)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		DKGL_RECORD(CommandQuery, 0, shader);
+		return ctxt.shaders.Find(shader) ? GL_TRUE : GL_FALSE;
+	}
+	GLAPI void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.shaders.Find(shader);
+		size_t bytes = 0;
+		if (p)
+		{
+			DKStringU8 source;
+			for (GLsizei i = 0; i < count; ++i)
+			{
+				if (length && length[i] >= 0)
+					source.Append((const DKUniChar8*)string[i], length[i]);
+				else
+					source.Append((const DKUniChar8*)string[i]);
+			}
+			bytes = source.Bytes();
+			p->value.source = source;
+			p->value.compiled = false;
+		}
+		DKGL_RECORD(CommandResource, bytes, shader, count);
+	}
+	GLAPI void APIENTRY glCompileShader(GLuint shader)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.shaders.Find(shader);
+		if (p)
+			p->value.compiled = true;
+		DKGL_RECORD(CommandResource, 0, shader);
+	}
+	GLAPI void APIENTRY glReleaseShaderCompiler(void)
+	{
+		DKGL_RECORD(CommandResource, 0);
+	}
+	GLAPI void APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.shaders.Find(shader);
+		if (params)
+		{
+			*params = 0;
+			if (p)
+			{
+				switch (pname)
+				{
+				case GL_SHADER_TYPE:			*params = p->value.type;								break;
+				case GL_COMPILE_STATUS:			*params = p->value.compiled ? GL_TRUE : GL_FALSE;		break;
+				case GL_SHADER_SOURCE_LENGTH:	*params = static_cast<GLint>(p->value.source.Bytes()) + 1;	break;
+				case GL_INFO_LOG_LENGTH:		*params = 0;											break;
+				}
+			}
+		}
+		DKGL_RECORD(CommandQuery, 0, shader, pname);
+	}
+	GLAPI void APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+	{
+		CopyName(DKStringU8::EmptyString(), bufSize, length, infoLog);
+		DKGL_RECORD(CommandQuery, 0, shader);
+	}
+	GLAPI void APIENTRY glGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.shaders.Find(shader);
+		CopyName(p ? p->value.source : DKStringU8::EmptyString(), bufSize, length, source);
+		DKGL_RECORD(CommandQuery, 0, shader);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// programs
+	GLAPI GLuint APIENTRY glCreateProgram(void)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		GLuint name = 0;
+		GenNames(ctxt, 1, &name);
+		ProgramObject obj;
+		obj.linked = false;
+		ctxt.programs.Update(name, obj);
+		DKGL_RECORD(CommandResource, 0, name);
+		return name;
+	}
+	GLAPI void APIENTRY glDeleteProgram(GLuint program)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		ctxt.programs.Remove(program);
+		if (ctxt.program == program)
+			ctxt.program = 0;
+		DKGL_RECORD(CommandResource, 0, program);
+	}
+	GLAPI GLboolean APIENTRY glIsProgram(GLuint program)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		DKGL_RECORD(CommandQuery, 0, program);
+		return ctxt.programs.Find(program) ? GL_TRUE : GL_FALSE;
+	}
+	GLAPI void APIENTRY glAttachShader(GLuint program, GLuint shader)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		if (p)
+			p->value.shaders.Add(shader);
+		DKGL_RECORD(CommandResource, 0, program, shader);
+	}
+	GLAPI void APIENTRY glLinkProgram(GLuint program)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		if (p)
+		{
+			ProgramObject& prog = p->value;
+			prog.attributes.Clear();
+			prog.uniforms.Clear();
+			for (GLuint s : prog.shaders)
+			{
+				auto ps = ctxt.shaders.Find(s);
+				if (ps)
+				{
+					ParseShaderVariables((const char*)(const DKUniChar8*)ps->value.source,
+						ps->value.type == GL_VERTEX_SHADER, prog.attributes, prog.uniforms);
+				}
+			}
+			prog.linked = true;
+		}
+		DKGL_RECORD(CommandResource, 0, program);
+	}
+	GLAPI void APIENTRY glValidateProgram(GLuint program)
+	{
+		DKGL_RECORD(CommandResource, 0, program);
+	}
+	GLAPI void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		if (params)
+		{
+			*params = 0;
+			if (p)
+			{
+				const ProgramObject& prog = p->value;
+				auto MaxLength = [](const DKArray<Variable>& vars) -> GLint
+				{
+					GLint len = 0;
+					for (const Variable& v : vars)
+						len = Max(len, static_cast<GLint>(v.name.Bytes()) + 1);
+					return len;
+				};
+				switch (pname)
+				{
+				case GL_LINK_STATUS:
+				case GL_VALIDATE_STATUS:				*params = prog.linked ? GL_TRUE : GL_FALSE;					break;
+				case GL_ATTACHED_SHADERS:				*params = static_cast<GLint>(prog.shaders.Count());		break;
+				case GL_ACTIVE_ATTRIBUTES:				*params = static_cast<GLint>(prog.attributes.Count());		break;
+				case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:	*params = MaxLength(prog.attributes);						break;
+				case GL_ACTIVE_UNIFORMS:				*params = static_cast<GLint>(prog.uniforms.Count());		break;
+				case GL_ACTIVE_UNIFORM_MAX_LENGTH:		*params = MaxLength(prog.uniforms);							break;
+				case GL_INFO_LOG_LENGTH:				*params = 0;												break;
+				}
+			}
+		}
+		DKGL_RECORD(CommandQuery, 0, program, pname);
+	}
+	GLAPI void APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+	{
+		CopyName(DKStringU8::EmptyString(), bufSize, length, infoLog);
+		DKGL_RECORD(CommandQuery, 0, program);
+	}
+	GLAPI void APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		if (p && index < p->value.attributes.Count())
+		{
+			const Variable& v = p->value.attributes.Value(index);
+			CopyName(v.name, bufSize, length, name);
+			if (size) *size = v.size;
+			if (type) *type = v.type;
+		}
+		else
+		{
+			CopyName(DKStringU8::EmptyString(), bufSize, length, name);
+		}
+		DKGL_RECORD(CommandQuery, 0, program, index);
+	}
+	GLAPI void APIENTRY glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		if (p && index < p->value.uniforms.Count())
+		{
+			const Variable& v = p->value.uniforms.Value(index);
+			CopyName(v.name, bufSize, length, name);
+			if (size) *size = v.size;
+			if (type) *type = v.type;
+		}
+		else
+		{
+			CopyName(DKStringU8::EmptyString(), bufSize, length, name);
+		}
+		DKGL_RECORD(CommandQuery, 0, program, index);
+	}
+	GLAPI GLint APIENTRY glGetAttribLocation(GLuint program, const GLchar* name)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		DKGL_RECORD(CommandQuery, 0, program);
+		return (p && name) ? VariableLocation(p->value.attributes, name) : -1;
+	}
+	GLAPI GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar* name)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		auto p = ctxt.programs.Find(program);
+		DKGL_RECORD(CommandQuery, 0, program);
+		return (p && name) ? VariableLocation(p->value.uniforms, name) : -1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// query, sync
+	GLAPI GLenum APIENTRY glGetError(void)
+	{
+		DKGL_RECORD(CommandQuery, 0);
+		return GL_NO_ERROR;
+	}
+	GLAPI void APIENTRY glGetIntegerv(GLenum pname, GLint* data)
+	{
+		Context& ctxt = GetContext();
+		CriticalSection guard(ctxt.lock);
+		if (data)
+		{
+			switch (pname)
+			{
+			case GL_MAX_TEXTURE_SIZE:					data[0] = 16384;			break;
+			case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:	data[0] = 80;				break;
+			case GL_MAX_TEXTURE_IMAGE_UNITS:			data[0] = 16;				break;
+			case GL_MAX_VERTEX_ATTRIBS:					data[0] = 16;				break;
+			case GL_MAX_COLOR_ATTACHMENTS:				data[0] = 8;				break;
+			case GL_MAX_DRAW_BUFFERS:					data[0] = 8;				break;
+			case GL_MAJOR_VERSION:						data[0] = 4;				break;
+			case GL_MINOR_VERSION:						data[0] = 1;				break;
+			case GL_FRAMEBUFFER_BINDING:				data[0] = ctxt.framebuffer;	break;
+			case GL_RENDERBUFFER_BINDING:				data[0] = ctxt.renderbuffer;	break;
+			case GL_VERTEX_ARRAY_BINDING:				data[0] = ctxt.vertexArray;	break;
+			case GL_CURRENT_PROGRAM:					data[0] = ctxt.program;		break;
+			case GL_ACTIVE_TEXTURE:						data[0] = ctxt.activeTexture;	break;
+			case GL_PACK_ALIGNMENT:						data[0] = ctxt.packAlignment;	break;
+			case GL_UNPACK_ALIGNMENT:					data[0] = ctxt.unpackAlignment;	break;
+			case GL_VIEWPORT:
+				memcpy(data, ctxt.viewport, sizeof(ctxt.viewport));
+				break;
+			case GL_ARRAY_BUFFER_BINDING:
+				data[0] = ctxt.bufferBindings.Find(GL_ARRAY_BUFFER) ? ctxt.bufferBindings.Find(GL_ARRAY_BUFFER)->value : 0;
+				break;
+			case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+				data[0] = ctxt.bufferBindings.Find(GL_ELEMENT_ARRAY_BUFFER) ? ctxt.bufferBindings.Find(GL_ELEMENT_ARRAY_BUFFER)->value : 0;
+				break;
+			default:
+				data[0] = 0;
+				break;
+			}
+		}
+		DKGL_RECORD(CommandQuery, 0, pname);
+	}
+	GLAPI void APIENTRY glFlush(void)														{ DKGL_RECORD(CommandSync, 0); }
+	GLAPI void APIENTRY glFinish(void)														{ DKGL_RECORD(CommandSync, 0); }
+}
+
+#endif	// ifdef DKGL_OPENGL_NULL
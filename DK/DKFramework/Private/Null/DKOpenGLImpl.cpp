@@ -0,0 +1,106 @@
+//
+//  File: DKOpenGLImpl.cpp
+//  Platform: Null (headless)
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#ifdef DKGL_OPENGL_NULL
+#include "../../../../lib/OpenGL.h"
+#include "../../DKOpenGLRecorder.h"
+#include "DKOpenGLImpl.h"
+
+using namespace DKFoundation;
+using namespace DKFramework;
+using namespace DKFramework::Private;
+
+DKOpenGLInterface* DKOpenGLInterface::CreateInterface(DKOpenGLContext*)
+{
+	return new DKOpenGLImpl();
+}
+
+DKOpenGLImpl::DKOpenGLImpl(void)
+	: swapInterval(false)
+{
+}
+
+DKOpenGLImpl::~DKOpenGLImpl(void)
+{
+	boundContexts.Clear();
+}
+
+bool DKOpenGLImpl::IsBound(void) const
+{
+	return boundContexts.Find(DKThread::CurrentThreadId()) != NULL;
+}
+
+void DKOpenGLImpl::Bind(void* target) const
+{
+	DKThread::ThreadId currentThreadId = DKThread::CurrentThreadId();
+
+	BoundContextMap::Pair* p = boundContexts.Find(currentThreadId);
+	if (p)
+	{
+		DKASSERT_DEBUG(p->value >= 0);
+		p->value++;
+	}
+	else
+	{
+		if (!boundContexts.Insert(currentThreadId, 1))
+			DKERROR_THROW("Context insert failed!");
+	}
+}
+
+void DKOpenGLImpl::Unbind(void) const
+{
+	DKThread::ThreadId currentThreadId = DKThread::CurrentThreadId();
+
+	BoundContextMap::Pair* p = boundContexts.Find(currentThreadId);
+	if (p)
+	{
+		DKASSERT_DEBUG(p->value >= 0);
+		p->value--;
+		if (p->value == 0)
+		{
+			glFinish();
+			boundContexts.Remove(currentThreadId);
+		}
+	}
+	else
+	{
+		DKERROR_THROW_DEBUG("cannot find context");
+	}
+}
+
+void DKOpenGLImpl::Flush(void) const
+{
+	glFlush();
+}
+
+void DKOpenGLImpl::Finish(void) const
+{
+	glFinish();
+}
+
+void DKOpenGLImpl::Present(void) const
+{
+	const DKOpenGLRecorder::Command cmd = { DKOpenGLRecorder::CommandSync, "Present", {0, 0, 0, 0}, 0 };
+	DKOpenGLRecorder::Record(cmd);
+}
+
+void DKOpenGLImpl::Update(void) const
+{
+}
+
+bool DKOpenGLImpl::GetSwapInterval(void) const
+{
+	return swapInterval;
+}
+
+void DKOpenGLImpl::SetSwapInterval(bool interval) const
+{
+	swapInterval = interval;
+}
+
+#endif	// ifdef DKGL_OPENGL_NULL
@@ -0,0 +1,51 @@
+//
+//  File: DKOpenGLImpl.h
+//  Platform: Null (headless)
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+
+#ifdef DKGL_OPENGL_NULL
+#include "../../../../lib/OpenGL.h"
+#include "../../../DKFoundation.h"
+#include "../../Interface/DKOpenGLInterface.h"
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		// OpenGL context for headless build, no window or GPU required.
+		// OpenGL functions are emulated by DKOpenGLFunctions.cpp
+		class DKOpenGLImpl : public DKOpenGLInterface
+		{
+		public:
+			DKOpenGLImpl(void);
+			~DKOpenGLImpl(void);
+
+			void Bind(void* target) const;		// bind context to current thread
+			void Unbind(void) const;			// unbind
+			bool IsBound(void) const;
+
+			void Flush(void) const;				// glFlush
+			void Finish(void) const;			// glFinish
+			void Present(void) const;			// recorded only
+
+			void Update(void) const;
+
+			bool GetSwapInterval(void) const;
+			void SetSwapInterval(bool interval) const;
+
+			unsigned int FramebufferId(void) const		{return 0;}
+		private:
+			// bound count for each thread
+			typedef DKFoundation::DKMap<DKFoundation::DKThread::ThreadId, int, DKFoundation::DKSpinLock> BoundContextMap;
+			mutable BoundContextMap	boundContexts;
+			mutable bool			swapInterval;
+		};
+	}
+}
+
+#endif // ifdef DKGL_OPENGL_NULL
@@ -0,0 +1,42 @@
+//
+//  File: QuaternionUtils.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include <math.h>
+#include "../../DKInclude.h"
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		// calculate ratio of two quaternions for slerp with dot-product.
+		// returns false if q1 = q2 or q1 = -q2. (result is q1)
+		inline bool SlerpRatio(float dot, float t, float& ratio1, float& ratio2)
+		{
+			// dot-product of two quaternions (angle of two quats)
+			double cosHalfTheta = dot;
+			bool flip = cosHalfTheta < 0.0;
+			if (flip)
+				cosHalfTheta = -cosHalfTheta;
+
+			if (cosHalfTheta >= 1.0) // q1 = q2 or q1 = -q2
+				return false;
+
+			float halfTheta = acos(cosHalfTheta);
+			float oneOverSinHalfTheta = 1.0 / sin(halfTheta);
+
+			float t2 = 1.0 - t;
+
+			ratio1 = sin(halfTheta * t2) * oneOverSinHalfTheta;
+			ratio2 = sin(halfTheta * t) * oneOverSinHalfTheta;
+
+			if (flip)
+				ratio2 = -ratio2;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,292 @@
+//
+//  File: SIMDUtils.h
+//  Author: Hongtae Kim (tiff2766@gmail.com)
+//
+//  Copyright (c) 2004-2015 Hongtae Kim. All rights reserved.
+//
+
+#pragma once
+#include "../../DKInclude.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// SIMDUtils.h
+// SIMD kernels for DKMatrix4, DKVector3, DKQuaternion.
+//
+// Instruction set is selected at build time.
+//  - SSE2 on x86 (x64, or x86 with SSE2 enabled)
+//  - NEON on ARM
+// Define DKGL_SIMD_DISABLED to build scalar version only.
+//
+// Kernels perform same operations in same order as scalar code, results
+// are identical to scalar version, except matrix inverse (SSE2 only) which
+// uses 2x2 block-wise cofactors. inverse matrix error is within 1e-5
+// relative to largest element for well-conditioned matrices.
+// NEON flushes denormals to zero on ARMv7.
+//
+// Note:
+//   DKMatrix4, DKVector3, DKQuaternion are packed with 4 bytes alignment,
+//   all kernels use unaligned load/store.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DKGL_SIMD_DISABLED
+#	if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define DKGL_SIMD_SSE 1
+#		include <emmintrin.h>
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define DKGL_SIMD_NEON 1
+#		include <arm_neon.h>
+#	endif
+#endif
+#if defined(DKGL_SIMD_SSE) || defined(DKGL_SIMD_NEON)
+#	define DKGL_SIMD_ENABLED 1
+#endif
+
+namespace DKFramework
+{
+	namespace Private
+	{
+		namespace SIMD
+		{
+#if defined(DKGL_SIMD_SSE)
+			// row of matrix multiplication, a (row) * b (4x4)
+			inline __m128 Matrix4MultiplyRow(const float* a, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+			{
+				__m128 v = _mm_mul_ps(_mm_set1_ps(a[0]), b0);
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[1]), b1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[2]), b2));
+				return _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[3]), b3));
+			}
+			// r = a * b (row-major 4x4), r can be a or b.
+			inline void Matrix4Multiply(const float* a, const float* b, float* r)
+			{
+				const __m128 b0 = _mm_loadu_ps(&b[0]);
+				const __m128 b1 = _mm_loadu_ps(&b[4]);
+				const __m128 b2 = _mm_loadu_ps(&b[8]);
+				const __m128 b3 = _mm_loadu_ps(&b[12]);
+				const __m128 r0 = Matrix4MultiplyRow(&a[0], b0, b1, b2, b3);
+				const __m128 r1 = Matrix4MultiplyRow(&a[4], b0, b1, b2, b3);
+				const __m128 r2 = Matrix4MultiplyRow(&a[8], b0, b1, b2, b3);
+				const __m128 r3 = Matrix4MultiplyRow(&a[12], b0, b1, b2, b3);
+				_mm_storeu_ps(&r[0], r0);
+				_mm_storeu_ps(&r[4], r1);
+				_mm_storeu_ps(&r[8], r2);
+				_mm_storeu_ps(&r[12], r3);
+			}
+			// homogeneous transform of 3 vectors (x, y, z, 1) * m, r can be v.
+			inline void Vector3Transform(const float* v, const float* m, float* r)
+			{
+				__m128 t = _mm_mul_ps(_mm_set1_ps(v[0]), _mm_loadu_ps(&m[0]));
+				t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(v[1]), _mm_loadu_ps(&m[4])));
+				t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(v[2]), _mm_loadu_ps(&m[8])));
+				t = _mm_add_ps(t, _mm_loadu_ps(&m[12]));
+				__m128 w = _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 3, 3, 3)));
+				t = _mm_mul_ps(t, w);
+				// store x, y, z only. (do not touch next element)
+				_mm_storel_pi(reinterpret_cast<__m64*>(r), t);
+				_mm_store_ss(&r[2], _mm_movehl_ps(t, t));
+			}
+			// homogeneous transform of 4 vectors in SoA layout.
+			inline void Vector3TransformSoA4(float* x, float* y, float* z, const float* m)
+			{
+				const __m128 vx = _mm_loadu_ps(x);
+				const __m128 vy = _mm_loadu_ps(y);
+				const __m128 vz = _mm_loadu_ps(z);
+				__m128 r[4];
+				for (int i = 0; i < 4; ++i)
+				{
+					__m128 t = _mm_mul_ps(vx, _mm_set1_ps(m[i]));
+					t = _mm_add_ps(t, _mm_mul_ps(vy, _mm_set1_ps(m[4 + i])));
+					t = _mm_add_ps(t, _mm_mul_ps(vz, _mm_set1_ps(m[8 + i])));
+					r[i] = _mm_add_ps(t, _mm_set1_ps(m[12 + i]));
+				}
+				__m128 w = _mm_div_ps(_mm_set1_ps(1.0f), r[3]);
+				_mm_storeu_ps(x, _mm_mul_ps(r[0], w));
+				_mm_storeu_ps(y, _mm_mul_ps(r[1], w));
+				_mm_storeu_ps(z, _mm_mul_ps(r[2], w));
+			}
+			// dot product of 4 quaternion pairs, in order of (w, x, y, z).
+			inline void QuaternionDot4(const float* q1, const float* q2, float* r)
+			{
+				__m128 ax = _mm_loadu_ps(&q1[0]), ay = _mm_loadu_ps(&q1[4]), az = _mm_loadu_ps(&q1[8]), aw = _mm_loadu_ps(&q1[12]);
+				__m128 bx = _mm_loadu_ps(&q2[0]), by = _mm_loadu_ps(&q2[4]), bz = _mm_loadu_ps(&q2[8]), bw = _mm_loadu_ps(&q2[12]);
+				_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+				_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+				__m128 d = _mm_mul_ps(aw, bw);
+				d = _mm_add_ps(d, _mm_mul_ps(ax, bx));
+				d = _mm_add_ps(d, _mm_mul_ps(ay, by));
+				d = _mm_add_ps(d, _mm_mul_ps(az, bz));
+				_mm_storeu_ps(r, d);
+			}
+			// r = q1 * s1 + q2 * s2 (4 components)
+			inline void Vector4Blend(const float* q1, float s1, const float* q2, float s2, float* r)
+			{
+				__m128 v = _mm_mul_ps(_mm_set1_ps(s1), _mm_loadu_ps(q1));
+				v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(s2), _mm_loadu_ps(q2)));
+				_mm_storeu_ps(r, v);
+			}
+
+#define DKGL_SIMD_SHUFFLE(a, b, x, y, z, w)	_mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define DKGL_SIMD_SWIZZLE(a, x, y, z, w)	_mm_shuffle_ps(a, a, _MM_SHUFFLE(w, z, y, x))
+			// 2x2 matrix operations, matrix stored as (m00, m01, m10, m11)
+			// a * b
+			inline __m128 Matrix2Mul(__m128 a, __m128 b)
+			{
+				return _mm_add_ps(_mm_mul_ps(a, DKGL_SIMD_SWIZZLE(b, 0, 3, 0, 3)),
+								  _mm_mul_ps(DKGL_SIMD_SWIZZLE(a, 1, 0, 3, 2), DKGL_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+			}
+			// adj(a) * b
+			inline __m128 Matrix2AdjMul(__m128 a, __m128 b)
+			{
+				return _mm_sub_ps(_mm_mul_ps(DKGL_SIMD_SWIZZLE(a, 3, 3, 0, 0), b),
+								  _mm_mul_ps(DKGL_SIMD_SWIZZLE(a, 1, 1, 2, 2), DKGL_SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+			}
+			// a * adj(b)
+			inline __m128 Matrix2MulAdj(__m128 a, __m128 b)
+			{
+				return _mm_sub_ps(_mm_mul_ps(a, DKGL_SIMD_SWIZZLE(b, 3, 0, 3, 0)),
+								  _mm_mul_ps(DKGL_SIMD_SWIZZLE(a, 1, 0, 3, 2), DKGL_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+			}
+			// inverse of 4x4 matrix with block-wise inversion.
+			// M = | A B |, inverse = 1/|M| * | X Y |
+			//     | C D |                   | Z W |
+			// returns false if matrix is singular. (r is not modified)
+			inline bool Matrix4Inverse(const float* m, float* r, float* determinant)
+			{
+				const __m128 r0 = _mm_loadu_ps(&m[0]);
+				const __m128 r1 = _mm_loadu_ps(&m[4]);
+				const __m128 r2 = _mm_loadu_ps(&m[8]);
+				const __m128 r3 = _mm_loadu_ps(&m[12]);
+
+				const __m128 A = _mm_movelh_ps(r0, r1);
+				const __m128 B = _mm_movehl_ps(r1, r0);
+				const __m128 C = _mm_movelh_ps(r2, r3);
+				const __m128 D = _mm_movehl_ps(r3, r2);
+
+				// determinants of sub-matrices (|A|, |B|, |C|, |D|)
+				const __m128 detSub = _mm_sub_ps(
+					_mm_mul_ps(DKGL_SIMD_SHUFFLE(r0, r2, 0, 2, 0, 2), DKGL_SIMD_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+					_mm_mul_ps(DKGL_SIMD_SHUFFLE(r0, r2, 1, 3, 1, 3), DKGL_SIMD_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+				const __m128 detA = DKGL_SIMD_SWIZZLE(detSub, 0, 0, 0, 0);
+				const __m128 detB = DKGL_SIMD_SWIZZLE(detSub, 1, 1, 1, 1);
+				const __m128 detC = DKGL_SIMD_SWIZZLE(detSub, 2, 2, 2, 2);
+				const __m128 detD = DKGL_SIMD_SWIZZLE(detSub, 3, 3, 3, 3);
+
+				const __m128 D_C = Matrix2AdjMul(D, C);
+				const __m128 A_B = Matrix2AdjMul(A, B);
+				__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Matrix2Mul(B, D_C));
+				__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Matrix2Mul(C, A_B));
+				__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Matrix2MulAdj(D, A_B));
+				__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Matrix2MulAdj(A, D_C));
+
+				// |M| = |A|*|D| + |B|*|C| - tr(adj(A)B * adj(D)C)
+				__m128 tr = _mm_mul_ps(A_B, DKGL_SIMD_SWIZZLE(D_C, 0, 2, 1, 3));
+				tr = _mm_add_ps(tr, DKGL_SIMD_SWIZZLE(tr, 2, 3, 0, 1));
+				tr = _mm_add_ps(tr, DKGL_SIMD_SWIZZLE(tr, 1, 0, 3, 2));
+				__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+				detM = _mm_sub_ps(detM, tr);
+
+				float det = _mm_cvtss_f32(detM);
+				if (det == 0.0f)
+					return false;
+				if (determinant)
+					*determinant = det;
+
+				const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+				X = _mm_mul_ps(X, rDetM);
+				Y = _mm_mul_ps(Y, rDetM);
+				Z = _mm_mul_ps(Z, rDetM);
+				W = _mm_mul_ps(W, rDetM);
+
+				// adjugate and transpose blocks while storing.
+				_mm_storeu_ps(&r[0], DKGL_SIMD_SHUFFLE(X, Y, 3, 1, 3, 1));
+				_mm_storeu_ps(&r[4], DKGL_SIMD_SHUFFLE(X, Y, 2, 0, 2, 0));
+				_mm_storeu_ps(&r[8], DKGL_SIMD_SHUFFLE(Z, W, 3, 1, 3, 1));
+				_mm_storeu_ps(&r[12], DKGL_SIMD_SHUFFLE(Z, W, 2, 0, 2, 0));
+				return true;
+			}
+#undef DKGL_SIMD_SHUFFLE
+#undef DKGL_SIMD_SWIZZLE
+
+#elif defined(DKGL_SIMD_NEON)
+			// row of matrix multiplication, a (row) * b (4x4)
+			inline float32x4_t Matrix4MultiplyRow(const float* a, float32x4_t b0, float32x4_t b1, float32x4_t b2, float32x4_t b3)
+			{
+				float32x4_t v = vmulq_n_f32(b0, a[0]);
+				v = vaddq_f32(v, vmulq_n_f32(b1, a[1]));
+				v = vaddq_f32(v, vmulq_n_f32(b2, a[2]));
+				return vaddq_f32(v, vmulq_n_f32(b3, a[3]));
+			}
+			// r = a * b (row-major 4x4), r can be a or b.
+			inline void Matrix4Multiply(const float* a, const float* b, float* r)
+			{
+				const float32x4_t b0 = vld1q_f32(&b[0]);
+				const float32x4_t b1 = vld1q_f32(&b[4]);
+				const float32x4_t b2 = vld1q_f32(&b[8]);
+				const float32x4_t b3 = vld1q_f32(&b[12]);
+				const float32x4_t r0 = Matrix4MultiplyRow(&a[0], b0, b1, b2, b3);
+				const float32x4_t r1 = Matrix4MultiplyRow(&a[4], b0, b1, b2, b3);
+				const float32x4_t r2 = Matrix4MultiplyRow(&a[8], b0, b1, b2, b3);
+				const float32x4_t r3 = Matrix4MultiplyRow(&a[12], b0, b1, b2, b3);
+				vst1q_f32(&r[0], r0);
+				vst1q_f32(&r[4], r1);
+				vst1q_f32(&r[8], r2);
+				vst1q_f32(&r[12], r3);
+			}
+			// homogeneous transform of 3 vectors (x, y, z, 1) * m, r can be v.
+			inline void Vector3Transform(const float* v, const float* m, float* r)
+			{
+				float32x4_t t = vmulq_n_f32(vld1q_f32(&m[0]), v[0]);
+				t = vaddq_f32(t, vmulq_n_f32(vld1q_f32(&m[4]), v[1]));
+				t = vaddq_f32(t, vmulq_n_f32(vld1q_f32(&m[8]), v[2]));
+				t = vaddq_f32(t, vld1q_f32(&m[12]));
+				// NEON has no division on ARMv7, divide scalar.
+				float w = 1.0f / vgetq_lane_f32(t, 3);
+				t = vmulq_n_f32(t, w);
+				vst1_f32(r, vget_low_f32(t));
+				r[2] = vgetq_lane_f32(t, 2);
+			}
+			// homogeneous transform of 4 vectors in SoA layout.
+			inline void Vector3TransformSoA4(float* x, float* y, float* z, const float* m)
+			{
+				const float32x4_t vx = vld1q_f32(x);
+				const float32x4_t vy = vld1q_f32(y);
+				const float32x4_t vz = vld1q_f32(z);
+				float32x4_t r[4];
+				for (int i = 0; i < 4; ++i)
+				{
+					float32x4_t t = vmulq_n_f32(vx, m[i]);
+					t = vaddq_f32(t, vmulq_n_f32(vy, m[4 + i]));
+					t = vaddq_f32(t, vmulq_n_f32(vz, m[8 + i]));
+					r[i] = vaddq_f32(t, vdupq_n_f32(m[12 + i]));
+				}
+				float w[4];
+				vst1q_f32(w, r[3]);
+				for (int i = 0; i < 4; ++i)
+					w[i] = 1.0f / w[i];
+				const float32x4_t vw = vld1q_f32(w);
+				vst1q_f32(x, vmulq_f32(r[0], vw));
+				vst1q_f32(y, vmulq_f32(r[1], vw));
+				vst1q_f32(z, vmulq_f32(r[2], vw));
+			}
+			// dot product of 4 quaternion pairs, in order of (w, x, y, z).
+			inline void QuaternionDot4(const float* q1, const float* q2, float* r)
+			{
+				const float32x4x4_t a = vld4q_f32(q1);	// de-interleave (x, y, z, w)
+				const float32x4x4_t b = vld4q_f32(q2);
+				float32x4_t d = vmulq_f32(a.val[3], b.val[3]);
+				d = vaddq_f32(d, vmulq_f32(a.val[0], b.val[0]));
+				d = vaddq_f32(d, vmulq_f32(a.val[1], b.val[1]));
+				d = vaddq_f32(d, vmulq_f32(a.val[2], b.val[2]));
+				vst1q_f32(r, d);
+			}
+			// r = q1 * s1 + q2 * s2 (4 components)
+			inline void Vector4Blend(const float* q1, float s1, const float* q2, float s2, float* r)
+			{
+				float32x4_t v = vmulq_n_f32(vld1q_f32(q1), s1);
+				v = vaddq_f32(v, vmulq_n_f32(vld1q_f32(q2), s2));
+				vst1q_f32(r, v);
+			}
+#endif
+		}
+	}
+}
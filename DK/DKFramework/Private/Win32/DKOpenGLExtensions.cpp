@@ -6,7 +6,7 @@
 //  Copyright (c) 2004-2014 Hongtae Kim. All rights reserved.
 //
 
-#ifdef _WIN32
+#if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
 
 #include <windows.h>
 #include <gl/gl.h>
@@ -1604,4 +1604,4 @@ namespace DKFramework
 	}
 }
 
-#endif		// #ifdef _WIN32
+#endif		// #if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
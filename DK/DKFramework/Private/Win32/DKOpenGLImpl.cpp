@@ -6,7 +6,7 @@
 //  Copyright (c) 2004-2014 Hongtae Kim. All rights reserved.
 //
 
-#ifdef _WIN32
+#if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
 #include "../../../../lib/OpenGL.h"
 #include "../../../../lib/OpenGL/wglext.h"
 #include "DKOpenGLImpl.h"
@@ -447,5 +447,5 @@ void DKOpenGLImpl::SetSwapInterval(bool interval) const
 		wglSwapIntervalEXT(interval);
 }
 
-#endif	// ifdef _WIN32
+#endif	// if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
 
@@ -8,7 +8,7 @@
 
 #pragma once
 
-#ifdef _WIN32
+#if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
 #include "../../../../lib/OpenGL.h"
 #include "../../../DKFoundation.h"
 #include "../../Interface/DKOpenGLInterface.h"
@@ -60,4 +60,4 @@ namespace DKFramework
 	}
 }
 
-#endif // ifdef _WIN32
+#endif // if defined(_WIN32) && !defined(DKGL_OPENGL_NULL)
@@ -1,5 +1,13 @@
 ﻿#pragma once
 
+#ifdef DKGL_OPENGL_NULL
+	// headless build without OpenGL implementation.
+	// every OpenGL functions are implemented by DKFramework/Private/Null,
+	// which emulates GL objects and records commands. (see DKOpenGLRecorder)
+	#define GL_GLEXT_PROTOTYPES 1
+	#include "OpenGL/glcorearb.h"
+#else
+
 #if defined(__APPLE__) && defined(__MACH__)
 	#include <TargetConditionals.h>
 	#if TARGET_OS_IPHONE
@@ -800,3 +808,4 @@ using namespace OpenGL;
 
 #endif //ifdef _WIN32
 
+#endif	// ifdef DKGL_OPENGL_NULL
@@ -33,7 +33,7 @@ public:
 		DCObjectCallPyCallableGIL([&]()
 		{
 			PyObject* tmp = PyObject_CallMethod(object,
-				"getTransform", "N", PyUnicode_FromWideChar(key, -1));
+				"getTransform", "N", PyUnicode_FromWideChar(key.String(), -1));
 
 			if (tmp && PyObject_TypeCheck(tmp, DCTransformUnitTypeObject()))
 			{
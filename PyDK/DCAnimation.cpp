@@ -126,7 +126,7 @@ static PyObject* DCAnimationGetTransform(DCAnimation* self, PyObject* args)
 		return NULL;
 
 	DKTransformUnit transform;
-	if (self->animation->GetNodeTransform(name, t, transform))
+	if (self->animation->GetNodeTransform(DKString(name), t, transform))
 	{
 		return DCTransformUnitFromObject(&transform);
 	}
@@ -176,7 +176,7 @@ static PyObject* DCAnimationHasNode(DCAnimation* self, PyObject* args)
 	if (!PyArg_ParseTuple(args, "s", &name))
 		return NULL;
 
-	DKAnimation::NodeIndex idx = self->animation->IndexOfNode(name);
+	DKAnimation::NodeIndex idx = self->animation->IndexOfNode(DKString(name));
 	if (idx == DKAnimation::invalidNodeIndex)
 	{
 		Py_RETURN_FALSE;
@@ -374,7 +374,7 @@ static PyObject* DCMeshSamplerNames(DCMesh* self, PyObject*)
 	Py_ssize_t index = 0;
 	map.EnumerateForward([&](DKMesh::TextureSamplerMap::Pair& pair)
 	{
-		PyTuple_SET_ITEM(tuple, index, PyUnicode_FromWideChar(pair.key, -1));
+		PyTuple_SET_ITEM(tuple, index, PyUnicode_FromWideChar(pair.key.String(), -1));
 		index++;
 	});
 	return tuple;
@@ -498,7 +498,7 @@ static PyObject* DCMeshMaterialPropertyNames(DCMesh* self, PyObject*)
 	Py_ssize_t index = 0;
 	map.EnumerateForward([&](DKMesh::PropertyMap::Pair& pair)
 	{
-		PyTuple_SET_ITEM(tuple, index, PyUnicode_FromWideChar(pair.key, -1));
+		PyTuple_SET_ITEM(tuple, index, PyUnicode_FromWideChar(pair.key.String(), -1));
 		index++;
 	});
 	return tuple;
@@ -191,7 +191,7 @@ static PyObject* DCModelFindDescendant(DCModel* self, PyObject* args)
 	if (!PyArg_ParseTuple(args, "s", &name))
 		return NULL;
 
-	DKModel* model = self->model->FindDescendant(name);
+	DKModel* model = self->model->FindDescendant(DKString(name));
 	if (model)
 		return DCModelFromObject(model);
 	Py_RETURN_NONE;